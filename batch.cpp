@@ -0,0 +1,71 @@
+#include "lib/pa_batch.h"
+#include "lib/pa_parallel.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+void Usage() {
+  std::fprintf(
+      stderr,
+      "Usage: pa-batch [--csv] [--threads N] [--block N] [--list] [FILE]\n"
+      "\n"
+      "Runs the request on each line of FILE (or standard input) and writes\n"
+      "one line of results for each, in the same order, to standard output.\n"
+      "\n"
+      "  --csv        Read and write CSV rather than JSON lines\n"
+      "  --threads N  Workers computing requests (default: one per core)\n"
+      "  --block N    Lines read and computed at a time (default: 4096)\n"
+      "  --list       List the functions and their arguments, and exit\n");
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  EBatchFormat format = EBatchFormat::Jsonl;
+  int threads = 0;
+  long block = 4096;
+  const char *path = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--csv") == 0) {
+      format = EBatchFormat::Csv;
+    } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      threads = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--block") == 0 && i + 1 < argc) {
+      block = std::atol(argv[++i]);
+    } else if (std::strcmp(argv[i], "--list") == 0) {
+      for (const std::string &name : PABatch::FunctionNames())
+        std::printf("%s %s\n", name.c_str(),
+                    PABatch::Signature(name).c_str());
+      return 0;
+    } else if (argv[i][0] != '-' && path == nullptr) {
+      path = argv[i];
+    } else {
+      Usage();
+      return 2;
+    }
+  }
+  if (threads < 0 || block < 1) {
+    Usage();
+    return 2;
+  }
+
+  std::ios::sync_with_stdio(false);
+  std::ifstream file;
+  if (path != nullptr) {
+    file.open(path);
+    if (!file) {
+      std::fprintf(stderr, "pa-batch: cannot open %s\n", path);
+      return 1;
+    }
+  }
+
+  PATaskPool pool(threads);
+  PABatch(format).Run(path != nullptr ? file : std::cin, std::cout, pool,
+                      (std::size_t)block);
+
+  return std::cout ? 0 : 1;
+}
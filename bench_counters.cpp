@@ -0,0 +1,171 @@
+#include "bench_counters.h"
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const char *const kCounterNames[BenchCounters::kCounterCount] = {
+    "cycles", "instructions", "branch-misses", "L1d-misses"};
+
+#ifdef __linux__
+/** Value, time enabled and time running, as read with the format below. */
+struct CounterRead {
+  std::uint64_t value;
+  std::uint64_t timeEnabled;
+  std::uint64_t timeRunning;
+};
+
+int OpenCounter(int counter) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  switch (counter) {
+  case 0:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    break;
+  case 1:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    break;
+  case 2:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+    break;
+  default:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_L1D |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    break;
+  }
+
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+} // namespace
+
+BenchCounters::BenchCounters() {
+  for (int c = 0; c < kCounterCount; c++) {
+    values[c] = -1;
+#ifdef __linux__
+    fds[c] = OpenCounter(c);
+    if (fds[c] < 0 && reason.empty())
+      reason = std::string("perf_event_open: ") + std::strerror(errno);
+#else
+    fds[c] = -1;
+#endif
+  }
+
+#ifndef __linux__
+  reason = "hardware counters need Linux perf_event_open";
+#endif
+}
+
+BenchCounters::~BenchCounters() {
+#ifdef __linux__
+  for (int fd : fds)
+    if (fd >= 0)
+      close(fd);
+#endif
+}
+
+/**
+ * \brief True if at least one counter could be opened.
+ */
+bool BenchCounters::IsAvailable() const {
+  for (int fd : fds)
+    if (fd >= 0)
+      return true;
+
+  return false;
+}
+
+/**
+ * \brief Why the first counter that failed could not be opened, or empty.
+ */
+std::string BenchCounters::Reason() const { return reason; }
+
+void BenchCounters::Start() {
+#ifdef __linux__
+  for (int fd : fds) {
+    if (fd < 0)
+      continue;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+#endif
+}
+
+void BenchCounters::Stop() {
+#ifdef __linux__
+  for (int fd : fds)
+    if (fd >= 0)
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+  for (int c = 0; c < kCounterCount; c++) {
+    CounterRead readValue;
+    values[c] = -1;
+
+    if (fds[c] < 0 ||
+        read(fds[c], &readValue, sizeof(readValue)) != sizeof(readValue) ||
+        readValue.timeRunning == 0)
+      continue;
+
+    values[c] = static_cast<double>(readValue.value) *
+                readValue.timeEnabled / readValue.timeRunning;
+  }
+#endif
+}
+
+double BenchCounters::Value(int counter) const { return values[counter]; }
+
+const char *BenchCounters::Name(int counter) { return kCounterNames[counter]; }
+
+/**
+ * \brief Table of time, counts and instructions per cycle, per call. Counts
+ * that were not taken are shown as "-".
+ */
+std::string FormatCounterRows(const std::vector<BenchCounterRow> &rows) {
+  std::ostringstream text;
+  text << std::left << std::setw(36) << "function" << std::right
+       << std::setw(10) << "ns";
+  for (int c = 0; c < BenchCounters::kCounterCount; c++)
+    text << std::setw(15) << BenchCounters::Name(c);
+  text << std::setw(8) << "IPC" << "\n";
+
+  text << std::fixed << std::setprecision(1);
+  for (const BenchCounterRow &row : rows) {
+    text << std::left << std::setw(36) << row.name << std::right
+         << std::setw(10) << row.nsPerCall;
+    for (int c = 0; c < BenchCounters::kCounterCount; c++) {
+      if (row.perCall[c] < 0)
+        text << std::setw(15) << "-";
+      else
+        text << std::setw(15) << row.perCall[c];
+    }
+
+    if (row.perCall[0] > 0 && row.perCall[1] >= 0)
+      text << std::setw(8) << std::setprecision(2)
+           << row.perCall[1] / row.perCall[0] << std::setprecision(1);
+    else
+      text << std::setw(8) << "-";
+    text << "\n";
+  }
+
+  return text.str();
+}
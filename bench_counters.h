@@ -0,0 +1,85 @@
+#ifndef _bench_counters
+#define _bench_counters
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Hardware event counters for the calling thread, from Linux
+ * perf_event_open: cycles, instructions, branch misses and L1 data cache
+ * read misses.
+ *
+ * Each counter is opened on its own, so a machine (or VM) that lacks one
+ * still reports the others. Where none can be opened (another OS, or
+ * /proc/sys/kernel/perf_event_paranoid too strict) IsAvailable() is false
+ * and Reason() says why; timings are still taken.
+ */
+class BenchCounters {
+public:
+  static const int kCounterCount = 4;
+
+  BenchCounters();
+  ~BenchCounters();
+
+  BenchCounters(const BenchCounters &) = delete;
+  BenchCounters &operator=(const BenchCounters &) = delete;
+
+  bool IsAvailable() const;
+
+  std::string Reason() const;
+
+  void Start();
+
+  void Stop();
+
+  /** Count since Start(), scaled for multiplexing; -1 if not counted. */
+  double Value(int counter) const;
+
+  static const char *Name(int counter);
+
+private:
+  int fds[kCounterCount];
+  double values[kCounterCount];
+  std::string reason;
+};
+
+/**
+ * \brief One function's counts, per call.
+ */
+struct BenchCounterRow {
+  std::string name;
+  double nsPerCall;
+  double perCall[BenchCounters::kCounterCount]; /**< -1 if not counted. */
+};
+
+/**
+ * \brief Runs function(i) for i = 0 .. calls - 1 with the counters on, and
+ * returns the time and counts per call.
+ */
+template <typename Function>
+BenchCounterRow MeasureCounters(BenchCounters &counters,
+                                const std::string &name, int calls,
+                                Function function) {
+  BenchCounterRow row;
+  row.name = name;
+
+  auto start = std::chrono::steady_clock::now();
+  counters.Start();
+  for (int i = 0; i < calls; i++)
+    function(i);
+  counters.Stop();
+  auto end = std::chrono::steady_clock::now();
+
+  row.nsPerCall =
+      std::chrono::duration<double, std::nano>(end - start).count() / calls;
+  for (int c = 0; c < BenchCounters::kCounterCount; c++)
+    row.perCall[c] = counters.Value(c) < 0 ? -1 : counters.Value(c) / calls;
+
+  return row;
+}
+
+std::string FormatCounterRows(const std::vector<BenchCounterRow> &rows);
+
+#endif
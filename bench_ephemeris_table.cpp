@@ -0,0 +1,99 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_ephemeris_table.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+const std::size_t kMinutesInYear = 525600;
+
+double Milliseconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+} // namespace
+
+SCENARIO("Ephemeris Table against Text", "[ephemeris_table]") {
+  GIVEN("A year of positions at one-minute steps") {
+    std::vector<std::vector<double>> columns(
+        5, std::vector<double>(kMinutesInYear));
+    for (std::size_t i = 0; i < kMinutesInYear; i++) {
+      double t = i / 1440.0;
+      columns[0][i] = std::fmod(0.0172 * t, 6.283185307179586);
+      columns[1][i] = 0.409 * std::sin(0.0172 * t);
+      columns[2][i] = 1.496e8 * (1 + 0.0167 * std::cos(0.0172 * t));
+      columns[3][i] = std::sin(6.283185307179586 * t);
+      columns[4][i] = std::fmod(6.283185307179586 * t, 6.283185307179586);
+    }
+
+    WHEN("They are written and read back as text and as a table") {
+      auto start = std::chrono::steady_clock::now();
+      {
+        std::ofstream text("bench_ephemeris_table.txt");
+        char line[160];
+        for (std::size_t i = 0; i < kMinutesInYear; i++) {
+          int length = std::snprintf(
+              line, sizeof(line), "%.17g %.17g %.17g %.17g %.17g\n",
+              columns[0][i], columns[1][i], columns[2][i], columns[3][i],
+              columns[4][i]);
+          text.write(line, length);
+        }
+      }
+      double writeTextMs = Milliseconds(start);
+
+      start = std::chrono::steady_clock::now();
+      double textSum = 0.0;
+      {
+        std::ifstream text("bench_ephemeris_table.txt");
+        std::string line;
+        while (std::getline(text, line)) {
+          const char *next = line.c_str();
+          char *end;
+          for (int column = 0; column < 4; column++) {
+            std::strtod(next, &end);
+            next = end;
+          }
+          textSum += std::strtod(next, &end);
+        }
+      }
+      double readTextMs = Milliseconds(start);
+
+      start = std::chrono::steady_clock::now();
+      PAEphemerisWriter writer;
+      writer.Create("bench_ephemeris_table.bin", "Sun", 0, 51.5, 2460310.5,
+                    1.0 / 1440);
+      writer.AppendColumns(columns);
+      writer.Close();
+      double writeTableMs = Milliseconds(start);
+
+      start = std::chrono::steady_clock::now();
+      PAEphemerisTable table;
+      table.Open("bench_ephemeris_table.bin");
+      double openTableMs = Milliseconds(start);
+      double tableSum = 0.0;
+      for (double azimuth : table.Column("azimuthRad"))
+        tableSum += azimuth;
+      double readTableMs = Milliseconds(start);
+
+      std::printf("%-28s %10s\n", "525600 rows x 5 columns", "ms");
+      std::printf("%-28s %10.1f\n", "Write text", writeTextMs);
+      std::printf("%-28s %10.1f\n", "Parse text, sum a column", readTextMs);
+      std::printf("%-28s %10.1f\n", "Write table", writeTableMs);
+      std::printf("%-28s %10.3f\n", "Open table", openTableMs);
+      std::printf("%-28s %10.1f\n", "Open table, sum a column", readTableMs);
+
+      std::remove("bench_ephemeris_table.txt");
+      std::remove("bench_ephemeris_table.bin");
+
+      THEN("Both give the same column") {
+        REQUIRE(table.size() == kMinutesInYear);
+        REQUIRE(tableSum == textSum);
+      }
+    }
+  }
+}
@@ -0,0 +1,82 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_macros.h"
+#include "lib/pa_models.h"
+#include "lib/pa_parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+/**
+ * \brief Moonrise and moonset, and the solar eclipse circumstances, for one
+ * site and date: cheap on most days, dear near the poles.
+ */
+double MoonAndEclipse(PAWorkerFacades &facades, const CObservingSite &site,
+                      const CMonthDayYear &date) {
+  CMoonRiseSet moon = facades.moon.MoonriseAndMoonset(
+      date.day, date.month, date.year, site.isDaylightSaving,
+      site.zoneCorrectionHours, site.geogLongDeg, site.geogLatDeg);
+  CSolarEclipseCircumstances eclipse =
+      facades.eclipses.SolarEclipseCircumstances(
+          date.day, date.month, date.year, site.isDaylightSaving,
+          site.zoneCorrectionHours, site.geogLongDeg, site.geogLatDeg);
+
+  return moon.mrLocalTimeHour + eclipse.utMidEclipseHour;
+}
+} // namespace
+
+SCENARIO("Scaling of the Work-Stealing Pool", "[parallel]") {
+  GIVEN("Eight sites from the equator to 78 N, over 90 days") {
+    std::vector<CObservingSite> sites;
+    for (int s = 0; s < 8; s++)
+      sites.push_back(CObservingSite(15.0 * s, 78.0 * s / 7, false, 0));
+    std::vector<CMonthDayYear> dates;
+    double startJulianDate = pa_macros::CivilDateToJulianDate(1, 1, 2024);
+    for (int d = 0; d < 90; d++) {
+      double julianDate = startJulianDate + d;
+      dates.push_back(CMonthDayYear(pa_macros::JulianDateMonth(julianDate),
+                                    (int)pa_macros::JulianDateDay(julianDate),
+                                    pa_macros::JulianDateYear(julianDate)));
+    }
+
+    int maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> workerCounts;
+    for (int w = 1; w < maxWorkers; w *= 2)
+      workerCounts.push_back(w);
+    workerCounts.push_back(maxWorkers);
+
+    WHEN("The job is run with 1 to N workers") {
+      std::vector<double> serial;
+      double serialMs = 0.0;
+      bool sameResults = true;
+
+      std::printf("%8s %12s %9s %8s\n", "Workers", "ms", "Speedup", "Steals");
+      for (int workers : workerCounts) {
+        PATaskPool pool(workers);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<double> results =
+            ParallelForEach(pool, sites, dates, MoonAndEclipse);
+        auto end = std::chrono::steady_clock::now();
+        double ms =
+            std::chrono::duration<double, std::milli>(end - start).count();
+
+        if (workers == 1) {
+          serial = results;
+          serialMs = ms;
+        }
+        sameResults = sameResults && results == serial;
+
+        std::printf("%8d %12.1f %9.2f %8llu\n", workers, ms, serialMs / ms,
+                    (unsigned long long)pool.Steals());
+      }
+
+      THEN("Every worker count gives the same results, in the same order") {
+        REQUIRE(serial.size() == sites.size() * dates.size());
+        REQUIRE(sameResults);
+      }
+    }
+  }
+}
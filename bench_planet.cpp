@@ -0,0 +1,40 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch2/catch.hpp"
+#include "lib/pa_data.h"
+#include "lib/pa_macros.h"
+#include "lib/pa_models.h"
+#include "lib/pa_types.h"
+#include "planet_reference.h"
+#include <vector>
+
+using namespace pa_macros;
+
+SCENARIO("Outer Planet Perturbations", "[planet]") {
+  GIVEN("Elements of the planets every 40 days from 1900 to 2100") {
+    std::vector<double> centuries;
+    for (double t = 0.0; t < 2.0; t += 40.0 / 36525.0)
+      centuries.push_back(t);
+
+    std::vector<pa_data::PlanetDataPrecise> pl = PlanetElements(0.5);
+
+    BENCHMARK("Jupiter to Neptune, hand-written series") {
+      double sum = 0.0;
+      for (double t : centuries)
+        for (std::size_t ip = 4; ip < pl.size(); ip++)
+          sum += BranchyPlanetLongL4945(t, pl[ip]).qc;
+      return sum;
+    };
+
+    BENCHMARK("Jupiter to Neptune, tables with shared arguments") {
+      double sum = 0.0;
+      for (double t : centuries) {
+        COuterPlanetArguments outer = OuterPlanetArguments(t);
+        for (std::size_t ip = 4; ip < pl.size(); ip++)
+          sum += PlanetLongL4945(outer, static_cast<EOuterPlanet>(ip - 4),
+                                 pl[ip].value4)
+                     .qc;
+      }
+      return sum;
+    };
+  }
+}
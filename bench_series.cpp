@@ -0,0 +1,81 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "bench_counters.h"
+#include "catch2/catch.hpp"
+#include "lib/pa_data.h"
+#include "lib/pa_macros.h"
+#include "lib/pa_models.h"
+#include "lib/pa_types.h"
+#include <iostream>
+#include <vector>
+
+using namespace pa_macros;
+
+namespace {
+/** Results are added here, so the calls are not optimized away. */
+volatile double sink = 0.0;
+
+const int kCalls = 20000;
+} // namespace
+
+SCENARIO("Hardware Counters for the Trigonometric Series", "[counters]") {
+  GIVEN("Instants every 0.37 days from 1/1/2000") {
+    std::vector<double> centuries(kCalls);
+    for (int i = 0; i < kCalls; i++)
+      centuries[i] = (CivilDateToJulianDate(1, 1, 2000) + 0.37 * i -
+                      2415020.0) /
+                     36525.0;
+
+    std::vector<COuterPlanetArguments> outer(kCalls);
+    for (int i = 0; i < kCalls; i++)
+      outer[i] = OuterPlanetArguments(centuries[i]);
+
+    std::vector<pa_data::PlanetDataPrecise> pl = PlanetElements(1.0);
+    BenchCounters counters;
+    std::vector<BenchCounterRow> rows;
+
+    rows.push_back(
+        MeasureCounters(counters, "MoonLongLatHP", kCalls, [&](int i) {
+          sink = sink + MoonLongLatHP(0, 0, 0, 0, 0, 1 + 0.37 * i, 1, 2000)
+                            .longitudeDegrees;
+        }));
+    rows.push_back(MeasureCounters(
+        counters, "MoonLongLatHP, terms >= 0.001 deg", kCalls, [&](int i) {
+          sink = sink +
+                 MoonLongLatHP(0, 0, 0, 0, 0, 1 + 0.37 * i, 1, 2000, 0.001)
+                     .longitudeDegrees;
+        }));
+    rows.push_back(
+        MeasureCounters(counters, "SunLong", kCalls, [&](int i) {
+          sink = sink + SunLong(0, 0, 0, 0, 0, 1 + 0.37 * i, 1, 2000);
+        }));
+    rows.push_back(
+        MeasureCounters(counters, "PlanetLongL4810", kCalls, [&](int i) {
+          sink = sink + PlanetLongL4810(pl, 0.001 * i).qc;
+        }));
+    rows.push_back(
+        MeasureCounters(counters, "PlanetLongL4945, Saturn", kCalls,
+                        [&](int i) {
+                          sink = sink + PlanetLongL4945(outer[i],
+                                                        EOuterPlanet::Saturn,
+                                                        pl[5].value4)
+                                            .qc;
+                        }));
+    rows.push_back(
+        MeasureCounters(counters, "OuterPlanetArguments", kCalls, [&](int i) {
+          sink = sink + OuterPlanetArguments(centuries[i]).j1;
+        }));
+    rows.push_back(
+        MeasureCounters(counters, "TrueAnomaly, e = 0.967", kCalls, [&](int i) {
+          sink = sink + TrueAnomaly(0.001 * i, 0.967);
+        }));
+
+    THEN("Time and counts per call are reported") {
+      if (!counters.IsAvailable())
+        std::cout << "Hardware counters unavailable (" << counters.Reason()
+                  << "); timings only.\n";
+      std::cout << FormatCounterRows(rows);
+
+      REQUIRE(rows.size() == 7);
+    }
+  }
+}
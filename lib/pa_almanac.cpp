@@ -0,0 +1,360 @@
+#include "pa_almanac.h"
+#include "pa_macros.h"
+#include "pa_models.h"
+#include "pa_trace.h"
+#include "pa_types.h"
+#include "pa_util.h"
+#include <cmath>
+
+using namespace pa_types;
+using namespace pa_models;
+using namespace pa_util;
+using namespace pa_macros;
+
+namespace {
+/** Altitude of the Sun's centre at sunrise and sunset, below the horizon. */
+const double kSunriseDepressionDeg = 0.8333333;
+
+/** Mean daily delay of moonrise and moonset, in hours. */
+const double kMoonDailyDelayHours = 0.84;
+
+/**
+ * \brief Greenwich date of local noon, and the Sun's apparent position then.
+ *
+ * This is the first pass of every solar event on the local date.
+ */
+struct SolarDay {
+  double gd;
+  int gm;
+  int gy;
+  double obliquityDeg;
+  double sunLongDeg;
+  double raHours;
+  double decDeg;
+};
+
+/**
+ * \brief Second pass of one solar event, as in the L3710 helpers.
+ *
+ * firstStatus and secondStatus are those of each pass; the GST warnings are
+ * for each pass's sidereal time of the event.
+ */
+struct SolarEvent {
+  ERiseSetStatus firstStatus;
+  bool firstGstWarning;
+  ERiseSetStatus secondStatus;
+  bool secondGstWarning;
+  double lctHours;
+  double decDeg;
+};
+
+/**
+ * \brief Apparent right ascension (hours) and declination (degrees) of the Sun
+ * at longitude sr, as in SunriseLocalCivilTimeL3710.
+ */
+void ApparentSun(double sr, double gd, int gm, int gy, double obliquityDeg,
+                 double &raHours, double &decDeg) {
+  double a = sr + NutatLong(gd, gm, gy) - 0.005694;
+
+  raHours = DecimalDegreesToDegreeHours(
+      EclipticRightAscensionObliq(a, 0, obliquityDeg));
+  decDeg = EclipticDeclinationObliq(a, 0, obliquityDeg);
+}
+
+SolarDay SolarDayAt(double ld, int lm, int ly, int ds, int zc) {
+  SolarDay day;
+
+  day.gd = LocalCivilTimeGreenwichDay(12, 0, 0, ds, zc, ld, lm, ly);
+  day.gm = LocalCivilTimeGreenwichMonth(12, 0, 0, ds, zc, ld, lm, ly);
+  day.gy = LocalCivilTimeGreenwichYear(12, 0, 0, ds, zc, ld, lm, ly);
+  day.obliquityDeg = Obliq(day.gd, day.gm, day.gy);
+  day.sunLongDeg = SunLong(12, 0, 0, ds, zc, ld, lm, ly);
+  ApparentSun(day.sunLongDeg, day.gd, day.gm, day.gy, day.obliquityDeg,
+              day.raHours, day.decDeg);
+
+  return day;
+}
+
+/**
+ * \brief Rising or setting of the Sun at altitude -di degrees, from the shared
+ * first pass.
+ */
+SolarEvent SolveSolarEvent(const SolarDay &day, bool isRising, double di,
+                           int ds, int zc, double gl, double gp) {
+  SolarEvent event = {ERiseSetStatus::Ok, false, ERiseSetStatus::Ok, false,
+                      -99.0, 0.0};
+
+  event.firstStatus = ERiseSet(day.raHours, 0, 0, day.decDeg, 0, 0, di, gp);
+  if (event.firstStatus != ERiseSetStatus::Ok)
+    return event;
+
+  double la = isRising ? RiseSetLocalSiderealTimeRise(day.raHours, 0, 0,
+                                                      day.decDeg, 0, 0, di, gp)
+                       : RiseSetLocalSiderealTimeSet(day.raHours, 0, 0,
+                                                     day.decDeg, 0, 0, di, gp);
+  double x = LocalSiderealTimeToGreenwichSiderealTime(la, 0, 0, gl);
+  double ut = GreenwichSiderealTimeToUniversalTime(x, 0, 0, day.gd, day.gm,
+                                                   day.gy);
+  event.firstGstWarning =
+      EGstUt(x, 0, 0, day.gd, day.gm, day.gy) != EWarningFlags::Ok;
+
+  double raHours;
+  ApparentSun(SunLong(ut, 0, 0, 0, 0, day.gd, day.gm, day.gy), day.gd, day.gm,
+              day.gy, day.obliquityDeg, raHours, event.decDeg);
+
+  event.secondStatus = ERiseSet(raHours, 0, 0, event.decDeg, 0, 0, di, gp);
+  if (event.secondStatus != ERiseSetStatus::Ok)
+    return event;
+
+  la = isRising
+           ? RiseSetLocalSiderealTimeRise(raHours, 0, 0, event.decDeg, 0, 0, di,
+                                          gp)
+           : RiseSetLocalSiderealTimeSet(raHours, 0, 0, event.decDeg, 0, 0, di,
+                                         gp);
+  x = LocalSiderealTimeToGreenwichSiderealTime(la, 0, 0, gl);
+  ut = GreenwichSiderealTimeToUniversalTime(x, 0, 0, day.gd, day.gm, day.gy);
+  event.secondGstWarning =
+      EGstUt(x, 0, 0, day.gd, day.gm, day.gy) != EWarningFlags::Ok;
+  event.lctHours =
+      UniversalTimeToLocalCivilTime(ut, 0, 0, ds, zc, day.gd, day.gm, day.gy);
+
+  return event;
+}
+
+/**
+ * \brief Local civil time of the event, or -99, as in SunriseLocalCivilTime
+ * and TwilightAMLocalCivilTime.
+ */
+double SolarEventTime(const SolarEvent &event) {
+  if (event.firstStatus != ERiseSetStatus::Ok || event.firstGstWarning ||
+      event.secondStatus != ERiseSetStatus::Ok)
+    return -99.0;
+
+  return event.lctHours;
+}
+
+/**
+ * \brief Status as in ESunRiseSetCalcStatus, from the rising event.
+ */
+ERiseSetStatus SunRiseSetStatus(const SolarEvent &rising) {
+  if (rising.firstStatus != ERiseSetStatus::Ok)
+    return rising.firstStatus;
+  if (rising.secondStatus != ERiseSetStatus::Ok)
+    return rising.secondStatus;
+  if (rising.secondGstWarning)
+    return ERiseSetStatus::GstToUtConversionWarning;
+
+  return ERiseSetStatus::Ok;
+}
+
+/**
+ * \brief Status as in ETwilight, from the morning event.
+ */
+ETwilightStatus TwilightStatus(const SolarEvent &morning) {
+  ERiseSetStatus status = (morning.firstStatus != ERiseSetStatus::Ok)
+                              ? morning.firstStatus
+                              : morning.secondStatus;
+
+  if (status == ERiseSetStatus::Circumpolar)
+    return ETwilightStatus::LastsAllNight;
+  if (status == ERiseSetStatus::NeverRises)
+    return ETwilightStatus::SunTooFarBelowHorizon;
+  if (morning.secondGstWarning)
+    return ETwilightStatus::ConversionError;
+
+  return ETwilightStatus::Ok;
+}
+
+/**
+ * \brief Azimuth of the event, or -99, as in SunriseAzimuth and
+ * SunsetAzimuth.
+ */
+double SolarEventAzimuth(const SolarEvent &event, bool isRising, double di,
+                         double gp) {
+  if (SolarEventTime(event) == -99.0)
+    return -99.0;
+
+  return isRising ? RiseSetAzimuthRise(0, 0, 0, event.decDeg, 0, 0, di, gp)
+                  : RiseSetAzimuthSet(0, 0, 0, event.decDeg, 0, 0, di, gp);
+}
+
+/**
+ * \brief Seed for today's moonrise or moonset from yesterday's: the same
+ * local time, plus the Moon's mean daily delay. Local noon if yesterday had
+ * none, or the seed would leave today.
+ *
+ * @param previousDayOffset Days from yesterday to yesterday's event, so an
+ * event late yesterday seeds today's a little later in the day, and one
+ * that fell on today seeds nothing.
+ */
+double MoonSeed(double previousLct, int previousDayOffset) {
+  if (previousLct == -99.0)
+    return 12.0;
+
+  double seed = previousLct + 24.0 * previousDayOffset + kMoonDailyDelayHours;
+
+  return (seed >= 0.0 && seed < 24.0) ? seed : 12.0;
+}
+} // namespace
+
+/**
+ * \brief Almanac for a site. Longitude is positive east, and the zone
+ * correction is in hours east of Greenwich.
+ */
+PAAlmanac::PAAlmanac(double geogLongDeg, double geogLatDeg,
+                     bool isDaylightSaving, int zoneCorrectionHours) {
+  this->geogLongDeg = geogLongDeg;
+  this->geogLatDeg = geogLatDeg;
+  this->daylightSaving = isDaylightSaving ? 1 : 0;
+  this->zoneCorrectionHours = zoneCorrectionHours;
+  this->moonMaxIterations = 8;
+  this->moonToleranceHours = 0.0001;
+}
+
+/**
+ * \brief Almanac for dayCount consecutive local dates, starting from the given
+ * one.
+ *
+ * @return CAlmanac
+ */
+CAlmanac PAAlmanac::Days(double localDay, int localMonth, int localYear,
+                         int dayCount) {
+  PA_TRACE_SPAN("PAAlmanac::Days");
+
+  CAlmanac almanac(dayCount > 0 ? dayCount : 0);
+
+  int ds = daylightSaving;
+  int zc = zoneCorrectionHours;
+  double gl = geogLongDeg;
+  double gp = geogLatDeg;
+  double firstJulianDate = CivilDateToJulianDate(localDay, localMonth,
+                                                 localYear);
+  const ETwilightType twilightTypes[3] = {ETwilightType::Civil,
+                                          ETwilightType::Nautical,
+                                          ETwilightType::Astronomical};
+
+  double moonriseLct = -99.0;
+  double moonsetLct = -99.0;
+  int moonriseDayOffset = 0;
+  int moonsetDayOffset = 0;
+
+  for (int i = 0; i < dayCount; i++) {
+    double julianDate = firstJulianDate + i;
+    double ld = JulianDateDay(julianDate);
+    int lm = JulianDateMonth(julianDate);
+    int ly = JulianDateYear(julianDate);
+
+    almanac.julianDate[i] = julianDate;
+
+    // The Sun: one first pass at local noon for all eight events.
+    SolarDay solarDay = SolarDayAt(ld, lm, ly, ds, zc);
+
+    SolarEvent sunrise =
+        SolveSolarEvent(solarDay, true, kSunriseDepressionDeg, ds, zc, gl, gp);
+    SolarEvent sunset =
+        SolveSolarEvent(solarDay, false, kSunriseDepressionDeg, ds, zc, gl, gp);
+
+    almanac.sunStatus[i] = SunRiseSetStatus(sunrise);
+    almanac.sunriseHours[i] = SolarEventTime(sunrise);
+    almanac.sunsetHours[i] = SolarEventTime(sunset);
+    almanac.sunriseAzimuthDeg[i] =
+        SolarEventAzimuth(sunrise, true, kSunriseDepressionDeg, gp);
+    almanac.sunsetAzimuthDeg[i] =
+        SolarEventAzimuth(sunset, false, kSunriseDepressionDeg, gp);
+
+    for (int t = 0; t < 3; t++) {
+      double di = (double)twilightTypes[t];
+      SolarEvent morning = SolveSolarEvent(solarDay, true, di, ds, zc, gl, gp);
+      SolarEvent evening = SolveSolarEvent(solarDay, false, di, ds, zc, gl, gp);
+
+      almanac.twilightStatus[t][i] = TwilightStatus(morning);
+      almanac.twilightBeginsHours[t][i] = SolarEventTime(morning);
+      almanac.twilightEndsHours[t][i] = SolarEventTime(evening);
+    }
+
+    // Equation of time, for the local date taken as a Greenwich date. It is
+    // found at 12h UT, which is local noon when the zone is Greenwich.
+    double eotSunLongDeg = (ds + zc == 0)
+                               ? solarDay.sunLongDeg
+                               : SunLong(12, 0, 0, 0, 0, ld, lm, ly);
+    double eotRaHours = DecimalDegreesToDegreeHours(EclipticRightAscension(
+        eotSunLongDeg, 0, 0, 0, 0, 0, ld, lm, ly));
+    almanac.equationOfTimeMinutes[i] =
+        60.0 *
+        (GreenwichSiderealTimeToUniversalTime(eotRaHours, 0, 0, ld, lm, ly) -
+         12);
+
+    // The Moon's phase and bright limb at local noon, as PAMoon::MoonPhase,
+    // sharing the Sun's position found above.
+    CMoonLongLatHP moon = MoonLongLatHP(12, 0, 0, ds, zc, ld, lm, ly);
+    double cd = cos(DegreesToRadians(moon.longitudeDegrees -
+                                     solarDay.sunLongDeg)) *
+                cos(DegreesToRadians(moon.latitudeDegrees));
+    double d = acos(cd);
+    double phaseAngle =
+        0.1468 * sin(d) *
+        (1.0 - 0.0549 * sin(MoonMeanAnomaly(12, 0, 0, ds, zc, ld, lm, ly)));
+    phaseAngle /=
+        (1.0 - 0.0167 * sin(SunMeanAnomaly(12, 0, 0, ds, zc, ld, lm, ly)));
+    phaseAngle = 3.141592654 - d - DegreesToRadians(phaseAngle);
+    almanac.moonPhase[i] = (1.0 + cos(phaseAngle)) / 2.0;
+
+    double sunRaRad = DegreesToRadians(EclipticRightAscensionObliq(
+        solarDay.sunLongDeg, 0, solarDay.obliquityDeg));
+    double sunDecRad = DegreesToRadians(EclipticDeclinationObliq(
+        solarDay.sunLongDeg, 0, solarDay.obliquityDeg));
+    double moonRaRad = DegreesToRadians(EclipticRightAscensionObliq(
+        moon.longitudeDegrees, moon.latitudeDegrees, solarDay.obliquityDeg));
+    double moonDecRad = DegreesToRadians(EclipticDeclinationObliq(
+        moon.longitudeDegrees, moon.latitudeDegrees, solarDay.obliquityDeg));
+    almanac.moonBrightLimbDeg[i] = WToDegrees(
+        atan2(cos(sunDecRad) * sin(sunRaRad - moonRaRad),
+              cos(moonDecRad) * sin(sunDecRad) -
+                  sin(moonDecRad) * cos(sunDecRad) *
+                      cos(sunRaRad - moonRaRad)));
+
+    // Moonrise and moonset, each seeded from the day before.
+    CMoonRiseSetEvent moonrise =
+        MoonRiseEvent(MoonSeed(moonriseLct, moonriseDayOffset), ld, lm, ly, ds,
+                      zc, gl, gp, moonToleranceHours, moonMaxIterations);
+    CMoonRiseSetEvent moonset =
+        MoonSetEvent(MoonSeed(moonsetLct, moonsetDayOffset), ld, lm, ly, ds,
+                     zc, gl, gp, moonToleranceHours, moonMaxIterations);
+
+    moonriseLct = moonrise.localTimeHours;
+    moonsetLct = moonset.localTimeHours;
+    moonriseDayOffset = (int)std::lround(
+        CivilDateToJulianDate(moonrise.localDateDay, moonrise.localDateMonth,
+                              moonrise.localDateYear) -
+        julianDate);
+    moonsetDayOffset = (int)std::lround(
+        CivilDateToJulianDate(moonset.localDateDay, moonset.localDateMonth,
+                              moonset.localDateYear) -
+        julianDate);
+
+    almanac.moonriseHours[i] = moonrise.localTimeHours;
+    almanac.moonriseDayOffset[i] = moonriseDayOffset;
+    almanac.moonriseAzimuthDeg[i] = moonrise.azimuthDeg;
+    almanac.moonriseIterations[i] = moonrise.iterations;
+    almanac.moonsetHours[i] = moonset.localTimeHours;
+    almanac.moonsetDayOffset[i] = moonsetDayOffset;
+    almanac.moonsetAzimuthDeg[i] = moonset.azimuthDeg;
+    almanac.moonsetIterations[i] = moonset.iterations;
+  }
+
+  return almanac;
+}
+
+/**
+ * \brief Almanac for every day of a local year.
+ *
+ * @return CAlmanac
+ */
+CAlmanac PAAlmanac::Year(int localYear) {
+  PA_TRACE_SPAN("PAAlmanac::Year");
+
+  int dayCount = (int)std::lround(CivilDateToJulianDate(1, 1, localYear + 1) -
+                                  CivilDateToJulianDate(1, 1, localYear));
+
+  return Days(1, 1, localYear, dayCount);
+}
@@ -0,0 +1,46 @@
+#ifndef _pa_almanac
+#define _pa_almanac
+
+#include "pa_models.h"
+#include "pa_types.h"
+
+using namespace pa_models;
+using namespace pa_types;
+
+/**
+ * \brief Daily almanac for a site: sunrise and sunset, civil, nautical and
+ * astronomical twilight, moonrise and moonset, Moon phase and equation of
+ * time.
+ *
+ * Each day is computed in one pass. The Sun's position at local noon is found
+ * once and shared by the first pass of all eight solar events, and the Moon's
+ * position at local noon is shared by the phase and bright limb. Moonrise and
+ * moonset give their time, date and azimuth from one iteration, seeded from
+ * the previous day's answer. Results match PASun::SunriseAndSunset,
+ * PASun::MorningAndEveningTwilight, PAMoon::MoonriseAndMoonset,
+ * PAMoon::MoonPhase (at local noon) and PASun::EquationOfTime, before
+ * rounding.
+ */
+class PAAlmanac {
+public:
+  PAAlmanac(double geogLongDeg, double geogLatDeg, bool isDaylightSaving,
+            int zoneCorrectionHours);
+
+  CAlmanac Days(double localDay, int localMonth, int localYear, int dayCount);
+
+  CAlmanac Year(int localYear);
+
+  /** Iterations allowed for each moonrise and moonset. */
+  int moonMaxIterations;
+
+  /** Agreement of successive moonrise/moonset estimates, in hours. */
+  double moonToleranceHours;
+
+private:
+  double geogLongDeg;
+  double geogLatDeg;
+  int daylightSaving;
+  int zoneCorrectionHours;
+};
+
+#endif
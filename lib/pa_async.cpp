@@ -0,0 +1,423 @@
+#include "pa_async.h"
+#include "pa_moon.h"
+#include "pa_planet.h"
+#include "pa_sun.h"
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+namespace {
+/**
+ * Keys for the dispatched methods, so that methods with the same arguments
+ * keep separate computations.
+ */
+enum AsyncMethod {
+  kApproximatePositionOfSun,
+  kPrecisePositionOfSun,
+  kSunDistanceAndAngularSize,
+  kSunriseAndSunset,
+  kMorningAndEveningTwilight,
+  kEquationOfTime,
+  kSolarElongation,
+  kApproximatePositionOfMoon,
+  kPrecisePositionOfMoon,
+  kMoonPhase,
+  kTimesOfNewMoonAndFullMoon,
+  kMoonDistAngDiamHorParallax,
+  kMoonriseAndMoonset,
+  kApproximatePositionOfPlanet,
+  kPrecisePositionOfPlanet,
+  kVisualAspectsOfAPlanet,
+  kAllPlanetsAtInstant /**< Positions and aspects of all, for any planet. */
+};
+
+const std::string kNoText;
+
+/**
+ * \brief Index of a planet in CAllPlanetPositions, or -1.
+ */
+int PlanetIndex(const std::string &planetName) {
+  static const std::vector<std::string> names = {
+      "Mercury", "Venus", "Mars", "Jupiter", "Saturn", "Uranus", "Neptune"};
+  auto found = std::find(names.begin(), names.end(), planetName);
+
+  return (found == names.end()) ? -1 : (int)(found - names.begin());
+}
+} // namespace
+
+PAAsyncDispatcher::PAAsyncDispatcher(int workerCount) : pool(workerCount) {
+  this->stopping = false;
+  this->requests = 0;
+  this->computations = 0;
+  this->dispatcher = std::thread(&PAAsyncDispatcher::DispatchLoop, this);
+}
+
+PAAsyncDispatcher::~PAAsyncDispatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  queued.notify_one();
+
+  dispatcher.join();
+}
+
+bool PAAsyncDispatcher::Key::operator<(const Key &other) const {
+  return std::tie(method, arguments, text) <
+         std::tie(other.method, other.arguments, other.text);
+}
+
+/**
+ * \brief Join the computation for key, or queue a new one.
+ */
+void PAAsyncDispatcher::Enqueue(Key key, std::function<std::any()> compute,
+                                std::function<void(const std::any &)> deliver) {
+  requests.fetch_add(1, std::memory_order_relaxed);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = inFlight.find(key);
+    if (found != inFlight.end()) {
+      found->second->deliveries.push_back(std::move(deliver));
+      return;
+    }
+
+    auto pending = std::make_shared<Pending>();
+    pending->key = key;
+    pending->compute = std::move(compute);
+    pending->deliveries.push_back(std::move(deliver));
+    inFlight.emplace(std::move(key), pending);
+    queue.push_back(pending);
+  }
+  queued.notify_one();
+}
+
+/**
+ * \brief Take everything queued, compute it on the pool, and hand out the
+ * results; until stopped with nothing left.
+ */
+void PAAsyncDispatcher::DispatchLoop() {
+  while (true) {
+    std::vector<std::shared_ptr<Pending>> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      queued.wait(lock, [this] { return stopping || !queue.empty(); });
+      if (queue.empty())
+        return;
+      batch.swap(queue);
+    }
+
+    pool.Run(batch.size(), [&batch](std::size_t task, int) {
+      batch[task]->value = batch[task]->compute();
+    });
+    computations.fetch_add(batch.size(), std::memory_order_relaxed);
+
+    // Later requests for these keys start afresh; the deliveries gathered
+    // so far are final once the entries are gone.
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (std::shared_ptr<Pending> &pending : batch)
+        inFlight.erase(pending->key);
+    }
+
+    for (std::shared_ptr<Pending> &pending : batch)
+      for (auto &deliver : pending->deliveries)
+        deliver(pending->value);
+  }
+}
+
+std::future<CApproximatePositionOfSun> PAAsyncSun::ApproximatePositionOfSun(
+    double lctHours, double lctMinutes, double lctSeconds, double localDay,
+    int localMonth, int localYear, bool isDaylightSaving, int zoneCorrection) {
+  return dispatcher.Submit<CApproximatePositionOfSun>(
+      kApproximatePositionOfSun,
+      {lctHours, lctMinutes, lctSeconds, localDay, (double)localMonth,
+       (double)localYear, (double)isDaylightSaving, (double)zoneCorrection},
+      kNoText, [=] {
+        return PASun().ApproximatePositionOfSun(
+            lctHours, lctMinutes, lctSeconds, localDay, localMonth, localYear,
+            isDaylightSaving, zoneCorrection);
+      });
+}
+
+std::future<CPrecisePositionOfSun> PAAsyncSun::PrecisePositionOfSun(
+    double lctHours, double lctMinutes, double lctSeconds, double localDay,
+    int localMonth, int localYear, bool isDaylightSaving, int zoneCorrection) {
+  return dispatcher.Submit<CPrecisePositionOfSun>(
+      kPrecisePositionOfSun,
+      {lctHours, lctMinutes, lctSeconds, localDay, (double)localMonth,
+       (double)localYear, (double)isDaylightSaving, (double)zoneCorrection},
+      kNoText, [=] {
+        return PASun().PrecisePositionOfSun(lctHours, lctMinutes, lctSeconds,
+                                            localDay, localMonth, localYear,
+                                            isDaylightSaving, zoneCorrection);
+      });
+}
+
+std::future<CSunDistanceAngularSize> PAAsyncSun::SunDistanceAndAngularSize(
+    double lctHours, double lctMinutes, double lctSeconds, double localDay,
+    int localMonth, int localYear, bool isDaylightSaving, int zoneCorrection) {
+  return dispatcher.Submit<CSunDistanceAngularSize>(
+      kSunDistanceAndAngularSize,
+      {lctHours, lctMinutes, lctSeconds, localDay, (double)localMonth,
+       (double)localYear, (double)isDaylightSaving, (double)zoneCorrection},
+      kNoText, [=] {
+        return PASun().SunDistanceAndAngularSize(
+            lctHours, lctMinutes, lctSeconds, localDay, localMonth, localYear,
+            isDaylightSaving, zoneCorrection);
+      });
+}
+
+std::future<CSunriseAndSunset> PAAsyncSun::SunriseAndSunset(
+    double localDay, int localMonth, int localYear, bool isDaylightSaving,
+    int zoneCorrection, double geographicalLongDeg, double geographicalLatDeg) {
+  return dispatcher.Submit<CSunriseAndSunset>(
+      kSunriseAndSunset,
+      {localDay, (double)localMonth, (double)localYear,
+       (double)isDaylightSaving, (double)zoneCorrection, geographicalLongDeg,
+       geographicalLatDeg},
+      kNoText, [=] {
+        return PASun().SunriseAndSunset(localDay, localMonth, localYear,
+                                        isDaylightSaving, zoneCorrection,
+                                        geographicalLongDeg,
+                                        geographicalLatDeg);
+      });
+}
+
+std::future<CMorningAndEveningTwilight> PAAsyncSun::MorningAndEveningTwilight(
+    double localDay, int localMonth, int localYear, bool isDaylightSaving,
+    int zoneCorrection, double geographicalLongDeg, double geographicalLatDeg,
+    ETwilightType twilightType) {
+  return dispatcher.Submit<CMorningAndEveningTwilight>(
+      kMorningAndEveningTwilight,
+      {localDay, (double)localMonth, (double)localYear,
+       (double)isDaylightSaving, (double)zoneCorrection, geographicalLongDeg,
+       geographicalLatDeg, (double)twilightType},
+      kNoText, [=] {
+        return PASun().MorningAndEveningTwilight(
+            localDay, localMonth, localYear, isDaylightSaving, zoneCorrection,
+            geographicalLongDeg, geographicalLatDeg, twilightType);
+      });
+}
+
+std::future<CEquationOfTime>
+PAAsyncSun::EquationOfTime(double gwdateDay, int gwdateMonth, int gwdateYear) {
+  return dispatcher.Submit<CEquationOfTime>(
+      kEquationOfTime, {gwdateDay, (double)gwdateMonth, (double)gwdateYear},
+      kNoText, [=] {
+        return PASun().EquationOfTime(gwdateDay, gwdateMonth, gwdateYear);
+      });
+}
+
+std::future<double>
+PAAsyncSun::SolarElongation(double raHour, double raMin, double raSec,
+                            double decDeg, double decMin, double decSec,
+                            double gwdateDay, int gwdateMonth, int gwdateYear) {
+  return dispatcher.Submit<double>(
+      kSolarElongation,
+      {raHour, raMin, raSec, decDeg, decMin, decSec, gwdateDay,
+       (double)gwdateMonth, (double)gwdateYear},
+      kNoText, [=] {
+        return PASun().SolarElongation(raHour, raMin, raSec, decDeg, decMin,
+                                       decSec, gwdateDay, gwdateMonth,
+                                       gwdateYear);
+      });
+}
+
+std::future<CMoonApproximatePosition> PAAsyncMoon::ApproximatePositionOfMoon(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear) {
+  return dispatcher.Submit<CMoonApproximatePosition>(
+      kApproximatePositionOfMoon,
+      {lctHour, lctMin, lctSec, (double)isDaylightSaving,
+       (double)zoneCorrectionHours, localDateDay, (double)localDateMonth,
+       (double)localDateYear},
+      kNoText, [=] {
+        return PAMoon().ApproximatePositionOfMoon(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear);
+      });
+}
+
+std::future<CMoonPrecisePosition> PAAsyncMoon::PrecisePositionOfMoon(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear) {
+  return dispatcher.Submit<CMoonPrecisePosition>(
+      kPrecisePositionOfMoon,
+      {lctHour, lctMin, lctSec, (double)isDaylightSaving,
+       (double)zoneCorrectionHours, localDateDay, (double)localDateMonth,
+       (double)localDateYear},
+      kNoText, [=] {
+        return PAMoon().PrecisePositionOfMoon(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear);
+      });
+}
+
+std::future<CMoonPhase>
+PAAsyncMoon::MoonPhase(double lctHour, double lctMin, double lctSec,
+                       bool isDaylightSaving, int zoneCorrectionHours,
+                       double localDateDay, int localDateMonth,
+                       int localDateYear, EAccuracyLevel accuracyLevel) {
+  return dispatcher.Submit<CMoonPhase>(
+      kMoonPhase,
+      {lctHour, lctMin, lctSec, (double)isDaylightSaving,
+       (double)zoneCorrectionHours, localDateDay, (double)localDateMonth,
+       (double)localDateYear, (double)accuracyLevel},
+      kNoText, [=] {
+        return PAMoon().MoonPhase(lctHour, lctMin, lctSec, isDaylightSaving,
+                                  zoneCorrectionHours, localDateDay,
+                                  localDateMonth, localDateYear,
+                                  accuracyLevel);
+      });
+}
+
+std::future<CMoonNewFull> PAAsyncMoon::TimesOfNewMoonAndFullMoon(
+    bool isDaylightSaving, int zoneCorrectionHours, double localDateDay,
+    int localDateMonth, int localDateYear) {
+  return dispatcher.Submit<CMoonNewFull>(
+      kTimesOfNewMoonAndFullMoon,
+      {(double)isDaylightSaving, (double)zoneCorrectionHours, localDateDay,
+       (double)localDateMonth, (double)localDateYear},
+      kNoText, [=] {
+        return PAMoon().TimesOfNewMoonAndFullMoon(
+            isDaylightSaving, zoneCorrectionHours, localDateDay,
+            localDateMonth, localDateYear);
+      });
+}
+
+std::future<CMoonDistDiameterHP> PAAsyncMoon::MoonDistAngDiamHorParallax(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear) {
+  return dispatcher.Submit<CMoonDistDiameterHP>(
+      kMoonDistAngDiamHorParallax,
+      {lctHour, lctMin, lctSec, (double)isDaylightSaving,
+       (double)zoneCorrectionHours, localDateDay, (double)localDateMonth,
+       (double)localDateYear},
+      kNoText, [=] {
+        return PAMoon().MoonDistAngDiamHorParallax(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear);
+      });
+}
+
+std::future<CMoonRiseSet> PAAsyncMoon::MoonriseAndMoonset(
+    double localDateDay, int localDateMonth, int localDateYear,
+    bool isDaylightSaving, int zoneCorrectionHours, double geogLongDeg,
+    double geogLatDeg) {
+  return dispatcher.Submit<CMoonRiseSet>(
+      kMoonriseAndMoonset,
+      {localDateDay, (double)localDateMonth, (double)localDateYear,
+       (double)isDaylightSaving, (double)zoneCorrectionHours, geogLongDeg,
+       geogLatDeg},
+      kNoText, [=] {
+        return PAMoon().MoonriseAndMoonset(localDateDay, localDateMonth,
+                                           localDateYear, isDaylightSaving,
+                                           zoneCorrectionHours, geogLongDeg,
+                                           geogLatDeg);
+      });
+}
+
+std::future<CApproximatePositionOfPlanet>
+PAAsyncPlanet::ApproximatePositionOfPlanet(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear, std::string planetName) {
+  return dispatcher.Submit<CApproximatePositionOfPlanet>(
+      kApproximatePositionOfPlanet,
+      {lctHour, lctMin, lctSec, (double)isDaylightSaving,
+       (double)zoneCorrectionHours, localDateDay, (double)localDateMonth,
+       (double)localDateYear},
+      planetName, [=] {
+        return PAPlanet().ApproximatePositionOfPlanet(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear, planetName);
+      });
+}
+
+std::future<CPrecisePositionOfPlanet> PAAsyncPlanet::PrecisePositionOfPlanet(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear, std::string planetName) {
+  std::vector<double> instant = {lctHour, lctMin, lctSec,
+                                 (double)isDaylightSaving,
+                                 (double)zoneCorrectionHours, localDateDay,
+                                 (double)localDateMonth, (double)localDateYear};
+
+  int index = PlanetIndex(planetName);
+  if (index < 0)
+    return dispatcher.Submit<CPrecisePositionOfPlanet>(
+        kPrecisePositionOfPlanet, instant, planetName, [=] {
+          return PAPlanet().PrecisePositionOfPlanet(
+              lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+              localDateDay, localDateMonth, localDateYear, planetName);
+        });
+
+  return dispatcher.Submit<CPrecisePositionOfPlanet, CAllPlanetPositions>(
+      kAllPlanetsAtInstant, instant, kNoText,
+      [=] {
+        return PAPlanet().PrecisePositionOfAllPlanets(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear, true);
+      },
+      [index](const CAllPlanetPositions &all) {
+        return all.positions[index];
+      });
+}
+
+std::future<CPlanetVisualAspects> PAAsyncPlanet::VisualAspectsOfAPlanet(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear, std::string planetName) {
+  std::vector<double> instant = {lctHour, lctMin, lctSec,
+                                 (double)isDaylightSaving,
+                                 (double)zoneCorrectionHours, localDateDay,
+                                 (double)localDateMonth, (double)localDateYear};
+
+  int index = PlanetIndex(planetName);
+  if (index < 0)
+    return dispatcher.Submit<CPlanetVisualAspects>(
+        kVisualAspectsOfAPlanet, instant, planetName, [=] {
+          return PAPlanet().VisualAspectsOfAPlanet(
+              lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+              localDateDay, localDateMonth, localDateYear, planetName);
+        });
+
+  return dispatcher.Submit<CPlanetVisualAspects, CAllPlanetPositions>(
+      kAllPlanetsAtInstant, instant, kNoText,
+      [=] {
+        return PAPlanet().PrecisePositionOfAllPlanets(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear, true);
+      },
+      [index](const CAllPlanetPositions &all) {
+        return all.visualAspects[index];
+      });
+}
+
+std::future<CAllPlanetPositions> PAAsyncPlanet::PrecisePositionOfAllPlanets(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear, bool includeVisualAspects) {
+  return dispatcher.Submit<CAllPlanetPositions, CAllPlanetPositions>(
+      kAllPlanetsAtInstant,
+      {lctHour, lctMin, lctSec, (double)isDaylightSaving,
+       (double)zoneCorrectionHours, localDateDay, (double)localDateMonth,
+       (double)localDateYear},
+      kNoText,
+      [=] {
+        return PAPlanet().PrecisePositionOfAllPlanets(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear, true);
+      },
+      [includeVisualAspects](const CAllPlanetPositions &all) {
+        CAllPlanetPositions result = all;
+        if (!includeVisualAspects)
+          result.visualAspects.clear();
+
+        return result;
+      });
+}
@@ -0,0 +1,253 @@
+#ifndef _pa_async
+#define _pa_async
+
+#include "pa_models.h"
+#include "pa_parallel.h"
+#include "pa_types.h"
+#include <any>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pa_models;
+using namespace pa_types;
+
+/**
+ * \brief Runs façade requests on a PATaskPool and answers them with
+ * futures, computing requests that coincide only once.
+ *
+ * Requests wait in a queue; a dispatcher thread takes everything queued,
+ * computes it as one batch on the pool and then fulfils the futures. Until
+ * a computation's results are handed out, any request with the same key
+ * (method and exact arguments) joins it instead of queuing its own.
+ * Requests may also share a wider computation: planet positions for any
+ * planet at one instant are all taken from one
+ * PAPlanet::PrecisePositionOfAllPlanets.
+ *
+ * The destructor finishes every queued request before it returns.
+ */
+class PAAsyncDispatcher {
+public:
+  /** @param workerCount Workers of the pool; 0 for one per core. */
+  explicit PAAsyncDispatcher(int workerCount = 0);
+  ~PAAsyncDispatcher();
+
+  PAAsyncDispatcher(const PAAsyncDispatcher &) = delete;
+  PAAsyncDispatcher &operator=(const PAAsyncDispatcher &) = delete;
+
+  /**
+   * \brief A future for extract(compute()), where compute() may be shared
+   * with every other request for the same key.
+   *
+   * @param method Distinguishes computations whose arguments could
+   * coincide.
+   * @param text Any string argument, such as a planet name.
+   */
+  template <typename Result, typename Computed, typename Compute,
+            typename Extract>
+  std::future<Result> Submit(int method, std::vector<double> arguments,
+                             const std::string &text, Compute compute,
+                             Extract extract) {
+    auto promise = std::make_shared<std::promise<Result>>();
+    std::future<Result> future = promise->get_future();
+    auto deliver = [promise, extract](const std::any &value) {
+      promise->set_value(extract(std::any_cast<const Computed &>(value)));
+    };
+
+    Enqueue(Key{method, std::move(arguments), text},
+            [compute] { return std::any(compute()); }, deliver);
+
+    return future;
+  }
+
+  /**
+   * \brief A future for compute(), shared with every other request for the
+   * same method and arguments.
+   */
+  template <typename Result, typename Compute>
+  std::future<Result> Submit(int method, std::vector<double> arguments,
+                             const std::string &text, Compute compute) {
+    return Submit<Result, Result>(method, std::move(arguments), text, compute,
+                                  [](const Result &result) { return result; });
+  }
+
+  /** Requests submitted. */
+  std::uint64_t Requests() const { return requests.load(); }
+
+  /** Computations run; requests less this is the number coalesced. */
+  std::uint64_t Computations() const { return computations.load(); }
+
+private:
+  struct Key {
+    int method;
+    std::vector<double> arguments;
+    std::string text;
+
+    bool operator<(const Key &other) const;
+  };
+
+  struct Pending {
+    Key key;
+    std::function<std::any()> compute;
+    std::vector<std::function<void(const std::any &)>> deliveries;
+    std::any value;
+  };
+
+  void Enqueue(Key key, std::function<std::any()> compute,
+               std::function<void(const std::any &)> deliver);
+
+  void DispatchLoop();
+
+  PATaskPool pool;
+  std::mutex mutex;
+  std::condition_variable queued;
+  std::map<Key, std::shared_ptr<Pending>> inFlight;
+  std::vector<std::shared_ptr<Pending>> queue;
+  bool stopping;
+  std::atomic<std::uint64_t> requests;
+  std::atomic<std::uint64_t> computations;
+  std::thread dispatcher;
+};
+
+/**
+ * \brief PASun, answered through a PAAsyncDispatcher.
+ */
+class PAAsyncSun {
+public:
+  explicit PAAsyncSun(PAAsyncDispatcher &dispatcher)
+      : dispatcher(dispatcher) {}
+
+  std::future<CApproximatePositionOfSun>
+  ApproximatePositionOfSun(double lctHours, double lctMinutes,
+                           double lctSeconds, double localDay, int localMonth,
+                           int localYear, bool isDaylightSaving,
+                           int zoneCorrection);
+
+  std::future<CPrecisePositionOfSun>
+  PrecisePositionOfSun(double lctHours, double lctMinutes, double lctSeconds,
+                       double localDay, int localMonth, int localYear,
+                       bool isDaylightSaving, int zoneCorrection);
+
+  std::future<CSunDistanceAngularSize>
+  SunDistanceAndAngularSize(double lctHours, double lctMinutes,
+                            double lctSeconds, double localDay,
+                            int localMonth, int localYear,
+                            bool isDaylightSaving, int zoneCorrection);
+
+  std::future<CSunriseAndSunset>
+  SunriseAndSunset(double localDay, int localMonth, int localYear,
+                   bool isDaylightSaving, int zoneCorrection,
+                   double geographicalLongDeg, double geographicalLatDeg);
+
+  std::future<CMorningAndEveningTwilight> MorningAndEveningTwilight(
+      double localDay, int localMonth, int localYear, bool isDaylightSaving,
+      int zoneCorrection, double geographicalLongDeg, double geographicalLatDeg,
+      ETwilightType twilightType);
+
+  std::future<CEquationOfTime> EquationOfTime(double gwdateDay,
+                                              int gwdateMonth, int gwdateYear);
+
+  std::future<double> SolarElongation(double raHour, double raMin,
+                                      double raSec, double decDeg,
+                                      double decMin, double decSec,
+                                      double gwdateDay, int gwdateMonth,
+                                      int gwdateYear);
+
+private:
+  PAAsyncDispatcher &dispatcher;
+};
+
+/**
+ * \brief PAMoon, answered through a PAAsyncDispatcher.
+ */
+class PAAsyncMoon {
+public:
+  explicit PAAsyncMoon(PAAsyncDispatcher &dispatcher)
+      : dispatcher(dispatcher) {}
+
+  std::future<CMoonApproximatePosition>
+  ApproximatePositionOfMoon(double lctHour, double lctMin, double lctSec,
+                            bool isDaylightSaving, int zoneCorrectionHours,
+                            double localDateDay, int localDateMonth,
+                            int localDateYear);
+
+  std::future<CMoonPrecisePosition>
+  PrecisePositionOfMoon(double lctHour, double lctMin, double lctSec,
+                        bool isDaylightSaving, int zoneCorrectionHours,
+                        double localDateDay, int localDateMonth,
+                        int localDateYear);
+
+  std::future<CMoonPhase>
+  MoonPhase(double lctHour, double lctMin, double lctSec,
+            bool isDaylightSaving, int zoneCorrectionHours,
+            double localDateDay, int localDateMonth, int localDateYear,
+            EAccuracyLevel accuracyLevel);
+
+  std::future<CMoonNewFull>
+  TimesOfNewMoonAndFullMoon(bool isDaylightSaving, int zoneCorrectionHours,
+                            double localDateDay, int localDateMonth,
+                            int localDateYear);
+
+  std::future<CMoonDistDiameterHP>
+  MoonDistAngDiamHorParallax(double lctHour, double lctMin, double lctSec,
+                             bool isDaylightSaving, int zoneCorrectionHours,
+                             double localDateDay, int localDateMonth,
+                             int localDateYear);
+
+  std::future<CMoonRiseSet>
+  MoonriseAndMoonset(double localDateDay, int localDateMonth,
+                     int localDateYear, bool isDaylightSaving,
+                     int zoneCorrectionHours, double geogLongDeg,
+                     double geogLatDeg);
+
+private:
+  PAAsyncDispatcher &dispatcher;
+};
+
+/**
+ * \brief PAPlanet, answered through a PAAsyncDispatcher.
+ *
+ * Precise positions and visual aspects of the seven planets are taken from
+ * one computation of all of them per instant.
+ */
+class PAAsyncPlanet {
+public:
+  explicit PAAsyncPlanet(PAAsyncDispatcher &dispatcher)
+      : dispatcher(dispatcher) {}
+
+  std::future<CApproximatePositionOfPlanet>
+  ApproximatePositionOfPlanet(double lctHour, double lctMin, double lctSec,
+                              bool isDaylightSaving, int zoneCorrectionHours,
+                              double localDateDay, int localDateMonth,
+                              int localDateYear, std::string planetName);
+
+  std::future<CPrecisePositionOfPlanet>
+  PrecisePositionOfPlanet(double lctHour, double lctMin, double lctSec,
+                          bool isDaylightSaving, int zoneCorrectionHours,
+                          double localDateDay, int localDateMonth,
+                          int localDateYear, std::string planetName);
+
+  std::future<CPlanetVisualAspects>
+  VisualAspectsOfAPlanet(double lctHour, double lctMin, double lctSec,
+                         bool isDaylightSaving, int zoneCorrectionHours,
+                         double localDateDay, int localDateMonth,
+                         int localDateYear, std::string planetName);
+
+  std::future<CAllPlanetPositions> PrecisePositionOfAllPlanets(
+      double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+      int zoneCorrectionHours, double localDateDay, int localDateMonth,
+      int localDateYear, bool includeVisualAspects = false);
+
+private:
+  PAAsyncDispatcher &dispatcher;
+};
+
+#endif
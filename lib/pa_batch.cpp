@@ -0,0 +1,1405 @@
+#include "pa_batch.h"
+#include "pa_binary.h"
+#include "pa_comet.h"
+#include "pa_coordinates.h"
+#include "pa_datetime.h"
+#include "pa_eclipses.h"
+#include "pa_models.h"
+#include "pa_moon.h"
+#include "pa_planet.h"
+#include "pa_sun.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+
+using namespace pa_models;
+
+namespace {
+const char *Name(EWarningFlags value) {
+  return value == EWarningFlags::Ok ? "Ok" : "Warning";
+}
+
+const char *Name(ERiseSetStatus value) {
+  switch (value) {
+  case ERiseSetStatus::Ok:
+    return "Ok";
+  case ERiseSetStatus::NeverRises:
+    return "NeverRises";
+  case ERiseSetStatus::Circumpolar:
+    return "Circumpolar";
+  default:
+    return "GstToUtConversionWarning";
+  }
+}
+
+const char *Name(ETwilightStatus value) {
+  switch (value) {
+  case ETwilightStatus::Ok:
+    return "Ok";
+  case ETwilightStatus::ConversionError:
+    return "ConversionError";
+  case ETwilightStatus::LastsAllNight:
+    return "LastsAllNight";
+  default:
+    return "SunTooFarBelowHorizon";
+  }
+}
+
+const char *Name(ELunarEclipseStatus value) {
+  return value == ELunarEclipseStatus::Certain    ? "Certain"
+         : value == ELunarEclipseStatus::Possible ? "Possible"
+                                                  : "None";
+}
+
+const char *Name(ESolarEclipseStatus value) {
+  return value == ESolarEclipseStatus::Certain    ? "Certain"
+         : value == ESolarEclipseStatus::Possible ? "Possible"
+                                                  : "None";
+}
+
+/** Appends text as a JSON string, quoted and escaped. */
+void AppendJsonString(std::string &output, std::string_view text) {
+  output += '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      output += '\\';
+      output += c;
+    } else if ((unsigned char)c < 0x20) {
+      char escape[8];
+      std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+      output += escape;
+    } else {
+      output += c;
+    }
+  }
+  output += '"';
+}
+
+/** Appends text as a CSV field, quoted only if it must be. */
+void AppendCsvField(std::string &output, std::string_view text) {
+  if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+    output += text;
+    return;
+  }
+  output += '"';
+  for (char c : text) {
+    if (c == '"')
+      output += '"';
+    output += c;
+  }
+  output += '"';
+}
+
+/**
+ * \brief The fields of one result, written to the end of a line of output.
+ */
+class Fields {
+public:
+  Fields(EBatchFormat format, std::string &output)
+      : format(format), output(output), count(0) {}
+
+  /** Prefixes the names of the fields added next, as in "Mars.". */
+  void Prefix(const std::string &prefix) { this->prefix = prefix; }
+
+  void Add(const char *name, double value) {
+    Separate(name);
+    if (!std::isfinite(value)) {
+      output += format == EBatchFormat::Jsonl ? "null" : "";
+      return;
+    }
+    char text[32];
+    std::to_chars_result written =
+        std::to_chars(text, text + sizeof(text), value);
+    output.append(text, written.ptr);
+  }
+
+  void Add(const char *name, int value) {
+    Separate(name);
+    char text[16];
+    std::to_chars_result written =
+        std::to_chars(text, text + sizeof(text), value);
+    output.append(text, written.ptr);
+  }
+
+  void Add(const char *name, std::string_view value) {
+    Separate(name);
+    if (format == EBatchFormat::Jsonl)
+      AppendJsonString(output, value);
+    else
+      AppendCsvField(output, value);
+  }
+
+  void Add(const char *name, EWarningFlags value) { Add(name, Name(value)); }
+  void Add(const char *name, ERiseSetStatus value) { Add(name, Name(value)); }
+  void Add(const char *name, ETwilightStatus value) {
+    Add(name, Name(value));
+  }
+  void Add(const char *name, ELunarEclipseStatus value) {
+    Add(name, Name(value));
+  }
+  void Add(const char *name, ESolarEclipseStatus value) {
+    Add(name, Name(value));
+  }
+
+private:
+  void Add(const char *name, const char *value) {
+    Add(name, std::string_view(value));
+  }
+
+  /** Writes what goes before a field: a comma, and in JSON its name. */
+  void Separate(const char *name) {
+    if (count++ > 0 || format == EBatchFormat::Csv)
+      output += ',';
+    if (format == EBatchFormat::Jsonl) {
+      output += '"';
+      output += prefix;
+      output += name;
+      output += "\":";
+    }
+  }
+
+  EBatchFormat format;
+  std::string &output;
+  std::string prefix;
+  int count;
+};
+
+/**
+ * \brief The argument tokens of one request, read as the types of the
+ * method's parameters.
+ *
+ * The tokens are checked by Check() against the method's signature before
+ * any is read, so the readers need not report errors.
+ */
+class Arguments {
+public:
+  std::vector<std::string_view> tokens;
+
+  /** Text of quoted CSV fields that had doubled quotes, for tokens to view. */
+  std::deque<std::string> unquoted;
+
+  double Double(int i) const {
+    double value = 0.0;
+    std::from_chars(Begin(i), End(i), value);
+    return value;
+  }
+
+  int Int(int i) const {
+    int value = 0;
+    std::from_chars(Begin(i), End(i), value);
+    return value;
+  }
+
+  bool Bool(int i) const { return tokens[i] == "true" || tokens[i] == "1"; }
+
+  std::string Text(int i) const { return std::string(tokens[i]); }
+
+  ETwilightType TwilightType(int i) const {
+    return tokens[i] == "Civil"      ? ETwilightType::Civil
+           : tokens[i] == "Nautical" ? ETwilightType::Nautical
+                                     : ETwilightType::Astronomical;
+  }
+
+  EAccuracyLevel AccuracyLevel(int i) const {
+    return tokens[i] == "Precise" ? EAccuracyLevel::Precise
+                                  : EAccuracyLevel::Approximate;
+  }
+
+  EAngleMeasurementUnits AngleUnits(int i) const {
+    return tokens[i] == "Hours" ? EAngleMeasurementUnits::Hours
+                                : EAngleMeasurementUnits::Degrees;
+  }
+
+  ECoordinateType CoordinateType(int i) const {
+    return tokens[i] == "Apparent" ? ECoordinateType::Apparent
+                                   : ECoordinateType::Actual;
+  }
+
+  /**
+   * \brief Checks the tokens against a signature, one character per
+   * parameter (see PABatch::Signature()).
+   *
+   * @return Empty if they fit, otherwise what is wrong.
+   */
+  std::string Check(const char *signature) const {
+    std::size_t expected = std::strlen(signature);
+    if (tokens.size() != expected)
+      return "expected " + std::to_string(expected) + " arguments, got " +
+             std::to_string(tokens.size());
+
+    for (std::size_t i = 0; i < expected; i++)
+      if (!Fits(signature[i], tokens[i]))
+        return "argument " + std::to_string(i + 1) + " is not " +
+               Describe(signature[i]);
+
+    return "";
+  }
+
+private:
+  const char *Begin(int i) const {
+    return tokens[i].data() + (tokens[i][0] == '+' ? 1 : 0);
+  }
+  const char *End(int i) const { return tokens[i].data() + tokens[i].size(); }
+
+  static bool Whole(std::string_view token, std::from_chars_result read) {
+    return read.ec == std::errc() && read.ptr == token.data() + token.size();
+  }
+
+  static bool Fits(char kind, std::string_view token) {
+    if (token.empty())
+      return kind == 's';
+    std::string_view number = token[0] == '+' ? token.substr(1) : token;
+    const char *first = number.data();
+    const char *last = first + number.size();
+
+    switch (kind) {
+    case 'd': {
+      double value;
+      return Whole(token, std::from_chars(first, last, value));
+    }
+    case 'i': {
+      int value;
+      return Whole(token, std::from_chars(first, last, value));
+    }
+    case 'b':
+      return token == "true" || token == "false" || token == "1" ||
+             token == "0";
+    case 't':
+      return token == "Civil" || token == "Nautical" ||
+             token == "Astronomical";
+    case 'a':
+      return token == "Approximate" || token == "Precise";
+    case 'u':
+      return token == "Hours" || token == "Degrees";
+    case 'c':
+      return token == "Actual" || token == "Apparent";
+    default:
+      return true;
+    }
+  }
+
+  static const char *Describe(char kind) {
+    switch (kind) {
+    case 'd':
+      return "a number";
+    case 'i':
+      return "an integer";
+    case 'b':
+      return "true or false";
+    case 't':
+      return "Civil, Nautical or Astronomical";
+    case 'a':
+      return "Approximate or Precise";
+    case 'u':
+      return "Hours or Degrees";
+    case 'c':
+      return "Actual or Apparent";
+    default:
+      return "text";
+    }
+  }
+};
+
+void Write(Fields &out, double result) { out.Add("value", result); }
+
+void Write(Fields &out, int result) { out.Add("value", result); }
+
+void Write(Fields &out, const CAberration &result) {
+  out.Add("apparentEclLongDeg", result.apparentEclLongDeg);
+  out.Add("apparentEclLongMin", result.apparentEclLongMin);
+  out.Add("apparentEclLongSec", result.apparentEclLongSec);
+  out.Add("apparentEclLatDeg", result.apparentEclLatDeg);
+  out.Add("apparentEclLatMin", result.apparentEclLatMin);
+  out.Add("apparentEclLatSec", result.apparentEclLatSec);
+}
+
+void Write(Fields &out, const CAngle &result) {
+  out.Add("degrees", result.degrees);
+  out.Add("minutes", result.minutes);
+  out.Add("seconds", result.seconds);
+}
+
+void Write(Fields &out, const CApproximatePositionOfPlanet &result) {
+  out.Add("planetRAHour", result.planetRAHour);
+  out.Add("planetRAMin", result.planetRAMin);
+  out.Add("planetRASec", result.planetRASec);
+  out.Add("planetDecDeg", result.planetDecDeg);
+  out.Add("planetDecMin", result.planetDecMin);
+  out.Add("planetDecSec", result.planetDecSec);
+}
+
+void Write(Fields &out, const CApproximatePositionOfSun &result) {
+  out.Add("rightAscensionHours", result.rightAscensionHours);
+  out.Add("rightAscensionMinutes", result.rightAscensionMinutes);
+  out.Add("rightAscensionSeconds", result.rightAscensionSeconds);
+  out.Add("declinationDegrees", result.declinationDegrees);
+  out.Add("declinationMinutes", result.declinationMinutes);
+  out.Add("declinationSeconds", result.declinationSeconds);
+}
+
+void Write(Fields &out, const CAtmosphericRefraction &result) {
+  out.Add("correctedRaHour", result.correctedRaHour);
+  out.Add("correctedRaMin", result.correctedRaMin);
+  out.Add("correctedRaSec", result.correctedRaSec);
+  out.Add("correctedDecDeg", result.correctedDecDeg);
+  out.Add("correctedDecMin", result.correctedDecMin);
+  out.Add("correctedDecSec", result.correctedDecSec);
+}
+
+void Write(Fields &out, const CBinaryStarOrbitalData &result) {
+  out.Add("positionAngleDeg", result.positionAngleDeg);
+  out.Add("separationArcsec", result.separationArcsec);
+}
+
+void Write(Fields &out, const CCivilTime &result) {
+  out.Add("hours", result.hours);
+  out.Add("minutes", result.minutes);
+  out.Add("seconds", result.seconds);
+}
+
+void Write(Fields &out, const CCometPosition &result) {
+  out.Add("raHour", result.raHour);
+  out.Add("raMin", result.raMin);
+  out.Add("raSec", result.raSec);
+  out.Add("decDeg", result.decDeg);
+  out.Add("decMin", result.decMin);
+  out.Add("decSec", result.decSec);
+  out.Add("distEarth", result.distEarth);
+}
+
+void Write(Fields &out, const CEqlipticCoordinates &result) {
+  out.Add("longitudeDegrees", result.longitudeDegrees);
+  out.Add("longitudeMinutes", result.longitudeMinutes);
+  out.Add("longitudeSeconds", result.longitudeSeconds);
+  out.Add("latitudeDegrees", result.latitudeDegrees);
+  out.Add("latitudeMinutes", result.latitudeMinutes);
+  out.Add("latitudeSeconds", result.latitudeSeconds);
+}
+
+void Write(Fields &out, const CEquationOfTime &result) {
+  out.Add("minutes", result.minutes);
+  out.Add("seconds", result.seconds);
+}
+
+void Write(Fields &out, const CEquatorialCoordinatesHA &result) {
+  out.Add("hourAngleHours", result.hourAngleHours);
+  out.Add("hourAngleMinutes", result.hourAngleMinutes);
+  out.Add("hourAngleSeconds", result.hourAngleSeconds);
+  out.Add("declinationDegrees", result.declinationDegrees);
+  out.Add("declinationMinutes", result.declinationMinutes);
+  out.Add("declinationSeconds", result.declinationSeconds);
+}
+
+void Write(Fields &out, const CEquatorialCoordinatesRA &result) {
+  out.Add("rightAscensionHours", result.rightAscensionHours);
+  out.Add("rightAscensionMinutes", result.rightAscensionMinutes);
+  out.Add("rightAscensionSeconds", result.rightAscensionSeconds);
+  out.Add("declinationDegrees", result.declinationDegrees);
+  out.Add("declinationMinutes", result.declinationMinutes);
+  out.Add("declinationSeconds", result.declinationSeconds);
+}
+
+void Write(Fields &out, const CGalacticCoordinates &result) {
+  out.Add("longitudeDegrees", result.longitudeDegrees);
+  out.Add("longitudeMinutes", result.longitudeMinutes);
+  out.Add("longitudeSeconds", result.longitudeSeconds);
+  out.Add("latitudeDegrees", result.latitudeDegrees);
+  out.Add("latitudeMinutes", result.latitudeMinutes);
+  out.Add("latitudeSeconds", result.latitudeSeconds);
+}
+
+void Write(Fields &out, const CGeocentricParallax &result) {
+  out.Add("correctedRaHour", result.correctedRaHour);
+  out.Add("correctedRaMin", result.correctedRaMin);
+  out.Add("correctedRaSec", result.correctedRaSec);
+  out.Add("correctedDecDeg", result.correctedDecDeg);
+  out.Add("correctedDecMin", result.correctedDecMin);
+  out.Add("correctedDecSec", result.correctedDecSec);
+}
+
+void Write(Fields &out, const CGreenwichSiderealTime &result) {
+  out.Add("hours", result.hours);
+  out.Add("minutes", result.minutes);
+  out.Add("seconds", result.seconds);
+}
+
+void Write(Fields &out, const CHeliographicCoordinates &result) {
+  out.Add("longitudeDegrees", result.longitudeDegrees);
+  out.Add("latitudeDegrees", result.latitudeDegrees);
+}
+
+void Write(Fields &out, const CHorizonCoordinates &result) {
+  out.Add("azimuthDegrees", result.azimuthDegrees);
+  out.Add("azimuthMinutes", result.azimuthMinutes);
+  out.Add("azimuthSeconds", result.azimuthSeconds);
+  out.Add("altitudeDegrees", result.altitudeDegrees);
+  out.Add("altitudeMinutes", result.altitudeMinutes);
+  out.Add("altitudeSeconds", result.altitudeSeconds);
+}
+
+void Write(Fields &out, const CHourAngle &result) {
+  out.Add("hours", result.hours);
+  out.Add("minutes", result.minutes);
+  out.Add("seconds", result.seconds);
+}
+
+void Write(Fields &out, const CLunarEclipseCircumstances &result) {
+  out.Add("certainDateDay", result.certainDateDay);
+  out.Add("certainDateMonth", result.certainDateMonth);
+  out.Add("certainDateYear", result.certainDateYear);
+  out.Add("utStartPenPhaseHour", result.utStartPenPhaseHour);
+  out.Add("utStartPenPhaseMinutes", result.utStartPenPhaseMinutes);
+  out.Add("utStartUmbralPhaseHour", result.utStartUmbralPhaseHour);
+  out.Add("utStartUmbralPhaseMinutes", result.utStartUmbralPhaseMinutes);
+  out.Add("utStartTotalPhaseHour", result.utStartTotalPhaseHour);
+  out.Add("utStartTotalPhaseMinutes", result.utStartTotalPhaseMinutes);
+  out.Add("utMidEclipseHour", result.utMidEclipseHour);
+  out.Add("utMidEclipseMinutes", result.utMidEclipseMinutes);
+  out.Add("utEndTotalPhaseHour", result.utEndTotalPhaseHour);
+  out.Add("utEndTotalPhaseMinutes", result.utEndTotalPhaseMinutes);
+  out.Add("utEndUmbralPhaseHour", result.utEndUmbralPhaseHour);
+  out.Add("utEndUmbralPhaseMinutes", result.utEndUmbralPhaseMinutes);
+  out.Add("utEndPenPhaseHour", result.utEndPenPhaseHour);
+  out.Add("utEndPenPhaseMinutes", result.utEndPenPhaseMinutes);
+  out.Add("eclipseMagnitude", result.eclipseMagnitude);
+}
+
+void Write(Fields &out, const CLunarEclipseOccurrence &result) {
+  out.Add("status", result.status);
+  out.Add("eventDateDay", result.eventDateDay);
+  out.Add("eventDateMonth", result.eventDateMonth);
+  out.Add("eventDateYear", result.eventDateYear);
+}
+
+void Write(Fields &out, const CMonthDayYear &result) {
+  out.Add("month", result.month);
+  out.Add("day", result.day);
+  out.Add("year", result.year);
+}
+
+void Write(Fields &out, const CMoonApproximatePosition &result) {
+  out.Add("raHour", result.raHour);
+  out.Add("raMin", result.raMin);
+  out.Add("raSec", result.raSec);
+  out.Add("decDeg", result.decDeg);
+  out.Add("decMin", result.decMin);
+  out.Add("decSec", result.decSec);
+}
+
+void Write(Fields &out, const CMoonDistDiameterHP &result) {
+  out.Add("earthMoonDist", result.earthMoonDist);
+  out.Add("angDiameterDeg", result.angDiameterDeg);
+  out.Add("angDiameterMin", result.angDiameterMin);
+  out.Add("horParallaxDeg", result.horParallaxDeg);
+  out.Add("horParallaxMin", result.horParallaxMin);
+  out.Add("horParallaxSec", result.horParallaxSec);
+}
+
+void Write(Fields &out, const CMoonNewFull &result) {
+  out.Add("nmLocalTimeHour", result.nmLocalTimeHour);
+  out.Add("nmLocalTimeMin", result.nmLocalTimeMin);
+  out.Add("nmLocalDateDay", result.nmLocalDateDay);
+  out.Add("nmLocalDateMonth", result.nmLocalDateMonth);
+  out.Add("nmLocalDateYear", result.nmLocalDateYear);
+  out.Add("fmLocalTimeHour", result.fmLocalTimeHour);
+  out.Add("fmLocalTimeMin", result.fmLocalTimeMin);
+  out.Add("fmLocalDateDay", result.fmLocalDateDay);
+  out.Add("fmLocalDateMonth", result.fmLocalDateMonth);
+  out.Add("fmLocalDateYear", result.fmLocalDateYear);
+}
+
+void Write(Fields &out, const CMoonPhase &result) {
+  out.Add("phase", result.phase);
+  out.Add("brightLimbDeg", result.brightLimbDeg);
+}
+
+void Write(Fields &out, const CMoonPrecisePosition &result) {
+  out.Add("raHour", result.raHour);
+  out.Add("raMin", result.raMin);
+  out.Add("raSec", result.raSec);
+  out.Add("decDeg", result.decDeg);
+  out.Add("decMin", result.decMin);
+  out.Add("decSec", result.decSec);
+  out.Add("earthMoonDistKM", result.earthMoonDistKM);
+  out.Add("horParallaxDeg", result.horParallaxDeg);
+}
+
+void Write(Fields &out, const CMoonRiseSet &result) {
+  out.Add("mrLocalTimeHour", result.mrLocalTimeHour);
+  out.Add("mrLocalTimeMin", result.mrLocalTimeMin);
+  out.Add("mrLocalDateDay", result.mrLocalDateDay);
+  out.Add("mrLocalDateMonth", result.mrLocalDateMonth);
+  out.Add("mrLocalDateYear", result.mrLocalDateYear);
+  out.Add("mrAzimuthDeg", result.mrAzimuthDeg);
+  out.Add("msLocalTimeHour", result.msLocalTimeHour);
+  out.Add("msLocalTimeMin", result.msLocalTimeMin);
+  out.Add("msLocalDateDay", result.msLocalDateDay);
+  out.Add("msLocalDateMonth", result.msLocalDateMonth);
+  out.Add("msLocalDateYear", result.msLocalDateYear);
+  out.Add("msAzimuthDeg", result.msAzimuthDeg);
+}
+
+void Write(Fields &out, const CMorningAndEveningTwilight &result) {
+  out.Add("amTwilightBeginsHour", result.amTwilightBeginsHour);
+  out.Add("amTwilightBeginsMin", result.amTwilightBeginsMin);
+  out.Add("pmTwilightEndsHour", result.pmTwilightEndsHour);
+  out.Add("pmTwilightEndsMin", result.pmTwilightEndsMin);
+  out.Add("status", result.status);
+}
+
+void Write(Fields &out, const CNutation &result) {
+  out.Add("nutInLongDeg", result.nutInLongDeg);
+  out.Add("nutInOblDeg", result.nutInOblDeg);
+}
+
+void Write(Fields &out, const CPlanetVisualAspects &result) {
+  out.Add("distanceAU", result.distanceAU);
+  out.Add("angDiaArcsec", result.angDiaArcsec);
+  out.Add("phase", result.phase);
+  out.Add("lightTimeHour", result.lightTimeHour);
+  out.Add("lightTimeMinutes", result.lightTimeMinutes);
+  out.Add("lightTimeSeconds", result.lightTimeSeconds);
+  out.Add("posAngleBrightLimbDeg", result.posAngleBrightLimbDeg);
+  out.Add("approximateMagnitude", result.approximateMagnitude);
+}
+
+void Write(Fields &out, const CPrecession &result) {
+  out.Add("correctedRaHour", result.correctedRaHour);
+  out.Add("correctedRaMinutes", result.correctedRaMinutes);
+  out.Add("correctedRaSeconds", result.correctedRaSeconds);
+  out.Add("correctedDecDeg", result.correctedDecDeg);
+  out.Add("correctedDecMinutes", result.correctedDecMinutes);
+  out.Add("correctedDecSeconds", result.correctedDecSeconds);
+}
+
+void Write(Fields &out, const CPrecisePositionOfPlanet &result) {
+  out.Add("PlanetRAHour", result.PlanetRAHour);
+  out.Add("PlanetRAMin", result.PlanetRAMin);
+  out.Add("PlanetRASec", result.PlanetRASec);
+  out.Add("PlanetDecDeg", result.PlanetDecDeg);
+  out.Add("PlanetDecMin", result.PlanetDecMin);
+  out.Add("PlanetDecSec", result.PlanetDecSec);
+}
+
+void Write(Fields &out, const CPrecisePositionOfSun &result) {
+  out.Add("rightAscensionHours", result.rightAscensionHours);
+  out.Add("rightAscensionMinutes", result.rightAscensionMinutes);
+  out.Add("rightAscensionSeconds", result.rightAscensionSeconds);
+  out.Add("declinationDegrees", result.declinationDegrees);
+  out.Add("declinationMinutes", result.declinationMinutes);
+  out.Add("declinationSeconds", result.declinationSeconds);
+}
+
+void Write(Fields &out, const CRightAscension &result) {
+  out.Add("hours", result.hours);
+  out.Add("minutes", result.minutes);
+  out.Add("seconds", result.seconds);
+}
+
+void Write(Fields &out, const CRiseSet &result) {
+  out.Add("rsStatus", result.rsStatus);
+  out.Add("utRiseHour", result.utRiseHour);
+  out.Add("utRiseMin", result.utRiseMin);
+  out.Add("utSetHour", result.utSetHour);
+  out.Add("utSetMin", result.utSetMin);
+  out.Add("azRise", result.azRise);
+  out.Add("azSet", result.azSet);
+}
+
+void Write(Fields &out, const CSelenographicCoordinates1 &result) {
+  out.Add("subEarthLongitude", result.subEarthLongitude);
+  out.Add("subEarthLatitude", result.subEarthLatitude);
+  out.Add("positionAngleOfPole", result.positionAngleOfPole);
+}
+
+void Write(Fields &out, const CSelenographicCoordinates2 &result) {
+  out.Add("subSolarLongitude", result.subSolarLongitude);
+  out.Add("subSolarColongitude", result.subSolarColongitude);
+  out.Add("subSolarLatitude", result.subSolarLatitude);
+}
+
+void Write(Fields &out, const CSolarEclipseCircumstances &result) {
+  out.Add("certainDateDay", result.certainDateDay);
+  out.Add("certainDateMonth", result.certainDateMonth);
+  out.Add("certainDateYear", result.certainDateYear);
+  out.Add("utFirstContactHour", result.utFirstContactHour);
+  out.Add("utFirstContactMinutes", result.utFirstContactMinutes);
+  out.Add("utMidEclipseHour", result.utMidEclipseHour);
+  out.Add("utMidEclipseMinutes", result.utMidEclipseMinutes);
+  out.Add("utLastContactHour", result.utLastContactHour);
+  out.Add("utLastContactMinutes", result.utLastContactMinutes);
+  out.Add("eclipseMagnitude", result.eclipseMagnitude);
+}
+
+void Write(Fields &out, const CSolarEclipseOccurrence &result) {
+  out.Add("status", result.status);
+  out.Add("eventDateDay", result.eventDateDay);
+  out.Add("eventDateMonth", result.eventDateMonth);
+  out.Add("eventDateYear", result.eventDateYear);
+}
+
+void Write(Fields &out, const CSunDistanceAngularSize &result) {
+  out.Add("distKm", result.distKm);
+  out.Add("angSizeDeg", result.angSizeDeg);
+  out.Add("angSizeMin", result.angSizeMin);
+  out.Add("angSizeSec", result.angSizeSec);
+}
+
+void Write(Fields &out, const CSunriseAndSunset &result) {
+  out.Add("localSunriseHour", result.localSunriseHour);
+  out.Add("localSunriseMinute", result.localSunriseMinute);
+  out.Add("localSunsetHour", result.localSunsetHour);
+  out.Add("localSunsetMinute", result.localSunsetMinute);
+  out.Add("azimuthOfSunriseDeg", result.azimuthOfSunriseDeg);
+  out.Add("azimuthOfSunsetDeg", result.azimuthOfSunsetDeg);
+  out.Add("status", result.status);
+}
+
+void Write(Fields &out, const CUniversalDateTime &result) {
+  out.Add("hours", result.hours);
+  out.Add("minutes", result.minutes);
+  out.Add("seconds", result.seconds);
+  out.Add("day", result.day);
+  out.Add("month", result.month);
+  out.Add("year", result.year);
+}
+
+void Write(Fields &out, const CUniversalTime &result) {
+  out.Add("hours", result.hours);
+  out.Add("minutes", result.minutes);
+  out.Add("seconds", result.seconds);
+  out.Add("warningFlag", result.warningFlag);
+}
+void Write(Fields &out, const CAllPlanetPositions &result) {
+  for (std::size_t i = 0; i < result.planetNames.size(); i++) {
+    out.Prefix(result.planetNames[i] + ".");
+    Write(out, result.positions[i]);
+    if (i < result.visualAspects.size())
+      Write(out, result.visualAspects[i]);
+  }
+  out.Prefix("");
+}
+
+/**
+ * \brief A method that can be named in a request.
+ */
+struct Method {
+  const char *name;      /**< Class and method, as in "PASun.EquationOfTime" */
+  const char *signature; /**< One character per parameter */
+  void (*call)(const Arguments &arguments, Fields &out);
+};
+
+const std::vector<Method> &Methods() {
+  static const std::vector<Method> methods = {
+      {"PADateTime.GetDateOfEaster", "i",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PADateTime().GetDateOfEaster(a.Int(0)));
+       }},
+      {"PADateTime.CivilDateToDayNumber", "iii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PADateTime().CivilDateToDayNumber(
+             a.Int(0), a.Int(1), a.Int(2)));
+       }},
+      {"PADateTime.CivilTimeToDecimalHours", "ddd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PADateTime().CivilTimeToDecimalHours(
+             a.Double(0), a.Double(1), a.Double(2)));
+       }},
+      {"PADateTime.DecimalHoursToCivilTime", "d",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PADateTime().DecimalHoursToCivilTime(a.Double(0)));
+       }},
+      {"PADateTime.LocalCivilTimeToUniversalTime", "dddbidii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PADateTime().LocalCivilTimeToUniversalTime(
+             a.Double(0), a.Double(1), a.Double(2), a.Bool(3), a.Int(4),
+             a.Double(5), a.Int(6), a.Int(7)));
+       }},
+      {"PADateTime.UniversalTimeToLocalCivilTime", "dddbiiii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PADateTime().UniversalTimeToLocalCivilTime(
+             a.Double(0), a.Double(1), a.Double(2), a.Bool(3), a.Int(4),
+             a.Int(5), a.Int(6), a.Int(7)));
+       }},
+      {"PADateTime.UniversalTimeToGreenwichSiderealTime", "ddddii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PADateTime().UniversalTimeToGreenwichSiderealTime(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Int(4),
+             a.Int(5)));
+       }},
+      {"PADateTime.GreenwichSiderealTimeToUniversalTime", "ddddii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PADateTime().GreenwichSiderealTimeToUniversalTime(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Int(4),
+             a.Int(5)));
+       }},
+      {"PADateTime.GreenwichSiderealTimeToLocalSiderealTime", "dddd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PADateTime().GreenwichSiderealTimeToLocalSiderealTime(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3)));
+       }},
+      {"PADateTime.LocalSiderealTimeToGreenwichSiderealTime", "dddd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PADateTime().LocalSiderealTimeToGreenwichSiderealTime(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3)));
+       }},
+      {"PACoordinates.AngleToDecimalDegrees", "ddd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().AngleToDecimalDegrees(
+             a.Double(0), a.Double(1), a.Double(2)));
+       }},
+      {"PACoordinates.DecimalDegreesToAngle", "d",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().DecimalDegreesToAngle(a.Double(0)));
+       }},
+      {"PACoordinates.RightAscensionToHourAngle", "ddddddbidiid",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().RightAscensionToHourAngle(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5), a.Bool(6), a.Int(7), a.Double(8), a.Int(9), a.Int(10),
+             a.Double(11)));
+       }},
+      {"PACoordinates.HourAngleToRightAscension", "ddddddbidiid",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().HourAngleToRightAscension(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5), a.Bool(6), a.Int(7), a.Double(8), a.Int(9), a.Int(10),
+             a.Double(11)));
+       }},
+      {"PACoordinates.EquatorialCoordinatesToHorizonCoordinates", "ddddddd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().EquatorialCoordinatesToHorizonCoordinates(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5), a.Double(6)));
+       }},
+      {"PACoordinates.HorizonCoordinatesToEquatorialCoordinates", "ddddddd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().HorizonCoordinatesToEquatorialCoordinates(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5), a.Double(6)));
+       }},
+      {"PACoordinates.MeanObliquityOfTheEcliptic", "dii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().MeanObliquityOfTheEcliptic(
+             a.Double(0), a.Int(1), a.Int(2)));
+       }},
+      {"PACoordinates.EclipticCoordinateToEquatorialCoordinate", "dddddddii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().EclipticCoordinateToEquatorialCoordinate(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5), a.Double(6), a.Int(7), a.Int(8)));
+       }},
+      {"PACoordinates.EquatorialCoordinateToEclipticCoordinate", "dddddddii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().EquatorialCoordinateToEclipticCoordinate(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5), a.Double(6), a.Int(7), a.Int(8)));
+       }},
+      {"PACoordinates.EquatorialCoordinateToGalacticCoordinate", "dddddd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().EquatorialCoordinateToGalacticCoordinate(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5)));
+       }},
+      {"PACoordinates.GalacticCoordinateToEquatorialCoordinate", "dddddd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().GalacticCoordinateToEquatorialCoordinate(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5)));
+       }},
+      {"PACoordinates.AngleBetweenTwoObjects", "ddddddddddddu",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().AngleBetweenTwoObjects(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5), a.Double(6), a.Double(7), a.Double(8), a.Double(9),
+             a.Double(10), a.Double(11), a.AngleUnits(12)));
+       }},
+      {"PACoordinates.RisingAndSetting", "dddddddiiddd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().RisingAndSetting(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5), a.Double(6), a.Int(7), a.Int(8), a.Double(9),
+             a.Double(10), a.Double(11)));
+       }},
+      {"PACoordinates.CorrectForPrecession", "dddddddiidii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().CorrectForPrecession(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5), a.Double(6), a.Int(7), a.Int(8), a.Double(9),
+             a.Int(10), a.Int(11)));
+       }},
+      {"PACoordinates.NutationInEclipticLongitudeAndObliquity", "dii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().NutationInEclipticLongitudeAndObliquity(
+             a.Double(0), a.Int(1), a.Int(2)));
+       }},
+      {"PACoordinates.CorrectForAberration", "ddddiidddddd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().CorrectForAberration(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Int(4),
+             a.Int(5), a.Double(6), a.Double(7), a.Double(8), a.Double(9),
+             a.Double(10), a.Double(11)));
+       }},
+      {"PACoordinates.AtmosphericRefraction", "ddddddcddiidiiddddd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().AtmosphericRefraction(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5), a.CoordinateType(6), a.Double(7), a.Double(8),
+             a.Int(9), a.Int(10), a.Double(11), a.Int(12), a.Int(13),
+             a.Double(14), a.Double(15), a.Double(16), a.Double(17),
+             a.Double(18)));
+       }},
+      {"PACoordinates.CorrectionsForGeocentricParallax", "ddddddcddddiidiiddd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().CorrectionsForGeocentricParallax(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Double(4),
+             a.Double(5), a.CoordinateType(6), a.Double(7), a.Double(8),
+             a.Double(9), a.Double(10), a.Int(11), a.Int(12), a.Double(13),
+             a.Int(14), a.Int(15), a.Double(16), a.Double(17), a.Double(18)));
+       }},
+      {"PACoordinates.HeliographicCoordinates", "dddii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().HeliographicCoordinates(
+             a.Double(0), a.Double(1), a.Double(2), a.Int(3), a.Int(4)));
+       }},
+      {"PACoordinates.CarringtonRotationNumber", "dii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().CarringtonRotationNumber(
+             a.Double(0), a.Int(1), a.Int(2)));
+       }},
+      {"PACoordinates.SelenographicCoordinates1", "dii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().SelenographicCoordinates1(
+             a.Double(0), a.Int(1), a.Int(2)));
+       }},
+      {"PACoordinates.SelenographicCoordinates2", "dii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PACoordinates().SelenographicCoordinates2(
+             a.Double(0), a.Int(1), a.Int(2)));
+       }},
+      {"PASun.ApproximatePositionOfSun", "ddddiibi",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PASun().ApproximatePositionOfSun(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Int(4),
+             a.Int(5), a.Bool(6), a.Int(7)));
+       }},
+      {"PASun.PrecisePositionOfSun", "ddddiibi",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PASun().PrecisePositionOfSun(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Int(4),
+             a.Int(5), a.Bool(6), a.Int(7)));
+       }},
+      {"PASun.SunDistanceAndAngularSize", "ddddiibi",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PASun().SunDistanceAndAngularSize(
+             a.Double(0), a.Double(1), a.Double(2), a.Double(3), a.Int(4),
+             a.Int(5), a.Bool(6), a.Int(7)));
+       }},
+      {"PASun.SunriseAndSunset", "diibidd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PASun().SunriseAndSunset(
+             a.Double(0), a.Int(1), a.Int(2), a.Bool(3), a.Int(4), a.Double(5),
+             a.Double(6)));
+       }},
+      {"PASun.MorningAndEveningTwilight", "diibiddt",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PASun().MorningAndEveningTwilight(
+             a.Double(0), a.Int(1), a.Int(2), a.Bool(3), a.Int(4), a.Double(5),
+             a.Double(6), a.TwilightType(7)));
+       }},
+      {"PASun.EquationOfTime", "dii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PASun().EquationOfTime(a.Double(0), a.Int(1), a.Int(2)));
+       }},
+      {"PASun.SolarElongation", "dddddddii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PASun().SolarElongation(a.Double(0), a.Double(1),
+                                            a.Double(2), a.Double(3),
+                                            a.Double(4), a.Double(5),
+                                            a.Double(6), a.Int(7), a.Int(8)));
+       }},
+      {"PAMoon.ApproximatePositionOfMoon", "dddbidii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAMoon().ApproximatePositionOfMoon(
+             a.Double(0), a.Double(1), a.Double(2), a.Bool(3), a.Int(4),
+             a.Double(5), a.Int(6), a.Int(7)));
+       }},
+      {"PAMoon.PrecisePositionOfMoon", "dddbidii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAMoon().PrecisePositionOfMoon(
+             a.Double(0), a.Double(1), a.Double(2), a.Bool(3), a.Int(4),
+             a.Double(5), a.Int(6), a.Int(7)));
+       }},
+      {"PAMoon.MoonPhase", "dddbidiia",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAMoon().MoonPhase(a.Double(0), a.Double(1), a.Double(2),
+                                       a.Bool(3), a.Int(4), a.Double(5),
+                                       a.Int(6), a.Int(7), a.AccuracyLevel(8)));
+       }},
+      {"PAMoon.TimesOfNewMoonAndFullMoon", "bidii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAMoon().TimesOfNewMoonAndFullMoon(
+             a.Bool(0), a.Int(1), a.Double(2), a.Int(3), a.Int(4)));
+       }},
+      {"PAMoon.MoonDistAngDiamHorParallax", "dddbidii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAMoon().MoonDistAngDiamHorParallax(
+             a.Double(0), a.Double(1), a.Double(2), a.Bool(3), a.Int(4),
+             a.Double(5), a.Int(6), a.Int(7)));
+       }},
+      {"PAMoon.MoonriseAndMoonset", "diibidd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAMoon().MoonriseAndMoonset(
+             a.Double(0), a.Int(1), a.Int(2), a.Bool(3), a.Int(4), a.Double(5),
+             a.Double(6)));
+       }},
+      {"PAPlanet.ApproximatePositionOfPlanet", "dddbidiis",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAPlanet().ApproximatePositionOfPlanet(
+             a.Double(0), a.Double(1), a.Double(2), a.Bool(3), a.Int(4),
+             a.Double(5), a.Int(6), a.Int(7), a.Text(8)));
+       }},
+      {"PAPlanet.PrecisePositionOfPlanet", "dddbidiis",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAPlanet().PrecisePositionOfPlanet(
+             a.Double(0), a.Double(1), a.Double(2), a.Bool(3), a.Int(4),
+             a.Double(5), a.Int(6), a.Int(7), a.Text(8)));
+       }},
+      {"PAPlanet.VisualAspectsOfAPlanet", "dddbidiis",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAPlanet().VisualAspectsOfAPlanet(
+             a.Double(0), a.Double(1), a.Double(2), a.Bool(3), a.Int(4),
+             a.Double(5), a.Int(6), a.Int(7), a.Text(8)));
+       }},
+      {"PAPlanet.PrecisePositionOfAllPlanets", "dddbidiib",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAPlanet().PrecisePositionOfAllPlanets(
+             a.Double(0), a.Double(1), a.Double(2), a.Bool(3), a.Int(4),
+             a.Double(5), a.Int(6), a.Int(7), a.Bool(8)));
+       }},
+      {"PAComet.PositionOfEllipticalComet", "dddbidiis",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAComet().PositionOfEllipticalComet(
+             a.Double(0), a.Double(1), a.Double(2), a.Bool(3), a.Int(4),
+             a.Double(5), a.Int(6), a.Int(7), a.Text(8)));
+       }},
+      {"PAComet.PositionOfParabolicComet", "dddbidiis",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAComet().PositionOfParabolicComet(
+             a.Double(0), a.Double(1), a.Double(2), a.Bool(3), a.Int(4),
+             a.Double(5), a.Int(6), a.Int(7), a.Text(8)));
+       }},
+      {"PABinary.binaryStarOrbit", "diis",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PABinary().binaryStarOrbit(
+             a.Double(0), a.Int(1), a.Int(2), a.Text(3)));
+       }},
+      {"PABinary.EpochYear", "dii",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PABinary::EpochYear(a.Double(0), a.Int(1), a.Int(2)));
+       }},
+      {"PAEclipses.LunarEclipseOccurrence", "diibi",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAEclipses().LunarEclipseOccurrence(
+             a.Double(0), a.Int(1), a.Int(2), a.Bool(3), a.Int(4)));
+       }},
+      {"PAEclipses.LunarEclipseCircumstances", "diibi",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAEclipses().LunarEclipseCircumstances(
+             a.Double(0), a.Int(1), a.Int(2), a.Bool(3), a.Int(4)));
+       }},
+      {"PAEclipses.SolarEclipseOccurrence", "diibi",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAEclipses().SolarEclipseOccurrence(
+             a.Double(0), a.Int(1), a.Int(2), a.Bool(3), a.Int(4)));
+       }},
+      {"PAEclipses.SolarEclipseCircumstances", "diibidd",
+       [](const Arguments &a, Fields &out) {
+         Write(out, PAEclipses().SolarEclipseCircumstances(
+             a.Double(0), a.Int(1), a.Int(2), a.Bool(3), a.Int(4), a.Double(5),
+             a.Double(6)));
+       }},
+  };
+  return methods;
+}
+
+const Method *Find(std::string_view name) {
+  static const std::unordered_map<std::string_view, const Method *> byName =
+      [] {
+        std::unordered_map<std::string_view, const Method *> map;
+        for (const Method &method : Methods())
+          map[method.name] = &method;
+        return map;
+      }();
+
+  auto found = byName.find(name);
+  return found == byName.end() ? nullptr : found->second;
+}
+
+std::string_view Trim(std::string_view text) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+    text.remove_prefix(1);
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t' ||
+                           text.back() == '\r'))
+    text.remove_suffix(1);
+  return text;
+}
+
+/**
+ * \brief Reads a CSV request: the function, then its arguments.
+ *
+ * A field may be quoted, as AppendCsvField writes it, to hold commas; a
+ * quote within it is doubled.
+ *
+ * @return Empty if the request was read, otherwise what is wrong.
+ */
+std::string ReadCsv(std::string_view line, std::string_view &function,
+                    Arguments &arguments) {
+  bool first = true;
+  while (true) {
+    std::string_view field;
+    line = Trim(line);
+    if (!line.empty() && line.front() == '"') {
+      std::size_t end = 1;
+      bool doubled = false;
+      while ((end = line.find('"', end)) != std::string_view::npos &&
+             end + 1 < line.size() && line[end + 1] == '"') {
+        doubled = true;
+        end += 2;
+      }
+      if (end == std::string_view::npos)
+        return "quoted field is not closed";
+
+      field = line.substr(1, end - 1);
+      if (doubled) {
+        std::string &text = arguments.unquoted.emplace_back();
+        for (std::size_t i = 0; i < field.size(); i++) {
+          text += field[i];
+          if (field[i] == '"')
+            i++;
+        }
+        field = text;
+      }
+      line = Trim(line.substr(end + 1));
+      if (!line.empty() && line.front() != ',')
+        return "text after a quoted field";
+    } else {
+      std::size_t comma = line.find(',');
+      field = Trim(line.substr(0, comma));
+      line.remove_prefix(comma == std::string_view::npos ? line.size()
+                                                         : comma);
+    }
+
+    if (first)
+      function = field;
+    else
+      arguments.tokens.push_back(field);
+    first = false;
+
+    if (line.empty())
+      return "";
+    line.remove_prefix(1);
+  }
+}
+
+/**
+ * \brief Whether text is a JSON number: an optional minus sign, an integer
+ * part without leading zeros, then an optional fraction and exponent.
+ */
+bool IsJsonNumber(std::string_view text) {
+  std::size_t i = 0;
+  auto digits = [&] {
+    std::size_t start = i;
+    while (i < text.size() && text[i] >= '0' && text[i] <= '9')
+      i++;
+    return i > start;
+  };
+
+  if (i < text.size() && text[i] == '-')
+    i++;
+  if (i < text.size() && text[i] == '0')
+    i++;
+  else if (!digits())
+    return false;
+  if (i < text.size() && text[i] == '.') {
+    i++;
+    if (!digits())
+      return false;
+  }
+  if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+    i++;
+    if (i < text.size() && (text[i] == '+' || text[i] == '-'))
+      i++;
+    if (!digits())
+      return false;
+  }
+  return i == text.size();
+}
+
+/**
+ * \brief Whether an "id" can be echoed into the output as it was read: a
+ * string without control characters, a number, true, false or null.
+ */
+bool IsEchoableId(std::string_view value, bool isString) {
+  if (isString)
+    return std::none_of(value.begin(), value.end(),
+                        [](char c) { return (unsigned char)c < 0x20; });
+  return IsJsonNumber(value) || value == "true" || value == "false" ||
+         value == "null";
+}
+
+/**
+ * \brief Reads the members of a JSON request that matter: "function", the
+ * array "args" and "id".
+ *
+ * Only what a request needs is understood: strings without escapes,
+ * numbers, true/false and arrays of them. Other members must be of those
+ * kinds and are ignored. The "id" is copied to the output as written, so it
+ * must be a string, a number, true, false or null.
+ */
+class JsonRequest {
+public:
+  explicit JsonRequest(std::string_view text) : text(text), position(0) {}
+
+  /** @return Empty if the request was read, otherwise what is wrong. */
+  std::string Read(std::string_view &function, Arguments &arguments,
+                   std::string_view &id) {
+    if (!Take('{'))
+      return "expected a JSON object";
+    if (Take('}'))
+      return "";
+
+    do {
+      std::string_view key;
+      if (!String(key) || !Take(':'))
+        return "expected a member name";
+
+      if (key == "args") {
+        if (!Take('['))
+          return "args is not an array";
+        if (!Take(']')) {
+          do {
+            std::string_view value;
+            if (!Value(value))
+              return "args must hold numbers, booleans and strings";
+            arguments.tokens.push_back(value);
+          } while (Take(','));
+          if (!Take(']'))
+            return "args is not closed";
+        }
+      } else {
+        std::size_t start = Skip();
+        std::string_view value;
+        bool isString = Peek() == '"';
+        if (!Value(value))
+          return "unreadable value of " + std::string(key);
+        if (key == "function")
+          function = value;
+        else if (key == "id") {
+          if (!IsEchoableId(value, isString))
+            return "id must be a string, number, true, false or null";
+          id = text.substr(start, isString ? value.size() + 2 : value.size());
+        }
+      }
+    } while (Take(','));
+
+    if (!Take('}'))
+      return "expected , or }";
+    return "";
+  }
+
+private:
+  std::size_t Skip() {
+    while (position < text.size() &&
+           (text[position] == ' ' || text[position] == '\t' ||
+            text[position] == '\r'))
+      position++;
+    return position;
+  }
+
+  char Peek() {
+    Skip();
+    return position < text.size() ? text[position] : '\0';
+  }
+
+  bool Take(char c) {
+    if (Peek() != c)
+      return false;
+    position++;
+    return true;
+  }
+
+  bool String(std::string_view &value) {
+    if (!Take('"'))
+      return false;
+    std::size_t end = text.find_first_of("\"\\", position);
+    if (end == std::string_view::npos || text[end] != '"')
+      return false;
+    value = text.substr(position, end - position);
+    position = end + 1;
+    return true;
+  }
+
+  /** A string's contents, or the text of a number or literal. */
+  bool Value(std::string_view &value) {
+    if (Peek() == '"')
+      return String(value);
+    std::size_t end = text.find_first_of(",]} \t\r", position);
+    if (end == std::string_view::npos)
+      end = text.size();
+    if (end == position)
+      return false;
+    value = text.substr(position, end - position);
+    position = end;
+    return true;
+  }
+
+  std::string_view text;
+  std::size_t position;
+};
+} // namespace
+
+PABatch::PABatch(EBatchFormat format) { this->format = format; }
+
+/**
+ * \brief Runs the request on one line of input.
+ *
+ * @param output Set to the line of output, without its newline; empty for a
+ * blank or comment line.
+ */
+void PABatch::ProcessLine(const std::string &line, std::size_t lineNumber,
+                          std::string &output) const {
+  output.clear();
+  std::string_view request = Trim(line);
+  if (request.empty() || request.front() == '#')
+    return;
+
+  std::string_view function;
+  std::string_view id;
+  Arguments arguments;
+  std::string error;
+  if (format == EBatchFormat::Jsonl)
+    error = JsonRequest(request).Read(function, arguments, id);
+  else
+    error = ReadCsv(request, function, arguments);
+
+  const Method *method = nullptr;
+  if (error.empty()) {
+    method = Find(function);
+    if (method == nullptr)
+      error = "unknown function";
+    else
+      error = arguments.Check(method->signature);
+  }
+
+  char number[24];
+  std::to_chars_result written =
+      std::to_chars(number, number + sizeof(number), lineNumber);
+
+  if (format == EBatchFormat::Jsonl) {
+    output += "{\"line\":";
+    output.append(number, written.ptr);
+    if (!id.empty()) {
+      output += ",\"id\":";
+      output += id;
+    }
+    output += ",\"function\":";
+    AppendJsonString(output, function);
+    if (!error.empty()) {
+      output += ",\"error\":";
+      AppendJsonString(output, error);
+      output += '}';
+      return;
+    }
+    output += ",\"result\":{";
+    Fields fields(format, output);
+    method->call(arguments, fields);
+    output += "}}";
+  } else {
+    output.append(number, written.ptr);
+    output += ',';
+    AppendCsvField(output, function);
+    if (!error.empty()) {
+      output += ",error,";
+      AppendCsvField(output, error);
+      return;
+    }
+    Fields fields(format, output);
+    method->call(arguments, fields);
+  }
+}
+
+/**
+ * \brief Runs every request read from input, writing one line of output for
+ * each in the order of the input.
+ *
+ * The input is read a block of lines at a time and the block computed on the
+ * pool before its output is written, so memory held is bounded by the block
+ * whatever the length of the input. The lines and outputs of a block reuse
+ * their storage from block to block.
+ *
+ * @return The number of requests run.
+ */
+std::size_t PABatch::Run(std::istream &input, std::ostream &output,
+                         PATaskPool &pool, std::size_t blockLines) const {
+  if (blockLines == 0)
+    blockLines = 1;
+  std::vector<std::string> lines(blockLines);
+  std::vector<std::string> outputs(blockLines);
+  std::size_t linesRead = 0;
+  std::size_t requests = 0;
+
+  while (true) {
+    std::size_t count = 0;
+    while (count < blockLines && std::getline(input, lines[count]))
+      count++;
+    if (count == 0)
+      break;
+
+    std::size_t firstLine = linesRead + 1;
+    pool.Run(count, [&](std::size_t task, int) {
+      ProcessLine(lines[task], firstLine + task, outputs[task]);
+    });
+    linesRead += count;
+
+    for (std::size_t i = 0; i < count; i++) {
+      if (outputs[i].empty())
+        continue;
+      output.write(outputs[i].data(), outputs[i].size());
+      output.put('\n');
+      requests++;
+    }
+    if (count < blockLines)
+      break;
+  }
+
+  output.flush();
+  return requests;
+}
+
+/**
+ * \brief Names of the methods that can be named in a request, as in
+ * "PASun.EquationOfTime".
+ */
+std::vector<std::string> PABatch::FunctionNames() {
+  std::vector<std::string> names;
+  for (const Method &method : Methods())
+    names.push_back(method.name);
+  return names;
+}
+
+/**
+ * \brief The parameters of a method, one character for each: d (double),
+ * i (int), b (bool), s (string), t (ETwilightType), a (EAccuracyLevel),
+ * u (EAngleMeasurementUnits) or c (ECoordinateType).
+ *
+ * @return Empty if there is no such method.
+ */
+std::string PABatch::Signature(const std::string &function) {
+  const Method *method = Find(function);
+  return method == nullptr ? "" : method->signature;
+}
@@ -0,0 +1,54 @@
+#ifndef _pa_batch
+#define _pa_batch
+
+#include "pa_parallel.h"
+#include "pa_types.h"
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace pa_types;
+
+/**
+ * \brief Runs façade methods named in lines of text, as the pa-batch program
+ * does.
+ *
+ * A request is one line, either CSV:
+ *
+ *     PASun.SunriseAndSunset,10,3,1986,false,-5,-71.05,42.37
+ *
+ * or a JSON object:
+ *
+ *     {"id": 7, "function": "PASun.SunriseAndSunset",
+ *      "args": [10, 3, 1986, false, -5, -71.05, 42.37]}
+ *
+ * The arguments are those of the method, in order. Booleans are true/false
+ * (or 1/0), enumerations are written by name (Civil, Precise, Degrees,
+ * Apparent, ...). A CSV field may be quoted to hold commas, with any quote
+ * within it doubled, as the output is. Blank lines and lines starting with
+ * '#' are skipped.
+ *
+ * Each request gives one line of output: its line number, any id, the
+ * function, and the fields of the result, or an error.
+ */
+class PABatch {
+public:
+  explicit PABatch(EBatchFormat format = EBatchFormat::Jsonl);
+
+  void ProcessLine(const std::string &line, std::size_t lineNumber,
+                   std::string &output) const;
+
+  std::size_t Run(std::istream &input, std::ostream &output, PATaskPool &pool,
+                  std::size_t blockLines = 4096) const;
+
+  static std::vector<std::string> FunctionNames();
+
+  static std::string Signature(const std::string &function);
+
+private:
+  EBatchFormat format;
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include "pa_util.h"
 #include <cmath>
 #include <string>
+#include <vector>
 
 using namespace pa_types;
 using namespace pa_models;
@@ -20,12 +21,9 @@ CBinaryStarOrbitalData PABinary::binaryStarOrbit(double greenwichDateDay,
                                                  std::string binaryName) {
   pa_data::BinaryStarData binaryInfo = pa_data::getBinaryStarData(binaryName);
 
-  double yYears = greenwichDateYear +
-                  (CivilDateToJulianDate(greenwichDateDay, greenwichDateMonth,
-                                         greenwichDateYear) -
-                   CivilDateToJulianDate(0, 1, greenwichDateYear)) /
-                      365.242191 -
-                  binaryInfo.epoch_peri;
+  double yYears =
+      EpochYear(greenwichDateDay, greenwichDateMonth, greenwichDateYear) -
+      binaryInfo.epoch_peri;
   double mDeg = 360 * yYears / binaryInfo.period;
   double mRad = DegreesToRadians(mDeg - 360 * floor(mDeg / 360));
   double eccentricity = binaryInfo.ecc;
@@ -48,3 +46,98 @@ CBinaryStarOrbitalData PABinary::binaryStarOrbit(double greenwichDateDay,
 
   return CBinaryStarOrbitalData(positionAngleDeg, separationArcsec);
 }
+
+/**
+ * Calculate the orbit track of a binary star over a series of epochs.
+ *
+ * The constants that depend only on the orbit are found once. Kepler's
+ * equation is then solved once per epoch, and the true anomaly and radius
+ * both come from the one eccentric anomaly. Values are not rounded.
+ *
+ * @param epochYears Epochs, as decimal years (see EpochYear).
+ *
+ * @return CBinaryStarOrbitTrack, in epoch order.
+ */
+CBinaryStarOrbitTrack
+PABinary::binaryStarOrbitTrack(const pa_data::BinaryStarData &binaryInfo,
+                               const std::vector<double> &epochYears) {
+  CBinaryStarOrbitTrack result(epochYears.size());
+
+  double eccentricity = binaryInfo.ecc;
+  double anomalyFactor = sqrt((1 + eccentricity) / (1 - eccentricity));
+  double longPeriRad = DegreesToRadians(binaryInfo.long_peri);
+  double cosIncl = cos(DegreesToRadians(binaryInfo.incl));
+
+  for (std::size_t k = 0; k < epochYears.size(); k++) {
+    double mDeg =
+        360 * (epochYears[k] - binaryInfo.epoch_peri) / binaryInfo.period;
+    double mRad = DegreesToRadians(mDeg - 360 * floor(mDeg / 360));
+
+    // Kepler's equation, by Newton's method.
+    double eRad = mRad;
+    for (int i = 0; i < 50; i++) {
+      double d = (eRad - eccentricity * sin(eRad) - mRad) /
+                 (1 - eccentricity * cos(eRad));
+      eRad -= d;
+      if (std::abs(d) < 1e-12)
+        break;
+    }
+
+    double trueAnomalyRad = 2 * atan(anomalyFactor * tan(eRad / 2));
+    double rArcsec = (1 - eccentricity * cos(eRad)) * binaryInfo.axis;
+    double raPeriRad = trueAnomalyRad + longPeriRad;
+
+    double y = sin(raPeriRad) * cosIncl;
+    double x = cos(raPeriRad);
+    double thetaDeg1 = WToDegrees(atan2(y, x)) + binaryInfo.pa_node;
+
+    // rho = r cos(raPeri) / cos(theta - node) = r sqrt(x^2 + y^2), which
+    // does not divide by zero when the companion crosses the node line.
+    result.positionAngleDeg[k] = thetaDeg1 - 360 * floor(thetaDeg1 / 360);
+    result.separationArcsec[k] = rArcsec * sqrt(x * x + y * y);
+  }
+
+  return result;
+}
+
+/**
+ * Calculate the orbit track of a named binary star over a series of epochs.
+ *
+ * @return CBinaryStarOrbitTrack, in epoch order.
+ */
+CBinaryStarOrbitTrack
+PABinary::binaryStarOrbitTrack(std::string binaryName,
+                               const std::vector<double> &epochYears) {
+  return binaryStarOrbitTrack(pa_data::getBinaryStarData(binaryName),
+                              epochYears);
+}
+
+/**
+ * Calculate orbit tracks for a catalogue of binary stars, over the same
+ * epochs.
+ *
+ * @return One CBinaryStarOrbitTrack per star, in catalogue order.
+ */
+std::vector<CBinaryStarOrbitTrack> PABinary::binaryStarOrbitTracks(
+    const std::vector<pa_data::BinaryStarData> &catalogue,
+    const std::vector<double> &epochYears) {
+  std::vector<CBinaryStarOrbitTrack> tracks;
+  tracks.reserve(catalogue.size());
+
+  for (const pa_data::BinaryStarData &binaryInfo : catalogue)
+    tracks.push_back(binaryStarOrbitTrack(binaryInfo, epochYears));
+
+  return tracks;
+}
+
+/**
+ * Convert a Greenwich date to a decimal year, as used for binary star epochs.
+ */
+double PABinary::EpochYear(double greenwichDateDay, int greenwichDateMonth,
+                           int greenwichDateYear) {
+  return greenwichDateYear +
+         (CivilDateToJulianDate(greenwichDateDay, greenwichDateMonth,
+                                greenwichDateYear) -
+          CivilDateToJulianDate(0, 1, greenwichDateYear)) /
+             365.242191;
+}
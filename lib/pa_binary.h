@@ -1,9 +1,11 @@
 #ifndef _pa_binary
 #define _pa_binary
 
+#include "pa_data.h"
 #include "pa_models.h"
 #include <string>
 #include <tuple>
+#include <vector>
 
 using namespace pa_models;
 
@@ -13,6 +15,21 @@ public:
                                          int greenwichDateMonth,
                                          int greenwichDateYear,
                                          std::string binaryName);
+
+  CBinaryStarOrbitTrack
+  binaryStarOrbitTrack(const pa_data::BinaryStarData &binaryInfo,
+                       const std::vector<double> &epochYears);
+
+  CBinaryStarOrbitTrack
+  binaryStarOrbitTrack(std::string binaryName,
+                       const std::vector<double> &epochYears);
+
+  std::vector<CBinaryStarOrbitTrack>
+  binaryStarOrbitTracks(const std::vector<pa_data::BinaryStarData> &catalogue,
+                        const std::vector<double> &epochYears);
+
+  static double EpochYear(double greenwichDateDay, int greenwichDateMonth,
+                          int greenwichDateYear);
 };
 
 #endif
@@ -0,0 +1,387 @@
+#include "pa_binary_catalogue.h"
+#include "pa_binary.h"
+#include "pa_data.h"
+#include "pa_models.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace pa_models;
+
+namespace {
+/**
+ * \brief File header.
+ */
+struct FileHeader {
+  char magic[8];       /**< "PABINCAT" */
+  uint32_t byteOrder;  /**< kByteOrder, as written by this machine */
+  uint32_t recordSize; /**< sizeof(OrbitRecord) */
+  uint64_t count;      /**< Number of records */
+};
+
+/**
+ * \brief One orbit, with the elements of pa_data::BinaryStarData.
+ */
+struct OrbitRecord {
+  char wds[10];        /**< WDS designation, space padded */
+  char discoverer[14]; /**< Discoverer designation, space padded */
+  double period;       /**< Period, in years */
+  double epochPeri;    /**< Epoch of periastron, as a decimal year */
+  double longPeri;     /**< Longitude (argument) of periastron, degrees */
+  double ecc;          /**< Eccentricity */
+  double axis;         /**< Semi-major axis, arcseconds */
+  double incl;         /**< Inclination, degrees */
+  double paNode;       /**< Position angle of the ascending node, degrees */
+};
+
+static_assert(sizeof(FileHeader) == 24, "FileHeader must be packed");
+static_assert(sizeof(OrbitRecord) == 80, "OrbitRecord must be packed");
+
+const char kMagic[8] = {'P', 'A', 'B', 'I', 'N', 'C', 'A', 'T'};
+const uint32_t kByteOrder = 0x01020304;
+
+/**
+ * \brief Columns (1-based, inclusive) of the fields read from the Sixth
+ * Catalog's orbit file (orb6orbits.txt), from its format description.
+ */
+struct Columns {
+  std::size_t first;
+  std::size_t last;
+};
+const Columns kWds = {20, 29};
+const Columns kDiscoverer = {31, 44};
+const Columns kPeriod = {81, 91};
+const std::size_t kPeriodUnit = 92;
+const Columns kAxis = {106, 114};
+const std::size_t kAxisUnit = 115;
+const Columns kIncl = {126, 133};
+const Columns kNode = {144, 151};
+const Columns kEpoch = {162, 172};
+const std::size_t kEpochUnit = 173;
+const Columns kEcc = {186, 193};
+const Columns kLongPeri = {204, 211};
+
+bool ParseField(const std::string &line, Columns columns, double &value) {
+  if (line.size() < columns.last)
+    return false;
+
+  std::string field =
+      line.substr(columns.first - 1, columns.last - columns.first + 1);
+  const char *begin = field.c_str();
+  char *end = nullptr;
+  value = strtod(begin, &end);
+
+  return end != begin;
+}
+
+char UnitAt(const std::string &line, std::size_t column) {
+  return (line.size() >= column) ? line[column - 1] : ' ';
+}
+
+void CopyPadded(char *destination, std::size_t size, const std::string &line,
+                Columns columns) {
+  memset(destination, ' ', size);
+  if (line.size() >= columns.first)
+    memcpy(destination, line.data() + columns.first - 1,
+           std::min(size, line.size() - (columns.first - 1)));
+}
+
+std::string Trimmed(const char *text, std::size_t size) {
+  std::size_t first = 0;
+  while (first < size && text[first] == ' ')
+    first++;
+  std::size_t last = size;
+  while (last > first && text[last - 1] == ' ')
+    last--;
+
+  return std::string(text + first, last - first);
+}
+
+/**
+ * \brief Convert a Julian date to a Besselian year.
+ */
+double BesselianYear(double julianDate) {
+  return 1900.0 + (julianDate - 2415020.31352) / 365.242198781;
+}
+
+/**
+ * \brief Read one orbit from a line of the Sixth Catalog.
+ *
+ * Periods are converted to years, semi-major axes to arcseconds, and epochs of
+ * periastron to decimal (Besselian) years.
+ *
+ * @return false if the line has no usable orbit.
+ */
+bool ParseOrbit(const std::string &line, OrbitRecord &record) {
+  double period, axis, incl, node, epoch, ecc, longPeri;
+  if (!ParseField(line, kPeriod, period) || !ParseField(line, kAxis, axis) ||
+      !ParseField(line, kIncl, incl) || !ParseField(line, kNode, node) ||
+      !ParseField(line, kEpoch, epoch) || !ParseField(line, kEcc, ecc) ||
+      !ParseField(line, kLongPeri, longPeri))
+    return false;
+
+  switch (UnitAt(line, kPeriodUnit)) {
+  case 'm':
+    period /= 525960.0;
+    break;
+  case 'h':
+    period /= 8766.0;
+    break;
+  case 'd':
+    period /= 365.25;
+    break;
+  case 'c':
+    period *= 100.0;
+    break;
+  default:
+    break;
+  }
+
+  if (UnitAt(line, kAxisUnit) == 'm')
+    axis /= 1000.0;
+
+  switch (UnitAt(line, kEpochUnit)) {
+  case 'd':
+    epoch = BesselianYear(epoch + 2400000.0);
+    break;
+  case 'm':
+    epoch = BesselianYear(epoch + 2400000.5);
+    break;
+  case 'c':
+    epoch = 1900.0 + 100.0 * epoch;
+    break;
+  default:
+    break;
+  }
+
+  if (period <= 0 || ecc < 0 || ecc >= 1)
+    return false;
+
+  CopyPadded(record.wds, sizeof(record.wds), line, kWds);
+  CopyPadded(record.discoverer, sizeof(record.discoverer), line, kDiscoverer);
+  record.period = period;
+  record.epochPeri = epoch;
+  record.longPeri = longPeri;
+  record.ecc = ecc;
+  record.axis = axis;
+  record.incl = incl;
+  record.paNode = node;
+
+  return true;
+}
+
+/**
+ * \brief Order records by WDS designation, then discoverer designation.
+ */
+bool RecordLess(const OrbitRecord &a, const OrbitRecord &b) {
+  int byWds = memcmp(a.wds, b.wds, sizeof(a.wds));
+  if (byWds != 0)
+    return byWds < 0;
+
+  return memcmp(a.discoverer, b.discoverer, sizeof(a.discoverer)) < 0;
+}
+} // namespace
+
+PABinaryCatalogue::PABinaryCatalogue() {
+  this->mapping = nullptr;
+  this->mappingBytes = 0;
+  this->records = nullptr;
+  this->count = 0;
+}
+
+PABinaryCatalogue::~PABinaryCatalogue() { Close(); }
+
+/**
+ * \brief Convert the Sixth Catalog's orbit file to a binary catalogue file.
+ *
+ * Lines without a complete, elliptical orbit are skipped.
+ *
+ * @param textPath Path of the catalogue's orbit file (orb6orbits.txt).
+ * @param binaryPath Path of the binary file to write.
+ *
+ * @return Number of orbits written, or -1 if a file could not be opened or
+ * written.
+ */
+int PABinaryCatalogue::ConvertSixthCatalog(const std::string &textPath,
+                                           const std::string &binaryPath) {
+  std::ifstream input(textPath);
+  if (!input)
+    return -1;
+
+  std::vector<OrbitRecord> orbits;
+  std::string line;
+  while (std::getline(input, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+
+    OrbitRecord record;
+    if (ParseOrbit(line, record))
+      orbits.push_back(record);
+  }
+  std::stable_sort(orbits.begin(), orbits.end(), RecordLess);
+
+  FileHeader header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.byteOrder = kByteOrder;
+  header.recordSize = sizeof(OrbitRecord);
+  header.count = orbits.size();
+
+  std::ofstream output(binaryPath, std::ios::binary | std::ios::trunc);
+  if (!output)
+    return -1;
+  output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  output.write(reinterpret_cast<const char *>(orbits.data()),
+               orbits.size() * sizeof(OrbitRecord));
+  if (!output)
+    return -1;
+
+  return (int)orbits.size();
+}
+
+/**
+ * \brief Map a binary catalogue file into memory.
+ *
+ * Any catalogue already open is closed first.
+ *
+ * @return false if the file could not be mapped, or is not a catalogue
+ * written by a machine with the same byte order.
+ */
+bool PABinaryCatalogue::Open(const std::string &binaryPath) {
+  Close();
+
+  int fd = open(binaryPath.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || (std::size_t)info.st_size < sizeof(FileHeader)) {
+    close(fd);
+    return false;
+  }
+
+  void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED)
+    return false;
+
+  const FileHeader *header = static_cast<const FileHeader *>(mapped);
+  bool valid = memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+               header->byteOrder == kByteOrder &&
+               header->recordSize == sizeof(OrbitRecord) &&
+               header->count <=
+                   ((std::size_t)info.st_size - sizeof(FileHeader)) /
+                       sizeof(OrbitRecord);
+  if (!valid) {
+    munmap(mapped, info.st_size);
+    return false;
+  }
+
+  this->mapping = mapped;
+  this->mappingBytes = info.st_size;
+  this->records = static_cast<const char *>(mapped) + sizeof(FileHeader);
+  this->count = header->count;
+
+  return true;
+}
+
+/**
+ * \brief Unmap the catalogue, if one is open.
+ */
+void PABinaryCatalogue::Close() {
+  if (mapping != nullptr)
+    munmap(mapping, mappingBytes);
+
+  this->mapping = nullptr;
+  this->mappingBytes = 0;
+  this->records = nullptr;
+  this->count = 0;
+}
+
+/**
+ * \brief Find the first orbit for a WDS designation (e.g. "00014+3937").
+ *
+ * @return Index of the orbit, or -1 if there is none. Other orbits for the
+ * same designation (other pairs in the system) follow it.
+ */
+int PABinaryCatalogue::Find(const std::string &wdsDesignation) const {
+  OrbitRecord key;
+  memset(key.wds, ' ', sizeof(key.wds));
+  memcpy(key.wds, wdsDesignation.data(),
+         std::min(sizeof(key.wds), wdsDesignation.size()));
+
+  const OrbitRecord *first = static_cast<const OrbitRecord *>(records);
+  const OrbitRecord *found =
+      std::lower_bound(first, first + count, key,
+                       [](const OrbitRecord &a, const OrbitRecord &b) {
+                         return memcmp(a.wds, b.wds, sizeof(a.wds)) < 0;
+                       });
+
+  if (found == first + count ||
+      memcmp(found->wds, key.wds, sizeof(key.wds)) != 0)
+    return -1;
+
+  return (int)(found - first);
+}
+
+std::string PABinaryCatalogue::WdsDesignation(std::size_t index) const {
+  const OrbitRecord &record = static_cast<const OrbitRecord *>(records)[index];
+
+  return Trimmed(record.wds, sizeof(record.wds));
+}
+
+std::string PABinaryCatalogue::DiscovererDesignation(std::size_t index) const {
+  const OrbitRecord &record = static_cast<const OrbitRecord *>(records)[index];
+
+  return Trimmed(record.discoverer, sizeof(record.discoverer));
+}
+
+/**
+ * \brief Orbit at an index, as used by PABinary.
+ *
+ * The name is the WDS designation, followed by the discoverer designation.
+ */
+pa_data::BinaryStarData PABinaryCatalogue::Star(std::size_t index) const {
+  const OrbitRecord &record = static_cast<const OrbitRecord *>(records)[index];
+
+  return pa_data::BinaryStarData(
+      WdsDesignation(index) + " " + DiscovererDesignation(index),
+      record.period, record.epochPeri, record.longPeri, record.ecc,
+      record.axis, record.incl, record.paNode);
+}
+
+/**
+ * \brief Orbit tracks for every orbit in the catalogue, over the same epochs.
+ *
+ * Elements are read straight from the mapped records.
+ *
+ * @param epochYears Epochs, as decimal years (see PABinary::EpochYear).
+ *
+ * @return One CBinaryStarOrbitTrack per orbit, in catalogue order.
+ */
+std::vector<CBinaryStarOrbitTrack>
+PABinaryCatalogue::OrbitTracks(const std::vector<double> &epochYears) const {
+  PABinary paBinary;
+  std::vector<CBinaryStarOrbitTrack> tracks;
+  tracks.reserve(count);
+
+  const OrbitRecord *first = static_cast<const OrbitRecord *>(records);
+  for (std::size_t i = 0; i < count; i++) {
+    const OrbitRecord &record = first[i];
+    pa_data::BinaryStarData binaryInfo(
+        "", record.period, record.epochPeri, record.longPeri, record.ecc,
+        record.axis, record.incl, record.paNode);
+
+    tracks.push_back(paBinary.binaryStarOrbitTrack(binaryInfo, epochYears));
+  }
+
+  return tracks;
+}
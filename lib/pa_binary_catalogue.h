@@ -0,0 +1,57 @@
+#ifndef _pa_binary_catalogue
+#define _pa_binary_catalogue
+
+#include "pa_data.h"
+#include "pa_models.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace pa_models;
+
+/**
+ * \brief Catalogue of visual binary orbits, read from a compact binary file.
+ *
+ * The file is made once from the Sixth Catalog of Orbits of Visual Binary
+ * Stars (ConvertSixthCatalog) and then mapped into memory (Open), so opening
+ * it costs the same for any number of orbits and reads nothing up front.
+ * Orbits are stored as fixed-size records sorted by WDS designation, which
+ * is also the index: lookups are a binary search of the mapped records.
+ * The file uses the byte order of the machine that wrote it.
+ */
+class PABinaryCatalogue {
+public:
+  PABinaryCatalogue();
+  ~PABinaryCatalogue();
+
+  PABinaryCatalogue(const PABinaryCatalogue &) = delete;
+  PABinaryCatalogue &operator=(const PABinaryCatalogue &) = delete;
+
+  static int ConvertSixthCatalog(const std::string &textPath,
+                                 const std::string &binaryPath);
+
+  bool Open(const std::string &binaryPath);
+
+  void Close();
+
+  std::size_t size() const { return count; }
+
+  int Find(const std::string &wdsDesignation) const;
+
+  std::string WdsDesignation(std::size_t index) const;
+
+  std::string DiscovererDesignation(std::size_t index) const;
+
+  pa_data::BinaryStarData Star(std::size_t index) const;
+
+  std::vector<CBinaryStarOrbitTrack>
+  OrbitTracks(const std::vector<double> &epochYears) const;
+
+private:
+  void *mapping;
+  std::size_t mappingBytes;
+  const void *records;
+  std::size_t count;
+};
+
+#endif
@@ -0,0 +1,491 @@
+#include "pa_cache.h"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+/**
+ * Keys for the cached methods, so that methods with the same arguments keep
+ * separate results.
+ */
+enum CachedMethod {
+  kApproximatePositionOfSun,
+  kPrecisePositionOfSun,
+  kSunDistanceAndAngularSize,
+  kSunriseAndSunset,
+  kMorningAndEveningTwilight,
+  kEquationOfTime,
+  kSolarElongation,
+  kApproximatePositionOfMoon,
+  kPrecisePositionOfMoon,
+  kMoonPhase,
+  kTimesOfNewMoonAndFullMoon,
+  kMoonDistAngDiamHorParallax,
+  kMoonriseAndMoonset,
+  kApproximatePositionOfPlanet,
+  kPrecisePositionOfPlanet,
+  kVisualAspectsOfAPlanet,
+  kPrecisePositionOfAllPlanets,
+  kLunarEclipseOccurrence,
+  kLunarEclipseCircumstances,
+  kSolarEclipseOccurrence,
+  kSolarEclipseCircumstances
+};
+
+const std::string kNoText;
+
+/**
+ * \brief A local day and time as one instant, in hours from the start of
+ * the month.
+ */
+double LocalHours(double day, double hours = 0, double minutes = 0,
+                  double seconds = 0) {
+  return day * 24 + hours + minutes / 60 + seconds / 3600;
+}
+} // namespace
+
+/**
+ * \brief Cache of about capacity results, over shardCount shards (see the
+ * class comment for the exact bound).
+ *
+ * @param resolution Step, in hours, to which the local time of a call is
+ * rounded.
+ *
+ * @throws std::invalid_argument if shardCount or resolution is not
+ * positive.
+ */
+PAResultCache::PAResultCache(std::size_t capacity, int shardCount,
+                             double resolution) {
+  if (shardCount <= 0)
+    throw std::invalid_argument("PAResultCache: shardCount must be positive");
+  if (!(resolution > 0))
+    throw std::invalid_argument("PAResultCache: resolution must be positive");
+
+  this->shardCapacity = std::max<std::size_t>(1, capacity / shardCount);
+  this->resolution = resolution;
+  for (int i = 0; i < shardCount; i++)
+    shards.push_back(std::make_unique<Shard>());
+}
+
+/**
+ * \brief Hits, misses and evictions since construction or Clear(), and the
+ * number of results held.
+ */
+CCacheStats PAResultCache::Stats() const {
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  std::uint64_t evictions = 0;
+  std::size_t size = 0;
+
+  for (const std::unique_ptr<Shard> &shard : shards) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    hits += shard->hits;
+    misses += shard->misses;
+    evictions += shard->evictions;
+    size += shard->order.size();
+  }
+
+  return CCacheStats(hits, misses, evictions, size,
+                     shardCapacity * shards.size());
+}
+
+/**
+ * \brief Drop every result, and zero the counts.
+ */
+void PAResultCache::Clear() {
+  for (std::unique_ptr<Shard> &shard : shards) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->index.clear();
+    shard->order.clear();
+    shard->hits = 0;
+    shard->misses = 0;
+    shard->evictions = 0;
+  }
+}
+
+bool PAResultCache::Key::operator==(const Key &other) const {
+  return method == other.method && count == other.count &&
+         arguments == other.arguments && text == other.text;
+}
+
+std::size_t PAResultCache::KeyHash::operator()(const Key &key) const {
+  // FNV-1a over the method and the quantized arguments.
+  std::uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](std::uint64_t value) {
+    hash ^= value;
+    hash *= 1099511628211ULL;
+  };
+
+  mix(static_cast<std::uint64_t>(key.method));
+  for (int i = 0; i < key.count; i++)
+    mix(static_cast<std::uint64_t>(key.arguments[i]));
+  mix(std::hash<std::string>()(key.text));
+
+  return static_cast<std::size_t>(hash);
+}
+
+PAResultCache::Key
+PAResultCache::MakeKey(int method, double localHours,
+                       std::initializer_list<double> exact,
+                       const std::string &text) const {
+  if (exact.size() + 1 > (std::size_t)kMaxArguments)
+    throw std::invalid_argument("PAResultCache: too many arguments");
+
+  Key key;
+  key.method = method;
+  key.count = 0;
+  key.arguments.fill(0);
+  key.text = text;
+
+  key.arguments[key.count++] = std::llround(localHours / resolution);
+
+  // The bits of the value; adding 0.0 makes -0.0 match 0.0.
+  for (double argument : exact) {
+    double value = argument + 0.0;
+    std::memcpy(&key.arguments[key.count++], &value, sizeof(value));
+  }
+
+  return key;
+}
+
+PAResultCache::Shard &PAResultCache::ShardFor(const Key &key) {
+  // The low bits pick the bucket inside the shard, so use the high ones.
+  std::uint64_t hash = KeyHash()(key);
+
+  return *shards[(hash >> 32) % shards.size()];
+}
+
+void PAResultCache::Store(Shard &shard, const Key &key, std::any value) {
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto found = shard.index.find(key);
+
+  if (found != shard.index.end()) {
+    shard.order.splice(shard.order.begin(), shard.order, found->second);
+    return;
+  }
+
+  shard.order.push_front(Entry{key, std::move(value)});
+  shard.index.emplace(key, shard.order.begin());
+
+  if (shard.order.size() > shardCapacity) {
+    shard.index.erase(shard.order.back().key);
+    shard.order.pop_back();
+    shard.evictions++;
+  }
+}
+
+CApproximatePositionOfSun PACachedSun::ApproximatePositionOfSun(
+    double lctHours, double lctMinutes, double lctSeconds, double localDay,
+    int localMonth, int localYear, bool isDaylightSaving, int zoneCorrection) {
+  return cache.Get<CApproximatePositionOfSun>(
+      kApproximatePositionOfSun,
+      LocalHours(localDay, lctHours, lctMinutes, lctSeconds),
+      {(double)localMonth, (double)localYear, (double)isDaylightSaving,
+       (double)zoneCorrection},
+      kNoText, [&] {
+        return sun.ApproximatePositionOfSun(lctHours, lctMinutes, lctSeconds,
+                                            localDay, localMonth, localYear,
+                                            isDaylightSaving, zoneCorrection);
+      });
+}
+
+CPrecisePositionOfSun PACachedSun::PrecisePositionOfSun(
+    double lctHours, double lctMinutes, double lctSeconds, double localDay,
+    int localMonth, int localYear, bool isDaylightSaving, int zoneCorrection) {
+  return cache.Get<CPrecisePositionOfSun>(
+      kPrecisePositionOfSun,
+      LocalHours(localDay, lctHours, lctMinutes, lctSeconds),
+      {(double)localMonth, (double)localYear, (double)isDaylightSaving,
+       (double)zoneCorrection},
+      kNoText, [&] {
+        return sun.PrecisePositionOfSun(lctHours, lctMinutes, lctSeconds,
+                                        localDay, localMonth, localYear,
+                                        isDaylightSaving, zoneCorrection);
+      });
+}
+
+CSunDistanceAngularSize PACachedSun::SunDistanceAndAngularSize(
+    double lctHours, double lctMinutes, double lctSeconds, double localDay,
+    int localMonth, int localYear, bool isDaylightSaving, int zoneCorrection) {
+  return cache.Get<CSunDistanceAngularSize>(
+      kSunDistanceAndAngularSize,
+      LocalHours(localDay, lctHours, lctMinutes, lctSeconds),
+      {(double)localMonth, (double)localYear, (double)isDaylightSaving,
+       (double)zoneCorrection},
+      kNoText, [&] {
+        return sun.SunDistanceAndAngularSize(lctHours, lctMinutes, lctSeconds,
+                                             localDay, localMonth, localYear,
+                                             isDaylightSaving, zoneCorrection);
+      });
+}
+
+CSunriseAndSunset PACachedSun::SunriseAndSunset(
+    double localDay, int localMonth, int localYear, bool isDaylightSaving,
+    int zoneCorrection, double geographicalLongDeg, double geographicalLatDeg) {
+  return cache.Get<CSunriseAndSunset>(
+      kSunriseAndSunset, LocalHours(localDay),
+      {(double)localMonth, (double)localYear, (double)isDaylightSaving,
+       (double)zoneCorrection, geographicalLongDeg, geographicalLatDeg},
+      kNoText, [&] {
+        return sun.SunriseAndSunset(localDay, localMonth, localYear,
+                                    isDaylightSaving, zoneCorrection,
+                                    geographicalLongDeg, geographicalLatDeg);
+      });
+}
+
+CMorningAndEveningTwilight PACachedSun::MorningAndEveningTwilight(
+    double localDay, int localMonth, int localYear, bool isDaylightSaving,
+    int zoneCorrection, double geographicalLongDeg, double geographicalLatDeg,
+    ETwilightType twilightType) {
+  return cache.Get<CMorningAndEveningTwilight>(
+      kMorningAndEveningTwilight, LocalHours(localDay),
+      {(double)localMonth, (double)localYear, (double)isDaylightSaving,
+       (double)zoneCorrection, geographicalLongDeg, geographicalLatDeg,
+       (double)twilightType},
+      kNoText, [&] {
+        return sun.MorningAndEveningTwilight(
+            localDay, localMonth, localYear, isDaylightSaving, zoneCorrection,
+            geographicalLongDeg, geographicalLatDeg, twilightType);
+      });
+}
+
+CEquationOfTime PACachedSun::EquationOfTime(double gwdateDay, int gwdateMonth,
+                                            int gwdateYear) {
+  return cache.Get<CEquationOfTime>(
+      kEquationOfTime, LocalHours(gwdateDay),
+      {(double)gwdateMonth, (double)gwdateYear},
+      kNoText,
+      [&] { return sun.EquationOfTime(gwdateDay, gwdateMonth, gwdateYear); });
+}
+
+double PACachedSun::SolarElongation(double raHour, double raMin, double raSec,
+                                    double decDeg, double decMin,
+                                    double decSec, double gwdateDay,
+                                    int gwdateMonth, int gwdateYear) {
+  return cache.Get<double>(
+      kSolarElongation, LocalHours(gwdateDay),
+      {raHour, raMin, raSec, decDeg, decMin, decSec, (double)gwdateMonth,
+       (double)gwdateYear},
+      kNoText, [&] {
+        return sun.SolarElongation(raHour, raMin, raSec, decDeg, decMin,
+                                   decSec, gwdateDay, gwdateMonth, gwdateYear);
+      });
+}
+
+CMoonApproximatePosition PACachedMoon::ApproximatePositionOfMoon(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear) {
+  return cache.Get<CMoonApproximatePosition>(
+      kApproximatePositionOfMoon,
+      LocalHours(localDateDay, lctHour, lctMin, lctSec),
+      {(double)isDaylightSaving, (double)zoneCorrectionHours,
+       (double)localDateMonth, (double)localDateYear},
+      kNoText, [&] {
+        return moon.ApproximatePositionOfMoon(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear);
+      });
+}
+
+CMoonPrecisePosition PACachedMoon::PrecisePositionOfMoon(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear) {
+  return cache.Get<CMoonPrecisePosition>(
+      kPrecisePositionOfMoon, LocalHours(localDateDay, lctHour, lctMin, lctSec),
+      {(double)isDaylightSaving, (double)zoneCorrectionHours,
+       (double)localDateMonth, (double)localDateYear},
+      kNoText, [&] {
+        return moon.PrecisePositionOfMoon(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear);
+      });
+}
+
+CMoonPhase PACachedMoon::MoonPhase(double lctHour, double lctMin,
+                                   double lctSec, bool isDaylightSaving,
+                                   int zoneCorrectionHours,
+                                   double localDateDay, int localDateMonth,
+                                   int localDateYear,
+                                   EAccuracyLevel accuracyLevel) {
+  return cache.Get<CMoonPhase>(
+      kMoonPhase, LocalHours(localDateDay, lctHour, lctMin, lctSec),
+      {(double)isDaylightSaving, (double)zoneCorrectionHours,
+       (double)localDateMonth, (double)localDateYear, (double)accuracyLevel},
+      kNoText, [&] {
+        return moon.MoonPhase(lctHour, lctMin, lctSec, isDaylightSaving,
+                              zoneCorrectionHours, localDateDay,
+                              localDateMonth, localDateYear, accuracyLevel);
+      });
+}
+
+CMoonNewFull PACachedMoon::TimesOfNewMoonAndFullMoon(bool isDaylightSaving,
+                                                     int zoneCorrectionHours,
+                                                     double localDateDay,
+                                                     int localDateMonth,
+                                                     int localDateYear) {
+  return cache.Get<CMoonNewFull>(
+      kTimesOfNewMoonAndFullMoon, LocalHours(localDateDay),
+      {(double)isDaylightSaving, (double)zoneCorrectionHours,
+       (double)localDateMonth, (double)localDateYear},
+      kNoText, [&] {
+        return moon.TimesOfNewMoonAndFullMoon(isDaylightSaving,
+                                              zoneCorrectionHours, localDateDay,
+                                              localDateMonth, localDateYear);
+      });
+}
+
+CMoonDistDiameterHP PACachedMoon::MoonDistAngDiamHorParallax(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear) {
+  return cache.Get<CMoonDistDiameterHP>(
+      kMoonDistAngDiamHorParallax,
+      LocalHours(localDateDay, lctHour, lctMin, lctSec),
+      {(double)isDaylightSaving, (double)zoneCorrectionHours,
+       (double)localDateMonth, (double)localDateYear},
+      kNoText, [&] {
+        return moon.MoonDistAngDiamHorParallax(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear);
+      });
+}
+
+CMoonRiseSet PACachedMoon::MoonriseAndMoonset(
+    double localDateDay, int localDateMonth, int localDateYear,
+    bool isDaylightSaving, int zoneCorrectionHours, double geogLongDeg,
+    double geogLatDeg) {
+  return cache.Get<CMoonRiseSet>(
+      kMoonriseAndMoonset, LocalHours(localDateDay),
+      {(double)localDateMonth, (double)localDateYear, (double)isDaylightSaving,
+       (double)zoneCorrectionHours, geogLongDeg, geogLatDeg},
+      kNoText, [&] {
+        return moon.MoonriseAndMoonset(localDateDay, localDateMonth,
+                                       localDateYear, isDaylightSaving,
+                                       zoneCorrectionHours, geogLongDeg,
+                                       geogLatDeg);
+      });
+}
+
+CApproximatePositionOfPlanet PACachedPlanet::ApproximatePositionOfPlanet(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear, std::string planetName) {
+  return cache.Get<CApproximatePositionOfPlanet>(
+      kApproximatePositionOfPlanet,
+      LocalHours(localDateDay, lctHour, lctMin, lctSec),
+      {(double)isDaylightSaving, (double)zoneCorrectionHours,
+       (double)localDateMonth, (double)localDateYear},
+      planetName, [&] {
+        return planet.ApproximatePositionOfPlanet(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear, planetName);
+      });
+}
+
+CPrecisePositionOfPlanet PACachedPlanet::PrecisePositionOfPlanet(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear, std::string planetName) {
+  return cache.Get<CPrecisePositionOfPlanet>(
+      kPrecisePositionOfPlanet,
+      LocalHours(localDateDay, lctHour, lctMin, lctSec),
+      {(double)isDaylightSaving, (double)zoneCorrectionHours,
+       (double)localDateMonth, (double)localDateYear},
+      planetName, [&] {
+        return planet.PrecisePositionOfPlanet(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear, planetName);
+      });
+}
+
+CPlanetVisualAspects PACachedPlanet::VisualAspectsOfAPlanet(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear, std::string planetName) {
+  return cache.Get<CPlanetVisualAspects>(
+      kVisualAspectsOfAPlanet,
+      LocalHours(localDateDay, lctHour, lctMin, lctSec),
+      {(double)isDaylightSaving, (double)zoneCorrectionHours,
+       (double)localDateMonth, (double)localDateYear},
+      planetName, [&] {
+        return planet.VisualAspectsOfAPlanet(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear, planetName);
+      });
+}
+
+CAllPlanetPositions PACachedPlanet::PrecisePositionOfAllPlanets(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear, bool includeVisualAspects) {
+  return cache.Get<CAllPlanetPositions>(
+      kPrecisePositionOfAllPlanets,
+      LocalHours(localDateDay, lctHour, lctMin, lctSec),
+      {(double)isDaylightSaving, (double)zoneCorrectionHours,
+       (double)localDateMonth, (double)localDateYear,
+       (double)includeVisualAspects},
+      kNoText, [&] {
+        return planet.PrecisePositionOfAllPlanets(
+            lctHour, lctMin, lctSec, isDaylightSaving, zoneCorrectionHours,
+            localDateDay, localDateMonth, localDateYear, includeVisualAspects);
+      });
+}
+
+CLunarEclipseOccurrence PACachedEclipses::LunarEclipseOccurrence(
+    double localDateDay, int localDateMonth, int localDateYear,
+    bool isDaylightSaving, int zoneCorrectionHours) {
+  return cache.Get<CLunarEclipseOccurrence>(
+      kLunarEclipseOccurrence, LocalHours(localDateDay),
+      {(double)localDateMonth, (double)localDateYear, (double)isDaylightSaving,
+       (double)zoneCorrectionHours},
+      kNoText, [&] {
+        return eclipses.LunarEclipseOccurrence(localDateDay, localDateMonth,
+                                               localDateYear, isDaylightSaving,
+                                               zoneCorrectionHours);
+      });
+}
+
+CLunarEclipseCircumstances PACachedEclipses::LunarEclipseCircumstances(
+    double localDateDay, int localDateMonth, int localDateYear,
+    bool isDaylightSaving, int zoneCorrectionHours) {
+  return cache.Get<CLunarEclipseCircumstances>(
+      kLunarEclipseCircumstances, LocalHours(localDateDay),
+      {(double)localDateMonth, (double)localDateYear, (double)isDaylightSaving,
+       (double)zoneCorrectionHours},
+      kNoText, [&] {
+        return eclipses.LunarEclipseCircumstances(
+            localDateDay, localDateMonth, localDateYear, isDaylightSaving,
+            zoneCorrectionHours);
+      });
+}
+
+CSolarEclipseOccurrence PACachedEclipses::SolarEclipseOccurrence(
+    double localDateDay, int localDateMonth, int localDateYear,
+    bool isDaylightSaving, int zoneCorrectionHours) {
+  return cache.Get<CSolarEclipseOccurrence>(
+      kSolarEclipseOccurrence, LocalHours(localDateDay),
+      {(double)localDateMonth, (double)localDateYear, (double)isDaylightSaving,
+       (double)zoneCorrectionHours},
+      kNoText, [&] {
+        return eclipses.SolarEclipseOccurrence(localDateDay, localDateMonth,
+                                               localDateYear, isDaylightSaving,
+                                               zoneCorrectionHours);
+      });
+}
+
+CSolarEclipseCircumstances PACachedEclipses::SolarEclipseCircumstances(
+    double localDateDay, int localDateMonth, int localDateYear,
+    bool isDaylightSaving, int zoneCorrectionHours, double geogLongitudeDeg,
+    double geogLatitudeDeg) {
+  return cache.Get<CSolarEclipseCircumstances>(
+      kSolarEclipseCircumstances, LocalHours(localDateDay),
+      {(double)localDateMonth, (double)localDateYear, (double)isDaylightSaving,
+       (double)zoneCorrectionHours, geogLongitudeDeg, geogLatitudeDeg},
+      kNoText, [&] {
+        return eclipses.SolarEclipseCircumstances(
+            localDateDay, localDateMonth, localDateYear, isDaylightSaving,
+            zoneCorrectionHours, geogLongitudeDeg, geogLatitudeDeg);
+      });
+}
@@ -0,0 +1,298 @@
+#ifndef _pa_cache
+#define _pa_cache
+
+#include "pa_eclipses.h"
+#include "pa_models.h"
+#include "pa_moon.h"
+#include "pa_planet.h"
+#include "pa_sun.h"
+#include "pa_types.h"
+#include <any>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace pa_models;
+using namespace pa_types;
+
+/**
+ * \brief Bounded, thread-safe store of façade results, keyed by method and
+ * quantized arguments.
+ *
+ * Entries are spread over shards by key hash; each shard has its own lock
+ * and its own least-recently-used list, so threads asking for different
+ * results seldom wait for each other. A hit copies the stored result out
+ * and computes nothing. A miss computes outside the lock, so two threads
+ * missing on the same key may both compute it.
+ *
+ * The local day and time of a call are taken together as one instant, in
+ * hours from the start of the month, and rounded to a multiple of
+ * resolution (hours) before they are compared: a resolution of 1.0 / 60
+ * makes calls within the same minute share one result. Other arguments,
+ * such as months, years, time zones and geographic coordinates, must match
+ * exactly.
+ *
+ * Each shard holds at most max(1, capacity / shardCount) results, so the
+ * cache as a whole holds up to that times shardCount: more than capacity
+ * when there are more shards than capacity, and less when capacity is not
+ * a multiple of shardCount. Stats() reports the actual bound.
+ */
+class PAResultCache {
+public:
+  static const int kMaxArguments = 10;
+
+  PAResultCache(std::size_t capacity = 4096, int shardCount = 16,
+                double resolution = 1e-6);
+
+  PAResultCache(const PAResultCache &) = delete;
+  PAResultCache &operator=(const PAResultCache &) = delete;
+
+  /**
+   * \brief The result for method and arguments: stored, or from compute()
+   * and then stored.
+   *
+   * @param method Distinguishes methods whose arguments could coincide.
+   * @param localHours Local day and time, in hours from the start of the
+   * month; rounded to resolution.
+   * @param exact Other arguments, compared as they are; at most
+   * kMaxArguments - 1.
+   * @param text Any string argument, such as a planet name.
+   */
+  template <typename Result, typename Compute>
+  Result Get(int method, double localHours,
+             std::initializer_list<double> exact, const std::string &text,
+             Compute compute) {
+    Key key = MakeKey(method, localHours, exact, text);
+    Shard &shard = ShardFor(key);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto found = shard.index.find(key);
+      if (found != shard.index.end()) {
+        shard.order.splice(shard.order.begin(), shard.order, found->second);
+        shard.hits++;
+        return std::any_cast<const Result &>(found->second->value);
+      }
+      shard.misses++;
+    }
+
+    Result result = compute();
+    Store(shard, key, std::any(result));
+
+    return result;
+  }
+
+  CCacheStats Stats() const;
+
+  void Clear();
+
+private:
+  struct Key {
+    int method;
+    int count;
+    std::array<std::int64_t, kMaxArguments> arguments;
+    std::string text;
+
+    bool operator==(const Key &other) const;
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key &key) const;
+  };
+
+  struct Entry {
+    Key key;
+    std::any value;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    std::list<Entry> order; /**< Most recently used first. */
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+  };
+
+  Key MakeKey(int method, double localHours,
+              std::initializer_list<double> exact,
+              const std::string &text) const;
+
+  Shard &ShardFor(const Key &key);
+
+  void Store(Shard &shard, const Key &key, std::any value);
+
+  std::vector<std::unique_ptr<Shard>> shards;
+  std::size_t shardCapacity;
+  double resolution;
+};
+
+/**
+ * \brief PASun, with results kept in a PAResultCache.
+ */
+class PACachedSun {
+public:
+  explicit PACachedSun(PAResultCache &cache) : cache(cache) {}
+
+  CApproximatePositionOfSun
+  ApproximatePositionOfSun(double lctHours, double lctMinutes,
+                           double lctSeconds, double localDay, int localMonth,
+                           int localYear, bool isDaylightSaving,
+                           int zoneCorrection);
+
+  CPrecisePositionOfSun
+  PrecisePositionOfSun(double lctHours, double lctMinutes, double lctSeconds,
+                       double localDay, int localMonth, int localYear,
+                       bool isDaylightSaving, int zoneCorrection);
+
+  CSunDistanceAngularSize
+  SunDistanceAndAngularSize(double lctHours, double lctMinutes,
+                            double lctSeconds, double localDay,
+                            int localMonth, int localYear,
+                            bool isDaylightSaving, int zoneCorrection);
+
+  CSunriseAndSunset SunriseAndSunset(double localDay, int localMonth,
+                                     int localYear, bool isDaylightSaving,
+                                     int zoneCorrection,
+                                     double geographicalLongDeg,
+                                     double geographicalLatDeg);
+
+  CMorningAndEveningTwilight MorningAndEveningTwilight(
+      double localDay, int localMonth, int localYear, bool isDaylightSaving,
+      int zoneCorrection, double geographicalLongDeg, double geographicalLatDeg,
+      ETwilightType twilightType);
+
+  CEquationOfTime EquationOfTime(double gwdateDay, int gwdateMonth,
+                                 int gwdateYear);
+
+  double SolarElongation(double raHour, double raMin, double raSec,
+                         double decDeg, double decMin, double decSec,
+                         double gwdateDay, int gwdateMonth, int gwdateYear);
+
+private:
+  PAResultCache &cache;
+  PASun sun;
+};
+
+/**
+ * \brief PAMoon, with results kept in a PAResultCache.
+ */
+class PACachedMoon {
+public:
+  explicit PACachedMoon(PAResultCache &cache) : cache(cache) {}
+
+  CMoonApproximatePosition
+  ApproximatePositionOfMoon(double lctHour, double lctMin, double lctSec,
+                            bool isDaylightSaving, int zoneCorrectionHours,
+                            double localDateDay, int localDateMonth,
+                            int localDateYear);
+
+  CMoonPrecisePosition
+  PrecisePositionOfMoon(double lctHour, double lctMin, double lctSec,
+                        bool isDaylightSaving, int zoneCorrectionHours,
+                        double localDateDay, int localDateMonth,
+                        int localDateYear);
+
+  CMoonPhase MoonPhase(double lctHour, double lctMin, double lctSec,
+                       bool isDaylightSaving, int zoneCorrectionHours,
+                       double localDateDay, int localDateMonth,
+                       int localDateYear, EAccuracyLevel accuracyLevel);
+
+  CMoonNewFull TimesOfNewMoonAndFullMoon(bool isDaylightSaving,
+                                         int zoneCorrectionHours,
+                                         double localDateDay,
+                                         int localDateMonth, int localDateYear);
+
+  CMoonDistDiameterHP
+  MoonDistAngDiamHorParallax(double lctHour, double lctMin, double lctSec,
+                             bool isDaylightSaving, int zoneCorrectionHours,
+                             double localDateDay, int localDateMonth,
+                             int localDateYear);
+
+  CMoonRiseSet MoonriseAndMoonset(double localDateDay, int localDateMonth,
+                                  int localDateYear, bool isDaylightSaving,
+                                  int zoneCorrectionHours, double geogLongDeg,
+                                  double geogLatDeg);
+
+private:
+  PAResultCache &cache;
+  PAMoon moon;
+};
+
+/**
+ * \brief PAPlanet, with results kept in a PAResultCache.
+ */
+class PACachedPlanet {
+public:
+  explicit PACachedPlanet(PAResultCache &cache) : cache(cache) {}
+
+  CApproximatePositionOfPlanet
+  ApproximatePositionOfPlanet(double lctHour, double lctMin, double lctSec,
+                              bool isDaylightSaving, int zoneCorrectionHours,
+                              double localDateDay, int localDateMonth,
+                              int localDateYear, std::string planetName);
+
+  CPrecisePositionOfPlanet
+  PrecisePositionOfPlanet(double lctHour, double lctMin, double lctSec,
+                          bool isDaylightSaving, int zoneCorrectionHours,
+                          double localDateDay, int localDateMonth,
+                          int localDateYear, std::string planetName);
+
+  CPlanetVisualAspects
+  VisualAspectsOfAPlanet(double lctHour, double lctMin, double lctSec,
+                         bool isDaylightSaving, int zoneCorrectionHours,
+                         double localDateDay, int localDateMonth,
+                         int localDateYear, std::string planetName);
+
+  CAllPlanetPositions PrecisePositionOfAllPlanets(
+      double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+      int zoneCorrectionHours, double localDateDay, int localDateMonth,
+      int localDateYear, bool includeVisualAspects = false);
+
+private:
+  PAResultCache &cache;
+  PAPlanet planet;
+};
+
+/**
+ * \brief PAEclipses, with results kept in a PAResultCache.
+ */
+class PACachedEclipses {
+public:
+  explicit PACachedEclipses(PAResultCache &cache) : cache(cache) {}
+
+  CLunarEclipseOccurrence LunarEclipseOccurrence(double localDateDay,
+                                                 int localDateMonth,
+                                                 int localDateYear,
+                                                 bool isDaylightSaving,
+                                                 int zoneCorrectionHours);
+
+  CLunarEclipseCircumstances LunarEclipseCircumstances(double localDateDay,
+                                                       int localDateMonth,
+                                                       int localDateYear,
+                                                       bool isDaylightSaving,
+                                                       int zoneCorrectionHours);
+
+  CSolarEclipseOccurrence SolarEclipseOccurrence(double localDateDay,
+                                                 int localDateMonth,
+                                                 int localDateYear,
+                                                 bool isDaylightSaving,
+                                                 int zoneCorrectionHours);
+
+  CSolarEclipseCircumstances
+  SolarEclipseCircumstances(double localDateDay, int localDateMonth,
+                            int localDateYear, bool isDaylightSaving,
+                            int zoneCorrectionHours, double geogLongitudeDeg,
+                            double geogLatitudeDeg);
+
+private:
+  PAResultCache &cache;
+  PAEclipses eclipses;
+};
+
+#endif
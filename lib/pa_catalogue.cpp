@@ -0,0 +1,94 @@
+#include "pa_catalogue.h"
+#include "pa_macros.h"
+#include "pa_models.h"
+#include "pa_types.h"
+#include "pa_util.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace pa_types;
+using namespace pa_models;
+using namespace pa_util;
+using namespace pa_macros;
+
+/**
+ * \brief Calculate rising, transit and setting times for a catalogue of
+ * objects, at one site and Greenwich date.
+ *
+ * Same model as PACoordinates::RisingAndSetting, but the sidereal time at 0h
+ * UT and the site terms are computed once for the whole catalogue. Times are
+ * returned as unrounded decimal hours. Rise/set times and azimuths are 0 for
+ * objects that never rise or are circumpolar; the transit time is always
+ * filled in. Objects with a rise or set time in the first 4 minutes of the
+ * day (where the sidereal to universal time conversion is ambiguous) are
+ * flagged with GstToUtConversionWarning.
+ *
+ * @param raHours Right ascension of each object, in decimal hours.
+ * @param decDeg Declination of each object, in decimal degrees (same length
+ * as raHours; extra elements in the longer array are ignored).
+ *
+ * @return CRiseSetCatalogue
+ */
+CRiseSetCatalogue PACatalogue::RisingAndSetting(
+    const std::vector<double> &raHours, const std::vector<double> &decDeg,
+    double gwDateDay, int gwDateMonth, int gwDateYear, double geogLongDeg,
+    double geogLatDeg, double vertShiftDeg) {
+  std::size_t count = std::min(raHours.size(), decDeg.size());
+  CRiseSetCatalogue result(count);
+
+  // Sidereal time at 0h UT, as in GreenwichSiderealTimeToUniversalTime.
+  double jd = CivilDateToJulianDate(gwDateDay, gwDateMonth, gwDateYear);
+  double centuries = (jd - 2451545) / 36525;
+  double gst0 = 6.697374558 + (2400.051336 * centuries) +
+                (0.000025862 * centuries * centuries);
+  double gst0Hours = gst0 - 24 * floor(gst0 / 24);
+  double longHours = geogLongDeg / 15;
+  double warningHours = 4.0 / 60.0;
+
+  double latRad = DegreesToRadians(geogLatDeg);
+  double vertRad = DegreesToRadians(vertShiftDeg);
+  double sinLat = sin(latRad);
+  double cosLat = cos(latRad);
+  double sinVert = sin(vertRad);
+  double cosVertCosLat = cos(vertRad) * cosLat;
+
+  auto lstToUt = [gst0Hours, longHours](double lstHours) {
+    double g = lstHours - longHours - gst0Hours;
+    return (g - 24 * floor(g / 24)) * 0.9972695663;
+  };
+
+  for (std::size_t i = 0; i < count; i++) {
+    double decRad = DegreesToRadians(decDeg[i]);
+    double sinDec = sin(decRad);
+    double cosDec = cos(decRad);
+    double cosH = -(sinVert + sinLat * sinDec) / (cosLat * cosDec);
+
+    result.utTransitHours[i] = lstToUt(raHours[i]);
+
+    if (cosH > 1) {
+      result.rsStatus[i] = ERiseSetStatus::NeverRises;
+      continue;
+    }
+    if (cosH < -1) {
+      result.rsStatus[i] = ERiseSetStatus::Circumpolar;
+      continue;
+    }
+
+    double hHours = DecimalDegreesToDegreeHours(WToDegrees(acos(cosH)));
+    double aDeg = WToDegrees(acos((sinDec + sinVert * sinLat) / cosVertCosLat));
+    double utRiseHours = lstToUt(raHours[i] - hHours);
+    double utSetHours = lstToUt(raHours[i] + hHours);
+
+    result.rsStatus[i] =
+        (utRiseHours < warningHours || utSetHours < warningHours)
+            ? ERiseSetStatus::GstToUtConversionWarning
+            : ERiseSetStatus::Ok;
+    result.utRiseHours[i] = utRiseHours;
+    result.utSetHours[i] = utSetHours;
+    result.azRiseDeg[i] = aDeg - 360 * floor(aDeg / 360);
+    result.azSetDeg[i] = (360 - aDeg) - 360 * floor((360 - aDeg) / 360);
+  }
+
+  return result;
+}
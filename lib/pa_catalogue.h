@@ -0,0 +1,26 @@
+#ifndef _pa_catalogue
+#define _pa_catalogue
+
+#include "pa_models.h"
+#include "pa_types.h"
+#include <vector>
+
+using namespace pa_models;
+using namespace pa_types;
+
+/**
+ * \brief Calculations over catalogues of fixed objects.
+ *
+ * Each method takes the catalogue as parallel arrays and computes the values
+ * that depend only on the site and date once, before looping over the
+ * objects.
+ */
+class PACatalogue {
+public:
+  CRiseSetCatalogue RisingAndSetting(const std::vector<double> &raHours,
+                                     const std::vector<double> &decDeg,
+                                     double gwDateDay, int gwDateMonth,
+                                     int gwDateYear, double geogLongDeg,
+                                     double geogLatDeg, double vertShiftDeg);
+};
+#endif
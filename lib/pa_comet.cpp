@@ -5,6 +5,7 @@
 #include "pa_util.h"
 #include <cmath>
 #include <string>
+#include <vector>
 
 using namespace pa_types;
 using namespace pa_models;
@@ -33,66 +34,17 @@ CCometPosition PAComet::PositionOfEllipticalComet(
   pa_data::CometDataElliptical cometInfo =
       pa_data::ellipticalCometLookup(cometName);
 
-  double timeSinceEpochYears =
-      (CivilDateToJulianDate(greenwichDateDay, greenwichDateMonth,
-                             greenwichDateYear) -
-       CivilDateToJulianDate(0.0, 1, greenwichDateYear)) /
-          365.242191 +
-      greenwichDateYear - cometInfo.epoch_EpochOfPerihelion;
-  double mcDeg = 360 * timeSinceEpochYears / cometInfo.period_PeriodOfOrbit;
-  double mcRad = DegreesToRadians(mcDeg - 360 * floor(mcDeg / 360));
-  double eccentricity = cometInfo.ecc_EccentricityOfOrbit;
-  double trueAnomalyDeg = WToDegrees(TrueAnomaly(mcRad, eccentricity));
-  double lcDeg = trueAnomalyDeg + cometInfo.peri_LongitudeOfPerihelion;
-  double rAU = cometInfo.axis_SemiMajorAxisOfOrbit *
-               (1 - eccentricity * eccentricity) /
-               (1 + eccentricity * cos(DegreesToRadians(trueAnomalyDeg)));
-  double lcNodeRad =
-      DegreesToRadians(lcDeg - cometInfo.node_LongitudeOfAscendingNode);
-  double psiRad =
-      asin(sin(lcNodeRad) *
-           sin(DegreesToRadians(cometInfo.incl_InclinationOfOrbit)));
-
-  double y =
-      sin(lcNodeRad) * cos(DegreesToRadians(cometInfo.incl_InclinationOfOrbit));
-  double x = cos(lcNodeRad);
-
-  double ldDeg =
-      WToDegrees(atan2(y, x)) + cometInfo.node_LongitudeOfAscendingNode;
-  double rdAU = rAU * cos(psiRad);
-
-  double earthLongitudeLeDeg =
-      SunLong(lctHour, lctMin, lctSec, daylightSaving, zoneCorrectionHours,
-              localDateDay, localDateMonth, localDateYear) +
-      180.0;
-  double earthRadiusVectorAU =
-      SunDist(lctHour, lctMin, lctSec, daylightSaving, zoneCorrectionHours,
-              localDateDay, localDateMonth, localDateYear);
-
-  double leLdRad = DegreesToRadians(earthLongitudeLeDeg - ldDeg);
-  double aRad = (rdAU < earthRadiusVectorAU)
-                    ? atan2((rdAU * sin(leLdRad)),
-                            (earthRadiusVectorAU - rdAU * cos(leLdRad)))
-                    : atan2((earthRadiusVectorAU * sin(-leLdRad)),
-                            (rdAU - earthRadiusVectorAU * cos(leLdRad)));
-
-  double cometLongDeg1 = (rdAU < earthRadiusVectorAU)
-                             ? 180.0 + earthLongitudeLeDeg + WToDegrees(aRad)
-                             : WToDegrees(aRad) + ldDeg;
-  double cometLongDeg = cometLongDeg1 - 360 * floor(cometLongDeg1 / 360);
-  double cometLatDeg = WToDegrees(
-      atan(rdAU * tan(psiRad) * sin(DegreesToRadians((cometLongDeg1 - ldDeg))) /
-           (earthRadiusVectorAU * sin(-leLdRad))));
+  CCometLongLatDist cometLongLatDist = ECometLongLatDist(
+      lctHour, lctMin, lctSec, daylightSaving, zoneCorrectionHours,
+      localDateDay, localDateMonth, localDateYear, cometInfo);
+
   double cometRAHours1 = DecimalDegreesToDegreeHours(EclipticRightAscension(
-      cometLongDeg, 0, 0, cometLatDeg, 0, 0, greenwichDateDay,
-      greenwichDateMonth, greenwichDateYear));
+      cometLongLatDist.longDeg, 0, 0, cometLongLatDist.latDeg, 0, 0,
+      greenwichDateDay, greenwichDateMonth, greenwichDateYear));
   double cometDecDeg1 = EclipticDeclination(
-      cometLongDeg, 0, 0, cometLatDeg, 0, 0, greenwichDateDay,
-      greenwichDateMonth, greenwichDateYear);
-  double cometDistanceAU = sqrt(
-      pow(earthRadiusVectorAU, 2) + pow(rAU, 2) -
-      2.0 * earthRadiusVectorAU * rAU *
-          cos(DegreesToRadians((lcDeg - earthLongitudeLeDeg))) * cos(psiRad));
+      cometLongLatDist.longDeg, 0, 0, cometLongLatDist.latDeg, 0, 0,
+      greenwichDateDay, greenwichDateMonth, greenwichDateYear);
+  double cometDistanceAU = cometLongLatDist.distAU;
 
   int cometRAHour = DecimalHoursHour(cometRAHours1 + 0.008333);
   int cometRAMin = DecimalHoursMinute(cometRAHours1 + 0.008333);
@@ -157,4 +109,87 @@ CCometPosition PAComet::PositionOfParabolicComet(
 
   return CCometPosition(cometRAHour, cometRAMin, cometRASec, cometDecDeg,
                         cometDecMin, cometDecSec, cometDistEarth);
-}
\ No newline at end of file
+}
+
+/**
+ * Calculate positions of many parabolic comets at one instant.
+ *
+ * Elements are given as parallel arrays, one entry per comet. The Earth's
+ * position and the obliquity are found once for the instant. Barker's
+ * equation is solved in closed form (SolveBarker), so every comet takes the
+ * same straight-line path through the loop. Distances are geometric, rather
+ * than from the approximation in PCometLongLatDist.
+ *
+ * @param julianDate Instant (Julian date, UT).
+ * @param perihelionJulianDate Times of perihelion passage (Julian dates).
+ * @param perihelionDistanceAU Perihelion distances, in AU.
+ * @param inclinationDeg Inclinations, in degrees.
+ * @param argPerihelionDeg Arguments of perihelion, in degrees.
+ * @param nodeDeg Longitudes of the ascending node, in degrees.
+ *
+ * @return CCometPositionCatalogue, in input order.
+ */
+CCometPositionCatalogue PAComet::PositionsOfParabolicComets(
+    double julianDate, const std::vector<double> &perihelionJulianDate,
+    const std::vector<double> &perihelionDistanceAU,
+    const std::vector<double> &inclinationDeg,
+    const std::vector<double> &argPerihelionDeg,
+    const std::vector<double> &nodeDeg) {
+  std::size_t count = perihelionJulianDate.size();
+  CCometPositionCatalogue result(count);
+
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+  double sunLongRad = DegreesToRadians(
+      SunLong(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year));
+  double sunDistAU = SunDist(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year);
+  double obliquityRad = DegreesToRadians(Obliq(g.day, g.month, g.year));
+
+  // Heliocentric ecliptic position of the Earth.
+  double earthX = -sunDistAU * cos(sunLongRad);
+  double earthY = -sunDistAU * sin(sunLongRad);
+  double sinObliquity = sin(obliquityRad);
+  double cosObliquity = cos(obliquityRad);
+
+  for (std::size_t k = 0; k < count; k++) {
+    double q = perihelionDistanceAU[k];
+    double dt = julianDate - perihelionJulianDate[k];
+    double s = SolveBarker(0.0364911624 * dt / (q * sqrt(q)));
+
+    // Position in the orbital plane, x towards perihelion.
+    double x = q * (1 - s * s);
+    double y = 2 * q * s;
+
+    double w = DegreesToRadians(argPerihelionDeg[k]);
+    double n = DegreesToRadians(nodeDeg[k]);
+    double i = DegreesToRadians(inclinationDeg[k]);
+    double sinW = sin(w);
+    double cosW = cos(w);
+    double sinN = sin(n);
+    double cosN = cos(n);
+    double sinI = sin(i);
+    double cosI = cos(i);
+
+    double hx = x * (cosW * cosN - sinW * sinN * cosI) -
+                y * (sinW * cosN + cosW * sinN * cosI);
+    double hy = x * (cosW * sinN + sinW * cosN * cosI) -
+                y * (sinW * sinN - cosW * cosN * cosI);
+    double hz = (x * sinW + y * cosW) * sinI;
+
+    double gx = hx - earthX;
+    double gy = hy - earthY;
+    double distanceAU = sqrt(gx * gx + gy * gy + hz * hz);
+
+    // Ecliptic to equatorial.
+    double ey = gy * cosObliquity - hz * sinObliquity;
+    double ez = gy * sinObliquity + hz * cosObliquity;
+    double raDeg = WToDegrees(atan2(ey, gx));
+
+    result.raHours[k] =
+        DecimalDegreesToDegreeHours(raDeg - 360 * floor(raDeg / 360));
+    result.decDeg[k] = WToDegrees(asin(ez / distanceAU));
+    result.earthDistanceAU[k] = distanceAU;
+    result.sunDistanceAU[k] = q * (1 + s * s);
+  }
+
+  return result;
+}
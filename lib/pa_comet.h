@@ -4,6 +4,7 @@
 #include "pa_models.h"
 #include <string>
 #include <tuple>
+#include <vector>
 
 using namespace pa_models;
 
@@ -21,6 +22,13 @@ public:
                                           double localDateDay,
                                           int localDateMonth, int localDateYear,
                                           std::string cometName);
+
+  CCometPositionCatalogue PositionsOfParabolicComets(
+      double julianDate, const std::vector<double> &perihelionJulianDate,
+      const std::vector<double> &perihelionDistanceAU,
+      const std::vector<double> &inclinationDeg,
+      const std::vector<double> &argPerihelionDeg,
+      const std::vector<double> &nodeDeg);
 };
 
 #endif
@@ -0,0 +1,292 @@
+#include "pa_comet_catalogue.h"
+#include "pa_macros.h"
+#include "pa_models.h"
+#include "pa_parallel.h"
+#include "pa_util.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <vector>
+
+using namespace pa_models;
+using namespace pa_util;
+using namespace pa_macros;
+
+namespace {
+/** Gaussian gravitational constant, in radians per day. */
+const double kGaussK = 0.01720209895;
+
+/** Orbits closer than this to e = 1 are treated as parabolic. */
+const double kParabolicLimit = 0.000001;
+
+/** Number of comets handed to a worker thread at a time. */
+const std::size_t kBlockSize = 512;
+
+/**
+ * \brief Read a numeric field from fixed columns (1-based, inclusive).
+ *
+ * @return false if the field is missing or not a number.
+ */
+bool ParseField(const std::string &line, std::size_t firstColumn,
+                std::size_t lastColumn, double &value) {
+  if (line.size() < lastColumn)
+    return false;
+
+  std::string field =
+      line.substr(firstColumn - 1, lastColumn - firstColumn + 1);
+  const char *begin = field.c_str();
+  char *end = nullptr;
+  value = strtod(begin, &end);
+
+  return end != begin;
+}
+
+std::string Trim(const std::string &text) {
+  std::size_t first = text.find_first_not_of(' ');
+  if (first == std::string::npos)
+    return "";
+
+  return text.substr(first, text.find_last_not_of(' ') - first + 1);
+}
+
+/**
+ * \brief Solve Kepler's equation for an elliptical orbit (Newton's method).
+ *
+ * @return Eccentric anomaly, in radians.
+ */
+double EllipticAnomaly(double meanAnomalyRad, double e) {
+  double m = meanAnomalyRad - 2 * M_PI * floor(meanAnomalyRad / (2 * M_PI));
+  double ea = (e < 0.8) ? m : M_PI;
+
+  for (int i = 0; i < 50; i++) {
+    double d = (ea - e * sin(ea) - m) / (1 - e * cos(ea));
+    ea -= d;
+    if (std::abs(d) < 1e-12)
+      break;
+  }
+
+  return ea;
+}
+
+/**
+ * \brief Solve Kepler's equation for a hyperbolic orbit (Newton's method).
+ *
+ * @return Hyperbolic anomaly.
+ */
+double HyperbolicAnomaly(double meanAnomalyRad, double e) {
+  double sign = (meanAnomalyRad < 0) ? -1.0 : 1.0;
+  double ha = sign * log(2 * std::abs(meanAnomalyRad) / e + 1.8);
+
+  for (int i = 0; i < 50; i++) {
+    double d = (e * sinh(ha) - ha - meanAnomalyRad) / (e * cosh(ha) - 1);
+    ha -= d;
+    if (std::abs(d) < 1e-12)
+      break;
+  }
+
+  return ha;
+}
+} // namespace
+
+/**
+ * \brief Load comets from a file of orbital elements in the one-line format
+ * used by the Minor Planet Center (CometEls.txt).
+ *
+ * @return Number of comets added, or -1 if the file could not be opened.
+ */
+int PACometCatalogue::LoadOrbitalElements(const std::string &path) {
+  std::ifstream input(path);
+  if (!input)
+    return -1;
+
+  return LoadOrbitalElements(input);
+}
+
+/**
+ * \brief Load comets from a stream of orbital elements in the one-line MPC
+ * format.
+ *
+ * Lines are parsed by column straight into the store. Blank lines and lines
+ * whose perihelion date or elements cannot be read are skipped. Perihelion
+ * times are given in TT, and are used as UT.
+ *
+ * @return Number of comets added.
+ */
+int PACometCatalogue::LoadOrbitalElements(std::istream &input) {
+  int added = 0;
+  std::string line;
+
+  while (std::getline(input, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+
+    double year, month, day, q, e, argPeri, node, incl;
+    if (!ParseField(line, 15, 18, year) || !ParseField(line, 20, 21, month) ||
+        !ParseField(line, 23, 29, day) || !ParseField(line, 31, 39, q) ||
+        !ParseField(line, 42, 49, e) || !ParseField(line, 52, 59, argPeri) ||
+        !ParseField(line, 62, 69, node) || !ParseField(line, 72, 79, incl))
+      continue;
+    if (month < 1 || month > 12 || q <= 0 || e < 0)
+      continue;
+
+    std::string name = (line.size() > 102) ? Trim(line.substr(102, 56)) : "";
+    if (name.empty())
+      name = Trim(line.substr(0, 12));
+
+    Add(name, CivilDateToJulianDate(day, (int)month, (int)year), q, e, argPeri,
+        node, incl);
+    added++;
+  }
+
+  return added;
+}
+
+/**
+ * \brief Add one comet to the catalogue.
+ *
+ * @param perihelionJulianDate Time of perihelion passage (Julian date).
+ * @param perihelionDistanceAU Perihelion distance, in AU.
+ * @param eccentricity Eccentricity (1 for a parabolic orbit).
+ */
+void PACometCatalogue::Add(const std::string &name,
+                           double perihelionJulianDate,
+                           double perihelionDistanceAU, double eccentricity,
+                           double argPerihelionDeg, double nodeDeg,
+                           double inclinationDeg) {
+  nameIndex.emplace(name, (int)names.size());
+
+  names.push_back(name);
+  this->perihelionJulianDate.push_back(perihelionJulianDate);
+  this->perihelionDistanceAU.push_back(perihelionDistanceAU);
+  this->eccentricity.push_back(eccentricity);
+  this->argPerihelionDeg.push_back(argPerihelionDeg);
+  this->nodeDeg.push_back(nodeDeg);
+  this->inclinationDeg.push_back(inclinationDeg);
+
+  double w = DegreesToRadians(argPerihelionDeg);
+  double n = DegreesToRadians(nodeDeg);
+  double i = DegreesToRadians(inclinationDeg);
+
+  px.push_back(cos(w) * cos(n) - sin(w) * sin(n) * cos(i));
+  py.push_back(cos(w) * sin(n) + sin(w) * cos(n) * cos(i));
+  pz.push_back(sin(w) * sin(i));
+  qx.push_back(-sin(w) * cos(n) - cos(w) * sin(n) * cos(i));
+  qy.push_back(-sin(w) * sin(n) + cos(w) * cos(n) * cos(i));
+  qz.push_back(cos(w) * sin(i));
+
+  // Parabolic orbits are marked by a mean motion of zero.
+  double axisAU = perihelionDistanceAU / std::abs(1 - eccentricity);
+  meanMotionRadPerDay.push_back((std::abs(1 - eccentricity) < kParabolicLimit)
+                                    ? 0.0
+                                    : kGaussK / (axisAU * sqrt(axisAU)));
+}
+
+/**
+ * \brief Index of a comet by name.
+ *
+ * @return Index into the columns, or -1 if there is no such comet.
+ */
+int PACometCatalogue::Find(const std::string &name) const {
+  auto found = nameIndex.find(name);
+
+  return (found == nameIndex.end()) ? -1 : found->second;
+}
+
+/**
+ * \brief Positions of every comet in the catalogue at one instant.
+ *
+ * The Earth's position (from SunLong and SunDist) and the obliquity are
+ * evaluated once for the instant. Each comet is then placed on its orbit
+ * (elliptical, parabolic or hyperbolic) and referred to the Earth. Light time
+ * is not allowed for, as in PAComet. The catalogue is split into blocks that
+ * are handed out to a pool of threads.
+ *
+ * @param julianDate Instant (Julian date, UT).
+ * @param threadCount Number of worker threads (0 for one per hardware thread).
+ */
+CCometPositionCatalogue PACometCatalogue::Positions(double julianDate,
+                                                    int threadCount) const {
+  PATaskPool pool(threadCount);
+  return Positions(julianDate, pool);
+}
+
+/**
+ * \brief As above, with the blocks run on a pool the caller keeps.
+ */
+CCometPositionCatalogue PACometCatalogue::Positions(double julianDate,
+                                                    PATaskPool &pool) const {
+  CCometPositionCatalogue result(size());
+
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+  double sunLongRad = DegreesToRadians(
+      SunLong(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year));
+  double sunDistAU = SunDist(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year);
+  double obliquityRad = DegreesToRadians(Obliq(g.day, g.month, g.year));
+
+  // Heliocentric ecliptic position of the Earth.
+  double earth[3] = {-sunDistAU * cos(sunLongRad),
+                     -sunDistAU * sin(sunLongRad), 0.0};
+  double sinObliquity = sin(obliquityRad);
+  double cosObliquity = cos(obliquityRad);
+
+  std::size_t blocks = (size() + kBlockSize - 1) / kBlockSize;
+  pool.Run(blocks, [&](std::size_t b, int) {
+    Propagate(b * kBlockSize, std::min(size(), (b + 1) * kBlockSize),
+              julianDate, earth, sinObliquity, cosObliquity, result);
+  });
+
+  return result;
+}
+
+void PACometCatalogue::Propagate(std::size_t begin, std::size_t end,
+                                 double julianDate, const double earth[3],
+                                 double sinObliquity, double cosObliquity,
+                                 CCometPositionCatalogue &result) const {
+  for (std::size_t k = begin; k < end; k++) {
+    double q = perihelionDistanceAU[k];
+    double e = eccentricity[k];
+    double dt = julianDate - perihelionJulianDate[k];
+
+    // Position in the orbital plane, x towards perihelion.
+    double x, y;
+    if (meanMotionRadPerDay[k] == 0.0) {
+      double s = SolveBarker(0.0364911624 * dt / (q * sqrt(q)));
+      x = q * (1 - s * s);
+      y = 2 * q * s;
+    } else if (e < 1) {
+      double axisAU = q / (1 - e);
+      double ea = EllipticAnomaly(meanMotionRadPerDay[k] * dt, e);
+      x = axisAU * (cos(ea) - e);
+      y = axisAU * sqrt(1 - e * e) * sin(ea);
+    } else {
+      double axisAU = q / (e - 1);
+      double ha = HyperbolicAnomaly(meanMotionRadPerDay[k] * dt, e);
+      x = axisAU * (e - cosh(ha));
+      y = axisAU * sqrt(e * e - 1) * sinh(ha);
+    }
+
+    double hx = x * px[k] + y * qx[k];
+    double hy = x * py[k] + y * qy[k];
+    double hz = x * pz[k] + y * qz[k];
+
+    double gx = hx - earth[0];
+    double gy = hy - earth[1];
+    double gz = hz - earth[2];
+    double distanceAU = sqrt(gx * gx + gy * gy + gz * gz);
+
+    // Ecliptic to equatorial.
+    double ex = gx;
+    double ey = gy * cosObliquity - gz * sinObliquity;
+    double ez = gy * sinObliquity + gz * cosObliquity;
+    double raDeg = WToDegrees(atan2(ey, ex));
+
+    result.raHours[k] =
+        DecimalDegreesToDegreeHours(raDeg - 360 * floor(raDeg / 360));
+    result.decDeg[k] = WToDegrees(asin(ez / distanceAU));
+    result.earthDistanceAU[k] = distanceAU;
+    result.sunDistanceAU[k] = sqrt(hx * hx + hy * hy + hz * hz);
+  }
+}
@@ -0,0 +1,60 @@
+#ifndef _pa_comet_catalogue
+#define _pa_comet_catalogue
+
+#include "pa_models.h"
+#include "pa_parallel.h"
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace pa_models;
+
+/**
+ * \brief Orbital elements for a catalogue of comets, with batch positions.
+ *
+ * Structure of arrays: element i of every column belongs to comet i. Angles
+ * are in degrees, referred to the ecliptic and equinox of the elements (J2000
+ * for MPC files), and are used as they are, as in PAComet.
+ */
+class PACometCatalogue {
+public:
+  int LoadOrbitalElements(const std::string &path);
+
+  int LoadOrbitalElements(std::istream &input);
+
+  void Add(const std::string &name, double perihelionJulianDate,
+           double perihelionDistanceAU, double eccentricity,
+           double argPerihelionDeg, double nodeDeg, double inclinationDeg);
+
+  int Find(const std::string &name) const;
+
+  std::size_t size() const { return names.size(); }
+
+  CCometPositionCatalogue Positions(double julianDate,
+                                    int threadCount = 0) const;
+
+  CCometPositionCatalogue Positions(double julianDate, PATaskPool &pool) const;
+
+  std::vector<std::string> names;           /**< Designation and name. */
+  std::vector<double> perihelionJulianDate; /**< Time of perihelion. */
+  std::vector<double> perihelionDistanceAU; /**< Perihelion distance, AU. */
+  std::vector<double> eccentricity;         /**< Eccentricity of the orbit. */
+  std::vector<double> argPerihelionDeg;     /**< Argument of perihelion. */
+  std::vector<double> nodeDeg;        /**< Longitude of the ascending node. */
+  std::vector<double> inclinationDeg; /**< Inclination of the orbit. */
+
+private:
+  void Propagate(std::size_t begin, std::size_t end, double julianDate,
+                 const double earth[3], double sinObliquity,
+                 double cosObliquity, CCometPositionCatalogue &result) const;
+
+  // Per-comet constants: orbital plane axes (towards perihelion, and 90
+  // degrees ahead) in ecliptic coordinates, and mean motion.
+  std::vector<double> px, py, pz, qx, qy, qz;
+  std::vector<double> meanMotionRadPerDay;
+
+  std::unordered_map<std::string, int> nameIndex;
+};
+
+#endif
@@ -121,28 +121,27 @@ CometDataParabolic parabolicCometLookup(std::string cometName) {
 }
 
 BinaryStarData getBinaryStarData(std::string binaryStarName) {
-  std::vector<BinaryStarData> binaryStarData;
-
-  binaryStarData.push_back(BinaryStarData("eta-Cor", 41.623, 1934.008, 219.907,
-                                          0.2763, 0.907, 59.025, 23.717));
-  binaryStarData.push_back(BinaryStarData("gamma-Vir", 171.37, 1836.433, 252.88,
-                                          0.8808, 3.746, 146.05, 31.78));
-  binaryStarData.push_back(BinaryStarData("eta-Cas", 480.0, 1889.6, 268.59,
-                                          0.497, 11.9939, 34.76, 278.42));
-  binaryStarData.push_back(BinaryStarData("zeta-Ori", 1508.6, 2070.6, 47.3,
-                                          0.07, 2.728, 72.0, 155.5));
-  binaryStarData.push_back(BinaryStarData("alpha-CMa", 50.09, 1894.13, 147.27,
-                                          0.5923, 7.5, 136.53, 44.57));
-  binaryStarData.push_back(BinaryStarData("delta-Gem", 1200.0, 1437.0, 57.19,
-                                          0.11, 6.9753, 63.28, 18.38));
-  binaryStarData.push_back(BinaryStarData("alpha-Gem", 420.07, 1965.3, 261.43,
-                                          0.33, 6.295, 115.94, 40.47));
-  binaryStarData.push_back(BinaryStarData("aplah-CMi", 40.65, 1927.6, 269.8,
-                                          0.4, 4.548, 35.7, 284.3));
-  binaryStarData.push_back(BinaryStarData("alpha-Cen", 79.92, 1955.56, 231.56,
-                                          0.516, 17.583, 79.24, 204.868));
-  binaryStarData.push_back(
-      BinaryStarData("alpha Sco", 900.0, 1889.0, 0.0, 0.0, 3.21, 86.3, 273.0));
+  // Built once, on first use.
+  static const std::vector<BinaryStarData> binaryStarData = {
+      BinaryStarData("eta-Cor", 41.623, 1934.008, 219.907, 0.2763, 0.907,
+                     59.025, 23.717),
+      BinaryStarData("gamma-Vir", 171.37, 1836.433, 252.88, 0.8808, 3.746,
+                     146.05, 31.78),
+      BinaryStarData("eta-Cas", 480.0, 1889.6, 268.59, 0.497, 11.9939, 34.76,
+                     278.42),
+      BinaryStarData("zeta-Ori", 1508.6, 2070.6, 47.3, 0.07, 2.728, 72.0,
+                     155.5),
+      BinaryStarData("alpha-CMa", 50.09, 1894.13, 147.27, 0.5923, 7.5, 136.53,
+                     44.57),
+      BinaryStarData("delta-Gem", 1200.0, 1437.0, 57.19, 0.11, 6.9753, 63.28,
+                     18.38),
+      BinaryStarData("alpha-Gem", 420.07, 1965.3, 261.43, 0.33, 6.295, 115.94,
+                     40.47),
+      BinaryStarData("aplah-CMi", 40.65, 1927.6, 269.8, 0.4, 4.548, 35.7,
+                     284.3),
+      BinaryStarData("alpha-Cen", 79.92, 1955.56, 231.56, 0.516, 17.583, 79.24,
+                     204.868),
+      BinaryStarData("alpha Sco", 900.0, 1889.0, 0.0, 0.0, 3.21, 86.3, 273.0)};
 
   for (int i = 0; i < binaryStarData.size(); i++)
     if (binaryStarData[i].name == binaryStarName)
@@ -2,6 +2,7 @@
 #include "pa_data.h"
 #include "pa_macros.h"
 #include "pa_models.h"
+#include "pa_trace.h"
 #include "pa_util.h"
 #include <cmath>
 #include <string>
@@ -18,6 +19,8 @@ CLunarEclipseOccurrence
 PAEclipses::LunarEclipseOccurrence(double localDateDay, int localDateMonth,
                                    int localDateYear, bool isDaylightSaving,
                                    int zoneCorrectionHours) {
+  PA_TRACE_SPAN("PAEclipses::LunarEclipseOccurrence");
+
   int daylightSaving = isDaylightSaving ? 1 : 0;
 
   double julianDateOfFullMoon =
@@ -60,6 +63,8 @@ CLunarEclipseCircumstances
 PAEclipses::LunarEclipseCircumstances(double localDateDay, int localDateMonth,
                                       int localDateYear, bool isDaylightSaving,
                                       int zoneCorrectionHours) {
+  PA_TRACE_SPAN("PAEclipses::LunarEclipseCircumstances");
+
   int daylightSaving = isDaylightSaving ? 1 : 0;
 
   double julianDateOfFullMoon =
@@ -187,6 +192,8 @@ CSolarEclipseOccurrence
 PAEclipses::SolarEclipseOccurrence(double localDateDay, int localDateMonth,
                                    int localDateYear, bool isDaylightSaving,
                                    int zoneCorrectionHours) {
+  PA_TRACE_SPAN("PAEclipses::SolarEclipseOccurrence");
+
   int daylightSaving = isDaylightSaving ? 1 : 0;
 
   double julianDateOfNewMoon =
@@ -229,6 +236,8 @@ CSolarEclipseCircumstances PAEclipses::SolarEclipseCircumstances(
     double localDateDay, int localDateMonth, int localDateYear,
     bool isDaylightSaving, int zoneCorrectionHours, double geogLongitudeDeg,
     double geogLatitudeDeg) {
+  PA_TRACE_SPAN("PAEclipses::SolarEclipseCircumstances");
+
   int daylightSaving = isDaylightSaving ? 1 : 0;
 
   double julianDateOfNewMoon =
@@ -0,0 +1,537 @@
+#include "pa_ephemeris_table.h"
+#include "pa_raw.h"
+#include "pa_util.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace pa_util;
+
+namespace {
+/**
+ * \brief File header. The column names follow it, then the columns, each
+ * with room for rowCapacity doubles.
+ */
+struct FileHeader {
+  char magic[8];        /**< "PAEPHTBL" */
+  uint32_t byteOrder;   /**< kByteOrder, as written by this machine */
+  uint32_t columnCount; /**< Number of columns */
+  uint64_t rowCount;    /**< Rows written */
+  uint64_t rowCapacity; /**< Rows each column has room for */
+  char body[32];        /**< Name of the body, such as "Sun" or "Mars" */
+  double geogLongDeg;   /**< Site of the altitude and azimuth columns */
+  double geogLatDeg;
+  double startJulianDate; /**< Julian date (UT) of the first row */
+  double stepDays;        /**< Time from one row to the next */
+};
+
+/**
+ * \brief Name of a column, NUL-padded.
+ */
+struct ColumnName {
+  char name[32];
+};
+
+static_assert(sizeof(FileHeader) == 96, "FileHeader must be packed");
+
+const char kMagic[8] = {'P', 'A', 'E', 'P', 'H', 'T', 'B', 'L'};
+const uint32_t kByteOrder = 0x01020304;
+
+/** Least capacity a table grows to, in rows. */
+const std::size_t kMinimumCapacity = 4096;
+
+/**
+ * \brief Offset of the first column: after the header and column names,
+ * rounded up to a cache line.
+ */
+std::size_t DataOffset(std::size_t columnCount) {
+  std::size_t names = sizeof(FileHeader) + columnCount * sizeof(ColumnName);
+  return (names + 63) / 64 * 64;
+}
+
+/**
+ * \brief Whether a file of a number of bytes holds the column names and
+ * columns its header describes. Divides rather than multiplies, so that a
+ * corrupt capacity cannot wrap the size it implies.
+ */
+bool HoldsColumns(const FileHeader &header, std::size_t bytes) {
+  if (header.columnCount == 0 || header.rowCount > header.rowCapacity)
+    return false;
+  std::size_t dataOffset = DataOffset(header.columnCount);
+  return dataOffset <= bytes &&
+         header.rowCapacity <=
+             (bytes - dataOffset) / sizeof(double) / header.columnCount;
+}
+
+/**
+ * \brief Write all of a buffer at an offset, however many calls it takes.
+ */
+bool WriteAt(int fd, const void *data, std::size_t bytes, std::size_t offset) {
+  const char *next = static_cast<const char *>(data);
+  while (bytes > 0) {
+    ssize_t written = pwrite(fd, next, bytes, offset);
+    if (written <= 0)
+      return false;
+    next += written;
+    bytes -= written;
+    offset += written;
+  }
+  return true;
+}
+
+/**
+ * \brief Read all of a buffer from an offset.
+ */
+bool ReadAt(int fd, void *data, std::size_t bytes, std::size_t offset) {
+  char *next = static_cast<char *>(data);
+  while (bytes > 0) {
+    ssize_t read = pread(fd, next, bytes, offset);
+    if (read <= 0)
+      return false;
+    next += read;
+    bytes -= read;
+    offset += read;
+  }
+  return true;
+}
+} // namespace
+
+PAEphemerisWriter::PAEphemerisWriter() {
+  this->fd = -1;
+  this->columnCount = 0;
+  this->rowCount = 0;
+  this->rowCapacity = 0;
+  this->dataOffset = 0;
+  this->geogLongDeg = 0.0;
+  this->geogLatDeg = 0.0;
+  this->startJulianDate = 0.0;
+  this->stepDays = 0.0;
+  this->positionColumns = false;
+}
+
+PAEphemerisWriter::~PAEphemerisWriter() { Close(); }
+
+/**
+ * \brief Columns filled by Append() from positions: right ascension and
+ * declination in radians, distance (km for the Sun and Moon, AU otherwise,
+ * as in pa_raw), and the geometric altitude and azimuth at the table's
+ * site, in radians.
+ */
+std::vector<std::string> PAEphemerisWriter::PositionColumns() {
+  return {"raRad", "decRad", "distance", "altitudeRad", "azimuthRad"};
+}
+
+/**
+ * \brief Create a table with no rows, replacing any file at the path.
+ *
+ * @param startJulianDate Julian date (UT) of the first row.
+ * @param stepDays Time from one row to the next; 1.0 / 1440 for a row a
+ * minute.
+ * @param columnNames Names of the columns, of at most 31 characters.
+ *
+ * @return false if there are no columns, a name or the body is too long, or
+ * the file could not be written.
+ */
+bool PAEphemerisWriter::Create(const std::string &path,
+                               const std::string &body, double geogLongDeg,
+                               double geogLatDeg, double startJulianDate,
+                               double stepDays,
+                               const std::vector<std::string> &columnNames) {
+  Close();
+
+  if (columnNames.empty() || body.size() >= sizeof(FileHeader::body))
+    return false;
+  for (const std::string &name : columnNames)
+    if (name.size() >= sizeof(ColumnName::name))
+      return false;
+
+  int created = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (created < 0)
+    return false;
+
+  FileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.byteOrder = kByteOrder;
+  header.columnCount = columnNames.size();
+  header.rowCount = 0;
+  header.rowCapacity = 0;
+  memcpy(header.body, body.data(), body.size());
+  header.geogLongDeg = geogLongDeg;
+  header.geogLatDeg = geogLatDeg;
+  header.startJulianDate = startJulianDate;
+  header.stepDays = stepDays;
+
+  std::vector<ColumnName> names(columnNames.size());
+  memset(names.data(), 0, names.size() * sizeof(ColumnName));
+  for (std::size_t i = 0; i < columnNames.size(); i++)
+    memcpy(names[i].name, columnNames[i].data(), columnNames[i].size());
+
+  std::size_t offset = DataOffset(columnNames.size());
+  if (!WriteAt(created, &header, sizeof(header), 0) ||
+      !WriteAt(created, names.data(), names.size() * sizeof(ColumnName),
+               sizeof(header)) ||
+      ftruncate(created, offset) != 0) {
+    close(created);
+    return false;
+  }
+
+  this->fd = created;
+  this->columnCount = columnNames.size();
+  this->rowCount = 0;
+  this->rowCapacity = 0;
+  this->dataOffset = offset;
+  this->geogLongDeg = geogLongDeg;
+  this->geogLatDeg = geogLatDeg;
+  this->startJulianDate = startJulianDate;
+  this->stepDays = stepDays;
+  this->positionColumns = columnNames == PositionColumns();
+
+  return true;
+}
+
+/**
+ * \brief Open an existing table, to append to it.
+ *
+ * @return false if the file could not be opened, or was not written by
+ * PAEphemerisWriter on a machine with the same byte order.
+ */
+bool PAEphemerisWriter::Open(const std::string &path) {
+  Close();
+
+  int opened = open(path.c_str(), O_RDWR);
+  if (opened < 0)
+    return false;
+
+  FileHeader header;
+  struct stat info;
+  if (!ReadAt(opened, &header, sizeof(header), 0) ||
+      fstat(opened, &info) != 0 ||
+      memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.byteOrder != kByteOrder ||
+      !HoldsColumns(header, info.st_size)) {
+    close(opened);
+    return false;
+  }
+
+  std::vector<ColumnName> names(header.columnCount);
+  if (!ReadAt(opened, names.data(), names.size() * sizeof(ColumnName),
+              sizeof(header))) {
+    close(opened);
+    return false;
+  }
+  std::vector<std::string> columnNames;
+  for (const ColumnName &name : names)
+    columnNames.push_back(
+        std::string(name.name, strnlen(name.name, sizeof(name.name))));
+
+  this->fd = opened;
+  this->columnCount = header.columnCount;
+  this->rowCount = header.rowCount;
+  this->rowCapacity = header.rowCapacity;
+  this->dataOffset = DataOffset(header.columnCount);
+  this->geogLongDeg = header.geogLongDeg;
+  this->geogLatDeg = header.geogLatDeg;
+  this->startJulianDate = header.startJulianDate;
+  this->stepDays = header.stepDays;
+  this->positionColumns = columnNames == PositionColumns();
+
+  return true;
+}
+
+/**
+ * \brief Close the table, if one is open. Every row appended is already in
+ * the file.
+ */
+void PAEphemerisWriter::Close() {
+  if (fd >= 0)
+    close(fd);
+
+  this->fd = -1;
+  this->columnCount = 0;
+  this->rowCount = 0;
+  this->rowCapacity = 0;
+  this->dataOffset = 0;
+  this->positionColumns = false;
+}
+
+/**
+ * \brief Append rows, given as columns in the order of the table's.
+ *
+ * @return false if no table is open, the number of columns is wrong, they
+ * are not all the same length, or the file could not be written.
+ */
+bool PAEphemerisWriter::AppendColumns(
+    const std::vector<std::vector<double>> &columns) {
+  if (fd < 0 || columns.size() != columnCount)
+    return false;
+
+  std::size_t rows = columns[0].size();
+  for (const std::vector<double> &column : columns)
+    if (column.size() != rows)
+      return false;
+  if (rows == 0)
+    return true;
+
+  if (!Reserve(rows))
+    return false;
+
+  for (std::size_t i = 0; i < columnCount; i++) {
+    std::size_t offset =
+        dataOffset + (i * rowCapacity + rowCount) * sizeof(double);
+    if (!WriteAt(fd, columns[i].data(), rows * sizeof(double), offset))
+      return false;
+  }
+
+  this->rowCount += rows;
+  return WriteHeader();
+}
+
+/**
+ * \brief Append the Sun's positions at the next rows' instants, as from
+ * pa_raw::Sun.
+ *
+ * The table must have PositionColumns().
+ */
+bool PAEphemerisWriter::Append(
+    const std::vector<pa_raw::SunPosition> &positions) {
+  std::vector<double> raRad, decRad, distance;
+  for (const pa_raw::SunPosition &position : positions) {
+    raRad.push_back(position.raRad);
+    decRad.push_back(position.decRad);
+    distance.push_back(position.distanceKm);
+  }
+  return AppendPositions(raRad, decRad, distance);
+}
+
+/**
+ * \brief Append the Moon's positions, as from pa_raw::Moon.
+ */
+bool PAEphemerisWriter::Append(
+    const std::vector<pa_raw::MoonPosition> &positions) {
+  std::vector<double> raRad, decRad, distance;
+  for (const pa_raw::MoonPosition &position : positions) {
+    raRad.push_back(position.raRad);
+    decRad.push_back(position.decRad);
+    distance.push_back(position.distanceKm);
+  }
+  return AppendPositions(raRad, decRad, distance);
+}
+
+/**
+ * \brief Append a planet's positions, as from pa_raw::Planet.
+ */
+bool PAEphemerisWriter::Append(
+    const std::vector<pa_raw::PlanetPosition> &positions) {
+  std::vector<double> raRad, decRad, distance;
+  for (const pa_raw::PlanetPosition &position : positions) {
+    raRad.push_back(position.raRad);
+    decRad.push_back(position.decRad);
+    distance.push_back(position.distanceAU);
+  }
+  return AppendPositions(raRad, decRad, distance);
+}
+
+/**
+ * \brief Append a comet's positions, as from pa_raw::EllipticalComet or
+ * pa_raw::ParabolicComet.
+ */
+bool PAEphemerisWriter::Append(
+    const std::vector<pa_raw::CometPosition> &positions) {
+  std::vector<double> raRad, decRad, distance;
+  for (const pa_raw::CometPosition &position : positions) {
+    raRad.push_back(position.raRad);
+    decRad.push_back(position.decRad);
+    distance.push_back(position.distanceAU);
+  }
+  return AppendPositions(raRad, decRad, distance);
+}
+
+/**
+ * \brief Append positions to a table of PositionColumns(), working out the
+ * altitude and azimuth of each at its row's instant.
+ */
+bool PAEphemerisWriter::AppendPositions(const std::vector<double> &raRad,
+                                        const std::vector<double> &decRad,
+                                        const std::vector<double> &distance) {
+  if (!positionColumns)
+    return false;
+
+  double geogLongRad = DegreesToRadians(geogLongDeg);
+  double geogLatRad = DegreesToRadians(geogLatDeg);
+  std::vector<double> altitudeRad(raRad.size());
+  std::vector<double> azimuthRad(raRad.size());
+  for (std::size_t i = 0; i < raRad.size(); i++) {
+    double lstHours =
+        pa_raw::LocalSiderealTime(JulianDate(rowCount + i), geogLongRad);
+    pa_raw::HorizonCoordinates horizon = pa_raw::EquatorialToHorizon(
+        DegreesToRadians(lstHours * 15.0) - raRad[i], decRad[i], geogLatRad);
+
+    altitudeRad[i] = horizon.altitudeRad;
+    azimuthRad[i] = horizon.azimuthRad;
+  }
+
+  return AppendColumns({raRad, decRad, distance, altitudeRad, azimuthRad});
+}
+
+/**
+ * \brief Make room for more rows, moving the columns apart if need be.
+ *
+ * The file is extended rather than written, so on most file systems the
+ * room not yet used takes no space on disk.
+ */
+bool PAEphemerisWriter::Reserve(std::size_t rows) {
+  if (rowCount + rows <= rowCapacity)
+    return true;
+
+  std::size_t capacity =
+      std::max({rowCapacity * 2, rowCount + rows, kMinimumCapacity});
+  if (ftruncate(fd, dataOffset + columnCount * capacity * sizeof(double)) !=
+      0)
+    return false;
+
+  // Last column first, so none is overwritten before it has moved.
+  std::vector<double> column(rowCount);
+  for (std::size_t i = columnCount; i-- > 1 && rowCount > 0;) {
+    if (!ReadAt(fd, column.data(), rowCount * sizeof(double),
+                dataOffset + i * rowCapacity * sizeof(double)) ||
+        !WriteAt(fd, column.data(), rowCount * sizeof(double),
+                 dataOffset + i * capacity * sizeof(double)))
+      return false;
+  }
+
+  this->rowCapacity = capacity;
+  return WriteHeader();
+}
+
+/**
+ * \brief Write the row count and capacity to the file's header.
+ */
+bool PAEphemerisWriter::WriteHeader() {
+  uint64_t counts[2] = {rowCount, rowCapacity};
+  return WriteAt(fd, counts, sizeof(counts),
+                 offsetof(FileHeader, rowCount));
+}
+
+PAEphemerisTable::PAEphemerisTable() {
+  this->mapping = nullptr;
+  this->mappingBytes = 0;
+  this->rowCount = 0;
+  this->rowCapacity = 0;
+  this->dataOffset = 0;
+  this->geogLongDeg = 0.0;
+  this->geogLatDeg = 0.0;
+  this->startJulianDate = 0.0;
+  this->stepDays = 0.0;
+}
+
+PAEphemerisTable::~PAEphemerisTable() { Close(); }
+
+/**
+ * \brief Map a table into memory.
+ *
+ * Any table already open is closed first.
+ *
+ * @return false if the file could not be mapped, or was not written by
+ * PAEphemerisWriter on a machine with the same byte order.
+ */
+bool PAEphemerisTable::Open(const std::string &path) {
+  Close();
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || (std::size_t)info.st_size < sizeof(FileHeader)) {
+    close(fd);
+    return false;
+  }
+
+  void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED)
+    return false;
+
+  const FileHeader *header = static_cast<const FileHeader *>(mapped);
+  bool valid = memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+               header->byteOrder == kByteOrder &&
+               HoldsColumns(*header, info.st_size);
+  if (!valid) {
+    munmap(mapped, info.st_size);
+    return false;
+  }
+
+  const ColumnName *names = reinterpret_cast<const ColumnName *>(header + 1);
+  for (uint32_t i = 0; i < header->columnCount; i++)
+    this->columnNames.push_back(std::string(
+        names[i].name, strnlen(names[i].name, sizeof(names[i].name))));
+
+  this->mapping = mapped;
+  this->mappingBytes = info.st_size;
+  this->rowCount = header->rowCount;
+  this->rowCapacity = header->rowCapacity;
+  this->dataOffset = DataOffset(header->columnCount);
+  this->body =
+      std::string(header->body, strnlen(header->body, sizeof(header->body)));
+  this->geogLongDeg = header->geogLongDeg;
+  this->geogLatDeg = header->geogLatDeg;
+  this->startJulianDate = header->startJulianDate;
+  this->stepDays = header->stepDays;
+
+  return true;
+}
+
+/**
+ * \brief Unmap the table, if one is open.
+ */
+void PAEphemerisTable::Close() {
+  if (mapping != nullptr)
+    munmap(mapping, mappingBytes);
+
+  this->mapping = nullptr;
+  this->mappingBytes = 0;
+  this->rowCount = 0;
+  this->rowCapacity = 0;
+  this->dataOffset = 0;
+  this->body.clear();
+  this->geogLongDeg = 0.0;
+  this->geogLatDeg = 0.0;
+  this->startJulianDate = 0.0;
+  this->stepDays = 0.0;
+  this->columnNames.clear();
+}
+
+/**
+ * \brief A column, by its position in ColumnNames().
+ *
+ * @return An empty span if there is no such column.
+ */
+PAColumnSpan PAEphemerisTable::Column(std::size_t index) const {
+  if (mapping == nullptr || index >= columnNames.size())
+    return PAColumnSpan();
+
+  const char *first = static_cast<const char *>(mapping) + dataOffset +
+                      index * rowCapacity * sizeof(double);
+  return PAColumnSpan(reinterpret_cast<const double *>(first), rowCount);
+}
+
+/**
+ * \brief A column, by name.
+ *
+ * @return An empty span if there is no such column.
+ */
+PAColumnSpan PAEphemerisTable::Column(const std::string &name) const {
+  auto found = std::find(columnNames.begin(), columnNames.end(), name);
+  if (found == columnNames.end())
+    return PAColumnSpan();
+
+  return Column(found - columnNames.begin());
+}
@@ -0,0 +1,163 @@
+#ifndef _pa_ephemeris_table
+#define _pa_ephemeris_table
+
+#include "pa_raw.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Read-only view of one column of a PAEphemerisTable: contiguous
+ * doubles, one per row.
+ */
+class PAColumnSpan {
+public:
+  PAColumnSpan() : first(nullptr), count(0) {}
+  PAColumnSpan(const double *first, std::size_t count)
+      : first(first), count(count) {}
+
+  const double *data() const { return first; }
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  const double *begin() const { return first; }
+  const double *end() const { return first + count; }
+
+  double operator[](std::size_t row) const { return first[row]; }
+
+private:
+  const double *first;
+  std::size_t count;
+};
+
+/**
+ * \brief Writes an ephemeris table: rows at equal steps of time from a
+ * starting instant, stored as one contiguous column of doubles per
+ * quantity.
+ *
+ * The header names the body, the observing site, the time base (a Julian
+ * date, UT) and the step, and the columns. Each column has room for a
+ * number of rows (the capacity); appending past it moves the columns apart
+ * to make room for twice as many, so appending is cheap on average and a
+ * column stays contiguous in the file for PAEphemerisTable to map.
+ *
+ * A table must not be appended to while it is open in a PAEphemerisTable.
+ */
+class PAEphemerisWriter {
+public:
+  PAEphemerisWriter();
+  ~PAEphemerisWriter();
+
+  PAEphemerisWriter(const PAEphemerisWriter &) = delete;
+  PAEphemerisWriter &operator=(const PAEphemerisWriter &) = delete;
+
+  static std::vector<std::string> PositionColumns();
+
+  bool Create(const std::string &path, const std::string &body,
+              double geogLongDeg, double geogLatDeg, double startJulianDate,
+              double stepDays,
+              const std::vector<std::string> &columnNames = PositionColumns());
+
+  bool Open(const std::string &path);
+
+  void Close();
+
+  bool IsOpen() const { return fd >= 0; }
+
+  /** Rows written so far. */
+  std::size_t size() const { return rowCount; }
+
+  /** Julian date (UT) of a row. */
+  double JulianDate(std::size_t row) const {
+    return startJulianDate + stepDays * row;
+  }
+
+  bool AppendColumns(const std::vector<std::vector<double>> &columns);
+
+  bool Append(const std::vector<pa_raw::SunPosition> &positions);
+
+  bool Append(const std::vector<pa_raw::MoonPosition> &positions);
+
+  bool Append(const std::vector<pa_raw::PlanetPosition> &positions);
+
+  bool Append(const std::vector<pa_raw::CometPosition> &positions);
+
+private:
+  bool AppendPositions(const std::vector<double> &raRad,
+                       const std::vector<double> &decRad,
+                       const std::vector<double> &distance);
+
+  bool Reserve(std::size_t rows);
+
+  bool WriteHeader();
+
+  int fd;
+  std::size_t columnCount;
+  std::size_t rowCount;
+  std::size_t rowCapacity;
+  std::size_t dataOffset;
+  double geogLongDeg;
+  double geogLatDeg;
+  double startJulianDate;
+  double stepDays;
+  bool positionColumns;
+};
+
+/**
+ * \brief An ephemeris table written by PAEphemerisWriter, mapped into
+ * memory.
+ *
+ * Opening reads only the header; the columns are handed out as spans of
+ * the mapping, so nothing is parsed or copied however many rows there are.
+ * A table written by a machine with another byte order is not opened.
+ */
+class PAEphemerisTable {
+public:
+  PAEphemerisTable();
+  ~PAEphemerisTable();
+
+  PAEphemerisTable(const PAEphemerisTable &) = delete;
+  PAEphemerisTable &operator=(const PAEphemerisTable &) = delete;
+
+  bool Open(const std::string &path);
+
+  void Close();
+
+  bool IsOpen() const { return mapping != nullptr; }
+
+  /** Number of rows. */
+  std::size_t size() const { return rowCount; }
+
+  const std::string &Body() const { return body; }
+  double GeogLongDeg() const { return geogLongDeg; }
+  double GeogLatDeg() const { return geogLatDeg; }
+  double StartJulianDate() const { return startJulianDate; }
+  double StepDays() const { return stepDays; }
+
+  /** Julian date (UT) of a row. */
+  double JulianDate(std::size_t row) const {
+    return startJulianDate + stepDays * row;
+  }
+
+  const std::vector<std::string> &ColumnNames() const { return columnNames; }
+
+  PAColumnSpan Column(std::size_t index) const;
+
+  PAColumnSpan Column(const std::string &name) const;
+
+private:
+  void *mapping;
+  std::size_t mappingBytes;
+  std::size_t rowCount;
+  std::size_t rowCapacity;
+  std::size_t dataOffset;
+  std::string body;
+  double geogLongDeg;
+  double geogLatDeg;
+  double startJulianDate;
+  double stepDays;
+  std::vector<std::string> columnNames;
+};
+
+#endif
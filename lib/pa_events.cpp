@@ -0,0 +1,405 @@
+#include "pa_events.h"
+#include "pa_macros.h"
+#include "pa_models.h"
+#include "pa_parallel.h"
+#include "pa_types.h"
+#include "pa_util.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace pa_types;
+using namespace pa_models;
+using namespace pa_util;
+using namespace pa_macros;
+
+namespace {
+/**
+ * \brief Search parameters for one planet.
+ */
+struct PlanetEventInfo {
+  std::string name;
+  bool inferior;            /**< Orbit inside the Earth's orbit */
+  double synodicPeriodDays; /**< Mean time between conjunctions */
+  double maxElongationRate; /**< Bound on |d(elongation)/dt|, deg per day */
+};
+
+const PlanetEventInfo kPlanetEventInfo[] = {
+    {"Mercury", true, 115.88, 3.6},  {"Venus", true, 583.92, 2.5},
+    {"Mars", false, 779.94, 1.8},    {"Jupiter", false, 398.88, 1.5},
+    {"Saturn", false, 378.09, 1.5},  {"Uranus", false, 369.66, 1.5},
+    {"Neptune", false, 367.49, 1.5},
+};
+
+/** Length of the time chunks searched in parallel, in days. */
+const double kChunkDays = 3652.5;
+
+/** Half-width of the difference used for the rate of longitude, in days. */
+const double kRateStepDays = 0.05;
+
+/**
+ * \brief Wrap an angle into (-180, 180] degrees.
+ */
+double Wrap180(double angleDeg) {
+  return angleDeg - 360 * ceil((angleDeg - 180) / 360);
+}
+
+CPlanetCoordinates PlanetAt(const std::string &planetName,
+                            double julianDate) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+
+  return PlanetCoordinates(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year,
+                           planetName);
+}
+
+double SunLongitudeAt(double julianDate) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+
+  return SunLong(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year);
+}
+
+/**
+ * \brief Search one planet over one chunk of time, keeping events that fall
+ * in [chunkStart, chunkEnd).
+ */
+std::vector<CPlanetaryEvent> SearchChunk(const PAEvents &events,
+                                         const PlanetEventInfo &info,
+                                         double chunkStart, double chunkEnd) {
+  std::vector<CPlanetaryEvent> found;
+  const std::string &name = info.name;
+
+  // Elongation in longitude, measured from the Sun (east positive).
+  auto elongation = [&name](double jd) {
+    return Wrap180(PlanetAt(name, jd).planetLongitude - SunLongitudeAt(jd));
+  };
+  auto oppositionOffset = [&elongation](double jd) {
+    return Wrap180(elongation(jd) - 180);
+  };
+  auto separation = [&name](double jd) {
+    CPlanetCoordinates planet = PlanetAt(name, jd);
+    double dLong =
+        DegreesToRadians(planet.planetLongitude - SunLongitudeAt(jd));
+    double lat = DegreesToRadians(planet.planetLatitude);
+
+    return WToDegrees(acos(cos(lat) * cos(dLong)));
+  };
+  auto longitudeRate = [&name](double jd) {
+    return Wrap180(PlanetAt(name, jd + kRateStepDays).planetLongitude -
+                   PlanetAt(name, jd - kRateStepDays).planetLongitude) /
+           (2 * kRateStepDays);
+  };
+
+  // Extrema and stations need a sample either side of each point, so their
+  // searches start and end one step outside the chunk.
+  double extremumStep = info.synodicPeriodDays / 40;
+  double paddedStart = chunkStart - extremumStep;
+  double paddedEnd = chunkEnd + extremumStep;
+  auto keep = [chunkStart, chunkEnd](double jd) {
+    return jd >= chunkStart && jd < chunkEnd;
+  };
+
+  for (const CScalarEvent &e :
+       events.ZeroCrossings(elongation, chunkStart, chunkEnd, 1.0,
+                            info.maxElongationRate, true)) {
+    EPlanetaryEventType type = EPlanetaryEventType::Conjunction;
+    CPlanetCoordinates planet = PlanetAt(name, e.julianDate);
+
+    if (info.inferior)
+      type = (planet.planetDistanceAU < 1.0)
+                 ? EPlanetaryEventType::InferiorConjunction
+                 : EPlanetaryEventType::SuperiorConjunction;
+    found.push_back(
+        CPlanetaryEvent(type, name, e.julianDate, separation(e.julianDate)));
+  }
+
+  if (info.inferior) {
+    for (const CScalarEvent &e : events.Extrema(separation, paddedStart,
+                                                paddedEnd, extremumStep)) {
+      if (e.direction < 0 || !keep(e.julianDate))
+        continue;
+
+      found.push_back(
+          CPlanetaryEvent((elongation(e.julianDate) > 0)
+                              ? EPlanetaryEventType::GreatestElongationEast
+                              : EPlanetaryEventType::GreatestElongationWest,
+                          name, e.julianDate, e.value));
+    }
+  } else {
+    for (const CScalarEvent &e :
+         events.ZeroCrossings(oppositionOffset, chunkStart, chunkEnd, 1.0,
+                              info.maxElongationRate, true))
+      found.push_back(CPlanetaryEvent(EPlanetaryEventType::Opposition, name,
+                                      e.julianDate,
+                                      separation(e.julianDate)));
+  }
+
+  for (const CScalarEvent &e : events.ZeroCrossings(
+           longitudeRate, paddedStart, paddedEnd, extremumStep)) {
+    if (!keep(e.julianDate))
+      continue;
+
+    found.push_back(CPlanetaryEvent(
+        (e.direction < 0) ? EPlanetaryEventType::StationaryRetrograde
+                          : EPlanetaryEventType::StationaryDirect,
+        name, e.julianDate, PlanetAt(name, e.julianDate).planetLongitude));
+  }
+
+  return found;
+}
+} // namespace
+
+PAEvents::PAEvents() { this->toleranceDays = 1.0 / 1440.0; }
+
+/**
+ * \brief Find the times at which a function of time crosses zero.
+ *
+ * The function is sampled from startJulianDate to endJulianDate and each sign
+ * change is refined to toleranceDays. When maxRatePerDay (a bound on the rate
+ * of change of f) is given, the search steps ahead by |f| / maxRatePerDay,
+ * the closest a root can be, but never by less than stepDays; otherwise it
+ * steps by stepDays.
+ *
+ * @param isAngleDeg f returns an angle in (-180, 180] degrees; jumps across
+ * +/-180 are not counted as crossings.
+ *
+ * @return Crossings in time order (direction +1 rising, -1 falling).
+ */
+std::vector<CScalarEvent>
+PAEvents::ZeroCrossings(const std::function<double(double)> &f,
+                        double startJulianDate, double endJulianDate,
+                        double stepDays, double maxRatePerDay,
+                        bool isAngleDeg) const {
+  std::vector<CScalarEvent> crossings;
+  double t = startJulianDate;
+  double ft = f(t);
+
+  while (t < endJulianDate) {
+    double step = stepDays;
+    if (maxRatePerDay > 0)
+      step = std::max(stepDays, std::abs(ft) / maxRatePerDay);
+
+    double tNext = std::min(t + step, endJulianDate);
+    double fNext = f(tNext);
+    bool signChange = (ft < 0) != (fNext < 0);
+
+    if (signChange && !(isAngleDeg && std::abs(fNext - ft) > 180)) {
+      double root = RefineCrossing(f, t, ft, tNext, fNext, toleranceDays);
+
+      crossings.push_back(CScalarEvent(root, f(root), (fNext > ft) ? 1 : -1));
+    }
+
+    t = tNext;
+    ft = fNext;
+  }
+
+  return crossings;
+}
+
+/**
+ * \brief Find the local maxima and minima of a function of time.
+ *
+ * The function is sampled every stepDays; each sample that is above (or
+ * below) both neighbours is refined to toleranceDays. The step must be short
+ * enough that no two extrema of the same kind fall within two steps.
+ *
+ * @param isAngleDeg f returns an angle in (-180, 180] degrees.
+ *
+ * @return Extrema in time order (direction +1 maximum, -1 minimum).
+ */
+std::vector<CScalarEvent>
+PAEvents::Extrema(const std::function<double(double)> &f,
+                  double startJulianDate, double endJulianDate,
+                  double stepDays, bool isAngleDeg) const {
+  std::vector<CScalarEvent> extrema;
+  int steps = std::max(
+      2, (int)ceil((endJulianDate - startJulianDate) / stepDays));
+  double step = (endJulianDate - startJulianDate) / steps;
+
+  std::vector<double> samples(steps + 1);
+  for (int i = 0; i <= steps; i++)
+    samples[i] = f(startJulianDate + i * step);
+
+  for (int i = 1; i < steps; i++) {
+    double center = samples[i];
+    double before = samples[i - 1] - center;
+    double after = samples[i + 1] - center;
+    if (isAngleDeg) {
+      before = Wrap180(before);
+      after = Wrap180(after);
+    }
+
+    double sign = 0;
+    if (before < 0 && after <= 0)
+      sign = 1;
+    if (before > 0 && after >= 0)
+      sign = -1;
+    if (sign == 0)
+      continue;
+
+    // Measure relative to the centre sample, so angles do not wrap.
+    std::function<double(double)> g = f;
+    if (isAngleDeg)
+      g = [&f, center](double jd) { return center + Wrap180(f(jd) - center); };
+
+    double tCenter = startJulianDate + i * step;
+    double tExtremum = RefineExtremum(g, tCenter - step, tCenter + step, sign,
+                                      toleranceDays);
+
+    extrema.push_back(CScalarEvent(tExtremum, f(tExtremum), (int)sign));
+  }
+
+  return extrema;
+}
+
+/**
+ * \brief Find conjunctions, oppositions, greatest elongations and stationary
+ * points of planets.
+ *
+ * Conjunctions and oppositions are zero crossings of the elongation in
+ * longitude from the Sun, stepped adaptively using a bound on its rate.
+ * Greatest elongations are maxima of the angular separation from the Sun, and
+ * stations are zero crossings of the rate of geocentric longitude, both
+ * sampled at a fixed fraction of the synodic period. The search is split into
+ * one task per planet and ten-year chunk, run on a pool of threads.
+ *
+ * @param planetNames Planets to search (Mercury to Neptune); unknown names
+ * are ignored.
+ * @param threadCount Number of worker threads (0 for one per hardware thread).
+ *
+ * @return Events sorted by time.
+ */
+std::vector<CPlanetaryEvent>
+PAEvents::PlanetaryEvents(const std::vector<std::string> &planetNames,
+                          double startJulianDate, double endJulianDate,
+                          int threadCount) const {
+  PATaskPool pool(threadCount);
+  return PlanetaryEvents(planetNames, startJulianDate, endJulianDate, pool);
+}
+
+/**
+ * \brief As above, with the tasks run on a pool the caller keeps.
+ */
+std::vector<CPlanetaryEvent>
+PAEvents::PlanetaryEvents(const std::vector<std::string> &planetNames,
+                          double startJulianDate, double endJulianDate,
+                          PATaskPool &pool) const {
+  struct Task {
+    const PlanetEventInfo *info;
+    double start;
+    double end;
+  };
+
+  std::vector<Task> tasks;
+  for (const std::string &planetName : planetNames)
+    for (const PlanetEventInfo &info : kPlanetEventInfo) {
+      if (info.name != planetName)
+        continue;
+
+      for (double start = startJulianDate; start < endJulianDate;
+           start += kChunkDays)
+        tasks.push_back(
+            {&info, start, std::min(start + kChunkDays, endJulianDate)});
+    }
+
+  std::vector<std::vector<CPlanetaryEvent>> results(tasks.size());
+  pool.Run(tasks.size(), [&](std::size_t i, int) {
+    results[i] =
+        SearchChunk(*this, *tasks[i].info, tasks[i].start, tasks[i].end);
+  });
+
+  std::vector<CPlanetaryEvent> events;
+  for (const std::vector<CPlanetaryEvent> &result : results)
+    events.insert(events.end(), result.begin(), result.end());
+  std::stable_sort(events.begin(), events.end(),
+                   [](const CPlanetaryEvent &a, const CPlanetaryEvent &b) {
+                     return a.julianDate < b.julianDate;
+                   });
+
+  // A crossing that straddles a chunk boundary can be found from both sides.
+  std::vector<CPlanetaryEvent> unique;
+  for (const CPlanetaryEvent &event : events) {
+    bool duplicate = false;
+
+    for (auto it = unique.rbegin();
+         it != unique.rend() && event.julianDate - it->julianDate < 1.0; ++it)
+      if (it->planetName == event.planetName &&
+          it->eventType == event.eventType)
+        duplicate = true;
+    if (!duplicate)
+      unique.push_back(event);
+  }
+
+  return unique;
+}
+
+/**
+ * \brief Refine a sign change of f in [a, b] (Illinois variant of regula
+ * falsi).
+ *
+ * @return Root, to within toleranceDays.
+ */
+double PAEvents::RefineCrossing(const std::function<double(double)> &f,
+                                double a, double fa, double b, double fb,
+                                double toleranceDays) {
+  int side = 0;
+
+  for (int i = 0; i < 100 && std::abs(b - a) > toleranceDays; i++) {
+    double c = (a * fb - b * fa) / (fb - fa);
+    double fc = f(c);
+
+    if (fc == 0)
+      return c;
+    if ((fc > 0) == (fb > 0)) {
+      b = c;
+      fb = fc;
+      if (side == -1)
+        fa /= 2;
+      side = -1;
+    } else {
+      a = c;
+      fa = fc;
+      if (side == 1)
+        fb /= 2;
+      side = 1;
+    }
+  }
+
+  return (a + b) / 2;
+}
+
+/**
+ * \brief Locate the extremum of f in [a, b] (golden-section search).
+ *
+ * @param sign 1 to find a maximum, -1 to find a minimum.
+ *
+ * @return Time of the extremum, to within toleranceDays.
+ */
+double PAEvents::RefineExtremum(const std::function<double(double)> &f,
+                                double a, double b, double sign,
+                                double toleranceDays) {
+  const double r = 0.6180339887498949;
+  double c = b - r * (b - a);
+  double d = a + r * (b - a);
+  double fc = sign * f(c);
+  double fd = sign * f(d);
+
+  while (std::abs(b - a) > toleranceDays) {
+    if (fc > fd) {
+      b = d;
+      d = c;
+      fd = fc;
+      c = b - r * (b - a);
+      fc = sign * f(c);
+    } else {
+      a = c;
+      c = d;
+      fc = fd;
+      d = a + r * (b - a);
+      fd = sign * f(d);
+    }
+  }
+
+  return (a + b) / 2;
+}
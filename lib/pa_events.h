@@ -0,0 +1,56 @@
+#ifndef _pa_events
+#define _pa_events
+
+#include "pa_models.h"
+#include "pa_parallel.h"
+#include "pa_types.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace pa_models;
+using namespace pa_types;
+
+/**
+ * \brief Search for the times at which functions of time cross zero or reach
+ * an extremum, and for planetary events built on them.
+ *
+ * Times are Julian dates (UT).
+ */
+class PAEvents {
+public:
+  PAEvents();
+
+  std::vector<CScalarEvent>
+  ZeroCrossings(const std::function<double(double)> &f, double startJulianDate,
+                double endJulianDate, double stepDays,
+                double maxRatePerDay = 0, bool isAngleDeg = false) const;
+
+  std::vector<CScalarEvent> Extrema(const std::function<double(double)> &f,
+                                    double startJulianDate,
+                                    double endJulianDate, double stepDays,
+                                    bool isAngleDeg = false) const;
+
+  std::vector<CPlanetaryEvent>
+  PlanetaryEvents(const std::vector<std::string> &planetNames,
+                  double startJulianDate, double endJulianDate,
+                  int threadCount = 0) const;
+
+  std::vector<CPlanetaryEvent>
+  PlanetaryEvents(const std::vector<std::string> &planetNames,
+                  double startJulianDate, double endJulianDate,
+                  PATaskPool &pool) const;
+
+  static double RefineCrossing(const std::function<double(double)> &f,
+                               double a, double fa, double b, double fb,
+                               double toleranceDays);
+
+  static double RefineExtremum(const std::function<double(double)> &f,
+                               double a, double b, double sign,
+                               double toleranceDays);
+
+  /** Accuracy of refined event times, in days. */
+  double toleranceDays;
+};
+
+#endif
@@ -0,0 +1,235 @@
+#include "pa_instrument.h"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace pa_instrument {
+namespace {
+const int kFunctionCount = static_cast<int>(EFunction::Count);
+
+const char *const kFunctionNames[kFunctionCount] = {
+    "SunLong",
+    "MoonLongLatHP",
+    "PlanetCoordinates",
+    "NutatLong",
+    "LocalCivilTimeGreenwichDay",
+    "LocalCivilTimeGreenwichMonth",
+    "LocalCivilTimeGreenwichYear",
+    "TrueAnomaly",
+    "SolveCubic",
+    "MoonRiseLCT",
+    "MoonRiseLCDMY",
+    "MoonRiseAz",
+    "MoonSetLCT",
+    "MoonSetLCDMY",
+    "MoonSetAz",
+    "MoonRiseSetEvent"};
+
+/**
+ * Counters for one function. Only the owning thread writes them; Snapshot()
+ * and Reset() read and clear them from other threads, so they are atomics
+ * used with relaxed ordering, which costs no more than plain loads and
+ * stores.
+ */
+struct Counter {
+  std::atomic<std::uint64_t> calls;
+  std::atomic<std::uint64_t> totalNs;
+  std::atomic<std::uint64_t> maxNs;
+  std::atomic<std::uint64_t> iterations;
+};
+
+void Add(std::atomic<std::uint64_t> &value, std::uint64_t amount) {
+  value.store(value.load(std::memory_order_relaxed) + amount,
+              std::memory_order_relaxed);
+}
+
+struct ThreadTable;
+
+/**
+ * Tables of the live threads, and the totals of threads that have exited.
+ * Never destroyed, so threads may exit during static destruction.
+ */
+struct Registry {
+  std::mutex mutex;
+  std::vector<ThreadTable *> tables;
+  FunctionStats retired[kFunctionCount];
+};
+
+Registry &GlobalRegistry() {
+  static Registry *registry = new Registry();
+
+  return *registry;
+}
+
+struct ThreadTable {
+  Counter counters[kFunctionCount];
+
+  ThreadTable() {
+    for (Counter &counter : counters) {
+      counter.calls = 0;
+      counter.totalNs = 0;
+      counter.maxNs = 0;
+      counter.iterations = 0;
+    }
+
+    Registry &registry = GlobalRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.tables.push_back(this);
+  }
+
+  ~ThreadTable() {
+    Registry &registry = GlobalRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (int i = 0; i < kFunctionCount; i++) {
+      FunctionStats &total = registry.retired[i];
+      total.calls += counters[i].calls;
+      total.totalNs += counters[i].totalNs;
+      total.maxNs = std::max<std::uint64_t>(total.maxNs, counters[i].maxNs);
+      total.iterations += counters[i].iterations;
+    }
+
+    registry.tables.erase(
+        std::find(registry.tables.begin(), registry.tables.end(), this));
+  }
+};
+
+Counter &ThisThreadCounter(EFunction function) {
+  thread_local ThreadTable table;
+
+  return table.counters[static_cast<int>(function)];
+}
+} // namespace
+
+/**
+ * \brief Whether the library was built with PA_INSTRUMENT.
+ */
+bool IsEnabled() {
+#ifdef PA_INSTRUMENT
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * \brief Name of an instrumented function, as it appears in the dumps.
+ */
+const char *FunctionName(EFunction function) {
+  return kFunctionNames[static_cast<int>(function)];
+}
+
+/**
+ * \brief Totals for every instrumented function, over all threads (live and
+ * exited) since the last Reset(). One entry per EFunction, in order.
+ */
+std::vector<FunctionStats> Snapshot() {
+  Registry &registry = GlobalRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::vector<FunctionStats> stats(kFunctionCount);
+
+  for (int i = 0; i < kFunctionCount; i++) {
+    stats[i] = registry.retired[i];
+    stats[i].name = kFunctionNames[i];
+
+    for (const ThreadTable *table : registry.tables) {
+      const Counter &counter = table->counters[i];
+      stats[i].calls += counter.calls.load(std::memory_order_relaxed);
+      stats[i].totalNs += counter.totalNs.load(std::memory_order_relaxed);
+      stats[i].maxNs = std::max<std::uint64_t>(
+          stats[i].maxNs, counter.maxNs.load(std::memory_order_relaxed));
+      stats[i].iterations +=
+          counter.iterations.load(std::memory_order_relaxed);
+    }
+  }
+
+  return stats;
+}
+
+/**
+ * \brief Zero all counters. Counts made by other threads while this runs may
+ * survive it, so call it between runs.
+ */
+void Reset() {
+  Registry &registry = GlobalRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  for (int i = 0; i < kFunctionCount; i++) {
+    registry.retired[i] = FunctionStats();
+
+    for (ThreadTable *table : registry.tables) {
+      Counter &counter = table->counters[i];
+      counter.calls.store(0, std::memory_order_relaxed);
+      counter.totalNs.store(0, std::memory_order_relaxed);
+      counter.maxNs.store(0, std::memory_order_relaxed);
+      counter.iterations.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+/**
+ * \brief One line per function that was called: calls, total, mean and
+ * maximum time, and iterations.
+ */
+std::string ToText(const std::vector<FunctionStats> &stats) {
+  std::ostringstream text;
+  text << std::left << std::setw(30) << "function" << std::right
+       << std::setw(12) << "calls" << std::setw(16) << "total ns"
+       << std::setw(12) << "mean ns" << std::setw(12) << "max ns"
+       << std::setw(12) << "iterations" << "\n";
+
+  for (const FunctionStats &entry : stats) {
+    if (entry.calls == 0 && entry.iterations == 0)
+      continue;
+
+    text << std::left << std::setw(30) << entry.name << std::right
+         << std::setw(12) << entry.calls << std::setw(16) << entry.totalNs
+         << std::setw(12) << (entry.calls ? entry.totalNs / entry.calls : 0)
+         << std::setw(12) << entry.maxNs << std::setw(12) << entry.iterations
+         << "\n";
+  }
+
+  return text.str();
+}
+
+/**
+ * \brief All functions as a JSON array of objects with name, calls,
+ * totalNs, maxNs and iterations.
+ */
+std::string ToJson(const std::vector<FunctionStats> &stats) {
+  std::ostringstream json;
+  json << "[";
+
+  for (std::size_t i = 0; i < stats.size(); i++) {
+    json << (i ? ",\n " : "\n ") << "{\"name\": \"" << stats[i].name
+         << "\", \"calls\": " << stats[i].calls
+         << ", \"totalNs\": " << stats[i].totalNs
+         << ", \"maxNs\": " << stats[i].maxNs
+         << ", \"iterations\": " << stats[i].iterations << "}";
+  }
+  json << "\n]\n";
+
+  return json.str();
+}
+
+/**
+ * \brief Count one call of function on this thread, taking elapsedNs.
+ */
+void Record(EFunction function, std::uint64_t elapsedNs) {
+  Counter &counter = ThisThreadCounter(function);
+
+  Add(counter.calls, 1);
+  Add(counter.totalNs, elapsedNs);
+  if (elapsedNs > counter.maxNs.load(std::memory_order_relaxed))
+    counter.maxNs.store(elapsedNs, std::memory_order_relaxed);
+}
+
+/**
+ * \brief Count loop passes of an iterative function on this thread.
+ */
+void AddIterations(EFunction function, std::uint64_t iterations) {
+  Add(ThisThreadCounter(function).iterations, iterations);
+}
+} // namespace pa_instrument
@@ -0,0 +1,98 @@
+#ifndef _pa_instrument
+#define _pa_instrument
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Call counts and timings for the hot pa_macros helpers.
+ *
+ * Compiled in only when PA_INSTRUMENT is defined (for example
+ * `make test OPT_FLAGS=-DPA_INSTRUMENT`); otherwise the PA_INSTRUMENT_*
+ * macros expand to nothing and Snapshot() reports zeros. Each thread counts
+ * into its own thread-local table, so instrumented code takes no locks.
+ * Timings are inclusive: SunLong's time includes the NutatLong it calls.
+ */
+namespace pa_instrument {
+
+enum class EFunction {
+  SunLong,
+  MoonLongLatHP,
+  PlanetCoordinates,
+  NutatLong,
+  LocalCivilTimeGreenwichDay,
+  LocalCivilTimeGreenwichMonth,
+  LocalCivilTimeGreenwichYear,
+  TrueAnomaly,
+  SolveCubic,
+  MoonRiseLCT,
+  MoonRiseLCDMY,
+  MoonRiseAz,
+  MoonSetLCT,
+  MoonSetLCDMY,
+  MoonSetAz,
+  MoonRiseSetEvent,
+  Count
+};
+
+struct FunctionStats {
+  std::string name;
+  std::uint64_t calls = 0;
+  std::uint64_t totalNs = 0;
+  std::uint64_t maxNs = 0;
+  std::uint64_t iterations = 0; /**< Loop passes of iterative solvers. */
+};
+
+bool IsEnabled();
+
+const char *FunctionName(EFunction function);
+
+std::vector<FunctionStats> Snapshot();
+
+void Reset();
+
+std::string ToText(const std::vector<FunctionStats> &stats);
+
+std::string ToJson(const std::vector<FunctionStats> &stats);
+
+void Record(EFunction function, std::uint64_t elapsedNs);
+
+void AddIterations(EFunction function, std::uint64_t iterations);
+
+/**
+ * \brief Times the enclosing scope, and records it as one call of function.
+ */
+class ScopedTimer {
+public:
+  explicit ScopedTimer(EFunction function)
+      : function(function), start(std::chrono::steady_clock::now()) {}
+
+  ~ScopedTimer() {
+    Record(function, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count());
+  }
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+  EFunction function;
+  std::chrono::steady_clock::time_point start;
+};
+} // namespace pa_instrument
+
+#ifdef PA_INSTRUMENT
+#define PA_INSTRUMENT_SCOPE(function)                                          \
+  pa_instrument::ScopedTimer paInstrumentScope(                                \
+      pa_instrument::EFunction::function)
+#define PA_INSTRUMENT_ITERATIONS(function, count)                              \
+  pa_instrument::AddIterations(pa_instrument::EFunction::function, count)
+#else
+#define PA_INSTRUMENT_SCOPE(function) ((void)0)
+#define PA_INSTRUMENT_ITERATIONS(function, count) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,386 @@
+#include "pa_lunation_cache.h"
+#include "pa_eclipses.h"
+#include "pa_macros.h"
+#include "pa_models.h"
+#include "pa_util.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace pa_models;
+using namespace pa_util;
+
+namespace {
+/**
+ * \brief File header.
+ */
+struct FileHeader {
+  char magic[8];             /**< "PALUNCAC" */
+  uint32_t byteOrder;        /**< kByteOrder, as written by this machine */
+  uint32_t recordSize;       /**< sizeof(LunationRecord) */
+  uint32_t algorithmVersion; /**< PALunationCache::kAlgorithmVersion */
+  int32_t firstYear;         /**< First year of the span */
+  int32_t lastYear;          /**< Last year of the span */
+  uint32_t count;            /**< Number of records */
+  double geogLongDeg;        /**< Site of the solar eclipse columns */
+  double geogLatDeg;
+};
+
+/**
+ * \brief One lunation. Times are UT hours on the Greenwich date of the new
+ * (solar) or full (lunar) Moon, or -99 where there is no such contact.
+ */
+struct LunationRecord {
+  double lunation;           /**< As from pa_macros::LunationNumber */
+  double newMoonJulianDate;  /**< As from pa_macros::NewMoon */
+  double fullMoonJulianDate; /**< As from pa_macros::FullMoon */
+  double lunarUt[7];         /**< First contact .. last contact */
+  double lunarMagnitude;
+  double solarUt[3]; /**< First contact, maximum, last contact */
+  double solarMagnitude;
+};
+
+static_assert(sizeof(FileHeader) == 48, "FileHeader must be packed");
+static_assert(sizeof(LunationRecord) == 120, "LunationRecord must be packed");
+
+const char kMagic[8] = {'P', 'A', 'L', 'U', 'N', 'C', 'A', 'C'};
+const uint32_t kByteOrder = 0x01020304;
+
+enum ELunarContact {
+  FirstContact,
+  StartUmbra,
+  StartTotal,
+  MaxEclipse,
+  EndTotal,
+  EndUmbra,
+  LastContact
+};
+
+/**
+ * \brief Tabulate the lunation that a Greenwich date falls in.
+ */
+LunationRecord MakeRecord(double lunation, double dy, int mn, int yr,
+                          double glong, double glat) {
+  LunationRecord record;
+  record.lunation = lunation;
+  record.newMoonJulianDate = pa_macros::NewMoon(0, 0, dy, mn, yr);
+  record.fullMoonJulianDate = pa_macros::FullMoon(0, 0, dy, mn, yr);
+
+  record.lunarUt[FirstContact] =
+      pa_macros::UTFirstContactLunarEclipse(dy, mn, yr, 0, 0);
+  record.lunarUt[StartUmbra] =
+      pa_macros::UTStartUmbraLunarEclipse(dy, mn, yr, 0, 0);
+  record.lunarUt[StartTotal] =
+      pa_macros::UTStartTotalLunarEclipse(dy, mn, yr, 0, 0);
+  record.lunarUt[MaxEclipse] = pa_macros::UTMaxLunarEclipse(dy, mn, yr, 0, 0);
+  record.lunarUt[EndTotal] =
+      pa_macros::UTEndTotalLunarEclipse(dy, mn, yr, 0, 0);
+  record.lunarUt[EndUmbra] =
+      pa_macros::UTEndUmbraLunarEclipse(dy, mn, yr, 0, 0);
+  record.lunarUt[LastContact] =
+      pa_macros::UTLastContactLunarEclipse(dy, mn, yr, 0, 0);
+  record.lunarMagnitude = pa_macros::MagLunarEclipse(dy, mn, yr, 0, 0);
+
+  record.solarUt[0] =
+      pa_macros::UTFirstContactSolarEclipse(dy, mn, yr, 0, 0, glong, glat);
+  record.solarUt[1] =
+      pa_macros::UTMaxSolarEclipse(dy, mn, yr, 0, 0, glong, glat);
+  record.solarUt[2] =
+      pa_macros::UTLastContactSolarEclipse(dy, mn, yr, 0, 0, glong, glat);
+  record.solarMagnitude =
+      pa_macros::MagSolarEclipse(dy, mn, yr, 0, 0, glong, glat);
+
+  return record;
+}
+
+/**
+ * \brief Local civil date of a new or full Moon, as PAEclipses finds it.
+ */
+void LocalCivilDate(double julianDate, int ds, int zc, double &day,
+                    int &month, int &year) {
+  double gDay = pa_macros::JulianDateDay(julianDate);
+  double integerDay = floor(gDay);
+  int gMonth = pa_macros::JulianDateMonth(julianDate);
+  int gYear = pa_macros::JulianDateYear(julianDate);
+  double ut = gDay - integerDay;
+
+  day = pa_macros::UniversalTimeLocalCivilDay(ut, 0.0, 0.0, ds, zc,
+                                              integerDay, gMonth, gYear);
+  month = pa_macros::UniversalTimeLocalCivilMonth(ut, 0.0, 0.0, ds, zc,
+                                                  integerDay, gMonth, gYear);
+  year = pa_macros::UniversalTimeLocalCivilYear(ut, 0.0, 0.0, ds, zc,
+                                                integerDay, gMonth, gYear);
+}
+
+double UtHour(double ut) {
+  return (ut == -99.0) ? -99.0 : pa_macros::DecimalHoursHour(ut + 0.008333);
+}
+
+double UtMinutes(double ut) {
+  return (ut == -99.0) ? -99.0 : pa_macros::DecimalHoursMinute(ut + 0.008333);
+}
+} // namespace
+
+PALunationCache::PALunationCache() {
+  this->mapping = nullptr;
+  this->mappingBytes = 0;
+  this->records = nullptr;
+  this->count = 0;
+  this->geogLongDeg = 0.0;
+  this->geogLatDeg = 0.0;
+}
+
+PALunationCache::~PALunationCache() { Close(); }
+
+/**
+ * \brief Tabulate every lunation that begins in a span of years, and write
+ * the table to a file.
+ *
+ * Solar eclipse circumstances are tabulated for one site; queries for any
+ * other site are computed.
+ *
+ * @param firstYear First year of the span.
+ * @param lastYear Last year of the span (inclusive).
+ *
+ * @return Number of lunations written, or -1 if the span is empty or the
+ * file could not be written.
+ */
+int PALunationCache::Generate(const std::string &path, int firstYear,
+                              int lastYear, double geogLongDeg,
+                              double geogLatDeg) {
+  if (lastYear < firstYear)
+    return -1;
+
+  std::vector<LunationRecord> lunations;
+  double firstDate = pa_macros::CivilDateToJulianDate(1, 1, firstYear);
+  double endDate = pa_macros::CivilDateToJulianDate(1, 1, lastYear + 1);
+  for (double julianDate = firstDate; julianDate < endDate; julianDate++) {
+    double dy = pa_macros::JulianDateDay(julianDate);
+    int mn = pa_macros::JulianDateMonth(julianDate);
+    int yr = pa_macros::JulianDateYear(julianDate);
+
+    double lunation = pa_macros::LunationNumber(0, 0, dy, mn, yr);
+    if (!lunations.empty() && lunation <= lunations.back().lunation)
+      continue;
+
+    lunations.push_back(
+        MakeRecord(lunation, dy, mn, yr, geogLongDeg, geogLatDeg));
+  }
+
+  FileHeader header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.byteOrder = kByteOrder;
+  header.recordSize = sizeof(LunationRecord);
+  header.algorithmVersion = kAlgorithmVersion;
+  header.firstYear = firstYear;
+  header.lastYear = lastYear;
+  header.count = lunations.size();
+  header.geogLongDeg = geogLongDeg;
+  header.geogLatDeg = geogLatDeg;
+
+  std::ofstream output(path, std::ios::binary | std::ios::trunc);
+  if (!output)
+    return -1;
+  output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  output.write(reinterpret_cast<const char *>(lunations.data()),
+               lunations.size() * sizeof(LunationRecord));
+  if (!output)
+    return -1;
+
+  return (int)lunations.size();
+}
+
+/**
+ * \brief Map a lunation table into memory.
+ *
+ * Any table already open is closed first.
+ *
+ * @return false if the file could not be mapped, or was not written by this
+ * kAlgorithmVersion on a machine with the same byte order. Queries are
+ * then computed.
+ */
+bool PALunationCache::Open(const std::string &path) {
+  Close();
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || (std::size_t)info.st_size < sizeof(FileHeader)) {
+    close(fd);
+    return false;
+  }
+
+  void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED)
+    return false;
+
+  const FileHeader *header = static_cast<const FileHeader *>(mapped);
+  bool valid = memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+               header->byteOrder == kByteOrder &&
+               header->recordSize == sizeof(LunationRecord) &&
+               header->algorithmVersion == kAlgorithmVersion &&
+               header->count <=
+                   ((std::size_t)info.st_size - sizeof(FileHeader)) /
+                       sizeof(LunationRecord);
+  if (!valid) {
+    munmap(mapped, info.st_size);
+    return false;
+  }
+
+  this->mapping = mapped;
+  this->mappingBytes = info.st_size;
+  this->records = static_cast<const char *>(mapped) + sizeof(FileHeader);
+  this->count = header->count;
+  this->geogLongDeg = header->geogLongDeg;
+  this->geogLatDeg = header->geogLatDeg;
+
+  return true;
+}
+
+/**
+ * \brief Unmap the table, if one is open.
+ */
+void PALunationCache::Close() {
+  if (mapping != nullptr)
+    munmap(mapping, mappingBytes);
+
+  this->mapping = nullptr;
+  this->mappingBytes = 0;
+  this->records = nullptr;
+  this->count = 0;
+  this->geogLongDeg = 0.0;
+  this->geogLatDeg = 0.0;
+}
+
+/**
+ * \brief Find a lunation (see pa_macros::LunationNumber).
+ *
+ * @return Index of its record, or -1 if it is not in the table.
+ */
+int PALunationCache::Find(double lunation) const {
+  const LunationRecord *first = static_cast<const LunationRecord *>(records);
+  const LunationRecord *found = std::lower_bound(
+      first, first + count, lunation,
+      [](const LunationRecord &a, double b) { return a.lunation < b; });
+
+  if (found == first + count || found->lunation != lunation)
+    return -1;
+
+  return (int)(found - first);
+}
+
+/**
+ * \brief Julian date of new Moon, as pa_macros::NewMoon.
+ */
+double PALunationCache::NewMoon(int ds, int zc, double dy, int mn,
+                                int yr) const {
+  int index = Find(pa_macros::LunationNumber(ds, zc, dy, mn, yr));
+  if (index < 0)
+    return pa_macros::NewMoon(ds, zc, dy, mn, yr);
+
+  return static_cast<const LunationRecord *>(records)[index].newMoonJulianDate;
+}
+
+/**
+ * \brief Julian date of full Moon, as pa_macros::FullMoon.
+ */
+double PALunationCache::FullMoon(int ds, int zc, double dy, int mn,
+                                 int yr) const {
+  int index = Find(pa_macros::LunationNumber(ds, zc, dy, mn, yr));
+  if (index < 0)
+    return pa_macros::FullMoon(ds, zc, dy, mn, yr);
+
+  return static_cast<const LunationRecord *>(records)[index].fullMoonJulianDate;
+}
+
+/**
+ * \brief Circumstances of a lunar eclipse, as
+ * PAEclipses::LunarEclipseCircumstances.
+ */
+CLunarEclipseCircumstances PALunationCache::LunarEclipseCircumstances(
+    double localDateDay, int localDateMonth, int localDateYear,
+    bool isDaylightSaving, int zoneCorrectionHours) const {
+  int daylightSaving = isDaylightSaving ? 1 : 0;
+
+  int index =
+      Find(pa_macros::LunationNumber(daylightSaving, zoneCorrectionHours,
+                                     localDateDay, localDateMonth,
+                                     localDateYear));
+  if (index < 0)
+    return PAEclipses().LunarEclipseCircumstances(
+        localDateDay, localDateMonth, localDateYear, isDaylightSaving,
+        zoneCorrectionHours);
+
+  const LunationRecord &record =
+      static_cast<const LunationRecord *>(records)[index];
+
+  double day;
+  int month, year;
+  LocalCivilDate(record.fullMoonJulianDate, daylightSaving,
+                 zoneCorrectionHours, day, month, year);
+
+  const double *ut = record.lunarUt;
+  double magnitude = (record.lunarMagnitude == -99.0)
+                         ? -99.0
+                         : Round(record.lunarMagnitude, 2);
+
+  return CLunarEclipseCircumstances(
+      day, month, year, UtHour(ut[FirstContact]), UtMinutes(ut[FirstContact]),
+      UtHour(ut[StartUmbra]), UtMinutes(ut[StartUmbra]),
+      UtHour(ut[StartTotal]), UtMinutes(ut[StartTotal]),
+      UtHour(ut[MaxEclipse]), UtMinutes(ut[MaxEclipse]), UtHour(ut[EndTotal]),
+      UtMinutes(ut[EndTotal]), UtHour(ut[EndUmbra]), UtMinutes(ut[EndUmbra]),
+      UtHour(ut[LastContact]), UtMinutes(ut[LastContact]), magnitude);
+}
+
+/**
+ * \brief Circumstances of a solar eclipse, as
+ * PAEclipses::SolarEclipseCircumstances.
+ *
+ * Only the site the table was generated for is tabulated.
+ */
+CSolarEclipseCircumstances PALunationCache::SolarEclipseCircumstances(
+    double localDateDay, int localDateMonth, int localDateYear,
+    bool isDaylightSaving, int zoneCorrectionHours, double geogLongitudeDeg,
+    double geogLatitudeDeg) const {
+  int daylightSaving = isDaylightSaving ? 1 : 0;
+
+  int index = -1;
+  if (geogLongitudeDeg == geogLongDeg && geogLatitudeDeg == geogLatDeg)
+    index = Find(pa_macros::LunationNumber(daylightSaving, zoneCorrectionHours,
+                                           localDateDay, localDateMonth,
+                                           localDateYear));
+  if (index < 0)
+    return PAEclipses().SolarEclipseCircumstances(
+        localDateDay, localDateMonth, localDateYear, isDaylightSaving,
+        zoneCorrectionHours, geogLongitudeDeg, geogLatitudeDeg);
+
+  const LunationRecord &record =
+      static_cast<const LunationRecord *>(records)[index];
+
+  double day;
+  int month, year;
+  LocalCivilDate(record.newMoonJulianDate, daylightSaving, zoneCorrectionHours,
+                 day, month, year);
+
+  const double *ut = record.solarUt;
+  double magnitude = (record.solarMagnitude == -99.0)
+                         ? -99.0
+                         : Round(record.solarMagnitude, 3);
+
+  return CSolarEclipseCircumstances(day, month, year, UtHour(ut[0]),
+                                    UtMinutes(ut[0]), UtHour(ut[1]),
+                                    UtMinutes(ut[1]), UtHour(ut[2]),
+                                    UtMinutes(ut[2]), magnitude);
+}
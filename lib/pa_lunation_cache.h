@@ -0,0 +1,75 @@
+#ifndef _pa_lunation_cache
+#define _pa_lunation_cache
+
+#include "pa_models.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace pa_models;
+
+/**
+ * \brief Table of new and full Moons and eclipse circumstances, one record
+ * per lunation, read from a binary file.
+ *
+ * These results depend only on the lunation (and, for solar eclipses, the
+ * observer's site), never on anything that changes at run time. The file is
+ * made once for a span of years (Generate) and then mapped into memory
+ * (Open). Records are sorted by lunation number, so a query finds its
+ * lunation with a binary search.
+ *
+ * Queries give the same results as pa_macros and PAEclipses. Where the
+ * table cannot answer -- no file open, a lunation outside the span, a solar
+ * eclipse for another site -- they are computed instead. A file written by
+ * a different kAlgorithmVersion, or by a machine with another byte order,
+ * is not opened.
+ */
+class PALunationCache {
+public:
+  /** Bumped whenever the tabulated functions would give different results. */
+  static const uint32_t kAlgorithmVersion = 1;
+
+  PALunationCache();
+  ~PALunationCache();
+
+  PALunationCache(const PALunationCache &) = delete;
+  PALunationCache &operator=(const PALunationCache &) = delete;
+
+  static int Generate(const std::string &path, int firstYear, int lastYear,
+                      double geogLongDeg, double geogLatDeg);
+
+  bool Open(const std::string &path);
+
+  void Close();
+
+  bool IsOpen() const { return mapping != nullptr; }
+
+  std::size_t size() const { return count; }
+
+  int Find(double lunation) const;
+
+  double NewMoon(int ds, int zc, double dy, int mn, int yr) const;
+
+  double FullMoon(int ds, int zc, double dy, int mn, int yr) const;
+
+  CLunarEclipseCircumstances
+  LunarEclipseCircumstances(double localDateDay, int localDateMonth,
+                            int localDateYear, bool isDaylightSaving,
+                            int zoneCorrectionHours) const;
+
+  CSolarEclipseCircumstances
+  SolarEclipseCircumstances(double localDateDay, int localDateMonth,
+                            int localDateYear, bool isDaylightSaving,
+                            int zoneCorrectionHours, double geogLongitudeDeg,
+                            double geogLatitudeDeg) const;
+
+private:
+  void *mapping;
+  std::size_t mappingBytes;
+  const void *records;
+  std::size_t count;
+  double geogLongDeg;
+  double geogLatDeg;
+};
+
+#endif
@@ -1,9 +1,14 @@
 #include "pa_macros.h"
 #include "pa_data.h"
+#include "pa_instrument.h"
 #include "pa_models.h"
+#include "pa_trace.h"
 #include "pa_types.h"
 #include "pa_util.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <iterator>
 #include <string.h>
 #include <tuple>
 #include <vector>
@@ -190,6 +195,17 @@ int JulianDateYear(double julianDate) {
   return (int)returnValue;
 }
 
+/**
+ * \brief Split a Julian Date into the Greenwich calendar date at 0h UT and
+ * the Universal Time (decimal hours) since then.
+ */
+CGreenwichDateTime JulianDateToGreenwichDateTime(double julianDate) {
+  double jd0 = floor(julianDate - 0.5) + 0.5;
+
+  return CGreenwichDateTime(JulianDateDay(jd0), JulianDateMonth(jd0),
+                            JulianDateYear(jd0), (julianDate - jd0) * 24);
+}
+
 /**
  * \brief Convert Right Ascension to Hour Angle
  *
@@ -362,6 +378,8 @@ double LocalCivilTimeGreenwichDay(double lctHours, double lctMinutes,
                                   double lctSeconds, int daylightSaving,
                                   int zoneCorrection, double localDay,
                                   int localMonth, int localYear) {
+  PA_INSTRUMENT_SCOPE(LocalCivilTimeGreenwichDay);
+
   double a = HmsToDh(lctHours, lctMinutes, lctSeconds);
   double b = a - daylightSaving - zoneCorrection;
   double c = localDay + (b / 24);
@@ -380,6 +398,8 @@ double LocalCivilTimeGreenwichMonth(double lctHours, double lctMinutes,
                                     double lctSeconds, int daylightSaving,
                                     int zoneCorrection, double localDay,
                                     int localMonth, int localYear) {
+  PA_INSTRUMENT_SCOPE(LocalCivilTimeGreenwichMonth);
+
   double a = HmsToDh(lctHours, lctMinutes, lctSeconds);
   double b = a - daylightSaving - zoneCorrection;
   double c = localDay + (b / 24);
@@ -397,6 +417,8 @@ double LocalCivilTimeGreenwichYear(double lctHours, double lctMinutes,
                                    double lctSeconds, int daylightSaving,
                                    int zoneCorrection, double localDay,
                                    int localMonth, int localYear) {
+  PA_INSTRUMENT_SCOPE(LocalCivilTimeGreenwichYear);
+
   double a = HmsToDh(lctHours, lctMinutes, lctSeconds);
   double b = a - daylightSaving - zoneCorrection;
   double c = localDay + (b / 24);
@@ -632,14 +654,47 @@ double Obliq(double greenwichDay, int greenwichMonth, int greenwichYear) {
          NutatObl(greenwichDay, greenwichMonth, greenwichYear);
 }
 
+namespace {
 /**
- * \brief Nutation amount to be added in ecliptic longitude, in degrees.
+ * Nutation at one Julian date. valid is false (zero-initialized) until the
+ * entry is first filled.
+ */
+struct NutationCacheEntry {
+  bool valid;
+  double julianDate;
+  double longitudeDeg;
+  double obliquityDeg;
+};
+
+const int kNutationCacheSize = 4;
+
+/**
+ * The last few dates each thread asked for. Callers tend to need nutation for
+ * one Greenwich date several times over (longitude, then obliquity through
+ * Obliq), so a handful of entries is enough.
+ */
+thread_local NutationCacheEntry nutationCache[kNutationCacheSize];
+thread_local int nutationCacheNext = 0;
+} // namespace
+
+/**
+ * \brief Nutation in ecliptic longitude and in obliquity, in degrees.
  *
- * Original macro name: NutatLong
+ * Finds the fundamental arguments once for both series. Results for the last
+ * few dates are kept per thread, so NutatLong() and NutatObl() for the same
+ * date cost one evaluation.
  */
-double NutatLong(double gd, int gm, int gy) {
-  double dj = CivilDateToJulianDate(gd, gm, gy) - 2415020;
-  double t = dj / 36525;
+pa_models::CNutation Nutation(double gd, int gm, int gy) {
+  PA_TRACE_SPAN("Nutation");
+
+  double jd = CivilDateToJulianDate(gd, gm, gy);
+
+  for (const NutationCacheEntry &entry : nutationCache) {
+    if (entry.valid && entry.julianDate == jd)
+      return pa_models::CNutation(entry.longitudeDeg, entry.obliquityDeg);
+  }
+
+  double t = (jd - 2415020) / 36525;
   double t2 = t * t;
 
   double a = 100.0021358 * t;
@@ -657,20 +712,17 @@ double NutatLong(double gd, int gm, int gy) {
   a = 99.99736056 * t;
   b = 360 * (a - floor(a));
 
-  double m1 = 358.4758 - 0.00015 * t2 + b;
-  m1 = DegreesToRadians(m1);
+  double m1 = DegreesToRadians(358.4758 - 0.00015 * t2 + b);
 
   a = 1325.552359 * t;
   b = 360 * (a - floor(a));
 
-  double m2 = 296.1046 + 0.009192 * t2 + b;
-  m2 = DegreesToRadians(m2);
+  double m2 = DegreesToRadians(296.1046 + 0.009192 * t2 + b);
 
   a = 5.372616667 * t;
   b = 360 * (a - floor(a));
 
-  double n1 = 259.1833 + 0.002078 * t2 - b;
-  n1 = DegreesToRadians(n1);
+  double n1 = DegreesToRadians(259.1833 + 0.002078 * t2 - b);
 
   double n2 = 2.0 * n1;
 
@@ -682,7 +734,28 @@ double NutatLong(double gd, int gm, int gy) {
   dp = dp + 0.0214 * sin(l2 - m1) - 0.0149 * sin(l2 - d2 + m2);
   dp = dp + 0.0124 * sin(l2 - n1) + 0.0114 * sin(d2 - m2);
 
-  return dp / 3600;
+  double ddo = (9.21 + 0.00091 * t) * cos(n1);
+  ddo = ddo + (0.5522 - 0.00029 * t) * cos(l2) - 0.0904 * cos(n2);
+  ddo = ddo + 0.0884 * cos(d2) + 0.0216 * cos(l2 + m1);
+  ddo = ddo + 0.0183 * cos(d2 - n1) + 0.0113 * cos(d2 + m2);
+  ddo = ddo - 0.0093 * cos(l2 - m1) - 0.0066 * cos(l2 - n1);
+
+  NutationCacheEntry &entry = nutationCache[nutationCacheNext];
+  entry = {true, jd, dp / 3600, ddo / 3600};
+  nutationCacheNext = (nutationCacheNext + 1) % kNutationCacheSize;
+
+  return pa_models::CNutation(entry.longitudeDeg, entry.obliquityDeg);
+}
+
+/**
+ * \brief Nutation amount to be added in ecliptic longitude, in degrees.
+ *
+ * Original macro name: NutatLong
+ */
+double NutatLong(double gd, int gm, int gy) {
+  PA_INSTRUMENT_SCOPE(NutatLong);
+
+  return Nutation(gd, gm, gy).nutInLongDeg;
 }
 
 /**
@@ -691,48 +764,7 @@ double NutatLong(double gd, int gm, int gy) {
  * Original macro name: NutatObl
  */
 double NutatObl(double greenwichDay, int greenwichMonth, int greenwichYear) {
-  double dj =
-      CivilDateToJulianDate(greenwichDay, greenwichMonth, greenwichYear) -
-      2415020;
-  double t = dj / 36525;
-  double t2 = t * t;
-
-  double a = 100.0021358 * t;
-  double b = 360 * (a - floor(a));
-
-  double l1 = 279.6967 + 0.000303 * t2 + b;
-  double l2 = 2 * DegreesToRadians(l1);
-
-  a = 1336.855231 * t;
-  b = 360 * (a - floor(a));
-
-  double d1 = 270.4342 - 0.001133 * t2 + b;
-  double d2 = 2 * DegreesToRadians(d1);
-
-  a = 99.99736056 * t;
-  b = 360 * (a - floor(a));
-
-  double m1 = DegreesToRadians(358.4758 - 0.00015 * t2 + b);
-
-  a = 1325.552359 * t;
-  b = 360 * (a - floor(a));
-
-  double m2 = DegreesToRadians(296.1046 + 0.009192 * t2 + b);
-
-  a = 5.372616667 * t;
-  b = 360 * (a - floor(a));
-
-  double n1 = DegreesToRadians(259.1833 + 0.002078 * t2 - b);
-
-  double n2 = 2 * n1;
-
-  double ddo = (9.21 + 0.00091 * t) * cos(n1);
-  ddo = ddo + (0.5522 - 0.00029 * t) * cos(l2) - 0.0904 * cos(n2);
-  ddo = ddo + 0.0884 * cos(d2) + 0.0216 * cos(l2 + m1);
-  ddo = ddo + 0.0183 * cos(d2 - n1) + 0.0113 * cos(d2 + m2);
-  ddo = ddo - 0.0093 * cos(l2 - m1) - 0.0066 * cos(l2 - n1);
-
-  return ddo / 3600;
+  return Nutation(greenwichDay, greenwichMonth, greenwichYear).nutInOblDeg;
 }
 
 /**
@@ -782,6 +814,9 @@ double GreenwichSiderealTimeToUniversalTime(double greenwichSiderealHours,
  */
 double SunLong(double lch, double lcm, double lcs, int ds, int zc, double ld,
                int lm, int ly) {
+  PA_INSTRUMENT_SCOPE(SunLong);
+  PA_TRACE_SPAN("SunLong");
+
   double aa = LocalCivilTimeGreenwichDay(lch, lcm, lcs, ds, zc, ld, lm, ly);
   int bb = LocalCivilTimeGreenwichMonth(lch, lcm, lcs, ds, zc, ld, lm, ly);
   int cc = LocalCivilTimeGreenwichYear(lch, lcm, lcs, ds, zc, ld, lm, ly);
@@ -905,11 +940,15 @@ double SunDist(double lch, double lcm, double lcs, int ds, int zc, double ld,
  * Original macro name: TrueAnomaly
  */
 double TrueAnomaly(double am, double ec) {
+  PA_INSTRUMENT_SCOPE(TrueAnomaly);
+
   double tp = 6.283185308;
   double m = am - tp * floor(am / tp);
   double ae = m;
 
   while (1 == 1) {
+    PA_INSTRUMENT_ITERATIONS(TrueAnomaly, 1);
+
     double d = ae - (ec * sin(ae)) - m;
     if (std::abs(d) < 0.000001) {
       break;
@@ -1185,40 +1224,133 @@ std::tuple<double, double> ParallaxDecL2870(double x, double y, double rc,
   return std::tuple<double, double>{p, q};
 }
 
-/**
- * \brief Calculate geocentric ecliptic longitude for the Moon
- *
- * Original macro name: MoonLong
- */
-double MoonLongitude(double lh, double lm, double ls, int ds, int zc, double dy,
-                     int mn, int yr) {
-  double ut = LocalCivilTimeToUniversalTime(lh, lm, ls, ds, zc, dy, mn, yr);
-  double gd = LocalCivilTimeGreenwichDay(lh, lm, ls, ds, zc, dy, mn, yr);
-  int gm = LocalCivilTimeGreenwichMonth(lh, lm, ls, ds, zc, dy, mn, yr);
-  int gy = LocalCivilTimeGreenwichYear(lh, lm, ls, ds, zc, dy, mn, yr);
-  double t =
-      ((CivilDateToJulianDate(gd, gm, gy) - 2415020) / 36525) + (ut / 876600);
+namespace {
+/**
+ * One periodic term of the lunar theory: amplitude (degrees) times the sine or
+ * cosine of an integer combination of the mean elongation D (me1), the Sun's
+ * mean anomaly M (ms), the Moon's mean anomaly M' (md) and the argument of
+ * latitude F (mf). Terms involving M are also multiplied by E (or E squared,
+ * for 2M).
+ */
+struct LunarTerm {
+  double amplitude;
+  int multiple[4]; /**< Multiples of D, M, M' and F */
+};
+
+/** Largest multiple of any argument in the tables. */
+const int kMaxMultiple = 4;
+
+/** Number of instants evaluated side by side. */
+const int kLunarLanes = 8;
+
+/** Longitude terms (sine), in degrees. */
+const LunarTerm kMoonLongitudeTerms[] = {
+    {6.28875, {0, 0, 1, 0}},      {1.274018, {2, 0, -1, 0}},
+    {0.658309, {2, 0, 0, 0}},     {0.213616, {0, 0, 2, 0}},
+    {-0.185596, {0, 1, 0, 0}},    {-0.114336, {0, 0, 0, 2}},
+    {0.058793, {2, 0, -2, 0}},    {0.057212, {2, -1, -1, 0}},
+    {0.05332, {2, 0, 1, 0}},      {0.045874, {2, -1, 0, 0}},
+    {0.041024, {0, -1, 1, 0}},    {-0.034718, {1, 0, 0, 0}},
+    {-0.030465, {0, 1, 1, 0}},    {0.015326, {2, 0, 0, -2}},
+    {-0.012528, {0, 0, 1, 2}},    {-0.01098, {0, 0, -1, 2}},
+    {0.010674, {4, 0, -1, 0}},    {0.010034, {0, 0, 3, 0}},
+    {0.008548, {4, 0, -2, 0}},    {-0.00791, {2, 1, -1, 0}},
+    {-0.006783, {2, 1, 0, 0}},    {0.005162, {-1, 0, 1, 0}},
+    {0.005, {1, 1, 0, 0}},        {0.003862, {4, 0, 0, 0}},
+    {0.004049, {2, -1, 1, 0}},    {0.003996, {2, 0, 2, 0}},
+    {0.003665, {2, 0, -3, 0}},    {0.002695, {0, -1, 2, 0}},
+    {0.002602, {-2, 0, 1, -2}},   {0.002396, {2, -1, -2, 0}},
+    {-0.002349, {1, 0, 1, 0}},    {0.002249, {2, -2, 0, 0}},
+    {-0.002125, {0, 1, 2, 0}},    {-0.002079, {0, 2, 0, 0}},
+    {0.002059, {2, -2, -1, 0}},   {-0.001773, {2, 0, 1, -2}},
+    {-0.001595, {2, 0, 0, 2}},    {0.00122, {4, -1, -1, 0}},
+    {-0.00111, {0, 0, 2, 2}},     {0.000892, {-3, 0, 1, 0}},
+    {-0.000811, {2, 1, 1, 0}},    {0.000761, {4, -1, -2, 0}},
+    {0.000704, {-2, -2, 1, 0}},   {0.000693, {2, 1, -2, 0}},
+    {0.000598, {2, -1, 0, -2}},   {0.00055, {4, 0, 1, 0}},
+    {0.000538, {0, 0, 4, 0}},     {0.000521, {4, -1, 0, 0}},
+    {0.000486, {-1, 0, 2, 0}},    {0.000717, {0, -2, 1, 0}}};
+
+/** Latitude terms (sine), in degrees. */
+const LunarTerm kMoonLatitudeTerms[] = {
+    {5.128189, {0, 0, 0, 1}},     {0.280606, {0, 0, 1, 1}},
+    {0.277693, {0, 0, 1, -1}},    {0.173238, {2, 0, 0, -1}},
+    {0.055413, {2, 0, -1, 1}},    {0.046272, {2, 0, -1, -1}},
+    {0.032573, {2, 0, 0, 1}},     {0.017198, {0, 0, 2, 1}},
+    {0.009267, {2, 0, 1, -1}},    {0.008823, {0, 0, 2, -1}},
+    {0.008247, {2, -1, 0, -1}},   {0.004323, {2, 0, -2, -1}},
+    {0.0042, {2, 0, 1, 1}},       {0.003372, {-2, -1, 0, 1}},
+    {0.002472, {2, -1, -1, 1}},   {0.002222, {2, -1, 0, 1}},
+    {0.002072, {2, -1, -1, -1}},  {0.001877, {0, -1, 1, 1}},
+    {0.001828, {4, 0, -1, -1}},   {-0.001803, {0, 1, 0, 1}},
+    {-0.00175, {0, 0, 0, 3}},     {0.00157, {0, -1, 1, -1}},
+    {-0.001487, {1, 0, 0, 1}},    {-0.001481, {0, 1, 1, 1}},
+    {0.001417, {0, -1, -1, 1}},   {0.00135, {0, -1, 0, 1}},
+    {0.00133, {-1, 0, 0, 1}},     {0.001106, {0, 0, 3, 1}},
+    {0.00102, {4, 0, 0, -1}},     {0.000833, {4, 0, -1, 1}},
+    {0.000781, {0, 0, 1, -3}},    {0.00067, {4, 0, -2, 1}},
+    {0.000606, {2, 0, 0, -3}},    {0.000597, {2, 0, 2, -1}},
+    {0.000492, {2, -1, 1, -1}},   {0.00045, {-2, 0, 2, -1}},
+    {0.000439, {0, 0, 3, -1}},    {0.000423, {2, 0, 2, 1}},
+    {0.000422, {2, 0, -3, -1}},   {-0.000367, {2, 1, -1, 1}},
+    {-0.000353, {2, 1, 0, 1}},    {0.000331, {4, 0, 0, 1}},
+    {0.000317, {2, -1, 1, 1}},    {0.000306, {2, -2, 0, -1}},
+    {-0.000283, {0, 0, 1, 3}}};
+
+/** Horizontal parallax terms (cosine), in degrees. */
+const LunarTerm kMoonParallaxTerms[] = {
+    {0.051818, {0, 0, 1, 0}},     {0.009531, {2, 0, -1, 0}},
+    {0.007843, {2, 0, 0, 0}},     {0.002824, {0, 0, 2, 0}},
+    {0.000857, {2, 0, 1, 0}},     {0.000533, {2, -1, 0, 0}},
+    {0.000401, {2, -1, -1, 0}},   {0.00032, {0, -1, 1, 0}},
+    {-0.000271, {1, 0, 0, 0}},    {-0.000264, {0, 1, 1, 0}},
+    {-0.000198, {0, 0, -1, 2}},   {0.000173, {0, 0, 3, 0}},
+    {0.000167, {4, 0, -1, 0}},    {-0.000111, {0, 1, 0, 0}},
+    {0.000103, {4, 0, -2, 0}},    {-0.000084, {-2, 0, 2, 0}},
+    {-0.000083, {2, 1, 0, 0}},    {0.000079, {2, 0, 2, 0}},
+    {0.000072, {4, 0, 0, 0}},     {0.000064, {2, -1, 1, 0}},
+    {-0.000063, {2, 1, -1, 0}},   {0.000041, {1, 1, 0, 0}},
+    {0.000035, {0, -1, 2, 0}},    {-0.000033, {-2, 0, 3, 0}},
+    {-0.00003, {1, 0, 1, 0}},     {-0.000029, {-2, 0, 0, 2}},
+    {-0.000029, {0, 1, 2, 0}},    {0.000026, {2, -2, 0, 0}},
+    {-0.000023, {-2, 0, 1, 2}},   {0.000019, {4, -1, -1, 0}}};
+
+/** Constant term of the horizontal parallax, in degrees. */
+const double kMoonParallaxConstant = 0.950724;
+
+/**
+ * Fundamental arguments of the lunar theory at one instant (radians, except E).
+ */
+struct MoonArguments {
+  double ml; /**< Moon's mean longitude */
+  double ms; /**< Sun's mean anomaly */
+  double md; /**< Moon's mean anomaly */
+  double me1; /**< Moon's mean elongation */
+  double mf; /**< Moon's argument of latitude */
+  double na; /**< Longitude of the Moon's ascending node */
+  double c;
+  double e; /**< Eccentricity factor for terms in the Sun's anomaly */
+};
+
+/**
+ * Fundamental arguments for q days (and t Julian centuries) since 1900
+ * January 0.5.
+ */
+MoonArguments MoonArgumentsAt(double q, double t) {
   double t2 = t * t;
 
-  double m1 = 27.32158213;
-  double m2 = 365.2596407;
-  double m3 = 27.55455094;
-  double m4 = 29.53058868;
-  double m5 = 27.21222039;
-  double m6 = 6798.363307;
-  double q = CivilDateToJulianDate(gd, gm, gy) - 2415020 + (ut / 24);
-  m1 = q / m1;
-  m2 = q / m2;
-  m3 = q / m3;
-  m4 = q / m4;
-  m5 = q / m5;
-  m6 = q / m6;
-  m1 = 360 * (m1 - floor(m1));
-  m2 = 360 * (m2 - floor(m2));
-  m3 = 360 * (m3 - floor(m3));
-  m4 = 360 * (m4 - floor(m4));
-  m5 = 360 * (m5 - floor(m5));
-  m6 = 360 * (m6 - floor(m6));
+  double m1 = q / 27.32158213;
+  double m2 = q / 365.2596407;
+  double m3 = q / 27.55455094;
+  double m4 = q / 29.53058868;
+  double m5 = q / 27.21222039;
+  double m6 = q / 6798.363307;
+  m1 = 360.0 * (m1 - floor(m1));
+  m2 = 360.0 * (m2 - floor(m2));
+  m3 = 360.0 * (m3 - floor(m3));
+  m4 = 360.0 * (m4 - floor(m4));
+  m5 = 360.0 * (m5 - floor(m5));
+  m6 = 360.0 * (m6 - floor(m6));
 
   double ml = 270.434164 + m1 - (0.001133 - 0.0000019 * t) * t2;
   double ms = 358.475833 + m2 - (0.00015 + 0.0000033 * t) * t2;
@@ -1234,50 +1366,180 @@ double MoonLongitude(double lh, double lm, double ls, int ds, int zc, double dy,
   double c = DegreesToRadians(na + 275.05 - 2.3 * t);
   double s4 = sin(c);
   ml = ml + 0.000233 * s1 + s3 + 0.001964 * s2;
-  ms = ms - 0.001778 * s1;
+  ms -= 0.001778 * s1;
   md = md + 0.000817 * s1 + s3 + 0.002541 * s2;
   mf = mf + s3 - 0.024691 * s2 - 0.004328 * s4;
   me1 = me1 + 0.002011 * s1 + s3 + 0.001964 * s2;
-  double e = 1.0 - (0.002495 + 0.00000752 * t) * t;
-  double e2 = e * e;
-  ml = DegreesToRadians(ml);
-  ms = DegreesToRadians(ms);
-  me1 = DegreesToRadians(me1);
-  mf = DegreesToRadians(mf);
-  md = DegreesToRadians(md);
-
-  double l = 6.28875 * sin(md) + 1.274018 * sin(2 * me1 - md);
-  l = l + 0.658309 * sin(2 * me1) + 0.213616 * sin(2 * md);
-  l = l - e * 0.185596 * sin(ms) - 0.114336 * sin(2 * mf);
-  l = l + 0.058793 * sin(2 * (me1 - md));
-  l = l + 0.057212 * e * sin(2 * me1 - ms - md) + 0.05332 * sin(2 * me1 + md);
-  l = l + 0.045874 * e * sin(2 * me1 - ms) + 0.041024 * e * sin(md - ms);
-  l = l - 0.034718 * sin(me1) - e * 0.030465 * sin(ms + md);
-  l = l + 0.015326 * sin(2 * (me1 - mf)) - 0.012528 * sin(2 * mf + md);
-  l = l - 0.01098 * sin(2 * mf - md) + 0.010674 * sin(4 * me1 - md);
-  l = l + 0.010034 * sin(3 * md) + 0.008548 * sin(4 * me1 - 2 * md);
-  l = l - e * 0.00791 * sin(ms - md + 2 * me1) -
-      e * 0.006783 * sin(2 * me1 + ms);
-  l = l + 0.005162 * sin(md - me1) + e * 0.005 * sin(ms + me1);
-  l = l + 0.003862 * sin(4 * me1) + e * 0.004049 * sin(md - ms + 2 * me1);
-  l = l + 0.003996 * sin(2 * (md + me1)) + 0.003665 * sin(2 * me1 - 3 * md);
-  l = l + e * 0.002695 * sin(2 * md - ms) + 0.002602 * sin(md - 2 * (mf + me1));
-  l = l + e * 0.002396 * sin(2 * (me1 - md) - ms) - 0.002349 * sin(md + me1);
-  l = l + e2 * 0.002249 * sin(2 * (me1 - ms)) - e * 0.002125 * sin(2 * md + ms);
-  l = l - e2 * 0.002079 * sin(2 * ms) +
-      e2 * 0.002059 * sin(2 * (me1 - ms) - md);
-  l = l - 0.001773 * sin(md + 2 * (me1 - mf)) - 0.001595 * sin(2 * (mf + me1));
-  l = l + e * 0.00122 * sin(4 * me1 - ms - md) - 0.00111 * sin(2 * (md + mf));
-  l = l + 0.000892 * sin(md - 3 * me1) - e * 0.000811 * sin(ms + md + 2 * me1);
-  l = l + e * 0.000761 * sin(4 * me1 - ms - 2 * md);
-  l = l + e2 * 0.000704 * sin(md - 2 * (ms + me1));
-  l = l + e * 0.000693 * sin(ms - 2 * (md - me1));
-  l = l + e * 0.000598 * sin(2 * (me1 - mf) - ms);
-  l = l + 0.00055 * sin(md + 4 * me1) + 0.000538 * sin(4 * md);
-  l = l + e * 0.000521 * sin(4 * me1 - ms) + 0.000486 * sin(2 * md - me1);
-  l = l + e2 * 0.000717 * sin(md - 2 * ms);
-
-  double mm = Unwind(ml + DegreesToRadians(l));
+
+  MoonArguments arguments;
+  arguments.ml = DegreesToRadians(ml);
+  arguments.ms = DegreesToRadians(ms);
+  arguments.md = DegreesToRadians(md);
+  arguments.me1 = DegreesToRadians(me1);
+  arguments.mf = DegreesToRadians(mf);
+  arguments.na = DegreesToRadians(na);
+  arguments.c = c;
+  arguments.e = 1.0 - (0.002495 + 0.00000752 * t) * t;
+
+  return arguments;
+}
+
+/**
+ * Fundamental arguments for a local civil date and time.
+ */
+MoonArguments MoonArgumentsAt(double lh, double lm, double ls, int ds, int zc,
+                              double dy, int mn, int yr) {
+  double ut = LocalCivilTimeToUniversalTime(lh, lm, ls, ds, zc, dy, mn, yr);
+  double gd = LocalCivilTimeGreenwichDay(lh, lm, ls, ds, zc, dy, mn, yr);
+  int gm = LocalCivilTimeGreenwichMonth(lh, lm, ls, ds, zc, dy, mn, yr);
+  int gy = LocalCivilTimeGreenwichYear(lh, lm, ls, ds, zc, dy, mn, yr);
+  double jd = CivilDateToJulianDate(gd, gm, gy);
+
+  return MoonArgumentsAt(jd - 2415020.0 + (ut / 24.0),
+                         ((jd - 2415020.0) / 36525.0) + (ut / 876600.0));
+}
+
+/**
+ * Sines and cosines of the multiples (-kMaxMultiple to kMaxMultiple) of D, M,
+ * M' and F, and the powers of E, for up to kLunarLanes instants. Element
+ * [argument][multiple + kMaxMultiple][lane].
+ */
+struct LunarMultiples {
+  int lanes;
+  double sines[4][2 * kMaxMultiple + 1][kLunarLanes];
+  double cosines[4][2 * kMaxMultiple + 1][kLunarLanes];
+  double ePowers[3][kLunarLanes];
+};
+
+/**
+ * Fill the multiples for each instant: one sine and one cosine per argument,
+ * then the Chebyshev recurrences sin((k+1)x) = 2 cos(x) sin(kx) - sin((k-1)x)
+ * and cos((k+1)x) = 2 cos(x) cos(kx) - cos((k-1)x).
+ */
+void FillLunarMultiples(const MoonArguments *arguments, int lanes,
+                        LunarMultiples &multiples) {
+  const int zero = kMaxMultiple;
+  multiples.lanes = lanes;
+
+  for (int l = 0; l < lanes; l++) {
+    const double x[4] = {arguments[l].me1, arguments[l].ms, arguments[l].md,
+                         arguments[l].mf};
+
+    for (int i = 0; i < 4; i++) {
+      double (*s)[kLunarLanes] = multiples.sines[i];
+      double (*c)[kLunarLanes] = multiples.cosines[i];
+      double twoCos = 2.0 * cos(x[i]);
+
+      s[zero][l] = 0.0;
+      c[zero][l] = 1.0;
+      s[zero + 1][l] = sin(x[i]);
+      c[zero + 1][l] = twoCos / 2.0;
+      for (int k = 2; k <= kMaxMultiple; k++) {
+        s[zero + k][l] = twoCos * s[zero + k - 1][l] - s[zero + k - 2][l];
+        c[zero + k][l] = twoCos * c[zero + k - 1][l] - c[zero + k - 2][l];
+      }
+      for (int k = 1; k <= kMaxMultiple; k++) {
+        s[zero - k][l] = -s[zero + k][l];
+        c[zero - k][l] = c[zero + k][l];
+      }
+    }
+
+    multiples.ePowers[0][l] = 1.0;
+    multiples.ePowers[1][l] = arguments[l].e;
+    multiples.ePowers[2][l] = arguments[l].e * arguments[l].e;
+  }
+}
+
+/**
+ * Add a series to sums[lane], one lane per instant. Each term's sine or cosine
+ * is built from the tabulated multiples with the angle-sum formulae, so no
+ * trigonometric functions are called. Terms smaller than minAmplitude
+ * (degrees) are skipped.
+ */
+void SumLunarSeries(const LunarTerm *terms, std::size_t termCount, bool cosine,
+                    double minAmplitude, const LunarMultiples &multiples,
+                    double *sums) {
+  const int zero = kMaxMultiple;
+
+  for (std::size_t i = 0; i < termCount; i++) {
+    const LunarTerm &term = terms[i];
+    if (std::abs(term.amplitude) < minAmplitude)
+      continue;
+
+    const double *sd = multiples.sines[0][zero + term.multiple[0]];
+    const double *cd = multiples.cosines[0][zero + term.multiple[0]];
+    const double *sm = multiples.sines[1][zero + term.multiple[1]];
+    const double *cm = multiples.cosines[1][zero + term.multiple[1]];
+    const double *sp = multiples.sines[2][zero + term.multiple[2]];
+    const double *cp = multiples.cosines[2][zero + term.multiple[2]];
+    const double *sf = multiples.sines[3][zero + term.multiple[3]];
+    const double *cf = multiples.cosines[3][zero + term.multiple[3]];
+    const double *ePower = multiples.ePowers[std::abs(term.multiple[1])];
+
+    for (int l = 0; l < multiples.lanes; l++) {
+      double s = sd[l] * cm[l] + cd[l] * sm[l];
+      double c = cd[l] * cm[l] - sd[l] * sm[l];
+      double s2 = s * cp[l] + c * sp[l];
+      double c2 = c * cp[l] - s * sp[l];
+      double s3 = s2 * cf[l] + c2 * sf[l];
+      double c3 = c2 * cf[l] - s2 * sf[l];
+
+      sums[l] += term.amplitude * ePower[l] * (cosine ? c3 : s3);
+    }
+  }
+}
+
+/**
+ * Longitude, latitude and horizontal parallax (degrees) for up to kLunarLanes
+ * instants, appended to results.
+ */
+void MoonLongLatHPLanes(const MoonArguments *arguments, int lanes,
+                        double minAmplitude,
+                        std::vector<CMoonLongLatHP> &results) {
+  LunarMultiples multiples;
+  FillLunarMultiples(arguments, lanes, multiples);
+
+  double l[kLunarLanes] = {0};
+  double g[kLunarLanes] = {0};
+  double pm[kLunarLanes];
+  for (int i = 0; i < lanes; i++)
+    pm[i] = kMoonParallaxConstant;
+
+  SumLunarSeries(kMoonLongitudeTerms, std::size(kMoonLongitudeTerms), false,
+                 minAmplitude, multiples, l);
+  SumLunarSeries(kMoonLatitudeTerms, std::size(kMoonLatitudeTerms), false,
+                 minAmplitude, multiples, g);
+  SumLunarSeries(kMoonParallaxTerms, std::size(kMoonParallaxTerms), true,
+                 minAmplitude, multiples, pm);
+
+  for (int i = 0; i < lanes; i++) {
+    const MoonArguments &a = arguments[i];
+    double mm = Unwind(a.ml + DegreesToRadians(l[i]));
+    double w1 = 0.0004664 * cos(a.na);
+    double w2 = 0.0000754 * cos(a.c);
+    double bm = DegreesToRadians(g[i]) * (1.0 - w1 - w2);
+
+    results.push_back(CMoonLongLatHP(WToDegrees(mm), WToDegrees(bm), pm[i]));
+  }
+}
+} // namespace
+
+/**
+ * \brief Calculate geocentric ecliptic longitude for the Moon
+ *
+ * Original macro name: MoonLong
+ */
+double MoonLongitude(double lh, double lm, double ls, int ds, int zc, double dy,
+                     int mn, int yr) {
+  MoonArguments arguments = MoonArgumentsAt(lh, lm, ls, ds, zc, dy, mn, yr);
+  LunarMultiples multiples;
+  FillLunarMultiples(&arguments, 1, multiples);
+
+  double l = 0.0;
+  SumLunarSeries(kMoonLongitudeTerms, std::size(kMoonLongitudeTerms), false,
+                 0.0, multiples, &l);
+
+  double mm = Unwind(arguments.ml + DegreesToRadians(l));
 
   return WToDegrees(mm);
 }
@@ -1289,94 +1551,16 @@ double MoonLongitude(double lh, double lm, double ls, int ds, int zc, double dy,
  */
 double MoonLatitude(double lh, double lm, double ls, int ds, int zc, double dy,
                     int mn, int yr) {
-  double ut = LocalCivilTimeToUniversalTime(lh, lm, ls, ds, zc, dy, mn, yr);
-  double gd = LocalCivilTimeGreenwichDay(lh, lm, ls, ds, zc, dy, mn, yr);
-  int gm = LocalCivilTimeGreenwichMonth(lh, lm, ls, ds, zc, dy, mn, yr);
-  int gy = LocalCivilTimeGreenwichYear(lh, lm, ls, ds, zc, dy, mn, yr);
-  double t =
-      ((CivilDateToJulianDate(gd, gm, gy) - 2415020) / 36525) + (ut / 876600);
-  double t2 = t * t;
+  MoonArguments arguments = MoonArgumentsAt(lh, lm, ls, ds, zc, dy, mn, yr);
+  LunarMultiples multiples;
+  FillLunarMultiples(&arguments, 1, multiples);
 
-  double m1 = 27.32158213;
-  double m2 = 365.2596407;
-  double m3 = 27.55455094;
-  double m4 = 29.53058868;
-  double m5 = 27.21222039;
-  double m6 = 6798.363307;
-  double q = CivilDateToJulianDate(gd, gm, gy) - 2415020 + (ut / 24);
-  m1 = q / m1;
-  m2 = q / m2;
-  m3 = q / m3;
-  m4 = q / m4;
-  m5 = q / m5;
-  m6 = q / m6;
-  m1 = 360 * (m1 - floor(m1));
-  m2 = 360 * (m2 - floor(m2));
-  m3 = 360 * (m3 - floor(m3));
-  m4 = 360 * (m4 - floor(m4));
-  m5 = 360 * (m5 - floor(m5));
-  m6 = 360 * (m6 - floor(m6));
+  double g = 0.0;
+  SumLunarSeries(kMoonLatitudeTerms, std::size(kMoonLatitudeTerms), false, 0.0,
+                 multiples, &g);
 
-  double ml = 270.434164 + m1 - (0.001133 - 0.0000019 * t) * t2;
-  double ms = 358.475833 + m2 - (0.00015 + 0.0000033 * t) * t2;
-  double md = 296.104608 + m3 + (0.009192 + 0.0000144 * t) * t2;
-  double me1 = 350.737486 + m4 - (0.001436 - 0.0000019 * t) * t2;
-  double mf = 11.250889 + m5 - (0.003211 + 0.0000003 * t) * t2;
-  double na = 259.183275 - m6 + (0.002078 + 0.0000022 * t) * t2;
-  double a = DegreesToRadians(51.2 + 20.2 * t);
-  double s1 = sin(a);
-  double s2 = sin(DegreesToRadians(na));
-  double b = 346.56 + (132.87 - 0.0091731 * t) * t;
-  double s3 = 0.003964 * sin(DegreesToRadians(b));
-  double c = DegreesToRadians(na + 275.05 - 2.3 * t);
-  double s4 = sin(c);
-  ml = ml + 0.000233 * s1 + s3 + 0.001964 * s2;
-  ms = ms - 0.001778 * s1;
-  md = md + 0.000817 * s1 + s3 + 0.002541 * s2;
-  mf = mf + s3 - 0.024691 * s2 - 0.004328 * s4;
-  me1 = me1 + 0.002011 * s1 + s3 + 0.001964 * s2;
-  double e = 1.0 - (0.002495 + 0.00000752 * t) * t;
-  double e2 = e * e;
-  ms = DegreesToRadians(ms);
-  na = DegreesToRadians(na);
-  me1 = DegreesToRadians(me1);
-  mf = DegreesToRadians(mf);
-  md = DegreesToRadians(md);
-
-  double g = 5.128189 * sin(mf) + 0.280606 * sin(md + mf);
-  g = g + 0.277693 * sin(md - mf) + 0.173238 * sin(2 * me1 - mf);
-  g = g + 0.055413 * sin(2 * me1 + mf - md) + 0.046272 * sin(2 * me1 - mf - md);
-  g = g + 0.032573 * sin(2 * me1 + mf) + 0.017198 * sin(2 * md + mf);
-  g = g + 0.009267 * sin(2 * me1 + md - mf) + 0.008823 * sin(2 * md - mf);
-  g = g + e * 0.008247 * sin(2 * me1 - ms - mf) +
-      0.004323 * sin(2 * (me1 - md) - mf);
-  g = g + 0.0042 * sin(2 * me1 + mf + md) +
-      e * 0.003372 * sin(mf - ms - 2 * me1);
-  g = g + e * 0.002472 * sin(2 * me1 + mf - ms - md);
-  g = g + e * 0.002222 * sin(2 * me1 + mf - ms);
-  g = g + e * 0.002072 * sin(2 * me1 - mf - ms - md);
-  g = g + e * 0.001877 * sin(mf - ms + md) + 0.001828 * sin(4 * me1 - mf - md);
-  g = g - e * 0.001803 * sin(mf + ms) - 0.00175 * sin(3 * mf);
-  g = g + e * 0.00157 * sin(md - ms - mf) - 0.001487 * sin(mf + me1);
-  g = g - e * 0.001481 * sin(mf + ms + md) + e * 0.001417 * sin(mf - ms - md);
-  g = g + e * 0.00135 * sin(mf - ms) + 0.00133 * sin(mf - me1);
-  g = g + 0.001106 * sin(mf + 3 * md) + 0.00102 * sin(4 * me1 - mf);
-  g = g + 0.000833 * sin(mf + 4 * me1 - md) + 0.000781 * sin(md - 3 * mf);
-  g = g + 0.00067 * sin(mf + 4 * me1 - 2 * md) +
-      0.000606 * sin(2 * me1 - 3 * mf);
-  g = g + 0.000597 * sin(2 * (me1 + md) - mf);
-  g = g + e * 0.000492 * sin(2 * me1 + md - ms - mf) +
-      0.00045 * sin(2 * (md - me1) - mf);
-  g = g + 0.000439 * sin(3 * md - mf) + 0.000423 * sin(mf + 2 * (me1 + md));
-  g = g + 0.000422 * sin(2 * me1 - mf - 3 * md) -
-      e * 0.000367 * sin(ms + mf + 2 * me1 - md);
-  g = g - e * 0.000353 * sin(ms + mf + 2 * me1) + 0.000331 * sin(mf + 4 * me1);
-  g = g + e * 0.000317 * sin(2 * me1 + mf - ms + md);
-  g = g + e2 * 0.000306 * sin(2 * (me1 - ms) - mf) -
-      0.000283 * sin(md + 3 * mf);
-
-  double w1 = 0.0004664 * cos(na);
-  double w2 = 0.0000754 * cos(c);
+  double w1 = 0.0004664 * cos(arguments.na);
+  double w2 = 0.0000754 * cos(arguments.c);
   double bm = DegreesToRadians(g) * (1.0 - w1 - w2);
 
   return WToDegrees(bm);
@@ -1418,77 +1602,13 @@ double MoonSize(double lh, double lm, double ls, int ds, int zc, double dy,
  */
 double MoonHorizontalParallax(double lh, double lm, double ls, int ds, int zc,
                               double dy, int mn, int yr) {
-  double ut = LocalCivilTimeToUniversalTime(lh, lm, ls, ds, zc, dy, mn, yr);
-  double gd = LocalCivilTimeGreenwichDay(lh, lm, ls, ds, zc, dy, mn, yr);
-  int gm = LocalCivilTimeGreenwichMonth(lh, lm, ls, ds, zc, dy, mn, yr);
-  int gy = LocalCivilTimeGreenwichYear(lh, lm, ls, ds, zc, dy, mn, yr);
-  double t =
-      ((CivilDateToJulianDate(gd, gm, gy) - 2415020) / 36525) + (ut / 876600);
-  double t2 = t * t;
+  MoonArguments arguments = MoonArgumentsAt(lh, lm, ls, ds, zc, dy, mn, yr);
+  LunarMultiples multiples;
+  FillLunarMultiples(&arguments, 1, multiples);
 
-  double m1 = 27.32158213;
-  double m2 = 365.2596407;
-  double m3 = 27.55455094;
-  double m4 = 29.53058868;
-  double m5 = 27.21222039;
-  double m6 = 6798.363307;
-  double q = CivilDateToJulianDate(gd, gm, gy) - 2415020 + (ut / 24);
-  m1 = q / m1;
-  m2 = q / m2;
-  m3 = q / m3;
-  m4 = q / m4;
-  m5 = q / m5;
-  m6 = q / m6;
-  m1 = 360 * (m1 - floor(m1));
-  m2 = 360 * (m2 - floor(m2));
-  m3 = 360 * (m3 - floor(m3));
-  m4 = 360 * (m4 - floor(m4));
-  m5 = 360 * (m5 - floor(m5));
-  m6 = 360 * (m6 - floor(m6));
-
-  double ml = 270.434164 + m1 - (0.001133 - 0.0000019 * t) * t2;
-  double ms = 358.475833 + m2 - (0.00015 + 0.0000033 * t) * t2;
-  double md = 296.104608 + m3 + (0.009192 + 0.0000144 * t) * t2;
-  double me1 = 350.737486 + m4 - (0.001436 - 0.0000019 * t) * t2;
-  double mf = 11.250889 + m5 - (0.003211 + 0.0000003 * t) * t2;
-  double na = 259.183275 - m6 + (0.002078 + 0.0000022 * t) * t2;
-  double a = DegreesToRadians(51.2 + 20.2 * t);
-  double s1 = sin(a);
-  double s2 = sin(DegreesToRadians(na));
-  double b = 346.56 + (132.87 - 0.0091731 * t) * t;
-  double s3 = 0.003964 * sin(DegreesToRadians(b));
-  double c = DegreesToRadians(na + 275.05 - 2.3 * t);
-  double s4 = sin(c);
-  ml = ml + 0.000233 * s1 + s3 + 0.001964 * s2;
-  ms = ms - 0.001778 * s1;
-  md = md + 0.000817 * s1 + s3 + 0.002541 * s2;
-  mf = mf + s3 - 0.024691 * s2 - 0.004328 * s4;
-  me1 = me1 + 0.002011 * s1 + s3 + 0.001964 * s2;
-  double e = 1.0 - (0.002495 + 0.00000752 * t) * t;
-  double e2 = e * e;
-  ms = DegreesToRadians(ms);
-  me1 = DegreesToRadians(me1);
-  mf = DegreesToRadians(mf);
-  md = DegreesToRadians(md);
-
-  double pm = 0.950724 + 0.051818 * cos(md) + 0.009531 * cos(2 * me1 - md);
-  pm = pm + 0.007843 * cos(2 * me1) + 0.002824 * cos(2 * md);
-  pm = pm + 0.000857 * cos(2 * me1 + md) + e * 0.000533 * cos(2 * me1 - ms);
-  pm = pm + e * 0.000401 * cos(2 * me1 - md - ms);
-  pm = pm + e * 0.00032 * cos(md - ms) - 0.000271 * cos(me1);
-  pm = pm - e * 0.000264 * cos(ms + md) - 0.000198 * cos(2 * mf - md);
-  pm = pm + 0.000173 * cos(3 * md) + 0.000167 * cos(4 * me1 - md);
-  pm = pm - e * 0.000111 * cos(ms) + 0.000103 * cos(4 * me1 - 2 * md);
-  pm = pm - 0.000084 * cos(2 * md - 2 * me1) - e * 0.000083 * cos(2 * me1 + ms);
-  pm = pm + 0.000079 * cos(2 * me1 + 2 * md) + 0.000072 * cos(4 * me1);
-  pm = pm + e * 0.000064 * cos(2 * me1 - ms + md) -
-       e * 0.000063 * cos(2 * me1 + ms - md);
-  pm = pm + e * 0.000041 * cos(ms + me1) + e * 0.000035 * cos(2 * md - ms);
-  pm = pm - 0.000033 * cos(3 * md - 2 * me1) - 0.00003 * cos(md + me1);
-  pm = pm - 0.000029 * cos(2 * (mf - me1)) - e * 0.000029 * cos(2 * md + ms);
-  pm = pm + e2 * 0.000026 * cos(2 * (me1 - ms)) -
-       0.000023 * cos(2 * (mf - me1) + md);
-  pm = pm + e * 0.000019 * cos(4 * me1 - ms - md);
+  double pm = kMoonParallaxConstant;
+  SumLunarSeries(kMoonParallaxTerms, std::size(kMoonParallaxTerms), true, 0.0,
+                 multiples, &pm);
 
   return pm;
 }
@@ -1552,11 +1672,20 @@ double SunEccentricity(double gd, int gm, int gy) {
  */
 double EclipticDeclination(double eld, double elm, double els, double bd,
                            double bm, double bs, double gd, int gm, int gy) {
-  double a =
-      DegreesToRadians(DegreesMinutesSecondsToDecimalDegrees(eld, elm, els));
-  double b =
-      DegreesToRadians(DegreesMinutesSecondsToDecimalDegrees(bd, bm, bs));
-  double c = DegreesToRadians(Obliq(gd, gm, gy));
+  return EclipticDeclinationObliq(
+      DegreesMinutesSecondsToDecimalDegrees(eld, elm, els),
+      DegreesMinutesSecondsToDecimalDegrees(bd, bm, bs), Obliq(gd, gm, gy));
+}
+
+/**
+ * \brief Ecliptic - Declination (degrees), for a given obliquity (degrees)
+ *
+ * Lets callers converting many positions for one date find the obliquity once.
+ */
+double EclipticDeclinationObliq(double eld, double bd, double obliq) {
+  double a = DegreesToRadians(eld);
+  double b = DegreesToRadians(bd);
+  double c = DegreesToRadians(obliq);
   double d = sin(b) * cos(c) + cos(b) * sin(c) * sin(a);
 
   return WToDegrees(asin(d));
@@ -1569,11 +1698,20 @@ double EclipticDeclination(double eld, double elm, double els, double bd,
  */
 double EclipticRightAscension(double eld, double elm, double els, double bd,
                               double bm, double bs, double gd, int gm, int gy) {
-  double a =
-      DegreesToRadians(DegreesMinutesSecondsToDecimalDegrees(eld, elm, els));
-  double b =
-      DegreesToRadians(DegreesMinutesSecondsToDecimalDegrees(bd, bm, bs));
-  double c = DegreesToRadians(Obliq(gd, gm, gy));
+  return EclipticRightAscensionObliq(
+      DegreesMinutesSecondsToDecimalDegrees(eld, elm, els),
+      DegreesMinutesSecondsToDecimalDegrees(bd, bm, bs), Obliq(gd, gm, gy));
+}
+
+/**
+ * \brief Ecliptic - Right Ascension (degrees), for a given obliquity (degrees)
+ *
+ * Lets callers converting many positions for one date find the obliquity once.
+ */
+double EclipticRightAscensionObliq(double eld, double bd, double obliq) {
+  double a = DegreesToRadians(eld);
+  double b = DegreesToRadians(bd);
+  double c = DegreesToRadians(obliq);
   double d = sin(a) * cos(c) - tan(b) * sin(c);
   double e = cos(a);
   double f = WToDegrees(atan2(d, e));
@@ -1638,6 +1776,8 @@ double SunMeanAnomaly(double lch, double lcm, double lcs, int ds, int zc,
  */
 double SunriseLocalCivilTime(double ld, int lm, int ly, int ds, int zc,
                              double gl, double gp) {
+  PA_TRACE_SPAN("SunriseLocalCivilTime");
+
   double di = 0.8333333;
   double gd = LocalCivilTimeGreenwichDay(12, 0, 0, ds, zc, ld, lm, ly);
   int gm = LocalCivilTimeGreenwichMonth(12, 0, 0, ds, zc, ld, lm, ly);
@@ -1683,6 +1823,8 @@ double SunriseLocalCivilTime(double ld, int lm, int ly, int ds, int zc,
  */
 double SunsetLocalCivilTime(double ld, int lm, int ly, int ds, int zc,
                             double gl, double gp) {
+  PA_TRACE_SPAN("SunsetLocalCivilTime");
+
   double di = 0.8333333;
   double gd = LocalCivilTimeGreenwichDay(12, 0, 0, ds, zc, ld, lm, ly);
   int gm = LocalCivilTimeGreenwichMonth(12, 0, 0, ds, zc, ld, lm, ly);
@@ -2072,6 +2214,8 @@ double RiseSetAzimuthSet(double rah, double ram, double ras, double dd,
  */
 double TwilightAMLocalCivilTime(double ld, int lm, int ly, int ds, int zc,
                                 double gl, double gp, ETwilightType tt) {
+  PA_TRACE_SPAN("TwilightAMLocalCivilTime");
+
   double di = (double)tt;
 
   double gd = LocalCivilTimeGreenwichDay(12, 0, 0, ds, zc, ld, lm, ly);
@@ -2139,6 +2283,8 @@ TwilightAMLocalCivilTime_L3710(double gd, int gm, int gy, double sr, double di,
  */
 double TwilightPMLocalCivilTime(double ld, int lm, int ly, int ds, int zc,
                                 double gl, double gp, ETwilightType tt) {
+  PA_TRACE_SPAN("TwilightPMLocalCivilTime");
+
   double di = (double)tt;
 
   double gd = LocalCivilTimeGreenwichDay(12, 0, 0, ds, zc, ld, lm, ly);
@@ -2292,15 +2438,90 @@ double Angle(double xx1, double xm1, double xs1, double dd1, double dm1,
   double h = DegreesToRadians(g);
   double i = acos(sin(d) * sin(h) + cos(d) * cos(h) * cos(b - f));
 
-  return WToDegrees(i);
+  return WToDegrees(i);
+}
+
+/**
+ * Calculate several planetary properties.
+ */
+pa_models::CPlanetCoordinates PlanetCoordinates(double lh, double lm, double ls,
+                                                int ds, int zc, double dy,
+                                                int mn, int yr, std::string s) {
+  PA_INSTRUMENT_SCOPE(PlanetCoordinates);
+
+  double b = LocalCivilTimeToUniversalTime(lh, lm, ls, ds, zc, dy, mn, yr);
+  double gd = LocalCivilTimeGreenwichDay(lh, lm, ls, ds, zc, dy, mn, yr);
+  int gm = LocalCivilTimeGreenwichMonth(lh, lm, ls, ds, zc, dy, mn, yr);
+  int gy = LocalCivilTimeGreenwichYear(lh, lm, ls, ds, zc, dy, mn, yr);
+  double a = CivilDateToJulianDate(gd, gm, gy);
+  double t = ((a - 2415020.0) / 36525.0) + (b / 876600.0);
+
+  std::vector<pa_data::PlanetDataPrecise> pl = PlanetElements(t);
+
+  // ip also chooses between the inferior and superior planet formulas for
+  // the geocentric longitude. When it was left at 0, every planet took the
+  // inferior formula, which puts a superior planet 180 degrees out for the
+  // months around opposition.
+  int ip = 0;
+  for (int i = 1; i < pl.size(); i++)
+    if (pl[i].name == s)
+      ip = i;
+
+  if (ip == 0) {
+    return (pa_models::CPlanetCoordinates){
+        WToDegrees(Unwind(0)), WToDegrees(Unwind(0)), WToDegrees(Unwind(0)),
+        WToDegrees(Unwind(0)), WToDegrees(Unwind(0)), WToDegrees(Unwind(0)),
+        WToDegrees(Unwind(0))};
+  }
+
+  double ms = SunMeanAnomaly(lh, lm, ls, ds, zc, dy, mn, yr);
+  double sr = DegreesToRadians(SunLong(lh, lm, ls, ds, zc, dy, mn, yr));
+  double re = SunDist(lh, lm, ls, ds, zc, dy, mn, yr);
+
+  return PlanetCoordinatesFromElements(pl, ip, t, ms, sr, re);
+}
+
+/**
+ * Calculate several planetary properties, for all seven planets (Mercury to
+ * Neptune, in that order).
+ *
+ * The orbital elements and the Sun's position are evaluated once and shared;
+ * each planet then runs its own light-time iteration. Results are the same as
+ * calling PlanetCoordinates() for each planet.
+ */
+std::vector<pa_models::CPlanetCoordinates>
+AllPlanetCoordinates(double lh, double lm, double ls, int ds, int zc,
+                     double dy, int mn, int yr) {
+  double b = LocalCivilTimeToUniversalTime(lh, lm, ls, ds, zc, dy, mn, yr);
+  double gd = LocalCivilTimeGreenwichDay(lh, lm, ls, ds, zc, dy, mn, yr);
+  int gm = LocalCivilTimeGreenwichMonth(lh, lm, ls, ds, zc, dy, mn, yr);
+  int gy = LocalCivilTimeGreenwichYear(lh, lm, ls, ds, zc, dy, mn, yr);
+  double a = CivilDateToJulianDate(gd, gm, gy);
+  double t = ((a - 2415020.0) / 36525.0) + (b / 876600.0);
+
+  std::vector<pa_data::PlanetDataPrecise> pl = PlanetElements(t);
+
+  double ms = SunMeanAnomaly(lh, lm, ls, ds, zc, dy, mn, yr);
+  double sr = DegreesToRadians(SunLong(lh, lm, ls, ds, zc, dy, mn, yr));
+  double re = SunDist(lh, lm, ls, ds, zc, dy, mn, yr);
+
+  pa_models::COuterPlanetArguments outer = OuterPlanetArguments(t);
+
+  std::vector<pa_models::CPlanetCoordinates> coordinates;
+  for (std::size_t ip = 1; ip < pl.size(); ip++)
+    coordinates.push_back(
+        PlanetCoordinatesFromElements(pl, ip, t, ms, sr, re, outer));
+
+  return coordinates;
 }
 
 /**
- * Calculate several planetary properties.
+ * Helper function for PlanetCoordinates()
+ *
+ * Orbital elements of all seven planets (index 1 Mercury to 7 Neptune), at t
+ * Julian centuries from 1900 January 0.5.
  */
-pa_models::CPlanetCoordinates PlanetCoordinates(double lh, double lm, double ls,
-                                                int ds, int zc, double dy,
-                                                int mn, int yr, std::string s) {
+std::vector<pa_data::PlanetDataPrecise> PlanetElements(double t) {
   double a11 = 178.179078;
   double a12 = 415.2057519;
   double a13 = 0.0003011;
@@ -2473,14 +2694,6 @@ pa_models::CPlanetCoordinates PlanetCoordinates(double lh, double lm, double ls,
 
   pl.push_back(pa_data::PlanetDataPrecise("", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0));
 
-  int ip = 0;
-  double b = LocalCivilTimeToUniversalTime(lh, lm, ls, ds, zc, dy, mn, yr);
-  double gd = LocalCivilTimeGreenwichDay(lh, lm, ls, ds, zc, dy, mn, yr);
-  int gm = LocalCivilTimeGreenwichMonth(lh, lm, ls, ds, zc, dy, mn, yr);
-  int gy = LocalCivilTimeGreenwichYear(lh, lm, ls, ds, zc, dy, mn, yr);
-  double a = CivilDateToJulianDate(gd, gm, gy);
-  double t = ((a - 2415020.0) / 36525.0) + (b / 876600.0);
-
   double a0 = a11;
   double a1 = a12;
   double a2 = a13;
@@ -2505,7 +2718,7 @@ pa_models::CPlanetCoordinates PlanetCoordinates(double lh, double lm, double ls,
   double g = a62;
   double h = a63;
   double aa = a1 * t;
-  b = 360.0 * (aa - floor(aa));
+  double b = 360.0 * (aa - floor(aa));
   double c = a0 + b + (a3 * t + a2) * t * t;
 
   pl.push_back(pa_data::PlanetDataPrecise(
@@ -2724,20 +2937,47 @@ pa_models::CPlanetCoordinates PlanetCoordinates(double lh, double lm, double ls,
       ((d3 * t + d2) * t + d1) * t + d0, ((e3 * t + e2) * t + e1) * t + e0, f,
       g, h, 0));
 
-  pa_data::PlanetDataPrecise check_planet =
-      pa_data::getPrecisePlanetData(s, pl);
+  return pl;
+}
 
-  if (check_planet.name == "NoMatch") {
-    return (pa_models::CPlanetCoordinates){
-        WToDegrees(Unwind(0)), WToDegrees(Unwind(0)), WToDegrees(Unwind(0)),
-        WToDegrees(Unwind(0)), WToDegrees(Unwind(0)), WToDegrees(Unwind(0)),
-        WToDegrees(Unwind(0))};
-  }
+/**
+ * Helper function for PlanetCoordinates()
+ *
+ * Position of planet ip (index into pl) from the elements of all the planets,
+ * the Sun's mean anomaly ms and longitude sr (radians), and the Sun's distance
+ * re (AU). The elements are copied, as the light-time iteration adjusts them.
+ */
+pa_models::CPlanetCoordinates
+PlanetCoordinatesFromElements(std::vector<pa_data::PlanetDataPrecise> pl,
+                              int ip, double t, double ms, double sr,
+                              double re) {
+  pa_models::COuterPlanetArguments outer;
+
+  if (ip > 3)
+    outer = OuterPlanetArguments(t);
+
+  return PlanetCoordinatesFromElements(pl, ip, t, ms, sr, re, outer);
+}
+
+/**
+ * Helper function for PlanetCoordinates()
+ *
+ * As above, with the outer planet arguments for t already found, so that
+ * several planets at one instant can share them.
+ */
+pa_models::CPlanetCoordinates
+PlanetCoordinatesFromElements(std::vector<pa_data::PlanetDataPrecise> pl,
+                              int ip, double t, double ms, double sr,
+                              double re,
+                              const pa_models::COuterPlanetArguments &outer) {
+  // The outer planet perturbations depend only on t, not on the light-time.
+  pa_models::CPlanetLongLatL4945 outerPerturbation(0.0, 0.0, 0.0, 0.0, 0.0,
+                                                   0.0, 0.0);
+  if (ip > 3)
+    outerPerturbation = PlanetLongL4945(
+        outer, static_cast<EOuterPlanet>(ip - 4), pl[ip].value4);
 
   double li = 0.0;
-  double ms = SunMeanAnomaly(lh, lm, ls, ds, zc, dy, mn, yr);
-  double sr = DegreesToRadians(SunLong(lh, lm, ls, ds, zc, dy, mn, yr));
-  double re = SunDist(lh, lm, ls, ds, zc, dy, mn, yr);
   double lg = sr + M_PI;
 
   double l0 = 0.0;
@@ -2765,13 +3005,13 @@ pa_models::CPlanetCoordinates PlanetCoordinates(double lh, double lm, double ls,
     double qf = 0.0;
     double qg = 0.0;
 
-    if (s == "Mercury") {
+    if (ip == 1) {
       pa_models::CPlanetLongLatL4685 temp_result = PlanetLongL4685(pl);
       qa = temp_result.qa;
       qb = temp_result.qb;
     }
 
-    if (s == "Venus") {
+    if (ip == 2) {
       pa_models::CPlanetLongLatL4735 temp_result = PlanetLongL4735(pl, ms, t);
 
       qa = temp_result.qa;
@@ -2780,7 +3020,7 @@ pa_models::CPlanetCoordinates PlanetCoordinates(double lh, double lm, double ls,
       qe = temp_result.qe;
     }
 
-    if (s == "Mars") {
+    if (ip == 3) {
       pa_models::CPlanetLongLatL4810 temp_result = PlanetLongL4810(pl, ms);
 
       qc = temp_result.qc;
@@ -2789,13 +3029,10 @@ pa_models::CPlanetCoordinates PlanetCoordinates(double lh, double lm, double ls,
       qb = temp_result.qb;
     }
 
-    pa_data::PlanetDataPrecise match_planet =
-        pa_data::getPrecisePlanetData(s, pl);
+    pa_data::PlanetDataPrecise match_planet = pl[ip];
 
-    if ((s == "Jupiter") || (s == "Saturn") || (s == "Uranus") ||
-        (s == "Neptune")) {
-      pa_models::CPlanetLongLatL4945 temp_result =
-          PlanetLongL4945(t, match_planet);
+    if (ip > 3) {
+      pa_models::CPlanetLongLatL4945 temp_result = outerPerturbation;
 
       qa = temp_result.qa;
       qb = temp_result.qb;
@@ -2955,287 +3192,580 @@ PlanetLongL4810(std::vector<pa_data::PlanetDataPrecise> pl, double ms) {
   return (pa_models::CPlanetLongLatL4810(a, sa, ca, qc, qe, qa, qb));
 }
 
+namespace {
+/**
+ * Sines and cosines held in COuterPlanetArguments::harmonics. The arguments
+ * are those of the book: j3, j4, j5, j6, j7 = j3 - j2, and jn (Neptune's mean
+ * longitude, 1.46205 + 3.81337t), with j9 = 2jn - j4 and the differences
+ * named by their parts (J4J3 is j4 - j3, JNJ4 is jn - j4, and so on).
+ * Multiples of one argument are contiguous, sines before cosines.
+ */
+// clang-format off
+enum OuterHarmonic {
+  kOne,
+  kSinJ3, kSin2J3, kSin3J3, kSin4J3,
+  kCosJ3, kCos2J3, kCos3J3, kCos4J3,
+  kSinJ4, kSin2J4,
+  kCosJ4, kCos2J4,
+  kSinJ5, kSin2J5,
+  kCosJ5, kCos2J5,
+  kSinJ6,
+  kCosJ6,
+  kSinJ7, kSin2J7, kSin3J7, kSin4J7, kSin5J7,
+  kCosJ7, kCos2J7, kCos3J7, kCos4J7, kCos5J7,
+  kSinJ9, kSin2J9,
+  kCosJ9, kCos2J9,
+  kSinJN,
+  kCosJN,
+  kSinJ4J2,
+  kCosJ4J2,
+  kSinJ4J3, kSin2J4J3, kSin3J4J3, kSin4J4J3,
+  kCosJ4J3, kCos2J4J3, kCos3J4J3, kCos4J4J3,
+  kSinJNJ2,
+  kCosJNJ2,
+  kSinJNJ3,
+  kCosJNJ3,
+  kSinJNJ4, kSin2JNJ4, kSin3JNJ4, kSin4JNJ4,
+  kCosJNJ4, kCos2JNJ4, kCos3JNJ4, kCos4JNJ4,
+  kSinUranusA, /**< sin(2j4 - j3) */
+  kCosUranusA, /**< cos(2j4 - j3) */
+  kCosUranusB, /**< cos(3j4 - j3) */
+  kSinUranusC, /**< sin(j4 + 3(jn - j4)) */
+  kOuterHarmonicCount
+};
+// clang-format on
+
+static_assert(kOuterHarmonicCount <= COuterPlanetArguments::kHarmonics,
+              "COuterPlanetArguments::harmonics is too small");
+
+/**
+ * One term of an outer planet perturbation: a quadratic in j1 times the
+ * product of two harmonics (kOne for a single harmonic or a constant).
+ */
+struct OuterPlanetTerm {
+  double coefficient[3];
+  OuterHarmonic first;
+  OuterHarmonic second;
+};
+
+struct OuterPlanetSeries {
+  const OuterPlanetTerm *terms;
+  std::size_t count;
+};
+
+template <std::size_t N>
+constexpr OuterPlanetSeries Series(const OuterPlanetTerm (&terms)[N]) {
+  return {terms, N};
+}
+
+const OuterPlanetSeries kNoSeries = {nullptr, 0};
+
+/**
+ * Series for one planet, in the book's units: qa and vk in degrees, qb in
+ * 1e-6 AU, qc and qg in degrees, qd in 1e-7, and qf in 1e-6 AU.
+ */
+struct OuterPlanetTable {
+  OuterPlanetSeries qa;
+  OuterPlanetSeries qb;
+  OuterPlanetSeries qc;
+  OuterPlanetSeries qd;
+  OuterPlanetSeries vk;
+  OuterPlanetSeries qf;
+  OuterPlanetSeries qg;
+};
+
+// clang-format off
+const OuterPlanetTerm kJupiterQc[] = {
+    {{0.331364, -0.010281, -0.004692}, kSinJ5, kOne},
+    {{0.003228, -0.064436, 0.002075}, kCosJ5, kOne},
+    {{-0.003083, -0.000275, 0.000489}, kSin2J5, kOne},
+    {{0.002472}, kSinJ6, kOne},
+    {{0.013619}, kSinJ7, kOne},
+    {{0.018472}, kSin2J7, kOne},
+    {{0.006717}, kSin3J7, kOne},
+    {{0.002775}, kSin4J7, kOne},
+    {{0.006417}, kSin2J7, kSinJ3},
+    {{0.007275, -0.001253}, kSinJ7, kSinJ3},
+    {{0.002439}, kSin3J7, kSinJ3},
+    {{-0.035681, -0.001208}, kSinJ7, kCosJ3},
+    {{-0.003767}, kCos2J7, kSinJ3},
+    {{-0.033839, -0.001125}, kCosJ7, kSinJ3},
+    {{-0.004261}, kSin2J7, kCosJ3},
+    {{-0.006333, 0.001161}, kCosJ7, kCosJ3},
+    {{0.002178}, kCosJ3, kOne},
+    {{-0.006675}, kCos2J7, kCosJ3},
+    {{-0.002664}, kCos3J7, kCosJ3},
+    {{-0.002572}, kSinJ7, kSin2J3},
+    {{-0.003567}, kSin2J7, kSin2J3},
+    {{0.002094}, kCosJ7, kCos2J3},
+    {{0.003342}, kCos2J7, kCos2J3},
+};
+
+const OuterPlanetTerm kJupiterQd[] = {
+    {{3606.0, 130.0, -43.0}, kSinJ5, kOne},
+    {{1289.0, -580.0}, kCosJ5, kOne},
+    {{-6764.0}, kSinJ7, kSinJ3},
+    {{-1110.0}, kSin2J7, kSinJ3},
+    {{-224.0}, kSin3J7, kSinJ3},
+    {{-204.0}, kSinJ3, kOne},
+    {{1284.0, 116.0}, kCosJ7, kSinJ3},
+    {{188.0}, kCos2J7, kSinJ3},
+    {{1460.0, 130.0}, kSinJ7, kCosJ3},
+    {{224.0}, kSin2J7, kCosJ3},
+    {{-817.0}, kCosJ3, kOne},
+    {{6074.0}, kCosJ7, kCosJ3},
+    {{992.0}, kCos2J7, kCosJ3},
+    {{508.0}, kCos3J7, kCosJ3},
+    {{230.0}, kCos4J7, kCosJ3},
+    {{108.0}, kCos5J7, kCosJ3},
+    {{-956.0, -73.0}, kSinJ7, kSin2J3},
+    {{448.0}, kSin2J7, kSin2J3},
+    {{137.0}, kSin3J7, kSin2J3},
+    {{-997.0, 108.0}, kCosJ7, kSin2J3},
+    {{480.0}, kCos2J7, kSin2J3},
+    {{148.0}, kCos3J7, kSin2J3},
+    {{-956.0, 99.0}, kSinJ7, kCos2J3},
+    {{490.0}, kSin2J7, kCos2J3},
+    {{158.0}, kSin3J7, kCos2J3},
+    {{179.0}, kCos2J3, kOne},
+    {{1024.0, 75.0}, kCosJ7, kCos2J3},
+    {{-437.0}, kCos2J7, kCos2J3},
+    {{-132.0}, kCos3J7, kCos2J3},
+};
+
+const OuterPlanetTerm kJupiterVk[] = {
+    {{0.007192, -0.003147}, kSinJ5, kOne},
+    {{-0.004344}, kSinJ3, kOne},
+    {{-0.020428, -0.000675, 0.000197}, kCosJ5, kOne},
+    {{0.034036}, kCosJ7, kSinJ3},
+    {{0.007269, 0.000672}, kSinJ7, kSinJ3},
+    {{0.005614}, kCos2J7, kSinJ3},
+    {{0.002964}, kCos3J7, kSinJ3},
+    {{0.037761}, kSinJ7, kCosJ3},
+    {{0.006158}, kSin2J7, kCosJ3},
+    {{-0.006603}, kCosJ7, kCosJ3},
+    {{-0.005356}, kSinJ7, kSin2J3},
+    {{0.002722}, kSin2J7, kSin2J3},
+    {{0.004483}, kCosJ7, kSin2J3},
+    {{-0.002642}, kCos2J7, kSin2J3},
+    {{0.004403}, kSinJ7, kCos2J3},
+    {{-0.002536}, kSin2J7, kCos2J3},
+    {{0.005547}, kCosJ7, kCos2J3},
+    {{-0.002689}, kCos2J7, kCos2J3},
+};
+
+const OuterPlanetTerm kJupiterQf[] = {
+    {{205.0}, kCosJ7, kOne},
+    {{-263.0}, kCosJ5, kOne},
+    {{693.0}, kCos2J7, kOne},
+    {{312.0}, kCos3J7, kOne},
+    {{147.0}, kCos4J7, kOne},
+    {{299.0}, kSinJ7, kSinJ3},
+    {{181.0}, kCos2J7, kSinJ3},
+    {{204.0}, kSin2J7, kCosJ3},
+    {{111.0}, kSin3J7, kCosJ3},
+    {{-337.0}, kCosJ7, kCosJ3},
+    {{-111.0}, kCos2J7, kCosJ3},
+};
+
+const OuterPlanetTerm kSaturnQc[] = {
+    {{0.007581}, kSin2J5, kOne},
+    {{-0.007986}, kSinJ6, kOne},
+    {{-0.148811}, kSinJ7, kOne},
+    {{-0.814181, 0.01815, -0.016714}, kSinJ5, kOne},
+    {{-0.010497, 0.160906, -0.0041}, kCosJ5, kOne},
+    {{-0.015208}, kSin3J7, kOne},
+    {{-0.006339}, kSin4J7, kOne},
+    {{-0.006244}, kSinJ3, kOne},
+    {{-0.0165}, kSin2J7, kSinJ3},
+    {{-0.040786}, kSin2J7, kOne},
+    {{0.008931, 0.002728}, kSinJ7, kSinJ3},
+    {{-0.005775}, kSin3J7, kSinJ3},
+    {{0.081344, 0.003206}, kCosJ7, kSinJ3},
+    {{0.015019}, kCos2J7, kSinJ3},
+    {{0.085581, 0.002494}, kSinJ7, kCosJ3},
+    {{0.014394}, kCos2J7, kCosJ3},
+    {{0.025328, -0.003117}, kCosJ7, kCosJ3},
+    {{0.006319}, kCos3J7, kCosJ3},
+    {{0.006369}, kSinJ7, kSin2J3},
+    {{0.009156}, kSin2J7, kSin2J3},
+    {{0.007525}, kSin3J4J3, kSin2J3},
+    {{-0.005236}, kCosJ7, kCos2J3},
+    {{-0.007736}, kCos2J7, kCos2J3},
+    {{-0.007528}, kCos3J4J3, kCos2J3},
+};
+
+const OuterPlanetTerm kSaturnQd[] = {
+    {{-7927.0, 2548.0, 91.0}, kSinJ5, kOne},
+    {{13381.0, 1226.0, -253.0}, kCosJ5, kOne},
+    {{248.0, -121.0}, kSin2J5, kOne},
+    {{-305.0, -91.0}, kCos2J5, kOne},
+    {{412.0}, kSin2J7, kOne},
+    {{12415.0}, kSinJ3, kOne},
+    {{390.0, -617.0}, kSinJ7, kSinJ3},
+    {{165.0, -204.0}, kSin2J7, kSinJ3},
+    {{26599.0}, kCosJ7, kSinJ3},
+    {{-4687.0}, kCos2J7, kSinJ3},
+    {{-1870.0}, kCos3J7, kSinJ3},
+    {{-821.0}, kCos4J7, kSinJ3},
+    {{-377.0}, kCos5J7, kSinJ3},
+    {{497.0}, kCos2J4J3, kSinJ3},
+    {{163.0, -611.0}, kCosJ3, kOne},
+    {{-12696.0}, kSinJ7, kCosJ3},
+    {{-4200.0}, kSin2J7, kCosJ3},
+    {{-1503.0}, kSin3J7, kCosJ3},
+    {{-619.0}, kSin4J7, kCosJ3},
+    {{-268.0}, kSin5J7, kCosJ3},
+    {{-282.0, -1306.0}, kCosJ7, kCosJ3},
+    {{-86.0, 230.0}, kCos2J7, kCosJ3},
+    {{461.0}, kSin2J4J3, kCosJ3},
+    {{-350.0}, kSin2J3, kOne},
+    {{2211.0, -286.0}, kSinJ7, kSin2J3},
+    {{-2208.0}, kSin2J7, kSin2J3},
+    {{-568.0}, kSin3J7, kSin2J3},
+    {{-346.0}, kSin4J7, kSin2J3},
+    {{-2780.0, -222.0}, kCosJ7, kSin2J3},
+    {{2022.0, 263.0}, kCos2J7, kSin2J3},
+    {{248.0}, kCos3J7, kSin2J3},
+    {{242.0}, kSin3J4J3, kSin2J3},
+    {{467.0}, kCos3J4J3, kSin2J3},
+    {{-490.0}, kCos2J3, kOne},
+    {{-2842.0, -279.0}, kSinJ7, kCos2J3},
+    {{128.0, 226.0}, kSin2J7, kCos2J3},
+    {{224.0}, kSin3J7, kCos2J3},
+    {{-1594.0, 282.0}, kCosJ7, kCos2J3},
+    {{2162.0, -207.0}, kCos2J7, kCos2J3},
+    {{561.0}, kCos3J7, kCos2J3},
+    {{343.0}, kCos4J7, kCos2J3},
+    {{469.0}, kSin3J4J3, kCos2J3},
+    {{-242.0}, kCos3J4J3, kCos2J3},
+    {{-205.0}, kSinJ7, kSin3J3},
+    {{262.0}, kSin3J7, kSin3J3},
+    {{208.0}, kCosJ7, kCos3J3},
+    {{-271.0}, kCos3J7, kCos3J3},
+    {{-382.0}, kCos3J7, kSin4J3},
+    {{-376.0}, kSin3J7, kCos4J3},
+};
+
+const OuterPlanetTerm kSaturnVk[] = {
+    {{0.077108, 0.007186, -0.001533}, kSinJ5, kOne},
+    {{-0.007075}, kSinJ7, kOne},
+    {{0.045803, -0.014766, -0.000536}, kCosJ5, kOne},
+    {{-0.072586}, kCosJ3, kOne},
+    {{-0.075825}, kSinJ7, kSinJ3},
+    {{-0.024839}, kSin2J7, kSinJ3},
+    {{-0.008631}, kSin3J7, kSinJ3},
+    {{-0.150383}, kCosJ7, kCosJ3},
+    {{0.026897}, kCos2J7, kCosJ3},
+    {{0.010053}, kCos3J7, kCosJ3},
+    {{-0.013597, -0.001719}, kSinJ7, kSin2J3},
+    {{0.011981}, kSin2J7, kCos2J3},
+    {{-0.007742, 0.001517}, kCosJ7, kSin2J3},
+    {{0.013586, -0.001375}, kCos2J7, kSin2J3},
+    {{-0.013667, 0.001239}, kSinJ7, kCos2J3},
+    {{0.014861, 0.001136}, kCosJ7, kCos2J3},
+    {{-0.013064, -0.001628}, kCos2J7, kCos2J3},
+};
+
+const OuterPlanetTerm kSaturnQf[] = {
+    {{572.0}, kSinJ5, kOne},
+    {{-1590.0}, kSin2J7, kCosJ3},
+    {{2933.0}, kCosJ5, kOne},
+    {{-647.0}, kSin3J7, kCosJ3},
+    {{33629.0}, kCosJ7, kOne},
+    {{-344.0}, kSin4J7, kCosJ3},
+    {{-3081.0}, kCos2J7, kOne},
+    {{2885.0}, kCosJ7, kCosJ3},
+    {{-1423.0}, kCos3J7, kOne},
+    {{2172.0, 102.0}, kCos2J7, kCosJ3},
+    {{-671.0}, kCos4J7, kOne},
+    {{296.0}, kCos3J7, kCosJ3},
+    {{-320.0}, kCos5J7, kOne},
+    {{-267.0}, kSin2J7, kSin2J3},
+    {{1098.0}, kSinJ3, kOne},
+    {{-778.0}, kCosJ7, kSin2J3},
+    {{-2812.0}, kSinJ7, kSinJ3},
+    {{495.0}, kCos2J7, kSin2J3},
+    {{688.0}, kSin2J7, kSinJ3},
+    {{250.0}, kCos3J7, kSin2J3},
+    {{-393.0}, kSin3J7, kSinJ3},
+    {{-856.0}, kSinJ7, kCos2J3},
+    {{-228.0}, kSin4J7, kSinJ3},
+    {{441.0}, kSin2J7, kCos2J3},
+    {{2138.0}, kCosJ7, kSinJ3},
+    {{296.0}, kCos2J7, kCos2J3},
+    {{-999.0}, kCos2J7, kSinJ3},
+    {{211.0}, kCos3J7, kCos2J3},
+    {{-642.0}, kCos3J7, kSinJ3},
+    {{-427.0}, kSinJ7, kSin3J3},
+    {{-325.0}, kCos4J7, kSinJ3},
+    {{398.0}, kSin3J7, kSin3J3},
+    {{-890.0}, kCosJ3, kOne},
+    {{344.0}, kCosJ7, kCos3J3},
+    {{2206.0}, kSinJ7, kCosJ3},
+    {{-427.0}, kCos3J7, kCos3J3},
+};
+
+const OuterPlanetTerm kSaturnQg[] = {
+    {{0.000747}, kCosJ7, kSinJ3},
+    {{0.001069}, kCosJ7, kCosJ3},
+    {{0.002108}, kSin2J7, kSin2J3},
+    {{0.001261}, kCos2J7, kSin2J3},
+    {{0.001236}, kSin2J7, kCos2J3},
+    {{-0.002075}, kCos2J7, kCos2J3},
+};
+
+const OuterPlanetTerm kUranusQa[] = {
+    {{-0.038581, 0.002031, -0.00191}, kCosUranusA, kOne},
+    {{0.010122, -0.000988}, kSinUranusA, kOne},
+    {{0.034964, -0.001038, 0.000868}, kCosUranusB, kOne},
+    {{0.005594}, kSinUranusC, kOne},
+    {{-0.014808}, kSinJ4J2, kOne},
+    {{-0.005794}, kSinJ4J3, kOne},
+    {{0.002347}, kCosJ4J3, kOne},
+    {{0.009872}, kSinJNJ4, kOne},
+    {{0.008803}, kSin2JNJ4, kOne},
+    {{-0.004308}, kSin3JNJ4, kOne},
+};
+
+const OuterPlanetTerm kUranusQb[] = {
+    {{-25948.0}, kOne, kOne},
+    {{4985.0}, kCosJ4J2, kOne},
+    {{-1230.0}, kCosJ4, kOne},
+    {{3354.0}, kCosJ4J3, kOne},
+    {{904.0}, kCos2JNJ4, kOne},
+    {{894.0}, kCosJNJ4, kOne},
+    {{-894.0}, kCos3JNJ4, kOne},
+    {{5795.0}, kCosJ4, kSinJ4J3},
+    {{-1165.0}, kSinJ4, kSinJ4J3},
+    {{1388.0}, kCos2J4, kSinJ4J3},
+    {{1351.0}, kCosJ4, kCosJ4J3},
+    {{5702.0}, kSinJ4, kCosJ4J3},
+    {{1388.0}, kSin2J4, kCosJ4J3},
+};
+
+const OuterPlanetTerm kUranusQc[] = {
+    {{0.864319, -0.001583}, kSinJ9, kOne},
+    {{0.082222, -0.006833}, kCosJ9, kOne},
+    {{0.036017}, kSin2J9, kOne},
+    {{-0.003019}, kCos2J9, kOne},
+    {{0.008122}, kSinJ6, kOne},
+};
+
+const OuterPlanetTerm kUranusQd[] = {
+    {{-3349.0, 163.0}, kSinJ9, kOne},
+    {{20981.0}, kCosJ9, kOne},
+    {{1311.0}, kCos2J9, kOne},
+};
+
+const OuterPlanetTerm kUranusVk[] = {
+    {{0.120303}, kSinJ9, kOne},
+    {{0.006197}, kSin2J9, kOne},
+    {{0.019472, -0.000947}, kCosJ9, kOne},
+};
+
+const OuterPlanetTerm kUranusQf[] = {
+    {{-3825.0}, kCosJ9, kOne},
+};
+
+const OuterPlanetTerm kUranusQg[] = {
+    {{0.000458}, kSinJ4J3, kSinJ4},
+    {{-0.000642}, kCosJ4J3, kSinJ4},
+    {{-0.000517}, kCos4JNJ4, kSinJ4},
+    {{-0.000347}, kSinJ4J3, kCosJ4},
+    {{-0.000853}, kCosJ4J3, kCosJ4},
+    {{-0.000517}, kSin4J4J3, kCosJ4},
+    {{0.000403}, kCos2JNJ4, kSin2J4},
+    {{0.000403}, kSin2JNJ4, kCos2J4},
+};
+
+const OuterPlanetTerm kNeptuneQa[] = {
+    {{-0.009556}, kSinJNJ2, kOne},
+    {{-0.005178}, kSinJNJ3, kOne},
+    {{0.002572}, kSin2JNJ4, kOne},
+    {{-0.002972}, kCos2JNJ4, kSinJN},
+    {{-0.002833}, kSin2JNJ4, kCosJN},
+};
+
+const OuterPlanetTerm kNeptuneQb[] = {
+    {{-40596.0}, kOne, kOne},
+    {{4992.0}, kCosJNJ2, kOne},
+    {{2744.0}, kCosJNJ3, kOne},
+    {{2044.0}, kCosJNJ4, kOne},
+    {{1051.0}, kCos2JNJ4, kOne},
+};
+
+const OuterPlanetTerm kNeptuneQc[] = {
+    {{-0.589833, 0.001089}, kSinJ9, kOne},
+    {{-0.056094, 0.004658}, kCosJ9, kOne},
+    {{-0.024286}, kSin2J9, kOne},
+};
+
+const OuterPlanetTerm kNeptuneQd[] = {
+    {{4389.0}, kSinJ9, kOne},
+    {{1129.0}, kSin2J9, kOne},
+    {{4262.0}, kCosJ9, kOne},
+    {{1089.0}, kCos2J9, kOne},
+};
+
+const OuterPlanetTerm kNeptuneVk[] = {
+    {{0.024039}, kSinJ9, kOne},
+    {{-0.025303}, kCosJ9, kOne},
+    {{0.006206}, kSin2J9, kOne},
+    {{-0.005992}, kCos2J9, kOne},
+};
+
+const OuterPlanetTerm kNeptuneQf[] = {
+    {{8189.0}, kCosJ9, kOne},
+    {{-817.0}, kSinJ9, kOne},
+    {{781.0}, kCos2J9, kOne},
+};
+
+const OuterPlanetTerm kNeptuneQg[] = {
+    {{0.000336}, kCos2JNJ4, kSinJN},
+    {{0.000364}, kSin2JNJ4, kCosJN},
+};
+// clang-format on
+
+/** Indexed by EOuterPlanet. */
+const OuterPlanetTable kOuterPlanetTables[] = {
+    {kNoSeries, kNoSeries, Series(kJupiterQc), Series(kJupiterQd),
+     Series(kJupiterVk), Series(kJupiterQf), kNoSeries},
+    {kNoSeries, kNoSeries, Series(kSaturnQc), Series(kSaturnQd),
+     Series(kSaturnVk), Series(kSaturnQf), Series(kSaturnQg)},
+    {Series(kUranusQa), Series(kUranusQb), Series(kUranusQc),
+     Series(kUranusQd), Series(kUranusVk), Series(kUranusQf),
+     Series(kUranusQg)},
+    {Series(kNeptuneQa), Series(kNeptuneQb), Series(kNeptuneQc),
+     Series(kNeptuneQd), Series(kNeptuneVk), Series(kNeptuneQf),
+     Series(kNeptuneQg)},
+};
+
+/**
+ * Sines and cosines of the first count multiples of angle, from one sin/cos
+ * and the angle-sum formulae.
+ */
+void FillMultiples(double angle, int count, double *sines, double *cosines) {
+  double s = sin(angle);
+  double c = cos(angle);
+
+  sines[0] = s;
+  cosines[0] = c;
+  for (int k = 1; k < count; k++) {
+    sines[k] = sines[k - 1] * c + cosines[k - 1] * s;
+    cosines[k] = cosines[k - 1] * c - sines[k - 1] * s;
+  }
+}
+
+double SumOuterSeries(const OuterPlanetSeries &series, const double *harmonics,
+                      double j1) {
+  double sum = 0.0;
+
+  for (std::size_t i = 0; i < series.count; i++) {
+    const OuterPlanetTerm &term = series.terms[i];
+    double amplitude =
+        term.coefficient[0] +
+        (term.coefficient[1] + term.coefficient[2] * j1) * j1;
+
+    sum += amplitude * harmonics[term.first] * harmonics[term.second];
+  }
+
+  return sum;
+}
+} // namespace
+
 /**
  * Helper function for PlanetCoordinates()
+ *
+ * Arguments of the outer planet perturbations at t Julian centuries from
+ * 1900 January 0.5. They are shared by Jupiter, Saturn, Uranus and Neptune,
+ * so one set serves all four planets and every light-time iteration.
  */
-pa_models::CPlanetLongLatL4945
-PlanetLongL4945(double t, pa_data::PlanetDataPrecise planet) {
-  double qa = 0.0;
-  double qb = 0.0;
-  double qc = 0.0;
-  double qd = 0.0;
-  double qe = 0.0;
-  double qf = 0.0;
-  double qg = 0.0;
-  double vk = 0.0;
-  double ja = 0.0;
-  double jb = 0.0;
-  double jc = 0.0;
-
-  double j1 = t / 5.0 + 0.1;
+pa_models::COuterPlanetArguments OuterPlanetArguments(double t) {
+  pa_models::COuterPlanetArguments arguments;
+  double *h = arguments.harmonics;
+
   double j2 = Unwind(4.14473 + 52.9691 * t);
   double j3 = Unwind(4.641118 + 21.32991 * t);
   double j4 = Unwind(4.250177 + 7.478172 * t);
   double j5 = 5.0 * j3 - 2.0 * j2;
   double j6 = 2.0 * j2 - 6.0 * j3 + 3.0 * j4;
+  double jn = Unwind(1.46205 + 3.81337 * t);
 
-  if ((planet.name == "Mercury") || (planet.name == "Venus") ||
-      (planet.name == "Mars")) {
-    return (pa_models::CPlanetLongLatL4945(qa, qb, qc, qd, qe, qf, qg));
-  }
+  arguments.j1 = t / 5.0 + 0.1;
 
-  if ((planet.name == "Jupiter") || (planet.name == "Saturn")) {
-    double j7 = j3 - j2;
-    double u1 = sin(j3);
-    double u2 = cos(j3);
-    double u3 = sin(2.0 * j3);
-    double u4 = cos(2.0 * j3);
-    double u5 = sin(j5);
-    double u6 = cos(j5);
-    double u7 = sin(2.0 * j5);
-    double u8a = sin(j6);
-    double u9 = sin(j7);
-    double ua = cos(j7);
-    double ub = sin(2.0 * j7);
-    double uc = cos(2.0 * j7);
-    double ud = sin(3.0 * j7);
-    double ue = cos(3.0 * j7);
-    double uf = sin(4.0 * j7);
-    double ug = cos(4.0 * j7);
-    double vh = cos(5.0 * j7);
-
-    if (planet.name == "Saturn") {
-      double ui = sin(3.0 * j3);
-      double uj = cos(3.0 * j3);
-      double uk = sin(4.0 * j3);
-      double ul = cos(4.0 * j3);
-      double vi = cos(2.0 * j5);
-      double un = sin(5.0 * j7);
-      double j8 = j4 - j3;
-      double uo = sin(2.0 * j8);
-      double up = cos(2.0 * j8);
-      double uq = sin(3.0 * j8);
-      double ur = cos(3.0 * j8);
-
-      qc = 0.007581 * u7 - 0.007986 * u8a - 0.148811 * u9;
-      qc -= (0.814181 - (0.01815 - 0.016714 * j1) * j1) * u5;
-      qc -= (0.010497 - (0.160906 - 0.0041 * j1) * j1) * u6;
-      qc = qc - 0.015208 * ud - 0.006339 * uf - 0.006244 * u1;
-      qc = qc - 0.0165 * ub * u1 - 0.040786 * ub;
-      qc = qc + (0.008931 + 0.002728 * j1) * u9 * u1 - 0.005775 * ud * u1;
-      qc = qc + (0.081344 + 0.003206 * j1) * ua * u1 + 0.015019 * uc * u1;
-      qc = qc + (0.085581 + 0.002494 * j1) * u9 * u2 + 0.014394 * uc * u2;
-      qc = qc + (0.025328 - 0.003117 * j1) * ua * u2 + 0.006319 * ue * u2;
-      qc = qc + 0.006369 * u9 * u3 + 0.009156 * ub * u3 + 0.007525 * uq * u3;
-      qc = qc - 0.005236 * ua * u4 - 0.007736 * uc * u4 - 0.007528 * ur * u4;
-      qc = DegreesToRadians(qc);
-
-      qd = (-7927.0 + (2548.0 + 91.0 * j1) * j1) * u5;
-      qd = qd + (13381.0 + (1226.0 - 253.0 * j1) * j1) * u6 +
-           (248.0 - 121.0 * j1) * u7;
-      qd = qd - (305.0 + 91.0 * j1) * vi + 412.0 * ub + 12415.0 * u1;
-      qd = qd + (390.0 - 617.0 * j1) * u9 * u1 + (165.0 - 204.0 * j1) * ub * u1;
-      qd = qd + 26599.0 * ua * u1 - 4687.0 * uc * u1 - 1870.0 * ue * u1 -
-           821.0 * ug * u1;
-      qd = qd - 377.0 * vh * u1 + 497.0 * up * u1 + (163.0 - 611.0 * j1) * u2;
-      qd = qd - 12696.0 * u9 * u2 - 4200.0 * ub * u2 - 1503.0 * ud * u2 -
-           619.0 * uf * u2;
-      qd = qd - 268.0 * un * u2 - (282.0 + 1306.0 * j1) * ua * u2;
-      qd = qd + (-86.0 + 230.0 * j1) * uc * u2 + 461.0 * uo * u2 - 350.0 * u3;
-      qd = qd + (2211.0 - 286.0 * j1) * u9 * u3 - 2208.0 * ub * u3 -
-           568.0 * ud * u3;
-      qd = qd - 346.0 * uf * u3 - (2780.0 + 222.0 * j1) * ua * u3;
-      qd = qd + (2022.0 + 263.0 * j1) * uc * u3 + 248.0 * ue * u3 +
-           242.0 * uq * u3;
-      qd = qd + 467.0 * ur * u3 - 490.0 * u4 - (2842.0 + 279.0 * j1) * u9 * u4;
-      qd = qd + (128.0 + 226.0 * j1) * ub * u4 + 224.0 * ud * u4;
-      qd = qd + (-1594.0 + 282.0 * j1) * ua * u4 +
-           (2162.0 - 207.0 * j1) * uc * u4;
-      qd = qd + 561.0 * ue * u4 + 343.0 * ug * u4 + 469.0 * uq * u4 -
-           242.0 * ur * u4;
-      qd = qd - 205.0 * u9 * ui + 262.0 * ud * ui + 208.0 * ua * uj -
-           271.0 * ue * uj;
-      qd = qd - 382.0 * ue * uk - 376.0 * ud * ul;
-      qd *= 0.0000001;
-
-      vk = (0.077108 + (0.007186 - 0.001533 * j1) * j1) * u5;
-      vk -= 0.007075 * u9;
-      vk += (0.045803 - (0.014766 + 0.000536 * j1) * j1) * u6;
-      vk = vk - 0.072586 * u2 - 0.075825 * u9 * u1 - 0.024839 * ub * u1;
-      vk = vk - 0.008631 * ud * u1 - 0.150383 * ua * u2;
-      vk = vk + 0.026897 * uc * u2 + 0.010053 * ue * u2;
-      vk = vk - (0.013597 + 0.001719 * j1) * u9 * u3 + 0.011981 * ub * u4;
-      vk -= (0.007742 - 0.001517 * j1) * ua * u3;
-      vk += (0.013586 - 0.001375 * j1) * uc * u3;
-      vk -= (0.013667 - 0.001239 * j1) * u9 * u4;
-      vk += (0.014861 + 0.001136 * j1) * ua * u4;
-      vk -= (0.013064 + 0.001628 * j1) * uc * u4;
-      qe = qc - (DegreesToRadians(vk) / planet.value4);
-
-      qf = 572.0 * u5 - 1590.0 * ub * u2 + 2933.0 * u6 - 647.0 * ud * u2;
-      qf = qf + 33629.0 * ua - 344.0 * uf * u2 - 3081.0 * uc + 2885.0 * ua * u2;
-      qf = qf - 1423.0 * ue + (2172.0 + 102.0 * j1) * uc * u2 - 671.0 * ug;
-      qf = qf + 296.0 * ue * u2 - 320.0 * vh - 267.0 * ub * u3 + 1098.0 * u1;
-      qf = qf - 778.0 * ua * u3 - 2812.0 * u9 * u1 + 495.0 * uc * u3 +
-           688.0 * ub * u1;
-      qf = qf + 250.0 * ue * u3 - 393.0 * ud * u1 - 856.0 * u9 * u4 -
-           228.0 * uf * u1;
-      qf = qf + 441.0 * ub * u4 + 2138.0 * ua * u1 + 296.0 * uc * u4 -
-           999.0 * uc * u1;
-      qf = qf + 211.0 * ue * u4 - 642.0 * ue * u1 - 427.0 * u9 * ui -
-           325.0 * ug * u1;
-      qf = qf + 398.0 * ud * ui - 890.0 * u2 + 344.0 * ua * uj +
-           2206.0 * u9 * u2;
-      qf -= 427.0 * ue * uj;
-      qf *= 0.000001;
-
-      qg = 0.000747 * ua * u1 + 0.001069 * ua * u2 + 0.002108 * ub * u3;
-      qg = qg + 0.001261 * uc * u3 + 0.001236 * ub * u4 - 0.002075 * uc * u4;
-      qg = DegreesToRadians(qg);
-
-      return (pa_models::CPlanetLongLatL4945(qa, qb, qc, qd, qe, qf, qg));
-    }
+  h[kOne] = 1.0;
+  FillMultiples(j3, 4, &h[kSinJ3], &h[kCosJ3]);
+  FillMultiples(j4, 2, &h[kSinJ4], &h[kCosJ4]);
+  FillMultiples(j5, 2, &h[kSinJ5], &h[kCosJ5]);
+  FillMultiples(j6, 1, &h[kSinJ6], &h[kCosJ6]);
+  FillMultiples(j3 - j2, 5, &h[kSinJ7], &h[kCosJ7]);
+  FillMultiples(2.0 * jn - j4, 2, &h[kSinJ9], &h[kCosJ9]);
+  FillMultiples(jn, 1, &h[kSinJN], &h[kCosJN]);
+  FillMultiples(j4 - j2, 1, &h[kSinJ4J2], &h[kCosJ4J2]);
+  FillMultiples(j4 - j3, 4, &h[kSinJ4J3], &h[kCosJ4J3]);
+  FillMultiples(jn - j2, 1, &h[kSinJNJ2], &h[kCosJNJ2]);
+  FillMultiples(jn - j3, 1, &h[kSinJNJ3], &h[kCosJNJ3]);
+  FillMultiples(jn - j4, 4, &h[kSinJNJ4], &h[kCosJNJ4]);
 
-    qc = (0.331364 - (0.010281 + 0.004692 * j1) * j1) * u5;
-    qc += (0.003228 - (0.064436 - 0.002075 * j1) * j1) * u6;
-    qc -= (0.003083 + (0.000275 - 0.000489 * j1) * j1) * u7;
-    qc = qc + 0.002472 * u8a + 0.013619 * u9 + 0.018472 * ub;
-    qc = qc + 0.006717 * ud + 0.002775 * uf + 0.006417 * ub * u1;
-    qc = qc + (0.007275 - 0.001253 * j1) * u9 * u1 + 0.002439 * ud * u1;
-    qc = qc - (0.035681 + 0.001208 * j1) * u9 * u2 - 0.003767 * uc * u1;
-    qc = qc - (0.033839 + 0.001125 * j1) * ua * u1 - 0.004261 * ub * u2;
-    qc = qc + (0.001161 * j1 - 0.006333) * ua * u2 + 0.002178 * u2;
-    qc = qc - 0.006675 * uc * u2 - 0.002664 * ue * u2 - 0.002572 * u9 * u3;
-    qc = qc - 0.003567 * ub * u3 + 0.002094 * ua * u4 + 0.003342 * uc * u4;
-    qc = DegreesToRadians(qc);
-
-    qd = (3606.0 + (130.0 - 43.0 * j1) * j1) * u5 + (1289.0 - 580.0 * j1) * u6;
-    qd =
-        qd - 6764.0 * u9 * u1 - 1110.0 * ub * u1 - 224.0 * ud * u1 - 204.0 * u1;
-    qd = qd + (1284.0 + 116.0 * j1) * ua * u1 + 188.0 * uc * u1;
-    qd = qd + (1460.0 + 130.0 * j1) * u9 * u2 + 224.0 * ub * u2 - 817.0 * u2;
-    qd = qd + 6074.0 * u2 * ua + 992.0 * uc * u2 + 508.0 * ue * u2 +
-         230.0 * ug * u2;
-    qd = qd + 108.0 * vh * u2 - (956.0 + 73.0 * j1) * u9 * u3 + 448.0 * ub * u3;
-    qd =
-        qd + 137.0 * ud * u3 + (108.0 * j1 - 997.0) * ua * u3 + 480.0 * uc * u3;
-    qd = qd + 148.0 * ue * u3 + (99.0 * j1 - 956.0) * u9 * u4 + 490.0 * ub * u4;
-    qd = qd + 158.0 * ud * u4 + 179.0 * u4 + (1024.0 + 75.0 * j1) * ua * u4;
-    qd = qd - 437.0 * uc * u4 - 132.0 * ue * u4;
-    qd *= 0.0000001;
-
-    vk = (0.007192 - 0.003147 * j1) * u5 - 0.004344 * u1;
-    vk += (j1 * (0.000197 * j1 - 0.000675) - 0.020428) * u6;
-    vk = vk + 0.034036 * ua * u1 + (0.007269 + 0.000672 * j1) * u9 * u1;
-    vk = vk + 0.005614 * uc * u1 + 0.002964 * ue * u1 + 0.037761 * u9 * u2;
-    vk = vk + 0.006158 * ub * u2 - 0.006603 * ua * u2 - 0.005356 * u9 * u3;
-    vk = vk + 0.002722 * ub * u3 + 0.004483 * ua * u3;
-    vk = vk - 0.002642 * uc * u3 + 0.004403 * u9 * u4;
-    vk = vk - 0.002536 * ub * u4 + 0.005547 * ua * u4 - 0.002689 * uc * u4;
-    qe = qc - (DegreesToRadians(vk) / planet.value4);
-
-    qf = 205.0 * ua - 263.0 * u6 + 693.0 * uc + 312.0 * ue + 147.0 * ug +
-         299.0 * u9 * u1;
-    qf = qf + 181.0 * uc * u1 + 204.0 * ub * u2 + 111.0 * ud * u2 -
-         337.0 * ua * u2;
-    qf -= 111.0 * uc * u2;
-    qf *= 0.000001;
-
-    return (pa_models::CPlanetLongLatL4945(qa, qb, qc, qd, qe, qf, qg));
-  }
+  h[kSinUranusA] = h[kSinJ4] * h[kCosJ4J3] + h[kCosJ4] * h[kSinJ4J3];
+  h[kCosUranusA] = h[kCosJ4] * h[kCosJ4J3] - h[kSinJ4] * h[kSinJ4J3];
+  h[kCosUranusB] = h[kCos2J4] * h[kCosJ4J3] - h[kSin2J4] * h[kSinJ4J3];
+  h[kSinUranusC] = h[kSinJ4] * h[kCos3JNJ4] + h[kCosJ4] * h[kSin3JNJ4];
 
-  if ((planet.name == "Uranus") || (planet.name == "Neptune")) {
-    double j8 = Unwind(1.46205 + 3.81337 * t);
-    double j9 = 2.0 * j8 - j4;
-    double vj = sin(j9);
-    double uu = cos(j9);
-    double uv = sin(2.0 * j9);
-    double uw = cos(2.0 * j9);
-
-    if (planet.name == "Neptune") {
-      ja = j8 - j2;
-      jb = j8 - j3;
-      jc = j8 - j4;
-      qc = (0.001089 * j1 - 0.589833) * vj;
-      qc = qc + (0.004658 * j1 - 0.056094) * uu - 0.024286 * uv;
-      qc = DegreesToRadians(qc);
-
-      vk = 0.024039 * vj - 0.025303 * uu + 0.006206 * uv;
-      vk -= 0.005992 * uw;
-      qe = qc - (DegreesToRadians(vk) / planet.value4);
-
-      qd = 4389.0 * vj + 1129.0 * uv + 4262.0 * uu + 1089.0 * uw;
-      qd *= 0.0000001;
-
-      qf = 8189.0 * uu - 817.0 * vj + 781.0 * uw;
-      qf *= 0.000001;
-
-      double vd = sin(2.0 * jc);
-      double ve = cos(2.0 * jc);
-      double vf = sin(j8);
-      double vg = cos(j8);
-      qa = -0.009556 * sin(ja) - 0.005178 * sin(jb);
-      qa = qa + 0.002572 * vd - 0.002972 * ve * vf - 0.002833 * vd * vg;
-
-      qg = 0.000336 * ve * vf + 0.000364 * vd * vg;
-      qg = DegreesToRadians(qg);
-
-      qb = -40596.0 + 4992.0 * cos(ja) + 2744.0 * cos(jb);
-      qb = qb + 2044.0 * cos(jc) + 1051.0 * ve;
-      qb *= 0.000001;
-
-      return (pa_models::CPlanetLongLatL4945(qa, qb, qc, qd, qe, qf, qg));
-    }
+  return arguments;
+}
 
-    ja = j4 - j2;
-    jb = j4 - j3;
-    jc = j8 - j4;
-    qc = (0.864319 - 0.001583 * j1) * vj;
-    qc = qc + (0.082222 - 0.006833 * j1) * uu + 0.036017 * uv;
-    qc = qc - 0.003019 * uw + 0.008122 * sin(j6);
-    qc = DegreesToRadians(qc);
-
-    vk = 0.120303 * vj + 0.006197 * uv;
-    vk += (0.019472 - 0.000947 * j1) * uu;
-    qe = qc - (DegreesToRadians(vk) / planet.value4);
-
-    qd = (163.0 * j1 - 3349.0) * vj + 20981.0 * uu + 1311.0 * uw;
-    qd *= 0.0000001;
-
-    qf = -0.003825 * uu;
-
-    qa = (-0.038581 + (0.002031 - 0.00191 * j1) * j1) * cos(j4 + jb);
-    qa += (0.010122 - 0.000988 * j1) * sin(j4 + jb);
-    double a =
-        (0.034964 - (0.001038 - 0.000868 * j1) * j1) * cos(2.0 * j4 + jb);
-    qa = a + qa + 0.005594 * sin(j4 + 3.0 * jc) - 0.014808 * sin(ja);
-    qa = qa - 0.005794 * sin(jb) + 0.002347 * cos(jb);
-    qa = qa + 0.009872 * sin(jc) + 0.008803 * sin(2.0 * jc);
-    qa -= 0.004308 * sin(3.0 * jc);
-
-    double ux = sin(jb);
-    double uy = cos(jb);
-    double uz = sin(j4);
-    double va = cos(j4);
-    double vb = sin(2.0 * j4);
-    double vc = cos(2.0 * j4);
-    qg = (0.000458 * ux - 0.000642 * uy - 0.000517 * cos(4.0 * jc)) * uz;
-    qg -= (0.000347 * ux + 0.000853 * uy + 0.000517 * sin(4.0 * jb)) * va;
-    qg += 0.000403 * (cos(2.0 * jc) * vb + sin(2.0 * jc) * vc);
-    qg = DegreesToRadians(qg);
-
-    qb = -25948.0 + 4985.0 * cos(ja) - 1230.0 * va + 3354.0 * uy;
-    qb = qb + 904.0 * cos(2.0 * jc) + 894.0 * (cos(jc) - cos(3.0 * jc));
-    qb += (5795.0 * va - 1165.0 * uz + 1388.0 * vc) * ux;
-    qb += (1351.0 * va + 5702.0 * uz + 1388.0 * vb) * uy;
-    qb *= 0.000001;
-
-    return (pa_models::CPlanetLongLatL4945(qa, qb, qc, qd, qe, qf, qg));
-  }
+/**
+ * Helper function for PlanetCoordinates()
+ *
+ * Perturbations of one outer planet, from the shared arguments and the
+ * planet's eccentricity (value4 of its elements).
+ */
+pa_models::CPlanetLongLatL4945
+PlanetLongL4945(const pa_models::COuterPlanetArguments &arguments,
+                EOuterPlanet planet, double eccentricity) {
+  const OuterPlanetTable &table =
+      kOuterPlanetTables[static_cast<int>(planet)];
+  const double *h = arguments.harmonics;
+  double j1 = arguments.j1;
+
+  double qa = SumOuterSeries(table.qa, h, j1);
+  double qb = SumOuterSeries(table.qb, h, j1) * 0.000001;
+  double qc = DegreesToRadians(SumOuterSeries(table.qc, h, j1));
+  double qd = SumOuterSeries(table.qd, h, j1) * 0.0000001;
+  double vk = SumOuterSeries(table.vk, h, j1);
+  double qe = qc - (DegreesToRadians(vk) / eccentricity);
+  double qf = SumOuterSeries(table.qf, h, j1) * 0.000001;
+  double qg = DegreesToRadians(SumOuterSeries(table.qg, h, j1));
 
   return (pa_models::CPlanetLongLatL4945(qa, qb, qc, qd, qe, qf, qg));
 }
 
+/**
+ * Helper function for PlanetCoordinates()
+ *
+ * Perturbations of the named planet at t Julian centuries from 1900 January
+ * 0.5; all zero for Mercury, Venus and Mars.
+ */
+pa_models::CPlanetLongLatL4945
+PlanetLongL4945(double t, pa_data::PlanetDataPrecise planet) {
+  EOuterPlanet outerPlanet;
+
+  if (planet.name == "Jupiter")
+    outerPlanet = EOuterPlanet::Jupiter;
+  else if (planet.name == "Saturn")
+    outerPlanet = EOuterPlanet::Saturn;
+  else if (planet.name == "Uranus")
+    outerPlanet = EOuterPlanet::Uranus;
+  else if (planet.name == "Neptune")
+    outerPlanet = EOuterPlanet::Neptune;
+  else
+    return (pa_models::CPlanetLongLatL4945(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0));
+
+  return PlanetLongL4945(OuterPlanetArguments(t), outerPlanet, planet.value4);
+}
+
 /**
  * Calculate longitude, latitude, and distance of parabolic-orbit comet.
  *
@@ -3316,15 +3846,83 @@ PCometLongLatDist(double lh, /** Local civil time, hour part. */
                                       comet_dist_au);
 }
 
+/**
+ * Calculate longitude, latitude, and distance of an elliptical-orbit comet.
+ *
+ * Helper function for PAComet::PositionOfEllipticalComet(), which uses the
+ * book's method rather than solving the orbit in space. Longitude is in the
+ * range 0-360 degrees.
+ */
+pa_models::CCometLongLatDist
+ECometLongLatDist(double lh, double lm, double ls, int ds, int zc, double dy,
+                  int mn, int yr, const pa_data::CometDataElliptical &comet) {
+  double gd = LocalCivilTimeGreenwichDay(lh, lm, ls, ds, zc, dy, mn, yr);
+  int gm = LocalCivilTimeGreenwichMonth(lh, lm, ls, ds, zc, dy, mn, yr);
+  int gy = LocalCivilTimeGreenwichYear(lh, lm, ls, ds, zc, dy, mn, yr);
+
+  double timeSinceEpochYears =
+      (CivilDateToJulianDate(gd, gm, gy) - CivilDateToJulianDate(0.0, 1, gy)) /
+          365.242191 +
+      gy - comet.epoch_EpochOfPerihelion;
+  double mcDeg = 360 * timeSinceEpochYears / comet.period_PeriodOfOrbit;
+  double mcRad = DegreesToRadians(mcDeg - 360 * floor(mcDeg / 360));
+  double eccentricity = comet.ecc_EccentricityOfOrbit;
+  double trueAnomalyDeg = WToDegrees(TrueAnomaly(mcRad, eccentricity));
+  double lcDeg = trueAnomalyDeg + comet.peri_LongitudeOfPerihelion;
+  double rAU = comet.axis_SemiMajorAxisOfOrbit *
+               (1 - eccentricity * eccentricity) /
+               (1 + eccentricity * cos(DegreesToRadians(trueAnomalyDeg)));
+  double lcNodeRad =
+      DegreesToRadians(lcDeg - comet.node_LongitudeOfAscendingNode);
+  double psiRad = asin(sin(lcNodeRad) *
+                       sin(DegreesToRadians(comet.incl_InclinationOfOrbit)));
+
+  double y =
+      sin(lcNodeRad) * cos(DegreesToRadians(comet.incl_InclinationOfOrbit));
+  double x = cos(lcNodeRad);
+
+  double ldDeg = WToDegrees(atan2(y, x)) + comet.node_LongitudeOfAscendingNode;
+  double rdAU = rAU * cos(psiRad);
+
+  double earthLongitudeLeDeg = SunLong(lh, lm, ls, ds, zc, dy, mn, yr) + 180.0;
+  double earthRadiusVectorAU = SunDist(lh, lm, ls, ds, zc, dy, mn, yr);
+
+  double leLdRad = DegreesToRadians(earthLongitudeLeDeg - ldDeg);
+  double aRad = (rdAU < earthRadiusVectorAU)
+                    ? atan2((rdAU * sin(leLdRad)),
+                            (earthRadiusVectorAU - rdAU * cos(leLdRad)))
+                    : atan2((earthRadiusVectorAU * sin(-leLdRad)),
+                            (rdAU - earthRadiusVectorAU * cos(leLdRad)));
+
+  double cometLongDeg1 = (rdAU < earthRadiusVectorAU)
+                             ? 180.0 + earthLongitudeLeDeg + WToDegrees(aRad)
+                             : WToDegrees(aRad) + ldDeg;
+  double cometLongDeg = cometLongDeg1 - 360 * floor(cometLongDeg1 / 360);
+  double cometLatDeg = WToDegrees(
+      atan(rdAU * tan(psiRad) * sin(DegreesToRadians((cometLongDeg1 - ldDeg))) /
+           (earthRadiusVectorAU * sin(-leLdRad))));
+  double cometDistanceAU = sqrt(
+      pow(earthRadiusVectorAU, 2) + pow(rAU, 2) -
+      2.0 * earthRadiusVectorAU * rAU *
+          cos(DegreesToRadians((lcDeg - earthLongitudeLeDeg))) * cos(psiRad));
+
+  return pa_models::CCometLongLatDist(cometLongDeg, cometLatDeg,
+                                      cometDistanceAU);
+}
+
 /**
  * For W, in radians, return S, also in radians.
  *
  * Original macro name: SolveCubic
  */
 double SolveCubic(double w) {
+  PA_INSTRUMENT_SCOPE(SolveCubic);
+
   double s = w / 3.0;
 
   while (1 == 1) {
+    PA_INSTRUMENT_ITERATIONS(SolveCubic, 1);
+
     double s2 = s * s;
     double d = (s2 + 3.0) * s - w;
 
@@ -3336,174 +3934,72 @@ double SolveCubic(double w) {
   }
 }
 
+/**
+ * \brief Solve Barker's equation, S^3 + 3S = W, in closed form.
+ *
+ * Same root as SolveCubic(), with substitution S = 2 sinh(theta), which turns
+ * the cubic into sinh(3 theta) = W / 2. There is no iteration, so the cost is
+ * the same for every W, and the result is odd in W and accurate for all W.
+ *
+ * @return S = tan(true anomaly / 2).
+ */
+double SolveBarker(double w) { return 2.0 * sinh(asinh(w / 2.0) / 3.0); }
+
 /**
  * Calculate longitude, latitude, and horizontal parallax of the Moon.
  *
  * Original macro names: MoonLong, MoonLat, MoonHP
+ *
+ * @param minAmplitude Terms with amplitudes below this (degrees) are left out;
+ * 0 keeps the full series.
  */
 pa_models::CMoonLongLatHP MoonLongLatHP(double lh, double lm, double ls, int ds,
-                                        int zc, double dy, int mn, int yr) {
-  double ut = LocalCivilTimeToUniversalTime(lh, lm, ls, ds, zc, dy, mn, yr);
-  double gd = LocalCivilTimeGreenwichDay(lh, lm, ls, ds, zc, dy, mn, yr);
-  int gm = LocalCivilTimeGreenwichMonth(lh, lm, ls, ds, zc, dy, mn, yr);
-  int gy = LocalCivilTimeGreenwichYear(lh, lm, ls, ds, zc, dy, mn, yr);
-  double t = ((CivilDateToJulianDate(gd, gm, gy) - 2415020.0) / 36525.0) +
-             (ut / 876600.0);
-  double t2 = t * t;
+                                        int zc, double dy, int mn, int yr,
+                                        double minAmplitude) {
+  PA_INSTRUMENT_SCOPE(MoonLongLatHP);
+  PA_TRACE_SPAN("MoonLongLatHP");
 
-  double m1 = 27.32158213;
-  double m2 = 365.2596407;
-  double m3 = 27.55455094;
-  double m4 = 29.53058868;
-  double m5 = 27.21222039;
-  double m6 = 6798.363307;
-  double q = CivilDateToJulianDate(gd, gm, gy) - 2415020.0 + (ut / 24.0);
-  m1 = q / m1;
-  m2 = q / m2;
-  m3 = q / m3;
-  m4 = q / m4;
-  m5 = q / m5;
-  m6 = q / m6;
-  m1 = 360.0 * (m1 - floor(m1));
-  m2 = 360.0 * (m2 - floor(m2));
-  m3 = 360.0 * (m3 - floor(m3));
-  m4 = 360.0 * (m4 - floor(m4));
-  m5 = 360.0 * (m5 - floor(m5));
-  m6 = 360.0 * (m6 - floor(m6));
+  MoonArguments arguments = MoonArgumentsAt(lh, lm, ls, ds, zc, dy, mn, yr);
 
-  double ml = 270.434164 + m1 - (0.001133 - 0.0000019 * t) * t2;
-  double ms = 358.475833 + m2 - (0.00015 + 0.0000033 * t) * t2;
-  double md = 296.104608 + m3 + (0.009192 + 0.0000144 * t) * t2;
-  double me1 = 350.737486 + m4 - (0.001436 - 0.0000019 * t) * t2;
-  double mf = 11.250889 + m5 - (0.003211 + 0.0000003 * t) * t2;
-  double na = 259.183275 - m6 + (0.002078 + 0.0000022 * t) * t2;
-  double a = DegreesToRadians(51.2 + 20.2 * t);
-  double s1 = sin(a);
-  double s2 = sin(DegreesToRadians(na));
-  double b = 346.56 + (132.87 - 0.0091731 * t) * t;
-  double s3 = 0.003964 * sin(DegreesToRadians(b));
-  double c = DegreesToRadians(na + 275.05 - 2.3 * t);
-  double s4 = sin(c);
-  ml = ml + 0.000233 * s1 + s3 + 0.001964 * s2;
-  ms -= 0.001778 * s1;
-  md = md + 0.000817 * s1 + s3 + 0.002541 * s2;
-  mf = mf + s3 - 0.024691 * s2 - 0.004328 * s4;
-  me1 = me1 + 0.002011 * s1 + s3 + 0.001964 * s2;
-  double e = 1.0 - (0.002495 + 0.00000752 * t) * t;
-  double e2 = e * e;
-  ml = DegreesToRadians(ml);
-  ms = DegreesToRadians(ms);
-  na = DegreesToRadians(na);
-  me1 = DegreesToRadians(me1);
-  mf = DegreesToRadians(mf);
-  md = DegreesToRadians(md);
-
-  // Longitude-specific
-  double l = 6.28875 * sin(md) + 1.274018 * sin(2.0 * me1 - md);
-  l = l + 0.658309 * sin(2.0 * me1) + 0.213616 * sin(2.0 * md);
-  l = l - e * 0.185596 * sin(ms) - 0.114336 * sin(2.0 * mf);
-  l += 0.058793 * sin(2.0 * (me1 - md));
-  l = l + 0.057212 * e * sin(2.0 * me1 - ms - md) +
-      0.05332 * sin(2.0 * me1 + md);
-  l = l + 0.045874 * e * sin(2.0 * me1 - ms) + 0.041024 * e * sin(md - ms);
-  l = l - 0.034718 * sin(me1) - e * 0.030465 * sin(ms + md);
-  l = l + 0.015326 * sin(2.0 * (me1 - mf)) - 0.012528 * sin(2.0 * mf + md);
-  l = l - 0.01098 * sin(2.0 * mf - md) + 0.010674 * sin(4.0 * me1 - md);
-  l = l + 0.010034 * sin(3.0 * md) + 0.008548 * sin(4.0 * me1 - 2.0 * md);
-  l = l - e * 0.00791 * sin(ms - md + 2.0 * me1) -
-      e * 0.006783 * sin(2.0 * me1 + ms);
-  l = l + 0.005162 * sin(md - me1) + e * 0.005 * sin(ms + me1);
-  l = l + 0.003862 * sin(4.0 * me1) + e * 0.004049 * sin(md - ms + 2.0 * me1);
-  l = l + 0.003996 * sin(2.0 * (md + me1)) +
-      0.003665 * sin(2.0 * me1 - 3.0 * md);
-  l = l + e * 0.002695 * sin(2.0 * md - ms) +
-      0.002602 * sin(md - 2.0 * (mf + me1));
-  l = l + e * 0.002396 * sin(2.0 * (me1 - md) - ms) - 0.002349 * sin(md + me1);
-  l = l + e2 * 0.002249 * sin(2.0 * (me1 - ms)) -
-      e * 0.002125 * sin(2.0 * md + ms);
-  l = l - e2 * 0.002079 * sin(2.0 * ms) +
-      e2 * 0.002059 * sin(2.0 * (me1 - ms) - md);
-  l = l - 0.001773 * sin(md + 2.0 * (me1 - mf)) -
-      0.001595 * sin(2.0 * (mf + me1));
-  l = l + e * 0.00122 * sin(4.0 * me1 - ms - md) -
-      0.00111 * sin(2.0 * (md + mf));
-  l = l + 0.000892 * sin(md - 3.0 * me1) -
-      e * 0.000811 * sin(ms + md + 2.0 * me1);
-  l += e * 0.000761 * sin(4.0 * me1 - ms - 2.0 * md);
-  l += e2 * 0.000704 * sin(md - 2.0 * (ms + me1));
-  l += e * 0.000693 * sin(ms - 2.0 * (md - me1));
-  l += e * 0.000598 * sin(2.0 * (me1 - mf) - ms);
-  l = l + 0.00055 * sin(md + 4.0 * me1) + 0.000538 * sin(4.0 * md);
-  l = l + e * 0.000521 * sin(4.0 * me1 - ms) + 0.000486 * sin(2.0 * md - me1);
-  l += e2 * 0.000717 * sin(md - 2.0 * ms);
-  double mm = Unwind(ml + DegreesToRadians(l));
-
-  // Latitude-specific
-  double g = 5.128189 * sin(mf) + 0.280606 * sin(md + mf);
-  g = g + 0.277693 * sin(md - mf) + 0.173238 * sin(2.0 * me1 - mf);
-  g = g + 0.055413 * sin(2.0 * me1 + mf - md) +
-      0.046272 * sin(2.0 * me1 - mf - md);
-  g = g + 0.032573 * sin(2.0 * me1 + mf) + 0.017198 * sin(2.0 * md + mf);
-  g = g + 0.009267 * sin(2.0 * me1 + md - mf) + 0.008823 * sin(2.0 * md - mf);
-  g = g + e * 0.008247 * sin(2.0 * me1 - ms - mf) +
-      0.004323 * sin(2.0 * (me1 - md) - mf);
-  g = g + 0.0042 * sin(2.0 * me1 + mf + md) +
-      e * 0.003372 * sin(mf - ms - 2.0 * me1);
-  g += e * 0.002472 * sin(2.0 * me1 + mf - ms - md);
-  g += e * 0.002222 * sin(2.0 * me1 + mf - ms);
-  g += e * 0.002072 * sin(2.0 * me1 - mf - ms - md);
-  g = g + e * 0.001877 * sin(mf - ms + md) +
-      0.001828 * sin(4.0 * me1 - mf - md);
-  g = g - e * 0.001803 * sin(mf + ms) - 0.00175 * sin(3.0 * mf);
-  g = g + e * 0.00157 * sin(md - ms - mf) - 0.001487 * sin(mf + me1);
-  g = g - e * 0.001481 * sin(mf + ms + md) + e * 0.001417 * sin(mf - ms - md);
-  g = g + e * 0.00135 * sin(mf - ms) + 0.00133 * sin(mf - me1);
-  g = g + 0.001106 * sin(mf + 3.0 * md) + 0.00102 * sin(4.0 * me1 - mf);
-  g = g + 0.000833 * sin(mf + 4.0 * me1 - md) + 0.000781 * sin(md - 3.0 * mf);
-  g = g + 0.00067 * sin(mf + 4.0 * me1 - 2.0 * md) +
-      0.000606 * sin(2.0 * me1 - 3.0 * mf);
-  g += 0.000597 * sin(2.0 * (me1 + md) - mf);
-  g = g + e * 0.000492 * sin(2.0 * me1 + md - ms - mf) +
-      0.00045 * sin(2.0 * (md - me1) - mf);
-  g = g + 0.000439 * sin(3.0 * md - mf) + 0.000423 * sin(mf + 2.0 * (me1 + md));
-  g = g + 0.000422 * sin(2.0 * me1 - mf - 3.0 * md) -
-      e * 0.000367 * sin(ms + mf + 2.0 * me1 - md);
-  g = g - e * 0.000353 * sin(ms + mf + 2.0 * me1) +
-      0.000331 * sin(mf + 4.0 * me1);
-  g += e * 0.000317 * sin(2.0 * me1 + mf - ms + md);
-  g = g + e2 * 0.000306 * sin(2.0 * (me1 - ms) - mf) -
-      0.000283 * sin(md + 3.0 * mf);
-  double w1 = 0.0004664 * cos(na);
-  double w2 = 0.0000754 * cos(c);
-  double bm = DegreesToRadians(g) * (1.0 - w1 - w2);
+  std::vector<CMoonLongLatHP> results;
+  MoonLongLatHPLanes(&arguments, 1, minAmplitude, results);
+
+  return results[0];
+}
 
-  // Horizontal parallax-specific
-  double pm = 0.950724 + 0.051818 * cos(md) + 0.009531 * cos(2.0 * me1 - md);
-  pm = pm + 0.007843 * cos(2.0 * me1) + 0.002824 * cos(2.0 * md);
-  pm = pm + 0.000857 * cos(2.0 * me1 + md) + e * 0.000533 * cos(2.0 * me1 - ms);
-  pm += e * 0.000401 * cos(2.0 * me1 - md - ms);
-  pm = pm + e * 0.00032 * cos(md - ms) - 0.000271 * cos(me1);
-  pm = pm - e * 0.000264 * cos(ms + md) - 0.000198 * cos(2.0 * mf - md);
-  pm = pm + 0.000173 * cos(3.0 * md) + 0.000167 * cos(4.0 * me1 - md);
-  pm = pm - e * 0.000111 * cos(ms) + 0.000103 * cos(4.0 * me1 - 2.0 * md);
-  pm = pm - 0.000084 * cos(2.0 * md - 2.0 * me1) -
-       e * 0.000083 * cos(2.0 * me1 + ms);
-  pm = pm + 0.000079 * cos(2.0 * me1 + 2.0 * md) + 0.000072 * cos(4.0 * me1);
-  pm = pm + e * 0.000064 * cos(2.0 * me1 - ms + md) -
-       e * 0.000063 * cos(2.0 * me1 + ms - md);
-  pm = pm + e * 0.000041 * cos(ms + me1) + e * 0.000035 * cos(2.0 * md - ms);
-  pm = pm - 0.000033 * cos(3.0 * md - 2.0 * me1) - 0.00003 * cos(md + me1);
-  pm =
-      pm - 0.000029 * cos(2.0 * (mf - me1)) - e * 0.000029 * cos(2.0 * md + ms);
-  pm = pm + e2 * 0.000026 * cos(2.0 * (me1 - ms)) -
-       0.000023 * cos(2.0 * (mf - me1) + md);
-  pm += e * 0.000019 * cos(4.0 * me1 - ms - md);
-
-  double moonLongDeg = WToDegrees(mm);
-  double moonLatDeg = WToDegrees(bm);
-  double moonHorPara = pm;
-
-  return pa_models::CMoonLongLatHP(moonLongDeg, moonLatDeg, moonHorPara);
+/**
+ * Calculate longitude, latitude, and horizontal parallax of the Moon at many
+ * instants.
+ *
+ * Instants are evaluated kLunarLanes at a time, each series term being applied
+ * to every instant in the group in one loop.
+ *
+ * @param julianDates Instants (Julian dates, UT).
+ * @param minAmplitude Terms with amplitudes below this (degrees) are left out;
+ * 0 keeps the full series.
+ *
+ * @return One CMoonLongLatHP per instant, in input order.
+ */
+std::vector<pa_models::CMoonLongLatHP>
+MoonLongLatHPBatch(const std::vector<double> &julianDates,
+                   double minAmplitude) {
+  std::vector<CMoonLongLatHP> results;
+  results.reserve(julianDates.size());
+
+  MoonArguments arguments[kLunarLanes];
+  for (std::size_t first = 0; first < julianDates.size();
+       first += kLunarLanes) {
+    int lanes = (int)std::min((std::size_t)kLunarLanes,
+                              julianDates.size() - first);
+
+    for (int l = 0; l < lanes; l++) {
+      double q = julianDates[first + l] - 2415020.0;
+      arguments[l] = MoonArgumentsAt(q, q / 36525.0);
+    }
+    MoonLongLatHPLanes(arguments, lanes, minAmplitude, results);
+  }
+
+  return results;
 }
 
 /**
@@ -3582,18 +4078,32 @@ double MoonMeanAnomaly(double lh, double lm, double ls, int ds, int zc,
 }
 
 /**
- * Calculate Julian date of New Moon.
+ * \brief Number of the lunation whose new Moon NewMoon() and full Moon
+ * FullMoon() find for a local date: new Moons counted from January 1900.
  *
- * Original macro name: NewMoon
+ * The eclipse functions pick their lunation the same way, so every result
+ * for a date follows from this number (and, for solar eclipses, the site).
  */
-double NewMoon(int ds, int zc, double dy, int mn, int yr) {
+double LunationNumber(int ds, int zc, double dy, int mn, int yr) {
   double d0 = LocalCivilTimeGreenwichDay(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int m0 = LocalCivilTimeGreenwichMonth(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int y0 = LocalCivilTimeGreenwichYear(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
 
   double j0 = CivilDateToJulianDate(0.0, 1, y0) - 2415020.0;
   double dj = CivilDateToJulianDate(d0, m0, y0) - 2415020.0;
-  double k = Lint(((y0 - 1900.0 + ((dj - j0) / 365.0)) * 12.3685) + 0.5);
+
+  return Lint(((y0 - 1900.0 + ((dj - j0) / 365.0)) * 12.3685) + 0.5);
+}
+
+/**
+ * Calculate Julian date of New Moon.
+ *
+ * Original macro name: NewMoon
+ */
+double NewMoon(int ds, int zc, double dy, int mn, int yr) {
+  PA_TRACE_SPAN("NewMoon");
+
+  double k = LunationNumber(ds, zc, dy, mn, yr);
   double tn = k / 1236.85;
   double tf = (k + 0.5) / 1236.85;
   double t = tn;
@@ -3613,13 +4123,9 @@ double NewMoon(int ds, int zc, double dy, int mn, int yr) {
  * Original macro name: FullMoon
  */
 double FullMoon(int ds, int zc, double dy, int mn, int yr) {
-  double d0 = LocalCivilTimeGreenwichDay(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
-  int m0 = LocalCivilTimeGreenwichMonth(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
-  int y0 = LocalCivilTimeGreenwichYear(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
+  PA_TRACE_SPAN("FullMoon");
 
-  double j0 = CivilDateToJulianDate(0.0, 1, y0) - 2415020.0;
-  double dj = CivilDateToJulianDate(d0, m0, y0) - 2415020.0;
-  double k = Lint(((y0 - 1900.0 + ((dj - j0) / 365.0)) * 12.3685) + 0.5);
+  double k = LunationNumber(ds, zc, dy, mn, yr);
   double tn = k / 1236.85;
   double tf = (k + 0.5) / 1236.85;
   double t = tn;
@@ -3637,6 +4143,8 @@ double FullMoon(int ds, int zc, double dy, int mn, int yr) {
  * Helper function for NewMoon() and FullMoon()
  */
 pa_models::CNewMoonFullMoonL6855 NewMoonFullMoonL6855(double k, double t) {
+  PA_TRACE_SPAN("NewMoonFullMoonL6855");
+
   double t2 = t * t;
   double e = 29.53 * k;
   double c = 166.56 + (132.87 - 0.009173 * t) * t;
@@ -3761,6 +4269,9 @@ double EQELong(double rah, double ram, double ras, double dd, double dm,
  */
 double MoonRiseLCT(double dy, int mn, int yr, int ds, int zc, double gLong,
                    double gLat) {
+  PA_INSTRUMENT_SCOPE(MoonRiseLCT);
+  PA_TRACE_SPAN("MoonRiseLCT");
+
   double gdy = LocalCivilTimeGreenwichDay(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int gmn = LocalCivilTimeGreenwichMonth(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int gyr = LocalCivilTimeGreenwichYear(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
@@ -3785,6 +4296,8 @@ double MoonRiseLCT(double dy, int mn, int yr, int ds, int zc, double gLong,
   double gu = 0.0;
 
   for (int k = 1; k < 9; k++) {
+    PA_INSTRUMENT_ITERATIONS(MoonRiseLCT, 1);
+
     x = LocalSiderealTimeToGreenwichSiderealTime(la, 0.0, 0.0, gLong);
     ut = GreenwichSiderealTimeToUniversalTime(x, 0.0, 0.0, gdy, gmn, gyr);
 
@@ -3884,6 +4397,9 @@ CMoonRiseLCTL6700 MoonRiseLCTL6700(double lct, int ds, int zc, double dy1,
  */
 CFullDatePrecise MoonRiseLCDMY(double dy, int mn, int yr, int ds, int zc,
                                double gLong, double gLat) {
+  PA_INSTRUMENT_SCOPE(MoonRiseLCDMY);
+  PA_TRACE_SPAN("MoonRiseLCDMY");
+
   double gdy = LocalCivilTimeGreenwichDay(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int gmn = LocalCivilTimeGreenwichMonth(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int gyr = LocalCivilTimeGreenwichYear(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
@@ -3907,6 +4423,8 @@ CFullDatePrecise MoonRiseLCDMY(double dy, int mn, int yr, int ds, int zc,
   double g1 = 0.0;
   double gu = 0.0;
   for (int k = 1; k < 9; k++) {
+    PA_INSTRUMENT_ITERATIONS(MoonRiseLCDMY, 1);
+
     x = LocalSiderealTimeToGreenwichSiderealTime(la, 0.0, 0.0, gLong);
     ut = GreenwichSiderealTimeToUniversalTime(x, 0.0, 0.0, gdy, gmn, gyr);
 
@@ -4005,6 +4523,9 @@ CMoonRiseLcDMYL6700 MoonRiseLCDMYL6700(double lct, int ds, int zc, double dy1,
  */
 double MoonRiseAz(double dy, int mn, int yr, int ds, int zc, double gLong,
                   double gLat) {
+  PA_INSTRUMENT_SCOPE(MoonRiseAz);
+  PA_TRACE_SPAN("MoonRiseAz");
+
   double gdy = LocalCivilTimeGreenwichDay(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int gmn = LocalCivilTimeGreenwichMonth(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int gyr = LocalCivilTimeGreenwichYear(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
@@ -4030,6 +4551,8 @@ double MoonRiseAz(double dy, int mn, int yr, int ds, int zc, double gLong,
   double gu = 0.0;
   double aa = 0.0;
   for (int k = 1; k < 9; k++) {
+    PA_INSTRUMENT_ITERATIONS(MoonRiseAz, 1);
+
     x = LocalSiderealTimeToGreenwichSiderealTime(la, 0.0, 0.0, gLong);
     ut = GreenwichSiderealTimeToUniversalTime(x, 0.0, 0.0, gdy, gmn, gyr);
 
@@ -4121,6 +4644,9 @@ CMoonRiseAzL6700 MoonRiseAzL6700(double lct, int ds, int zc, double dy1,
  */
 double MoonSetLCT(double dy, int mn, int yr, int ds, int zc, double gLong,
                   double gLat) {
+  PA_INSTRUMENT_SCOPE(MoonSetLCT);
+  PA_TRACE_SPAN("MoonSetLCT");
+
   double gdy = LocalCivilTimeGreenwichDay(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int gmn = LocalCivilTimeGreenwichMonth(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int gyr = LocalCivilTimeGreenwichYear(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
@@ -4144,6 +4670,8 @@ double MoonSetLCT(double dy, int mn, int yr, int ds, int zc, double gLong,
   double g1 = 0.0;
   double gu = 0.0;
   for (int k = 1; k < 9; k++) {
+    PA_INSTRUMENT_ITERATIONS(MoonSetLCT, 1);
+
     x = LocalSiderealTimeToGreenwichSiderealTime(la, 0.0, 0.0, gLong);
     ut = GreenwichSiderealTimeToUniversalTime(x, 0.0, 0.0, gdy, gmn, gyr);
 
@@ -4243,6 +4771,9 @@ CMoonSetLCTL6700 MoonSetLCTL6700(double lct, int ds, int zc, double dy1,
  */
 CFullDatePrecise MoonSetLCDMY(double dy, int mn, int yr, int ds, int zc,
                               double gLong, double gLat) {
+  PA_INSTRUMENT_SCOPE(MoonSetLCDMY);
+  PA_TRACE_SPAN("MoonSetLCDMY");
+
   double gdy = LocalCivilTimeGreenwichDay(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int gmn = LocalCivilTimeGreenwichMonth(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int gyr = LocalCivilTimeGreenwichYear(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
@@ -4266,6 +4797,8 @@ CFullDatePrecise MoonSetLCDMY(double dy, int mn, int yr, int ds, int zc,
   double g1 = 0.0;
   double gu = 0.0;
   for (int k = 1; k < 9; k++) {
+    PA_INSTRUMENT_ITERATIONS(MoonSetLCDMY, 1);
+
     x = LocalSiderealTimeToGreenwichSiderealTime(la, 0.0, 0.0, gLong);
     ut = GreenwichSiderealTimeToUniversalTime(x, 0.0, 0.0, gdy, gmn, gyr);
 
@@ -4363,6 +4896,9 @@ CMoonSetLcDMYL6700 MoonSetLCDMYL6700(double lct, int ds, int zc, double dy1,
  */
 double MoonSetAz(double dy, int mn, int yr, int ds, int zc, double gLong,
                  double gLat) {
+  PA_INSTRUMENT_SCOPE(MoonSetAz);
+  PA_TRACE_SPAN("MoonSetAz");
+
   double gdy = LocalCivilTimeGreenwichDay(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int gmn = LocalCivilTimeGreenwichMonth(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int gyr = LocalCivilTimeGreenwichYear(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
@@ -4389,6 +4925,8 @@ double MoonSetAz(double dy, int mn, int yr, int ds, int zc, double gLong,
   double gu = 0.0;
   double aa = 0.0;
   for (int k = 1; k < 9; k++) {
+    PA_INSTRUMENT_ITERATIONS(MoonSetAz, 1);
+
     x = LocalSiderealTimeToGreenwichSiderealTime(la, 0.0, 0.0, gLong);
     ut = GreenwichSiderealTimeToUniversalTime(x, 0.0, 0.0, gdy, gmn, gyr);
 
@@ -4472,6 +5010,154 @@ CMoonSetAzL6700 MoonSetAzL6700(double lct, int ds, int zc, double dy1, int mn1,
   return CMoonSetAzL6700(mm, bm, pm, dp, th, di, p, q, lu, lct, au);
 }
 
+namespace {
+/**
+ * \brief Local sidereal time and azimuth of the Moon's rising or setting, for
+ * its position at local time lct, as in MoonRiseLCTL6700 and MoonRiseAzL6700.
+ *
+ * @return false if the Moon does not rise or set.
+ */
+bool MoonHorizonCrossing(bool isRising, double lct, int ds, int zc, double dy1,
+                         int mn1, int yr1, double gdy, int gmn, int gyr,
+                         double gLat, double &lst, double &azimuthDeg) {
+  pa_models::CMoonLongLatHP moon =
+      MoonLongLatHP(lct, 0.0, 0.0, ds, zc, dy1, mn1, yr1);
+  double pm = DegreesToRadians(moon.horizontalParallax);
+  double dp = NutatLong(gdy, gmn, gyr);
+  double di = WToDegrees(0.27249 * sin(pm) + 0.0098902 - pm);
+  double obliquityDeg = Obliq(gdy, gmn, gyr);
+  double p = DecimalDegreesToDegreeHours(EclipticRightAscensionObliq(
+      moon.longitudeDegrees + dp, moon.latitudeDegrees, obliquityDeg));
+  double q = EclipticDeclinationObliq(moon.longitudeDegrees + dp,
+                                      moon.latitudeDegrees, obliquityDeg);
+
+  if (isRising) {
+    lst = RiseSetLocalSiderealTimeRise(p, 0.0, 0.0, q, 0.0, 0.0, di, gLat);
+    azimuthDeg = RiseSetAzimuthRise(p, 0.0, 0.0, q, 0.0, 0.0, di, gLat);
+  } else {
+    lst = RiseSetLocalSiderealTimeSet(p, 0.0, 0.0, q, 0.0, 0.0, di, gLat);
+    azimuthDeg = RiseSetAzimuthSet(p, 0.0, 0.0, q, 0.0, 0.0, di, gLat);
+  }
+
+  return ERiseSet(p, 0.0, 0.0, q, 0.0, 0.0, di, gLat) == ERiseSetStatus::Ok;
+}
+
+/**
+ * \brief Moonrise or moonset nearest the local time seedLct on the given local
+ * date, by the iteration of MoonRiseLCT.
+ */
+CMoonRiseSetEvent MoonEventFromSeed(bool isRising, double seedLct, double dy,
+                                    int mn, int yr, int ds, int zc,
+                                    double gLong, double gLat,
+                                    double toleranceHours, int maxIterations) {
+  PA_INSTRUMENT_SCOPE(MoonRiseSetEvent);
+
+  double gdy =
+      LocalCivilTimeGreenwichDay(seedLct, 0.0, 0.0, ds, zc, dy, mn, yr);
+  int gmn = LocalCivilTimeGreenwichMonth(seedLct, 0.0, 0.0, ds, zc, dy, mn, yr);
+  int gyr = LocalCivilTimeGreenwichYear(seedLct, 0.0, 0.0, ds, zc, dy, mn, yr);
+  double lct = seedLct;
+  double dy1 = dy;
+  int mn1 = mn;
+  int yr1 = yr;
+  double la;
+  double azimuthDeg;
+  int iterations = 1;
+  bool isConverged = false;
+
+  if (!MoonHorizonCrossing(isRising, lct, ds, zc, dy1, mn1, yr1, gdy, gmn, gyr,
+                           gLat, la, azimuthDeg))
+    return CMoonRiseSetEvent(-99.0, dy, mn, yr, 0.0, iterations, false);
+
+  double x;
+  double ut;
+  double g1 = 0.0;
+  double gu = 0.0;
+
+  for (int k = 1; k <= maxIterations; k++) {
+    PA_INSTRUMENT_ITERATIONS(MoonRiseSetEvent, 1);
+
+    x = LocalSiderealTimeToGreenwichSiderealTime(la, 0.0, 0.0, gLong);
+    ut = GreenwichSiderealTimeToUniversalTime(x, 0.0, 0.0, gdy, gmn, gyr);
+
+    isConverged = (k > 1) && (std::abs(ut - gu) <= toleranceHours);
+
+    g1 = (k == 1) ? ut : gu;
+    gu = ut;
+
+    if (isConverged)
+      break;
+
+    double adjustedUt = ut;
+    if (EGstUt(x, 0.0, 0.0, gdy, gmn, gyr) != EWarningFlags::Ok)
+      if (std::abs(g1 - adjustedUt) > 0.5)
+        adjustedUt += 23.93447;
+    adjustedUt = UTDayAdjust(adjustedUt, g1);
+
+    lct = UniversalTimeToLocalCivilTime(adjustedUt, 0.0, 0.0, ds, zc, gdy, gmn,
+                                        gyr);
+    dy1 = UniversalTimeLocalCivilDay(adjustedUt, 0.0, 0.0, ds, zc, gdy, gmn,
+                                     gyr);
+    mn1 = UniversalTimeLocalCivilMonth(adjustedUt, 0.0, 0.0, ds, zc, gdy, gmn,
+                                       gyr);
+    yr1 = UniversalTimeLocalCivilYear(adjustedUt, 0.0, 0.0, ds, zc, gdy, gmn,
+                                      gyr);
+    gdy = LocalCivilTimeGreenwichDay(lct, 0.0, 0.0, ds, zc, dy1, mn1, yr1);
+    gmn = LocalCivilTimeGreenwichMonth(lct, 0.0, 0.0, ds, zc, dy1, mn1, yr1);
+    gyr = LocalCivilTimeGreenwichYear(lct, 0.0, 0.0, ds, zc, dy1, mn1, yr1);
+
+    iterations++;
+    if (!MoonHorizonCrossing(isRising, lct, ds, zc, dy1, mn1, yr1, gdy, gmn,
+                             gyr, gLat, la, azimuthDeg))
+      return CMoonRiseSetEvent(-99.0, dy, mn, yr, 0.0, iterations, false);
+  }
+
+  x = LocalSiderealTimeToGreenwichSiderealTime(la, 0.0, 0.0, gLong);
+  ut = GreenwichSiderealTimeToUniversalTime(x, 0.0, 0.0, gdy, gmn, gyr);
+
+  if (EGstUt(x, 0.0, 0.0, gdy, gmn, gyr) != EWarningFlags::Ok)
+    if (std::abs(g1 - ut) > 0.5)
+      ut += 23.93447;
+
+  ut = UTDayAdjust(ut, g1);
+
+  return CMoonRiseSetEvent(
+      UniversalTimeToLocalCivilTime(ut, 0.0, 0.0, ds, zc, gdy, gmn, gyr),
+      UniversalTimeLocalCivilDay(ut, 0.0, 0.0, ds, zc, gdy, gmn, gyr),
+      UniversalTimeLocalCivilMonth(ut, 0.0, 0.0, ds, zc, gdy, gmn, gyr),
+      UniversalTimeLocalCivilYear(ut, 0.0, 0.0, ds, zc, gdy, gmn, gyr),
+      azimuthDeg, iterations, isConverged);
+}
+} // namespace
+
+/**
+ * \brief Moonrise nearest the local time seedLct on the given local date:
+ * local time, local date and azimuth in one iteration.
+ *
+ * Stops once successive UT estimates agree within toleranceHours, or after
+ * maxIterations refinements. The defaults, seeded at 12h, reproduce
+ * MoonRiseLCT, MoonRiseLCDMY and MoonRiseAz. Seeding with yesterday's
+ * moonrise (about 50 minutes later) usually converges in two or three.
+ */
+CMoonRiseSetEvent MoonRiseEvent(double seedLct, double dy, int mn, int yr,
+                                int ds, int zc, double gLong, double gLat,
+                                double toleranceHours, int maxIterations) {
+  return MoonEventFromSeed(true, seedLct, dy, mn, yr, ds, zc, gLong, gLat,
+                           toleranceHours, maxIterations);
+}
+
+/**
+ * \brief Moonset nearest the local time seedLct on the given local date, as
+ * MoonRiseEvent. The defaults reproduce MoonSetLCT, MoonSetLCDMY and
+ * MoonSetAz.
+ */
+CMoonRiseSetEvent MoonSetEvent(double seedLct, double dy, int mn, int yr,
+                               int ds, int zc, double gLong, double gLat,
+                               double toleranceHours, int maxIterations) {
+  return MoonEventFromSeed(false, seedLct, dy, mn, yr, ds, zc, gLong, gLat,
+                           toleranceHours, maxIterations);
+}
+
 /**
  * Determine if a lunar eclipse is likely to occur.
  *
@@ -4479,6 +5165,8 @@ CMoonSetAzL6700 MoonSetAzL6700(double lct, int ds, int zc, double dy1, int mn1,
  */
 ELunarEclipseStatus LunarEclipseOccurrence(int ds, int zc, double dy, int mn,
                                            int yr) {
+  PA_TRACE_SPAN("LunarEclipseOccurrence");
+
   double d0 = LocalCivilTimeGreenwichDay(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int m0 = LocalCivilTimeGreenwichMonth(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int y0 = LocalCivilTimeGreenwichYear(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
@@ -4560,6 +5248,8 @@ CLunarEclipseOccurrenceL6855 LunarEclipseOccurrenceL6855(double t, double k) {
  * Original macro name: UTMaxLunarEclipse
  */
 double UTMaxLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
+  PA_TRACE_SPAN("UTMaxLunarEclipse");
+
   double tp = 2.0 * M_PI;
 
   if (LunarEclipseOccurrence(ds, zc, dy, mn, yr) == ELunarEclipseStatus::None)
@@ -4641,6 +5331,8 @@ double UTMaxLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
  * Original macro name: UTFirstContactLunarEclipse
  */
 double UTFirstContactLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
+  PA_TRACE_SPAN("UTFirstContactLunarEclipse");
+
   double tp = 2.0 * M_PI;
 
   if (LunarEclipseOccurrence(ds, zc, dy, mn, yr) == ELunarEclipseStatus::None)
@@ -4728,6 +5420,8 @@ double UTFirstContactLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
  * Original macro name: UTLastContactLunarEclipse
  */
 double UTLastContactLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
+  PA_TRACE_SPAN("UTLastContactLunarEclipse");
+
   double tp = 2.0 * M_PI;
 
   if (LunarEclipseOccurrence(ds, zc, dy, mn, yr) == ELunarEclipseStatus::None)
@@ -4812,6 +5506,8 @@ double UTLastContactLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
  * Original macro name: UTStartUmbraLunarEclipse
  */
 double UTStartUmbraLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
+  PA_TRACE_SPAN("UTStartUmbraLunarEclipse");
+
   double tp = 2.0 * M_PI;
 
   if (LunarEclipseOccurrence(ds, zc, dy, mn, yr) == ELunarEclipseStatus::None)
@@ -4911,6 +5607,8 @@ double UTStartUmbraLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
  * Original macro name: UTEndUmbraLunarEclipse
  */
 double UTEndUmbraLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
+  PA_TRACE_SPAN("UTEndUmbraLunarEclipse");
+
   double tp = 2.0 * M_PI;
 
   if (LunarEclipseOccurrence(ds, zc, dy, mn, yr) == ELunarEclipseStatus::None)
@@ -5007,6 +5705,8 @@ double UTEndUmbraLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
  * Original macro name: UTStartTotalLunarEclipse
  */
 double UTStartTotalLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
+  PA_TRACE_SPAN("UTStartTotalLunarEclipse");
+
   double tp = 2.0 * M_PI;
 
   if (LunarEclipseOccurrence(ds, zc, dy, mn, yr) == ELunarEclipseStatus::None)
@@ -5116,6 +5816,8 @@ double UTStartTotalLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
  * Original macro name: UTEndTotalLunarEclipse
  */
 double UTEndTotalLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
+  PA_TRACE_SPAN("UTEndTotalLunarEclipse");
+
   double tp = 2.0 * M_PI;
 
   if (LunarEclipseOccurrence(ds, zc, dy, mn, yr) == ELunarEclipseStatus::None)
@@ -5222,6 +5924,8 @@ double UTEndTotalLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
  * Original macro name: MagLunarEclipse
  */
 double MagLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
+  PA_TRACE_SPAN("MagLunarEclipse");
+
   double tp = 2.0 * M_PI;
 
   if (LunarEclipseOccurrence(ds, zc, dy, mn, yr) == ELunarEclipseStatus::None)
@@ -5324,6 +6028,8 @@ double MagLunarEclipse(double dy, int mn, int yr, int ds, int zc) {
  */
 ESolarEclipseStatus SolarEclipseOccurrence(int ds, int zc, double dy, int mn,
                                            int yr) {
+  PA_TRACE_SPAN("SolarEclipseOccurrence");
+
   double d0 = LocalCivilTimeGreenwichDay(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int m0 = LocalCivilTimeGreenwichMonth(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
   int y0 = LocalCivilTimeGreenwichYear(12.0, 0.0, 0.0, ds, zc, dy, mn, yr);
@@ -5402,6 +6108,8 @@ CSolarEclipseOccurrenceL6855 SolarEclipseOccurrenceL6855(double t, double k) {
  */
 double UTMaxSolarEclipse(double dy, int mn, int yr, int ds, int zc,
                          double glong, double glat) {
+  PA_TRACE_SPAN("UTMaxSolarEclipse");
+
   double tp = 2.0 * M_PI;
 
   if (SolarEclipseOccurrence(ds, zc, dy, mn, yr) == ESolarEclipseStatus::None)
@@ -5538,6 +6246,8 @@ CUTMaxSolarEclipseL7390 UTMaxSolarEclipseL7390(double x, double y, double igday,
  */
 double UTFirstContactSolarEclipse(double dy, int mn, int yr, int ds, int zc,
                                   double glong, double glat) {
+  PA_TRACE_SPAN("UTFirstContactSolarEclipse");
+
   double tp = 2.0 * M_PI;
 
   if (SolarEclipseOccurrence(ds, zc, dy, mn, yr) == ESolarEclipseStatus::None)
@@ -5681,6 +6391,8 @@ UTFirstContactSolarEclipseL7390(double x, double y, double igday, int gmonth,
  */
 double UTLastContactSolarEclipse(double dy, int mn, int yr, int ds, int zc,
                                  double glong, double glat) {
+  PA_TRACE_SPAN("UTLastContactSolarEclipse");
+
   double tp = 2.0 * M_PI;
 
   if (SolarEclipseOccurrence(ds, zc, dy, mn, yr) == ESolarEclipseStatus::None)
@@ -5818,6 +6530,8 @@ UTLastContactSolarEclipseL7390(double x, double y, double igday, int gmonth,
  */
 double MagSolarEclipse(double dy, int mn, int yr, int ds, int zc, double glong,
                        double glat) {
+  PA_TRACE_SPAN("MagSolarEclipse");
+
   double tp = 2.0 * M_PI;
 
   if (SolarEclipseOccurrence(ds, zc, dy, mn, yr) == ESolarEclipseStatus::None)
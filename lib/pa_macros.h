@@ -29,6 +29,8 @@ int JulianDateMonth(double julian_date);
 
 int JulianDateYear(double julian_date);
 
+CGreenwichDateTime JulianDateToGreenwichDateTime(double julian_date);
+
 double RightAscensionToHourAngle(double ra_hours, double ra_minutes,
                                  double ra_seconds, double lct_hours,
                                  double lct_minutes, double lct_seconds,
@@ -119,6 +121,8 @@ double DegreeHoursToDecimalDegrees(double degree_hours);
 
 double Obliq(double greenwich_day, int greenwich_month, int greenwich_year);
 
+CNutation Nutation(double gd, int gm, int gy);
+
 double NutatLong(double gd, int gm, int gy);
 
 double NutatObl(double greenwich_day, int greenwich_month, int greenwich_year);
@@ -194,9 +198,13 @@ double SunEccentricity(double gd, int gm, int gy);
 double EclipticDeclination(double eld, double elm, double els, double bd,
                            double bm, double bs, double gd, int gm, int gy);
 
+double EclipticDeclinationObliq(double eld, double bd, double obliq);
+
 double EclipticRightAscension(double eld, double elm, double els, double bd,
                               double bm, double bs, double gd, int gm, int gy);
 
+double EclipticRightAscensionObliq(double eld, double bd, double obliq);
+
 double SunTrueAnomaly(double lch, double lcm, double lcs, int ds, int zc,
                       double ld, int lm, int ly);
 
@@ -304,6 +312,22 @@ CPlanetCoordinates PlanetCoordinates(double lh, double lm, double ls, int ds,
                                      int zc, double dy, int mn, int yr,
                                      std::string s);
 
+std::vector<CPlanetCoordinates> AllPlanetCoordinates(double lh, double lm,
+                                                     double ls, int ds, int zc,
+                                                     double dy, int mn, int yr);
+
+std::vector<pa_data::PlanetDataPrecise> PlanetElements(double t);
+
+CPlanetCoordinates
+PlanetCoordinatesFromElements(std::vector<pa_data::PlanetDataPrecise> pl,
+                              int ip, double t, double ms, double sr,
+                              double re);
+
+CPlanetCoordinates
+PlanetCoordinatesFromElements(std::vector<pa_data::PlanetDataPrecise> pl,
+                              int ip, double t, double ms, double sr,
+                              double re, const COuterPlanetArguments &outer);
+
 CPlanetLongLatL4685 PlanetLongL4685(std::vector<pa_data::PlanetDataPrecise> pl);
 
 CPlanetLongLatL4735 PlanetLongL4735(std::vector<pa_data::PlanetDataPrecise> pl,
@@ -312,6 +336,11 @@ CPlanetLongLatL4735 PlanetLongL4735(std::vector<pa_data::PlanetDataPrecise> pl,
 CPlanetLongLatL4810 PlanetLongL4810(std::vector<pa_data::PlanetDataPrecise> pl,
                                     double ms);
 
+COuterPlanetArguments OuterPlanetArguments(double t);
+
+CPlanetLongLatL4945 PlanetLongL4945(const COuterPlanetArguments &arguments,
+                                    EOuterPlanet planet, double eccentricity);
+
 CPlanetLongLatL4945 PlanetLongL4945(double t,
                                     pa_data::PlanetDataPrecise planet);
 
@@ -320,10 +349,21 @@ CCometLongLatDist PCometLongLatDist(double lh, double lm, double ls, int ds,
                                     double td, int tm, int ty, double q,
                                     double i, double p, double n);
 
+CCometLongLatDist ECometLongLatDist(double lh, double lm, double ls, int ds,
+                                    int zc, double dy, int mn, int yr,
+                                    const pa_data::CometDataElliptical &comet);
+
 double SolveCubic(double w);
 
+double SolveBarker(double w);
+
 CMoonLongLatHP MoonLongLatHP(double lh, double lm, double ls, int ds, int zc,
-                             double dy, int mn, int yr);
+                             double dy, int mn, int yr,
+                             double minAmplitude = 0.0);
+
+std::vector<CMoonLongLatHP>
+MoonLongLatHPBatch(const std::vector<double> &julianDates,
+                   double minAmplitude = 0.0);
 
 double MoonPhase(double lh, double lm, double ls, int ds, int zc, double dy,
                  int mn, int yr);
@@ -331,6 +371,8 @@ double MoonPhase(double lh, double lm, double ls, int ds, int zc, double dy,
 double MoonMeanAnomaly(double lh, double lm, double ls, int ds, int zc,
                        double dy, int mn, int yr);
 
+double LunationNumber(int ds, int zc, double dy, int mn, int yr);
+
 double NewMoon(int ds, int zc, double dy, int mn, int yr);
 
 double FullMoon(int ds, int zc, double dy, int mn, int yr);
@@ -415,6 +457,16 @@ CMoonSetAzL6700 MoonSetAzL6700(double lct, int ds, int zc, double dy1, int mn1,
                                int yr1, double gdy, int gmn, int gyr,
                                double gLat);
 
+CMoonRiseSetEvent MoonRiseEvent(double seedLct, double dy, int mn, int yr,
+                                int ds, int zc, double gLong, double gLat,
+                                double toleranceHours = 0.0,
+                                int maxIterations = 8);
+
+CMoonRiseSetEvent MoonSetEvent(double seedLct, double dy, int mn, int yr,
+                               int ds, int zc, double gLong, double gLat,
+                               double toleranceHours = 0.0,
+                               int maxIterations = 8);
+
 ELunarEclipseStatus LunarEclipseOccurrence(int ds, int zc, double dy, int mn,
                                            int yr);
 
@@ -2,6 +2,9 @@
 #define _pa_models
 
 #include "pa_types.h"
+#include <cstdint>
+#include <string>
+#include <vector>
 
 using namespace pa_types;
 
@@ -60,6 +63,21 @@ public:
       : CUniversalDateTime(hours, minutes, seconds, day, month, year) {}
 };
 
+class CGreenwichDateTime {
+public:
+  CGreenwichDateTime(double day, int month, int year, double utHours) {
+    this->day = day;
+    this->month = month;
+    this->year = year;
+    this->utHours = utHours;
+  }
+
+  double day;
+  int month;
+  int year;
+  double utHours;
+};
+
 class CGreenwichSiderealTime {
 public:
   CGreenwichSiderealTime(int hours, int minutes, double seconds) {
@@ -378,6 +396,19 @@ public:
   double qg;
 };
 
+/**
+ * Arguments of the outer planet perturbations at one instant: j1, and the
+ * sines and cosines of the multiples and combinations of j2...j6 that
+ * PlanetLongL4945() needs, in an order private to it.
+ */
+class COuterPlanetArguments {
+public:
+  static const int kHarmonics = 64;
+
+  double j1;
+  double harmonics[kHarmonics];
+};
+
 class CPlanetVisualAspects {
 public:
   CPlanetVisualAspects(double distanceAU, double angDiaArcsec, double phase,
@@ -404,6 +435,17 @@ public:
   double approximateMagnitude;
 };
 
+/**
+ * \brief Precise positions, and optionally visual aspects, of all seven planets
+ * at one instant.
+ */
+class CAllPlanetPositions {
+public:
+  std::vector<std::string> planetNames; /**< Mercury to Neptune. */
+  std::vector<CPrecisePositionOfPlanet> positions;
+  std::vector<CPlanetVisualAspects> visualAspects; /**< Empty unless asked. */
+};
+
 class CRiseSet {
 public:
   CRiseSet(ERiseSetStatus rsStatus, double utRiseHour, double utRiseMin,
@@ -426,6 +468,236 @@ public:
   double azSet;
 };
 
+/**
+ * \brief Rise, transit and set times for a catalogue of objects.
+ *
+ * Structure of arrays: element i of every column belongs to object i.
+ */
+class CRiseSetCatalogue {
+public:
+  CRiseSetCatalogue() {}
+
+  CRiseSetCatalogue(std::size_t count)
+      : rsStatus(count), utRiseHours(count), utTransitHours(count),
+        utSetHours(count), azRiseDeg(count), azSetDeg(count) {}
+
+  std::size_t size() const { return rsStatus.size(); }
+
+  std::vector<ERiseSetStatus> rsStatus; /**< Rise/set status. */
+  std::vector<double> utRiseHours;      /**< UT of rising, decimal hours. */
+  std::vector<double> utTransitHours;   /**< UT of transit, decimal hours. */
+  std::vector<double> utSetHours;       /**< UT of setting, decimal hours. */
+  std::vector<double> azRiseDeg;        /**< Azimuth at rising, degrees. */
+  std::vector<double> azSetDeg;         /**< Azimuth at setting, degrees. */
+};
+
+/**
+ * \brief Positions for a catalogue of comets at one instant.
+ *
+ * Structure of arrays: element i of every column belongs to comet i.
+ */
+class CCometPositionCatalogue {
+public:
+  CCometPositionCatalogue() {}
+
+  CCometPositionCatalogue(std::size_t count)
+      : raHours(count), decDeg(count), earthDistanceAU(count),
+        sunDistanceAU(count) {}
+
+  std::size_t size() const { return raHours.size(); }
+
+  std::vector<double> raHours;         /**< Right ascension, decimal hours. */
+  std::vector<double> decDeg;          /**< Declination, decimal degrees. */
+  std::vector<double> earthDistanceAU; /**< Distance from the Earth, in AU. */
+  std::vector<double> sunDistanceAU;   /**< Distance from the Sun, in AU. */
+};
+
+/**
+ * \brief Daily almanac for one site.
+ *
+ * Structure of arrays: element i of every column belongs to local date i.
+ * Times are local civil time in decimal hours, or -99 if the event does not
+ * happen, and are kept as floats (better than a tenth of a second). Moonrise
+ * and moonset may fall on the day before or after; their day offset columns
+ * say which. Twilight columns are indexed civil, nautical, astronomical.
+ */
+class CAlmanac {
+public:
+  CAlmanac() {}
+
+  CAlmanac(std::size_t count)
+      : julianDate(count), sunStatus(count), sunriseHours(count),
+        sunsetHours(count), sunriseAzimuthDeg(count), sunsetAzimuthDeg(count),
+        moonriseHours(count), moonriseDayOffset(count),
+        moonriseAzimuthDeg(count), moonriseIterations(count),
+        moonsetHours(count), moonsetDayOffset(count),
+        moonsetAzimuthDeg(count), moonsetIterations(count), moonPhase(count),
+        moonBrightLimbDeg(count), equationOfTimeMinutes(count) {
+    for (int t = 0; t < 3; t++) {
+      twilightStatus[t].resize(count);
+      twilightBeginsHours[t].resize(count);
+      twilightEndsHours[t].resize(count);
+    }
+  }
+
+  std::size_t size() const { return julianDate.size(); }
+
+  std::vector<double> julianDate; /**< Local date, as the JD of its 0h. */
+  std::vector<ERiseSetStatus> sunStatus; /**< As from SunriseAndSunset. */
+  std::vector<float> sunriseHours;
+  std::vector<float> sunsetHours;
+  std::vector<float> sunriseAzimuthDeg;
+  std::vector<float> sunsetAzimuthDeg;
+  std::vector<ETwilightStatus> twilightStatus[3];
+  std::vector<float> twilightBeginsHours[3]; /**< Morning twilight begins. */
+  std::vector<float> twilightEndsHours[3];   /**< Evening twilight ends. */
+  std::vector<float> moonriseHours;
+  std::vector<int> moonriseDayOffset; /**< Days after the date. */
+  std::vector<float> moonriseAzimuthDeg;
+  std::vector<int> moonriseIterations; /**< Lunar positions used. */
+  std::vector<float> moonsetHours;
+  std::vector<int> moonsetDayOffset; /**< Days after the date. */
+  std::vector<float> moonsetAzimuthDeg;
+  std::vector<int> moonsetIterations; /**< Lunar positions used. */
+  std::vector<float> moonPhase;         /**< Illuminated fraction, at noon. */
+  std::vector<float> moonBrightLimbDeg; /**< Bright limb angle, at noon. */
+  std::vector<float> equationOfTimeMinutes; /**< As from EquationOfTime. */
+};
+
+/**
+ * \brief Counts for a PAResultCache, over all shards.
+ */
+class CCacheStats {
+public:
+  CCacheStats(std::uint64_t hits, std::uint64_t misses,
+              std::uint64_t evictions, std::size_t size,
+              std::size_t capacity) {
+    this->hits = hits;
+    this->misses = misses;
+    this->evictions = evictions;
+    this->size = size;
+    this->capacity = capacity;
+  }
+
+  std::uint64_t hits;
+  std::uint64_t misses;
+  std::uint64_t evictions;
+  std::size_t size;     /**< Results held now. */
+  std::size_t capacity; /**< Most results held at once. */
+};
+
+/**
+ * \brief Observer's site and time zone, for bulk jobs over many sites.
+ */
+class CObservingSite {
+public:
+  CObservingSite(double geogLongDeg, double geogLatDeg, bool isDaylightSaving,
+                 int zoneCorrectionHours) {
+    this->geogLongDeg = geogLongDeg;
+    this->geogLatDeg = geogLatDeg;
+    this->isDaylightSaving = isDaylightSaving;
+    this->zoneCorrectionHours = zoneCorrectionHours;
+  }
+
+  double geogLongDeg;
+  double geogLatDeg;
+  bool isDaylightSaving;
+  int zoneCorrectionHours;
+};
+
+/**
+ * \brief Interval of time, as Julian dates (UT).
+ */
+class CVisibilityWindow {
+public:
+  CVisibilityWindow(double startJulianDate, double endJulianDate) {
+    this->startJulianDate = startJulianDate;
+    this->endJulianDate = endJulianDate;
+  }
+
+  double startJulianDate;
+  double endJulianDate;
+};
+
+/**
+ * \brief Altitude limit for one body, used in a visibility search.
+ */
+class CAltitudeConstraint {
+public:
+  CAltitudeConstraint(EVisibilityBody body, EAltitudeSense sense,
+                      double altitudeDeg) {
+    this->body = body;
+    this->sense = sense;
+    this->altitudeDeg = altitudeDeg;
+    this->raHours = 0;
+    this->decDeg = 0;
+  }
+
+  CAltitudeConstraint(double raHours, double decDeg, EAltitudeSense sense,
+                      double altitudeDeg) {
+    this->body = EVisibilityBody::FixedObject;
+    this->sense = sense;
+    this->altitudeDeg = altitudeDeg;
+    this->raHours = raHours;
+    this->decDeg = decDeg;
+  }
+
+  CAltitudeConstraint(std::string planetName, EAltitudeSense sense,
+                      double altitudeDeg) {
+    this->body = EVisibilityBody::Planet;
+    this->sense = sense;
+    this->altitudeDeg = altitudeDeg;
+    this->raHours = 0;
+    this->decDeg = 0;
+    this->planetName = planetName;
+  }
+
+  EVisibilityBody body;   /**< Body the limit applies to. */
+  EAltitudeSense sense;   /**< Whether the body must be above or below. */
+  double altitudeDeg;     /**< Altitude limit, in degrees. */
+  double raHours;         /**< Right ascension of a fixed object, in hours. */
+  double decDeg;          /**< Declination of a fixed object, in degrees. */
+  std::string planetName; /**< Name of the planet, for Planet constraints. */
+};
+
+/**
+ * \brief Zero crossing or extremum of a scalar function of time.
+ */
+class CScalarEvent {
+public:
+  CScalarEvent(double julianDate, double value, int direction) {
+    this->julianDate = julianDate;
+    this->value = value;
+    this->direction = direction;
+  }
+
+  double julianDate; /**< Time of the event (Julian date, UT). */
+  double value;      /**< Function value at the event. */
+  int direction; /**< Crossing: +1 rising, -1 falling. Extremum: +1 maximum,
+                    -1 minimum. */
+};
+
+/**
+ * \brief Planetary event (conjunction, opposition, elongation, station).
+ */
+class CPlanetaryEvent {
+public:
+  CPlanetaryEvent(EPlanetaryEventType eventType, std::string planetName,
+                  double julianDate, double value) {
+    this->eventType = eventType;
+    this->planetName = planetName;
+    this->julianDate = julianDate;
+    this->value = value;
+  }
+
+  EPlanetaryEventType eventType;
+  std::string planetName;
+  double julianDate; /**< Time of the event (Julian date, UT). */
+  double value; /**< Elongation from the Sun (conjunctions, oppositions,
+                   greatest elongations) or geocentric ecliptic longitude
+                   (stations), in degrees. */
+};
+
 class CPrecession {
 public:
   CPrecession(double correctedRaHour, double correctedRaMinutes,
@@ -724,6 +996,25 @@ public:
   double separationArcsec;
 };
 
+/**
+ * \brief Orbit track of a binary star: position angle and separation at a
+ * series of epochs.
+ *
+ * Structure of arrays: element i of every column belongs to epoch i.
+ */
+class CBinaryStarOrbitTrack {
+public:
+  CBinaryStarOrbitTrack() {}
+
+  CBinaryStarOrbitTrack(std::size_t count)
+      : positionAngleDeg(count), separationArcsec(count) {}
+
+  std::size_t size() const { return positionAngleDeg.size(); }
+
+  std::vector<double> positionAngleDeg; /**< Position angle, degrees. */
+  std::vector<double> separationArcsec; /**< Separation, arcseconds. */
+};
+
 class CMoonApproximatePosition {
 public:
   CMoonApproximatePosition(double raHour, double raMin, double raSec,
@@ -894,6 +1185,33 @@ public:
   double msAzimuthDeg;
 };
 
+/**
+ * \brief One moonrise or moonset: local time (-99 if there is none), local
+ * date and azimuth, with the number of lunar positions the iteration used.
+ */
+class CMoonRiseSetEvent {
+public:
+  CMoonRiseSetEvent(double localTimeHours, double localDateDay,
+                    int localDateMonth, int localDateYear, double azimuthDeg,
+                    int iterations, bool isConverged) {
+    this->localTimeHours = localTimeHours;
+    this->localDateDay = localDateDay;
+    this->localDateMonth = localDateMonth;
+    this->localDateYear = localDateYear;
+    this->azimuthDeg = azimuthDeg;
+    this->iterations = iterations;
+    this->isConverged = isConverged;
+  }
+
+  double localTimeHours;
+  double localDateDay;
+  int localDateMonth;
+  int localDateYear;
+  double azimuthDeg;
+  int iterations;   /**< Lunar positions computed. */
+  bool isConverged; /**< Tolerance met before the iteration limit. */
+};
+
 class CMoonRiseLCTL6680 {
 public:
   CMoonRiseLCTL6680(double ut, double lct, double dy1, int mn1, int yr1,
@@ -2,6 +2,7 @@
 #include "pa_data.h"
 #include "pa_macros.h"
 #include "pa_models.h"
+#include "pa_trace.h"
 #include "pa_util.h"
 #include <cmath>
 #include <string>
@@ -19,6 +20,8 @@ PAMoon::ApproximatePositionOfMoon(double lctHour, double lctMin, double lctSec,
                                   bool isDaylightSaving,
                                   int zoneCorrectionHours, double localDateDay,
                                   int localDateMonth, int localDateYear) {
+  PA_TRACE_SPAN("PAMoon::ApproximatePositionOfMoon");
+
   int daylightSaving = isDaylightSaving ? 1 : 0;
 
   double l0 = 91.9293359879052;
@@ -91,6 +94,8 @@ PAMoon::PrecisePositionOfMoon(double lctHour, double lctMin, double lctSec,
                               bool isDaylightSaving, int zoneCorrectionHours,
                               double localDateDay, int localDateMonth,
                               int localDateYear) {
+  PA_TRACE_SPAN("PAMoon::PrecisePositionOfMoon");
+
   int daylightSaving = isDaylightSaving ? 1 : 0;
 
   double gdateDay = LocalCivilTimeGreenwichDay(
@@ -140,6 +145,8 @@ CMoonPhase PAMoon::MoonPhase(double lctHour, double lctMin, double lctSec,
                              bool isDaylightSaving, int zoneCorrectionHours,
                              double localDateDay, int localDateMonth,
                              int localDateYear, EAccuracyLevel accuracyLevel) {
+  PA_TRACE_SPAN("PAMoon::MoonPhase");
+
   int daylightSaving = isDaylightSaving ? 1 : 0;
 
   double gdateDay = LocalCivilTimeGreenwichDay(
@@ -198,6 +205,8 @@ CMoonNewFull PAMoon::TimesOfNewMoonAndFullMoon(bool isDaylightSaving,
                                                double localDateDay,
                                                int localDateMonth,
                                                int localDateYear) {
+  PA_TRACE_SPAN("PAMoon::TimesOfNewMoonAndFullMoon");
+
   int daylightSaving = isDaylightSaving ? 1 : 0;
 
   double jdOfNewMoonDays = NewMoon(daylightSaving, zoneCorrectionHours,
@@ -259,6 +268,8 @@ PAMoon::MoonDistAngDiamHorParallax(double lctHour, double lctMin, double lctSec,
                                    bool isDaylightSaving,
                                    int zoneCorrectionHours, double localDateDay,
                                    int localDateMonth, int localDateYear) {
+  PA_TRACE_SPAN("PAMoon::MoonDistAngDiamHorParallax");
+
   int daylightSaving = isDaylightSaving ? 1 : 0;
 
   double moonDistance =
@@ -290,6 +301,8 @@ CMoonRiseSet PAMoon::MoonriseAndMoonset(double localDateDay, int localDateMonth,
                                         bool isDaylightSaving,
                                         int zoneCorrectionHours,
                                         double geogLongDeg, double geogLatDeg) {
+  PA_TRACE_SPAN("PAMoon::MoonriseAndMoonset");
+
   int daylightSaving = isDaylightSaving ? 1 : 0;
 
   double localTimeOfMoonriseHours =
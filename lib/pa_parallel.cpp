@@ -0,0 +1,140 @@
+#include "pa_parallel.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace {
+/** Chunks dealt to each worker: enough to even out uneven tasks. */
+const std::size_t kChunksPerWorker = 8;
+} // namespace
+
+PATaskPool::PATaskPool(int workerCount) {
+  if (workerCount <= 0)
+    workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+  this->generation = 0;
+  this->finishedWorkers = 0;
+  this->stopping = false;
+  this->job = nullptr;
+  this->steals = 0;
+
+  for (int w = 0; w < workerCount; w++)
+    workers.push_back(std::make_unique<Worker>());
+  for (int w = 1; w < workerCount; w++)
+    threads.emplace_back(&PATaskPool::WorkerLoop, this, w);
+}
+
+PATaskPool::~PATaskPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  jobReady.notify_all();
+
+  for (std::thread &thread : threads)
+    thread.join();
+}
+
+/**
+ * \brief Call task(i, worker) for i = 0 .. taskCount - 1, and return when
+ * all have returned.
+ *
+ * worker (0 .. WorkerCount() - 1) names the thread making the call; no two
+ * calls with the same worker run at once. Jobs from several threads are run
+ * one after another.
+ */
+void PATaskPool::Run(
+    std::size_t taskCount,
+    const std::function<void(std::size_t task, int worker)> &task) {
+  if (taskCount == 0)
+    return;
+
+  std::lock_guard<std::mutex> runLock(runMutex);
+
+  std::size_t workerCount = workers.size();
+  std::size_t chunkSize =
+      std::max<std::size_t>(1, taskCount / (workerCount * kChunksPerWorker));
+  std::size_t chunkIndex = 0;
+  for (std::size_t first = 0; first < taskCount; first += chunkSize) {
+    Worker &worker = *workers[chunkIndex++ % workerCount];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.chunks.push_back({first, std::min(taskCount, first + chunkSize)});
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = &task;
+    finishedWorkers = 0;
+    generation++;
+  }
+  jobReady.notify_all();
+
+  Work(0);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  jobDone.wait(lock,
+               [this] { return finishedWorkers == (int)threads.size(); });
+  job = nullptr;
+}
+
+void PATaskPool::WorkerLoop(int worker) {
+  std::uint64_t seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      jobReady.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping)
+        return;
+      seen = generation;
+    }
+
+    Work(worker);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      finishedWorkers++;
+    }
+    jobDone.notify_one();
+  }
+}
+
+/**
+ * \brief Run chunks until no queue has any left.
+ */
+void PATaskPool::Work(int worker) {
+  Chunk chunk;
+  while (TakeChunk(worker, chunk))
+    for (std::size_t i = chunk.first; i < chunk.last; i++)
+      (*job)(i, worker);
+}
+
+/**
+ * \brief Take the newest chunk from the worker's own queue, or else the
+ * oldest from the next queue that has one.
+ */
+bool PATaskPool::TakeChunk(int worker, Chunk &chunk) {
+  {
+    Worker &own = *workers[worker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.chunks.empty()) {
+      chunk = own.chunks.back();
+      own.chunks.pop_back();
+      return true;
+    }
+  }
+
+  for (std::size_t offset = 1; offset < workers.size(); offset++) {
+    Worker &victim = *workers[(worker + offset) % workers.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.chunks.empty()) {
+      chunk = victim.chunks.front();
+      victim.chunks.pop_front();
+      steals.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,133 @@
+#ifndef _pa_parallel
+#define _pa_parallel
+
+#include "pa_eclipses.h"
+#include "pa_models.h"
+#include "pa_moon.h"
+#include "pa_planet.h"
+#include "pa_sun.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace pa_models;
+
+/**
+ * \brief Fixed set of worker threads that share out bulk jobs by work
+ * stealing.
+ *
+ * Run() cuts a job's tasks into chunks and deals them to the workers' own
+ * queues. A worker takes chunks from the back of its queue; once that is
+ * empty it steals from the front of another's. Days that cost more (polar
+ * moonrise, eclipse days) leave their worker behind, and the others take
+ * its remaining chunks.
+ *
+ * The thread calling Run() is worker 0, so a pool of one worker starts no
+ * threads. Tasks must not throw.
+ */
+class PATaskPool {
+public:
+  /** @param workerCount Workers, including the caller; 0 for one per core. */
+  explicit PATaskPool(int workerCount = 0);
+  ~PATaskPool();
+
+  PATaskPool(const PATaskPool &) = delete;
+  PATaskPool &operator=(const PATaskPool &) = delete;
+
+  int WorkerCount() const { return (int)workers.size(); }
+
+  void Run(std::size_t taskCount,
+           const std::function<void(std::size_t task, int worker)> &task);
+
+  /** Chunks taken from another worker's queue, over all jobs. */
+  std::uint64_t Steals() const { return steals.load(); }
+
+private:
+  struct Chunk {
+    std::size_t first;
+    std::size_t last; /**< One past the last task. */
+  };
+
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Chunk> chunks;
+  };
+
+  void WorkerLoop(int worker);
+
+  void Work(int worker);
+
+  bool TakeChunk(int worker, Chunk &chunk);
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+
+  std::mutex runMutex; /**< One job at a time. */
+  std::mutex mutex;
+  std::condition_variable jobReady;
+  std::condition_variable jobDone;
+  std::uint64_t generation;
+  int finishedWorkers;
+  bool stopping;
+  const std::function<void(std::size_t, int)> *job;
+  std::atomic<std::uint64_t> steals;
+};
+
+/**
+ * \brief Per-worker scratch for ParallelForEach: a set of façades that only
+ * one worker uses.
+ */
+struct PAWorkerFacades {
+  PASun sun;
+  PAMoon moon;
+  PAPlanet planet;
+  PAEclipses eclipses;
+};
+
+/**
+ * \brief Call function(scratch, site, date) for every site and date, on
+ * the pool's workers.
+ *
+ * Each worker has its own Scratch (by default, its own façades), so
+ * function needs no locks for it. Results come back in the same order
+ * whatever the number of workers: site by site, and date by date within a
+ * site (result[siteIndex * dates.size() + dateIndex]).
+ */
+template <typename Scratch = PAWorkerFacades, typename Function>
+auto ParallelForEach(PATaskPool &pool,
+                     const std::vector<CObservingSite> &sites,
+                     const std::vector<CMonthDayYear> &dates,
+                     Function function)
+    -> std::vector<decltype(function(std::declval<Scratch &>(), sites[0],
+                                     dates[0]))> {
+  using Result =
+      decltype(function(std::declval<Scratch &>(), sites[0], dates[0]));
+
+  std::size_t count = sites.size() * dates.size();
+  std::vector<std::optional<Result>> slots(count);
+  std::vector<Scratch> scratch(pool.WorkerCount());
+
+  pool.Run(count, [&](std::size_t task, int worker) {
+    const CObservingSite &site = sites[task / dates.size()];
+    const CMonthDayYear &date = dates[task % dates.size()];
+    slots[task].emplace(function(scratch[worker], site, date));
+  });
+
+  std::vector<Result> results;
+  results.reserve(count);
+  for (std::optional<Result> &slot : slots)
+    results.push_back(std::move(*slot));
+
+  return results;
+}
+
+#endif
@@ -5,12 +5,90 @@
 #include "pa_util.h"
 #include <cmath>
 #include <string>
+#include <vector>
 
 using namespace pa_types;
 using namespace pa_models;
 using namespace pa_util;
 using namespace pa_macros;
 
+namespace {
+/**
+ * Precise position of a planet from its coordinates, for a given obliquity
+ * (degrees).
+ */
+CPrecisePositionOfPlanet
+PrecisePositionFromCoordinates(const CPlanetCoordinates &coordinateResults,
+                               double obliqDeg) {
+  double planetRAHours =
+      DecimalDegreesToDegreeHours(EclipticRightAscensionObliq(
+          coordinateResults.planetLongitude, coordinateResults.planetLatitude,
+          obliqDeg));
+  double planetDecDeg1 =
+      EclipticDeclinationObliq(coordinateResults.planetLongitude,
+                               coordinateResults.planetLatitude, obliqDeg);
+
+  int planetRAHour = DecimalHoursHour(planetRAHours);
+  int planetRAMin = DecimalHoursMinute(planetRAHours);
+  double planetRASec = DecimalHoursSecond(planetRAHours);
+  double planetDecDeg = DecimalDegreesDegrees(planetDecDeg1);
+  double planetDecMin = DecimalDegreesMinutes(planetDecDeg1);
+  double planetDecSec = DecimalDegreesSeconds(planetDecDeg1);
+
+  return CPrecisePositionOfPlanet(planetRAHour, planetRAMin, planetRASec,
+                                  planetDecDeg, planetDecMin, planetDecSec);
+}
+
+/**
+ * Visual aspects of a planet from its coordinates, for a given obliquity
+ * (degrees) and the Sun's right ascension and declination (radians).
+ */
+CPlanetVisualAspects
+VisualAspectsFromCoordinates(const CPlanetCoordinates &planetCoordInfo,
+                             const std::string &planetName, double obliqDeg,
+                             double sunRARad, double sunDecRad) {
+  double planetRARad = DegreesToRadians(EclipticRightAscensionObliq(
+      planetCoordInfo.planetLongitude, planetCoordInfo.planetLatitude,
+      obliqDeg));
+  double planetDecRad = DegreesToRadians(EclipticDeclinationObliq(
+      planetCoordInfo.planetLongitude, planetCoordInfo.planetLatitude,
+      obliqDeg));
+
+  double lightTravelTimeHours = planetCoordInfo.planetDistanceAU * 0.1386;
+
+  pa_data::PlanetData planetInfo = pa_data::planetLookup(planetName);
+  double angularDiameterArcsec =
+      planetInfo.theta0_AngularDiameter / planetCoordInfo.planetDistanceAU;
+  double phase1 =
+      0.5 * (1.0 + cos(DegreesToRadians(planetCoordInfo.planetLongitude -
+                                        planetCoordInfo.planetHLong1)));
+
+  double y = cos(sunDecRad) * sin(sunRARad - planetRARad);
+  double x = cos(planetDecRad) * sin(sunDecRad) -
+             sin(planetDecRad) * cos(sunDecRad) * cos(sunRARad - planetRARad);
+
+  double chiDeg = WToDegrees(atan2(y, x));
+  double radiusVectorAU = planetCoordInfo.planetRVect;
+  double approximateMagnitude1 =
+      5.0 * log10(radiusVectorAU * planetCoordInfo.planetDistanceAU /
+                  sqrt(phase1)) +
+      planetInfo.v0_VisualMagnitude;
+
+  double distanceAU = Round(planetCoordInfo.planetDistanceAU, 5);
+  double angDiaArcsec = Round(angularDiameterArcsec, 1);
+  double phase = Round(phase1, 2);
+  int lightTimeHour = DecimalHoursHour(lightTravelTimeHours);
+  int lightTimeMinutes = DecimalHoursMinute(lightTravelTimeHours);
+  double lightTimeSeconds = DecimalHoursSecond(lightTravelTimeHours);
+  double posAngleBrightLimbDeg = Round(chiDeg, 1);
+  double approximateMagnitude = Round(approximateMagnitude1, 1);
+
+  return CPlanetVisualAspects(distanceAU, angDiaArcsec, phase, lightTimeHour,
+                              lightTimeMinutes, lightTimeSeconds,
+                              posAngleBrightLimbDeg, approximateMagnitude);
+}
+} // namespace
+
 /**
  * Calculate approximate position of a planet.
  *
@@ -125,24 +203,9 @@ CPrecisePositionOfPlanet PAPlanet::PrecisePositionOfPlanet(
                                    zoneCorrectionHours, localDateDay,
                                    localDateMonth, localDateYear, planetName);
 
-  double planetRAHours =
-      pa_macros::DecimalDegreesToDegreeHours(pa_macros::EclipticRightAscension(
-          coordinateResults.planetLongitude, 0, 0,
-          coordinateResults.planetLatitude, 0, 0, localDateDay, localDateMonth,
-          localDateYear));
-  double planetDecDeg1 = pa_macros::EclipticDeclination(
-      coordinateResults.planetLongitude, 0, 0, coordinateResults.planetLatitude,
-      0, 0, localDateDay, localDateMonth, localDateYear);
-
-  int planetRAHour = pa_macros::DecimalHoursHour(planetRAHours);
-  int planetRAMin = pa_macros::DecimalHoursMinute(planetRAHours);
-  double planetRASec = pa_macros::DecimalHoursSecond(planetRAHours);
-  double planetDecDeg = pa_macros::DecimalDegreesDegrees(planetDecDeg1);
-  double planetDecMin = pa_macros::DecimalDegreesMinutes(planetDecDeg1);
-  double planetDecSec = pa_macros::DecimalDegreesSeconds(planetDecDeg1);
-
-  return CPrecisePositionOfPlanet(planetRAHour, planetRAMin, planetRASec,
-                                  planetDecDeg, planetDecMin, planetDecSec);
+  return PrecisePositionFromCoordinates(
+      coordinateResults,
+      pa_macros::Obliq(localDateDay, localDateMonth, localDateYear));
 }
 
 /**
@@ -171,53 +234,76 @@ PAPlanet::VisualAspectsOfAPlanet(double lctHour, double lctMin, double lctSec,
       lctHour, lctMin, lctSec, daylightSaving, zoneCorrectionHours,
       localDateDay, localDateMonth, localDateYear, planetName);
 
-  double planetRARad = DegreesToRadians(EclipticRightAscension(
-      planetCoordInfo.planetLongitude, 0, 0, planetCoordInfo.planetLatitude, 0,
-      0, localDateDay, localDateMonth, localDateYear));
-  double planetDecRad = DegreesToRadians(EclipticDeclination(
-      planetCoordInfo.planetLongitude, 0, 0, planetCoordInfo.planetLatitude, 0,
-      0, localDateDay, localDateMonth, localDateYear));
+  double sunEclLongDeg =
+      SunLong(lctHour, lctMin, lctSec, daylightSaving, zoneCorrectionHours,
+              localDateDay, localDateMonth, localDateYear);
+  double sunObliqDeg =
+      Obliq(greenwichDateDay, greenwichDateMonth, greenwichDateYear);
+  double sunRARad = DegreesToRadians(
+      EclipticRightAscensionObliq(sunEclLongDeg, 0, sunObliqDeg));
+  double sunDecRad =
+      DegreesToRadians(EclipticDeclinationObliq(sunEclLongDeg, 0, sunObliqDeg));
+
+  return VisualAspectsFromCoordinates(
+      planetCoordInfo, planetName,
+      Obliq(localDateDay, localDateMonth, localDateYear), sunRARad, sunDecRad);
+}
 
-  double lightTravelTimeHours = planetCoordInfo.planetDistanceAU * 0.1386;
+/**
+ * Calculate precise positions, and optionally visual aspects, of all seven
+ * planets at one instant.
+ *
+ * The orbital elements, the Sun's position and the obliquity are evaluated
+ * once and shared by all the planets. Results are the same as calling
+ * PrecisePositionOfPlanet() and VisualAspectsOfAPlanet() for each planet.
+ *
+ * @return CAllPlanetPositions
+ */
+CAllPlanetPositions PAPlanet::PrecisePositionOfAllPlanets(
+    double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+    int zoneCorrectionHours, double localDateDay, int localDateMonth,
+    int localDateYear, bool includeVisualAspects) {
+  int daylightSaving = isDaylightSaving ? 1 : 0;
 
-  pa_data::PlanetData planetInfo = pa_data::planetLookup(planetName);
-  double angularDiameterArcsec =
-      planetInfo.theta0_AngularDiameter / planetCoordInfo.planetDistanceAU;
-  double phase1 =
-      0.5 * (1.0 + cos(DegreesToRadians(planetCoordInfo.planetLongitude -
-                                        planetCoordInfo.planetHLong1)));
+  std::vector<CPlanetCoordinates> coordinates = AllPlanetCoordinates(
+      lctHour, lctMin, lctSec, daylightSaving, zoneCorrectionHours,
+      localDateDay, localDateMonth, localDateYear);
+  double obliqDeg = Obliq(localDateDay, localDateMonth, localDateYear);
+
+  CAllPlanetPositions result;
+  result.planetNames = {"Mercury", "Venus",  "Mars",   "Jupiter",
+                        "Saturn",  "Uranus", "Neptune"};
+  for (const CPlanetCoordinates &planetCoordInfo : coordinates)
+    result.positions.push_back(
+        PrecisePositionFromCoordinates(planetCoordInfo, obliqDeg));
+
+  if (!includeVisualAspects)
+    return result;
+
+  double greenwichDateDay = LocalCivilTimeGreenwichDay(
+      lctHour, lctMin, lctSec, daylightSaving, zoneCorrectionHours,
+      localDateDay, localDateMonth, localDateYear);
+  int greenwichDateMonth = LocalCivilTimeGreenwichMonth(
+      lctHour, lctMin, lctSec, daylightSaving, zoneCorrectionHours,
+      localDateDay, localDateMonth, localDateYear);
+  int greenwichDateYear = LocalCivilTimeGreenwichYear(
+      lctHour, lctMin, lctSec, daylightSaving, zoneCorrectionHours,
+      localDateDay, localDateMonth, localDateYear);
 
   double sunEclLongDeg =
       SunLong(lctHour, lctMin, lctSec, daylightSaving, zoneCorrectionHours,
               localDateDay, localDateMonth, localDateYear);
+  double sunObliqDeg =
+      Obliq(greenwichDateDay, greenwichDateMonth, greenwichDateYear);
   double sunRARad = DegreesToRadians(
-      EclipticRightAscension(sunEclLongDeg, 0, 0, 0, 0, 0, greenwichDateDay,
-                             greenwichDateMonth, greenwichDateYear));
-  double sunDecRad = DegreesToRadians(
-      EclipticDeclination(sunEclLongDeg, 0, 0, 0, 0, 0, greenwichDateDay,
-                          greenwichDateMonth, greenwichDateYear));
+      EclipticRightAscensionObliq(sunEclLongDeg, 0, sunObliqDeg));
+  double sunDecRad =
+      DegreesToRadians(EclipticDeclinationObliq(sunEclLongDeg, 0, sunObliqDeg));
 
-  double y = cos(sunDecRad) * sin(sunRARad - planetRARad);
-  double x = cos(planetDecRad) * sin(sunDecRad) -
-             sin(planetDecRad) * cos(sunDecRad) * cos(sunRARad - planetRARad);
+  for (std::size_t i = 0; i < coordinates.size(); i++)
+    result.visualAspects.push_back(
+        VisualAspectsFromCoordinates(coordinates[i], result.planetNames[i],
+                                     obliqDeg, sunRARad, sunDecRad));
 
-  double chiDeg = WToDegrees(atan2(y, x));
-  double radiusVectorAU = planetCoordInfo.planetRVect;
-  double approximateMagnitude1 =
-      5.0 * log10(radiusVectorAU * planetCoordInfo.planetDistanceAU /
-                  sqrt(phase1)) +
-      planetInfo.v0_VisualMagnitude;
-
-  double distanceAU = Round(planetCoordInfo.planetDistanceAU, 5);
-  double angDiaArcsec = Round(angularDiameterArcsec, 1);
-  double phase = Round(phase1, 2);
-  int lightTimeHour = DecimalHoursHour(lightTravelTimeHours);
-  int lightTimeMinutes = DecimalHoursMinute(lightTravelTimeHours);
-  double lightTimeSeconds = DecimalHoursSecond(lightTravelTimeHours);
-  double posAngleBrightLimbDeg = Round(chiDeg, 1);
-  double approximateMagnitude = Round(approximateMagnitude1, 1);
-
-  return CPlanetVisualAspects(distanceAU, angDiaArcsec, phase, lightTimeHour,
-                              lightTimeMinutes, lightTimeSeconds,
-                              posAngleBrightLimbDeg, approximateMagnitude);
+  return result;
 }
@@ -26,5 +26,10 @@ public:
                          bool isDaylightSaving, int zoneCorrectionHours,
                          double localDateDay, int localDateMonth,
                          int localDateYear, std::string planetName);
+
+  CAllPlanetPositions PrecisePositionOfAllPlanets(
+      double lctHour, double lctMin, double lctSec, bool isDaylightSaving,
+      int zoneCorrectionHours, double localDateDay, int localDateMonth,
+      int localDateYear, bool includeVisualAspects = false);
 };
 #endif
@@ -0,0 +1,151 @@
+#include "pa_ranges.h"
+#include "pa_raw.h"
+#include "pa_util.h"
+#include <cmath>
+#include <string>
+
+using namespace pa_util;
+
+namespace pa_ranges {
+
+PositionGenerator::PositionGenerator(const std::string &body,
+                                     double startJulianDate, double stepDays) {
+  this->body = body;
+  this->startJulianDate = startJulianDate;
+  this->stepDays = stepDays;
+  this->haveTerms = false;
+}
+
+/**
+ * \brief Terms of the Greenwich date of an instant, kept from the last
+ * instant if it fell on the same date.
+ */
+const pa_raw::DateTerms &PositionGenerator::Terms(double julianDate) {
+  if (!haveTerms || julianDate < terms.midnightJulianDate ||
+      julianDate >= terms.midnightJulianDate + 1) {
+    terms = pa_raw::DateTermsOf(julianDate);
+    haveTerms = true;
+  }
+  return terms;
+}
+
+/**
+ * \brief Compute values first .. first + count - 1 of the range.
+ *
+ * A body that is neither "Sun", "Moon" nor a planet gives zeros, as
+ * pa_raw::Planet does.
+ */
+void PositionGenerator::Fill(std::size_t first, std::size_t count,
+                             Position *values) {
+  for (std::size_t i = 0; i < count; i++) {
+    double julianDate = startJulianDate + stepDays * (first + i);
+    const pa_raw::DateTerms &dateTerms = Terms(julianDate);
+
+    Position &value = values[i];
+    value.julianDate = julianDate;
+    if (body == "Sun") {
+      pa_raw::SunPosition sun = pa_raw::Sun(julianDate, dateTerms);
+      value.raRad = sun.raRad;
+      value.decRad = sun.decRad;
+      value.distance = sun.distanceKm;
+    } else if (body == "Moon") {
+      pa_raw::MoonPosition moon = pa_raw::Moon(julianDate, dateTerms);
+      value.raRad = moon.raRad;
+      value.decRad = moon.decRad;
+      value.distance = moon.distanceKm;
+    } else {
+      pa_raw::PlanetPosition planet =
+          pa_raw::Planet(julianDate, body, dateTerms);
+      value.raRad = planet.raRad;
+      value.decRad = planet.decRad;
+      value.distance = planet.distanceAU;
+    }
+  }
+}
+
+SunAltitudeGenerator::SunAltitudeGenerator(const CObservingSite &site,
+                                           double startJulianDate,
+                                           double stepDays) {
+  this->geogLongHours = site.geogLongDeg / 15.0;
+  this->sinLatitude = sin(DegreesToRadians(site.geogLatDeg));
+  this->cosLatitude = cos(DegreesToRadians(site.geogLatDeg));
+  this->startJulianDate = startJulianDate;
+  this->stepDays = stepDays;
+  this->haveTerms = false;
+}
+
+/**
+ * \brief Terms of the Greenwich date of an instant, kept from the last
+ * instant if it fell on the same date.
+ */
+const pa_raw::DateTerms &SunAltitudeGenerator::Terms(double julianDate) {
+  if (!haveTerms || julianDate < terms.midnightJulianDate ||
+      julianDate >= terms.midnightJulianDate + 1) {
+    terms = pa_raw::DateTermsOf(julianDate);
+    haveTerms = true;
+  }
+  return terms;
+}
+
+/**
+ * \brief Compute values first .. first + count - 1 of the range.
+ *
+ * The same as pa_raw::EquatorialToHorizon of the hour angle from
+ * pa_raw::LocalSiderealTime, with the site's latitude terms worked out
+ * once.
+ */
+void SunAltitudeGenerator::Fill(std::size_t first, std::size_t count,
+                                Altitude *values) {
+  for (std::size_t i = 0; i < count; i++) {
+    double julianDate = startJulianDate + stepDays * (first + i);
+    const pa_raw::DateTerms &dateTerms = Terms(julianDate);
+    pa_raw::SunPosition sun = pa_raw::Sun(julianDate, dateTerms);
+
+    double lstHours =
+        pa_raw::GreenwichSiderealTime(julianDate, dateTerms) + geogLongHours;
+    lstHours = lstHours - 24 * floor(lstHours / 24);
+    double hourAngleRad = DegreesToRadians(lstHours * 15.0) - sun.raRad;
+
+    double sinAltitude = sin(sun.decRad) * sinLatitude +
+                         cos(sun.decRad) * cosLatitude * cos(hourAngleRad);
+    double azimuthRad =
+        atan2(-cos(sun.decRad) * cosLatitude * sin(hourAngleRad),
+              sin(sun.decRad) - sinLatitude * sinAltitude);
+
+    values[i].julianDate = julianDate;
+    values[i].altitudeRad = asin(sinAltitude);
+    values[i].azimuthRad =
+        azimuthRad - 2 * M_PI * floor(azimuthRad / (2 * M_PI));
+  }
+}
+
+/**
+ * \brief Positions of a body ("Sun", "Moon" or a planet) from an instant, at
+ * equal steps.
+ *
+ * @param startJulianDate Julian date (UT) of the first position.
+ * @param stepDays Time from one position to the next.
+ * @param count Number of positions; kUnbounded for no end.
+ * @param chunkSize Positions computed at a time.
+ */
+LazyRange<PositionGenerator> Ephemeris(const std::string &body,
+                                       double startJulianDate,
+                                       double stepDays, std::size_t count,
+                                       std::size_t chunkSize) {
+  return LazyRange<PositionGenerator>(
+      PositionGenerator(body, startJulianDate, stepDays), count, chunkSize);
+}
+
+/**
+ * \brief Altitudes of the Sun at a site from an instant, at equal steps.
+ *
+ * The site's time zone is not used: instants are Julian dates (UT).
+ */
+LazyRange<SunAltitudeGenerator>
+SunAltitudes(const CObservingSite &site, double startJulianDate,
+             double stepDays, std::size_t count, std::size_t chunkSize) {
+  return LazyRange<SunAltitudeGenerator>(
+      SunAltitudeGenerator(site, startJulianDate, stepDays), count, chunkSize);
+}
+
+} // namespace pa_ranges
@@ -0,0 +1,244 @@
+#ifndef _pa_ranges
+#define _pa_ranges
+
+#include "pa_models.h"
+#include "pa_raw.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace pa_models;
+
+/**
+ * \brief Lazy ranges of positions at equal steps of time.
+ *
+ * A range computes nothing until it is iterated, and then only a chunk of
+ * values at a time, so a loop or algorithm that stops early leaves the rest
+ * uncomputed. Instant i of a range is start + i * step, worked out afresh
+ * each time rather than accumulated. Terms that depend only on the
+ * Greenwich date (obliquity, nutation, sidereal time at 0h UT) are kept
+ * from one instant to the next until the date changes.
+ *
+ * Values are those of the pa_raw functions, and so of the façades.
+ *
+ *     for (const pa_ranges::Position &mars :
+ *          pa_ranges::Ephemeris("Mars", 2460310.5, 1.0).Take(365))
+ *       ...
+ *
+ *     auto days = pa_ranges::SunAltitudes(site, 2460310.5, 1.0 / 1440);
+ *     auto sunrise = std::find_if(days.begin(), days.end(),
+ *         [](const pa_ranges::Altitude &a) { return a.altitudeRad > 0; });
+ */
+namespace pa_ranges {
+
+/** Length of a range with no end. */
+const std::size_t kUnbounded = std::numeric_limits<std::size_t>::max();
+
+/** Values computed at a time, unless a range is given another. */
+const std::size_t kDefaultChunk = 64;
+
+/**
+ * Distance is in km for the Sun and Moon and AU for the planets, as in
+ * pa_raw.
+ */
+struct Position {
+  double julianDate;
+  double raRad;
+  double decRad;
+  double distance;
+};
+
+/**
+ * Geometric altitude and azimuth, without refraction.
+ */
+struct Altitude {
+  double julianDate;
+  double altitudeRad;
+  double azimuthRad;
+};
+
+/**
+ * \brief Positions of the Sun, the Moon or a planet.
+ */
+class PositionGenerator {
+public:
+  using value_type = Position;
+
+  PositionGenerator(const std::string &body, double startJulianDate,
+                    double stepDays);
+
+  void Fill(std::size_t first, std::size_t count, Position *values);
+
+private:
+  const pa_raw::DateTerms &Terms(double julianDate);
+
+  std::string body;
+  double startJulianDate;
+  double stepDays;
+  pa_raw::DateTerms terms;
+  bool haveTerms;
+};
+
+/**
+ * \brief Altitudes and azimuths of the Sun at a site.
+ */
+class SunAltitudeGenerator {
+public:
+  using value_type = Altitude;
+
+  SunAltitudeGenerator(const CObservingSite &site, double startJulianDate,
+                       double stepDays);
+
+  void Fill(std::size_t first, std::size_t count, Altitude *values);
+
+private:
+  const pa_raw::DateTerms &Terms(double julianDate);
+
+  double geogLongHours;
+  double sinLatitude;
+  double cosLatitude;
+  double startJulianDate;
+  double stepDays;
+  pa_raw::DateTerms terms;
+  bool haveTerms;
+};
+
+/**
+ * \brief A range of the values of a Generator, computed a chunk at a time
+ * as its iterators reach them.
+ *
+ * Iterators are input iterators. Copies of a range, and of its iterators,
+ * share the generator and the chunk last computed; an iterator that goes
+ * back to a value outside that chunk has it computed again. No chunk runs
+ * past the end of the range.
+ *
+ * Dereferencing an iterator gives a copy of the value, not a reference into
+ * the chunk, so an iterator kept by an algorithm such as std::max_element
+ * still gives its own value after others have moved the chunk on.
+ */
+template <typename Generator> class LazyRange {
+  class State;
+
+public:
+  using value_type = typename Generator::value_type;
+
+  class iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = typename Generator::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+
+    /**
+     * \brief Holds a copy of the value for operator->.
+     */
+    class pointer {
+    public:
+      explicit pointer(const value_type &value) : value(value) {}
+
+      const value_type *operator->() const { return &value; }
+
+    private:
+      value_type value;
+    };
+
+    iterator() : state(nullptr), index(0) {}
+    iterator(std::shared_ptr<State> state, std::size_t index)
+        : state(state), index(index) {}
+
+    reference operator*() const { return state->At(index); }
+    pointer operator->() const { return pointer(state->At(index)); }
+
+    iterator &operator++() {
+      index++;
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator before = *this;
+      index++;
+      return before;
+    }
+
+    bool operator==(const iterator &other) const {
+      return index == other.index;
+    }
+    bool operator!=(const iterator &other) const {
+      return index != other.index;
+    }
+
+  private:
+    std::shared_ptr<State> state;
+    std::size_t index;
+  };
+
+  LazyRange(Generator generator, std::size_t count, std::size_t chunkSize)
+      : generator(generator), count(count),
+        chunkSize(std::max<std::size_t>(chunkSize, 1)),
+        state(std::make_shared<State>(generator, count, this->chunkSize)) {}
+
+  iterator begin() const { return iterator(state, 0); }
+  iterator end() const { return iterator(state, count); }
+
+  /** Number of values; kUnbounded if there is no end. */
+  std::size_t size() const { return count; }
+
+  /**
+   * \brief A range of the first count values (fewer if this range is
+   * shorter).
+   */
+  LazyRange Take(std::size_t count) const {
+    return LazyRange(generator, std::min(count, this->count), chunkSize);
+  }
+
+private:
+  /**
+   * \brief The generator and the chunk of values it last computed.
+   */
+  class State {
+  public:
+    State(Generator generator, std::size_t count, std::size_t chunkSize)
+        : generator(generator), count(count), chunkSize(chunkSize), first(0) {
+      values.reserve(std::min(chunkSize, count));
+    }
+
+    const value_type &At(std::size_t index) {
+      if (index < first || index >= first + values.size()) {
+        values.resize(std::min(chunkSize, count - index));
+        generator.Fill(index, values.size(), values.data());
+        first = index;
+      }
+      return values[index - first];
+    }
+
+  private:
+    Generator generator;
+    std::size_t count;
+    std::size_t chunkSize;
+    std::size_t first;
+    std::vector<value_type> values;
+  };
+
+  Generator generator;
+  std::size_t count;
+  std::size_t chunkSize;
+  std::shared_ptr<State> state;
+};
+
+LazyRange<PositionGenerator> Ephemeris(const std::string &body,
+                                       double startJulianDate,
+                                       double stepDays,
+                                       std::size_t count = kUnbounded,
+                                       std::size_t chunkSize = kDefaultChunk);
+
+LazyRange<SunAltitudeGenerator>
+SunAltitudes(const CObservingSite &site, double startJulianDate,
+             double stepDays, std::size_t count = kUnbounded,
+             std::size_t chunkSize = kDefaultChunk);
+
+} // namespace pa_ranges
+#endif
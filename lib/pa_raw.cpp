@@ -0,0 +1,480 @@
+#include "pa_raw.h"
+#include "pa_data.h"
+#include "pa_macros.h"
+#include "pa_models.h"
+#include "pa_types.h"
+#include "pa_util.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace pa_models;
+using namespace pa_types;
+using namespace pa_util;
+using namespace pa_macros;
+
+namespace {
+/**
+ * \brief Ecliptic to equatorial coordinates, all in radians.
+ *
+ * Same formulae as EclipticRightAscensionObliq() and
+ * EclipticDeclinationObliq(), without the conversions to degrees.
+ */
+pa_raw::EquatorialCoordinates EclipticToEquatorialObliq(double longitudeRad,
+                                                        double latitudeRad,
+                                                        double obliquityRad) {
+  double raRad = atan2(sin(longitudeRad) * cos(obliquityRad) -
+                           tan(latitudeRad) * sin(obliquityRad),
+                       cos(longitudeRad));
+  double decRad =
+      asin(sin(latitudeRad) * cos(obliquityRad) +
+           cos(latitudeRad) * sin(obliquityRad) * sin(longitudeRad));
+
+  return {raRad - 2 * M_PI * floor(raRad / (2 * M_PI)), decRad};
+}
+
+/**
+ * \brief Obliquity (radians) for the Greenwich date of an instant.
+ */
+double ObliquityRad(const CGreenwichDateTime &g) {
+  return DegreesToRadians(Obliq(g.day, g.month, g.year));
+}
+
+pa_raw::PlanetPosition PlanetFromCoordinates(const CPlanetCoordinates &c,
+                                             double obliquityRad) {
+  double longitudeRad = DegreesToRadians(c.planetLongitude);
+  double latitudeRad = DegreesToRadians(c.planetLatitude);
+  pa_raw::EquatorialCoordinates equatorial =
+      EclipticToEquatorialObliq(longitudeRad, latitudeRad, obliquityRad);
+
+  return {longitudeRad,      latitudeRad,        equatorial.raRad,
+          equatorial.decRad, c.planetDistanceAU, c.planetRVect};
+}
+
+pa_raw::CometPosition CometFromLongLatDist(const CCometLongLatDist &c,
+                                           double obliquityRad) {
+  double longitudeRad = DegreesToRadians(c.longDeg);
+  double latitudeRad = DegreesToRadians(c.latDeg);
+  pa_raw::EquatorialCoordinates equatorial =
+      EclipticToEquatorialObliq(longitudeRad, latitudeRad, obliquityRad);
+
+  return {longitudeRad, latitudeRad, equatorial.raRad, equatorial.decRad,
+          c.distAU};
+}
+
+/**
+ * \brief Julian date of an eclipse time given by the UT macros.
+ *
+ * The macros give UT in hours on the Greenwich date of the lunation, wrapped
+ * into 0-24; a contact is put back on the same side of midnight as the
+ * maximum.
+ */
+double EclipseJulianDate(double dayJulianDate, double utHours,
+                         double utMaximumHours) {
+  if (utHours == -99.0)
+    return -99.0;
+
+  if (utHours - utMaximumHours > 12.0)
+    utHours -= 24.0;
+  else if (utMaximumHours - utHours > 12.0)
+    utHours += 24.0;
+
+  return dayJulianDate + utHours / 24.0;
+}
+
+/**
+ * \brief Greenwich date and UT of an instant on the date of some DateTerms.
+ */
+CGreenwichDateTime GreenwichDateTime(double julianDate,
+                                     const pa_raw::DateTerms &terms) {
+  return CGreenwichDateTime(terms.day, terms.month, terms.year,
+                            (julianDate - terms.midnightJulianDate) * 24);
+}
+
+/**
+ * \brief pa_raw::Sun, given the terms that depend only on the date.
+ */
+pa_raw::SunPosition SunAt(const CGreenwichDateTime &g, double obliquityRad,
+                          double eccentricity) {
+  double longitudeRad =
+      DegreesToRadians(SunLong(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year));
+  pa_raw::EquatorialCoordinates equatorial =
+      EclipticToEquatorialObliq(longitudeRad, 0, obliquityRad);
+
+  double trueAnomalyRad = DegreesToRadians(
+      SunTrueAnomaly(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year));
+  double f = (1 + eccentricity * cos(trueAnomalyRad)) /
+             (1 - eccentricity * eccentricity);
+
+  return {longitudeRad, equatorial.raRad, equatorial.decRad, 149598500 / f,
+          DegreesToRadians(f * 0.533128)};
+}
+
+/**
+ * \brief pa_raw::Moon, given the terms that depend only on the date.
+ */
+pa_raw::MoonPosition MoonAt(const CGreenwichDateTime &g, double obliquityRad,
+                            double nutationLongitudeDeg) {
+  CMoonLongLatHP moon =
+      MoonLongLatHP(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year);
+  double longitudeRad = DegreesToRadians(moon.longitudeDegrees);
+  double latitudeRad = DegreesToRadians(moon.latitudeDegrees);
+  double parallaxRad = DegreesToRadians(moon.horizontalParallax);
+
+  pa_raw::EquatorialCoordinates equatorial = EclipticToEquatorialObliq(
+      DegreesToRadians(moon.longitudeDegrees + nutationLongitudeDeg),
+      latitudeRad, obliquityRad);
+  double distanceKm = 6378.14 / sin(parallaxRad);
+
+  return {longitudeRad,
+          latitudeRad,
+          equatorial.raRad,
+          equatorial.decRad,
+          distanceKm,
+          DegreesToRadians(384401.0 * 0.5181 / distanceKm),
+          parallaxRad};
+}
+} // namespace
+
+namespace pa_raw {
+
+/**
+ * \brief Terms that depend only on the Greenwich date of an instant.
+ */
+DateTerms DateTermsOf(double julianDate) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+
+  DateTerms terms;
+  terms.midnightJulianDate = floor(julianDate - 0.5) + 0.5;
+  terms.day = g.day;
+  terms.month = g.month;
+  terms.year = g.year;
+  terms.obliquityRad = ObliquityRad(g);
+  terms.nutationLongitudeDeg = NutatLong(g.day, g.month, g.year);
+  terms.sunEccentricity = SunEccentricity(g.day, g.month, g.year);
+  terms.siderealTimeAtMidnightHours =
+      UniversalTimeToGreenwichSiderealTime(0, 0, 0, g.day, g.month, g.year);
+
+  return terms;
+}
+
+/**
+ * \brief Position, distance and angular diameter of the Sun.
+ *
+ * Matches PASun::PrecisePositionOfSun and PASun::SunDistanceAndAngularSize.
+ */
+SunPosition Sun(double julianDate) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+
+  return SunAt(g, ObliquityRad(g), SunEccentricity(g.day, g.month, g.year));
+}
+
+/**
+ * \brief Sun(), with the terms of its Greenwich date already worked out.
+ */
+SunPosition Sun(double julianDate, const DateTerms &terms) {
+  return SunAt(GreenwichDateTime(julianDate, terms), terms.obliquityRad,
+               terms.sunEccentricity);
+}
+
+/**
+ * \brief Position, distance, angular diameter and horizontal parallax of the
+ * Moon.
+ *
+ * The lunar series is evaluated once. Matches PAMoon::PrecisePositionOfMoon
+ * and PAMoon::MoonDistAngDiamHorParallax.
+ */
+MoonPosition Moon(double julianDate) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+
+  return MoonAt(g, ObliquityRad(g), NutatLong(g.day, g.month, g.year));
+}
+
+/**
+ * \brief Moon(), with the terms of its Greenwich date already worked out.
+ */
+MoonPosition Moon(double julianDate, const DateTerms &terms) {
+  return MoonAt(GreenwichDateTime(julianDate, terms), terms.obliquityRad,
+                terms.nutationLongitudeDeg);
+}
+
+/**
+ * \brief Illuminated fraction of the Moon (precise method) and position angle
+ * of its bright limb.
+ *
+ * Matches PAMoon::MoonPhase with EAccuracyLevel::Precise.
+ */
+MoonPhase Phase(double julianDate) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+  double obliquityRad = ObliquityRad(g);
+
+  CMoonLongLatHP moon =
+      MoonLongLatHP(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year);
+  EquatorialCoordinates sun = EclipticToEquatorialObliq(
+      DegreesToRadians(SunLong(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year)),
+      0, obliquityRad);
+  EquatorialCoordinates moonEquatorial = EclipticToEquatorialObliq(
+      DegreesToRadians(moon.longitudeDegrees),
+      DegreesToRadians(moon.latitudeDegrees), obliquityRad);
+
+  double y = cos(sun.decRad) * sin(sun.raRad - moonEquatorial.raRad);
+  double x = cos(moonEquatorial.decRad) * sin(sun.decRad) -
+             sin(moonEquatorial.decRad) * cos(sun.decRad) *
+                 cos(sun.raRad - moonEquatorial.raRad);
+
+  return {pa_macros::MoonPhase(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year),
+          atan2(y, x)};
+}
+
+/**
+ * \brief Julian date of the new moon in the lunation containing the
+ * Greenwich date of an instant, as found by PAMoon.
+ */
+double NewMoon(double julianDate) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+
+  return pa_macros::NewMoon(0, 0, g.day, g.month, g.year);
+}
+
+/**
+ * \brief Julian date of the full moon in the lunation containing the
+ * Greenwich date of an instant, as found by PAMoon.
+ */
+double FullMoon(double julianDate) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+
+  return pa_macros::FullMoon(0, 0, g.day, g.month, g.year);
+}
+
+/**
+ * \brief Position of a planet, with its distances from the Earth and Sun.
+ *
+ * Matches PAPlanet::PrecisePositionOfPlanet. Every field is zero for an
+ * unknown planet.
+ */
+PlanetPosition Planet(double julianDate, const std::string &planetName) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+
+  CPlanetCoordinates coordinates = PlanetCoordinates(
+      g.utHours, 0, 0, 0, 0, g.day, g.month, g.year, planetName);
+  if (coordinates.planetDistanceAU == 0)
+    return {0, 0, 0, 0, 0, 0};
+
+  return PlanetFromCoordinates(coordinates, ObliquityRad(g));
+}
+
+/**
+ * \brief Planet(), with the terms of its Greenwich date already worked out.
+ */
+PlanetPosition Planet(double julianDate, const std::string &planetName,
+                      const DateTerms &terms) {
+  CGreenwichDateTime g = GreenwichDateTime(julianDate, terms);
+
+  CPlanetCoordinates coordinates = PlanetCoordinates(
+      g.utHours, 0, 0, 0, 0, g.day, g.month, g.year, planetName);
+  if (coordinates.planetDistanceAU == 0)
+    return {0, 0, 0, 0, 0, 0};
+
+  return PlanetFromCoordinates(coordinates, terms.obliquityRad);
+}
+
+/**
+ * \brief Positions of all seven planets (Mercury to Neptune, in that order).
+ *
+ * The orbital elements and the Sun's position are evaluated once, as in
+ * PAPlanet::PrecisePositionOfAllPlanets.
+ */
+std::vector<PlanetPosition> AllPlanets(double julianDate) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+  double obliquityRad = ObliquityRad(g);
+
+  std::vector<PlanetPosition> positions;
+  for (const CPlanetCoordinates &coordinates : AllPlanetCoordinates(
+           g.utHours, 0, 0, 0, 0, g.day, g.month, g.year))
+    positions.push_back(PlanetFromCoordinates(coordinates, obliquityRad));
+
+  return positions;
+}
+
+/**
+ * \brief Position of a comet on an elliptical orbit, from pa_data.
+ *
+ * Matches PAComet::PositionOfEllipticalComet.
+ */
+CometPosition EllipticalComet(double julianDate, const std::string &cometName) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+
+  return CometFromLongLatDist(
+      ECometLongLatDist(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year,
+                        pa_data::ellipticalCometLookup(cometName)),
+      ObliquityRad(g));
+}
+
+/**
+ * \brief Position of a comet on a parabolic orbit, from pa_data.
+ *
+ * Matches PAComet::PositionOfParabolicComet.
+ */
+CometPosition ParabolicComet(double julianDate, const std::string &cometName) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+  pa_data::CometDataParabolic comet = pa_data::parabolicCometLookup(cometName);
+
+  return CometFromLongLatDist(
+      PCometLongLatDist(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year,
+                        comet.epoch_peri_day, comet.epoch_peri_month,
+                        comet.epoch_peri_year, comet.peri_dist, comet.incl,
+                        comet.arg_peri, comet.node),
+      ObliquityRad(g));
+}
+
+/**
+ * \brief Greenwich sidereal time, in decimal hours.
+ */
+double GreenwichSiderealTime(double julianDate) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+
+  return UniversalTimeToGreenwichSiderealTime(g.utHours, 0, 0, g.day, g.month,
+                                              g.year);
+}
+
+/**
+ * \brief GreenwichSiderealTime(), advanced from the sidereal time at 0h UT
+ * on its Greenwich date.
+ */
+double GreenwichSiderealTime(double julianDate, const DateTerms &terms) {
+  double h = terms.siderealTimeAtMidnightHours +
+             (julianDate - terms.midnightJulianDate) * 24 * 1.002737909;
+
+  return h - (24 * floor(h / 24));
+}
+
+/**
+ * \brief Local sidereal time, in decimal hours.
+ *
+ * @param geogLongitudeRad Geographical longitude (east positive), radians.
+ */
+double LocalSiderealTime(double julianDate, double geogLongitudeRad) {
+  double lstHours = GreenwichSiderealTime(julianDate) +
+                    RadiansToDegrees(geogLongitudeRad) / 15.0;
+
+  return lstHours - 24 * floor(lstHours / 24);
+}
+
+/**
+ * \brief Obliquity of the ecliptic, with nutation, in radians.
+ */
+double Obliquity(double julianDate) {
+  return ObliquityRad(JulianDateToGreenwichDateTime(julianDate));
+}
+
+/**
+ * \brief Convert ecliptic coordinates to equatorial, for the obliquity on the
+ * Greenwich date of an instant.
+ */
+EquatorialCoordinates EclipticToEquatorial(double longitudeRad,
+                                           double latitudeRad,
+                                           double julianDate) {
+  return EclipticToEquatorialObliq(longitudeRad, latitudeRad,
+                                   Obliquity(julianDate));
+}
+
+/**
+ * \brief Convert equatorial coordinates to ecliptic, for the obliquity on the
+ * Greenwich date of an instant.
+ */
+EclipticCoordinates EquatorialToEcliptic(double raRad, double decRad,
+                                         double julianDate) {
+  double obliquityRad = Obliquity(julianDate);
+
+  double longitudeRad =
+      atan2(sin(raRad) * cos(obliquityRad) + tan(decRad) * sin(obliquityRad),
+            cos(raRad));
+  double latitudeRad = asin(sin(decRad) * cos(obliquityRad) -
+                            cos(decRad) * sin(obliquityRad) * sin(raRad));
+
+  return {longitudeRad - 2 * M_PI * floor(longitudeRad / (2 * M_PI)),
+          latitudeRad};
+}
+
+/**
+ * \brief Convert equatorial coordinates to horizon coordinates.
+ *
+ * Azimuth is measured from the north, through the east.
+ */
+HorizonCoordinates EquatorialToHorizon(double hourAngleRad, double decRad,
+                                       double geogLatitudeRad) {
+  double sinAltitude = sin(decRad) * sin(geogLatitudeRad) +
+                       cos(decRad) * cos(geogLatitudeRad) * cos(hourAngleRad);
+  double azimuthRad =
+      atan2(-cos(decRad) * cos(geogLatitudeRad) * sin(hourAngleRad),
+            sin(decRad) - sin(geogLatitudeRad) * sinAltitude);
+
+  return {azimuthRad - 2 * M_PI * floor(azimuthRad / (2 * M_PI)),
+          asin(sinAltitude)};
+}
+
+/**
+ * \brief Circumstances of the lunar eclipse at the full moon of the lunation
+ * containing the Greenwich date of an instant.
+ *
+ * Matches PAEclipses::LunarEclipseCircumstances.
+ */
+LunarEclipse LunarEclipseCircumstances(double julianDate) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+
+  double fullMoonJulianDate = pa_macros::FullMoon(0, 0, g.day, g.month, g.year);
+  double dayJulianDate = floor(fullMoonJulianDate - 0.5) + 0.5;
+
+  double utMaximum = UTMaxLunarEclipse(g.day, g.month, g.year, 0, 0);
+  auto at = [&](double utHours) {
+    return EclipseJulianDate(dayJulianDate, utHours, utMaximum);
+  };
+
+  return {
+      pa_macros::LunarEclipseOccurrence(0, 0, g.day, g.month, g.year),
+      at(UTFirstContactLunarEclipse(g.day, g.month, g.year, 0, 0)),
+      at(UTStartUmbraLunarEclipse(g.day, g.month, g.year, 0, 0)),
+      at(UTStartTotalLunarEclipse(g.day, g.month, g.year, 0, 0)),
+      at(utMaximum),
+      at(UTEndTotalLunarEclipse(g.day, g.month, g.year, 0, 0)),
+      at(UTEndUmbraLunarEclipse(g.day, g.month, g.year, 0, 0)),
+      at(UTLastContactLunarEclipse(g.day, g.month, g.year, 0, 0)),
+      MagLunarEclipse(g.day, g.month, g.year, 0, 0)};
+}
+
+/**
+ * \brief Circumstances, seen from one place, of the solar eclipse at the new
+ * moon of the lunation containing the Greenwich date of an instant.
+ *
+ * Matches PAEclipses::SolarEclipseCircumstances.
+ *
+ * @param geogLongitudeRad Geographical longitude (east positive), radians.
+ * @param geogLatitudeRad Geographical latitude, radians.
+ */
+SolarEclipse SolarEclipseCircumstances(double julianDate,
+                                       double geogLongitudeRad,
+                                       double geogLatitudeRad) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+  double longitudeDeg = RadiansToDegrees(geogLongitudeRad);
+  double latitudeDeg = RadiansToDegrees(geogLatitudeRad);
+
+  double newMoonJulianDate = pa_macros::NewMoon(0, 0, g.day, g.month, g.year);
+  double dayJulianDate = floor(newMoonJulianDate - 0.5) + 0.5;
+
+  double utMaximum = UTMaxSolarEclipse(g.day, g.month, g.year, 0, 0,
+                                       longitudeDeg, latitudeDeg);
+  auto at = [&](double utHours) {
+    return EclipseJulianDate(dayJulianDate, utHours, utMaximum);
+  };
+
+  return {pa_macros::SolarEclipseOccurrence(0, 0, g.day, g.month, g.year),
+          at(UTFirstContactSolarEclipse(g.day, g.month, g.year, 0, 0,
+                                        longitudeDeg, latitudeDeg)),
+          at(utMaximum),
+          at(UTLastContactSolarEclipse(g.day, g.month, g.year, 0, 0,
+                                       longitudeDeg, latitudeDeg)),
+          MagSolarEclipse(g.day, g.month, g.year, 0, 0, longitudeDeg,
+                          latitudeDeg)};
+}
+
+} // namespace pa_raw
@@ -0,0 +1,172 @@
+#ifndef _pa_raw
+#define _pa_raw
+
+#include "pa_types.h"
+#include <string>
+#include <vector>
+
+using namespace pa_types;
+
+/**
+ * \brief Decimal API, for programs rather than people.
+ *
+ * Each function takes an instant as a Julian date (UT) and returns plain
+ * structs: angles in radians, times as Julian dates or decimal hours, and
+ * distances in km or AU. Nothing is split into hours/minutes/seconds or
+ * rounded. Results come from the same calculations as the façade classes
+ * (PASun, PAMoon, PAPlanet, PAComet, PACoordinates, PAEclipses).
+ */
+namespace pa_raw {
+
+struct SunPosition {
+  double eclipticLongitudeRad;
+  double raRad;
+  double decRad;
+  double distanceKm;
+  double angularDiameterRad;
+};
+
+struct MoonPosition {
+  double eclipticLongitudeRad; /**< Not corrected for nutation. */
+  double eclipticLatitudeRad;
+  double raRad; /**< Corrected for nutation, as in PrecisePositionOfMoon. */
+  double decRad;
+  double distanceKm;
+  double angularDiameterRad;
+  double horizontalParallaxRad;
+};
+
+struct MoonPhase {
+  double illuminatedFraction;
+  double brightLimbPositionAngleRad;
+};
+
+struct PlanetPosition {
+  double eclipticLongitudeRad;
+  double eclipticLatitudeRad;
+  double raRad;
+  double decRad;
+  double distanceAU;
+  double sunDistanceAU;
+};
+
+struct CometPosition {
+  double eclipticLongitudeRad;
+  double eclipticLatitudeRad;
+  double raRad;
+  double decRad;
+  double distanceAU;
+};
+
+struct EquatorialCoordinates {
+  double raRad;
+  double decRad;
+};
+
+struct EclipticCoordinates {
+  double longitudeRad;
+  double latitudeRad;
+};
+
+struct HorizonCoordinates {
+  double azimuthRad;
+  double altitudeRad;
+};
+
+/**
+ * Times are Julian dates (UT), or -99 for a phase that does not happen.
+ */
+struct LunarEclipse {
+  ELunarEclipseStatus status;
+  double firstContactJulianDate;
+  double startUmbralJulianDate;
+  double startTotalJulianDate;
+  double maximumJulianDate;
+  double endTotalJulianDate;
+  double endUmbralJulianDate;
+  double lastContactJulianDate;
+  double magnitude;
+};
+
+/**
+ * Times are Julian dates (UT), or -99 if the eclipse is not seen.
+ */
+struct SolarEclipse {
+  ESolarEclipseStatus status;
+  double firstContactJulianDate;
+  double maximumJulianDate;
+  double lastContactJulianDate;
+  double magnitude;
+};
+
+/**
+ * \brief Terms that depend only on the Greenwich date of an instant, and so
+ * can be shared by every instant on that date.
+ *
+ * Sun(), Moon(), Planet() and GreenwichSiderealTime() given the terms of an
+ * instant's date return just what they do without them.
+ */
+struct DateTerms {
+  double midnightJulianDate; /**< 0h UT on the Greenwich date */
+  double day;
+  int month;
+  int year;
+  double obliquityRad;
+  double nutationLongitudeDeg;
+  double sunEccentricity;
+  double siderealTimeAtMidnightHours;
+};
+
+DateTerms DateTermsOf(double julianDate);
+
+SunPosition Sun(double julianDate);
+
+SunPosition Sun(double julianDate, const DateTerms &terms);
+
+MoonPosition Moon(double julianDate);
+
+MoonPosition Moon(double julianDate, const DateTerms &terms);
+
+MoonPhase Phase(double julianDate);
+
+double NewMoon(double julianDate);
+
+double FullMoon(double julianDate);
+
+PlanetPosition Planet(double julianDate, const std::string &planetName);
+
+PlanetPosition Planet(double julianDate, const std::string &planetName,
+                      const DateTerms &terms);
+
+std::vector<PlanetPosition> AllPlanets(double julianDate);
+
+CometPosition EllipticalComet(double julianDate, const std::string &cometName);
+
+CometPosition ParabolicComet(double julianDate, const std::string &cometName);
+
+double GreenwichSiderealTime(double julianDate);
+
+double GreenwichSiderealTime(double julianDate, const DateTerms &terms);
+
+double LocalSiderealTime(double julianDate, double geogLongitudeRad);
+
+double Obliquity(double julianDate);
+
+EquatorialCoordinates EclipticToEquatorial(double longitudeRad,
+                                           double latitudeRad,
+                                           double julianDate);
+
+EclipticCoordinates EquatorialToEcliptic(double raRad, double decRad,
+                                         double julianDate);
+
+HorizonCoordinates EquatorialToHorizon(double hourAngleRad, double decRad,
+                                       double geogLatitudeRad);
+
+LunarEclipse LunarEclipseCircumstances(double julianDate);
+
+SolarEclipse SolarEclipseCircumstances(double julianDate,
+                                       double geogLongitudeRad,
+                                       double geogLatitudeRad);
+
+} // namespace pa_raw
+#endif
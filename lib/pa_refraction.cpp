@@ -0,0 +1,239 @@
+#include "pa_refraction.h"
+#include "pa_macros.h"
+#include "pa_types.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace pa_types;
+using namespace pa_macros;
+
+namespace {
+/** Altitude (radians) below which Refract stops correcting. */
+const double kRefractLimitRad = -0.087;
+
+/** Apparent altitude (radians) where RefractL3035 switches formula. */
+const double kRefractSeamRad = 0.2617994;
+
+/** Offset used to sample each side of a segment end, in degrees. */
+const double kEdgeNudgeDeg = 0.000001;
+
+/** Finest grid spacing, in degrees; finer requests are raised to it. */
+const double kMinStepDeg = 0.0001;
+
+/**
+ * \brief Correction (corrected minus input altitude) from the direct formula.
+ */
+double DirectCorrection(double altitudeDeg, ECoordinateType coordinateType,
+                        double pressureMbar, double temperatureCelsius) {
+  return Refract(altitudeDeg, coordinateType, pressureMbar,
+                 temperatureCelsius) -
+         altitudeDeg;
+}
+
+/**
+ * \brief Fill a segment of the grid, from one end towards the other.
+ *
+ * The first and last nodes are sampled just inside the segment, so they pick
+ * up the formula branch that belongs to the segment.
+ */
+double FillSegment(std::vector<double> &corrections, double fromDeg,
+                   double toDeg, double requestedStepDeg,
+                   ECoordinateType coordinateType, double pressureMbar,
+                   double temperatureCelsius) {
+  double spanDeg = std::abs(toDeg - fromDeg);
+  int cells = std::max(3, (int)ceil(spanDeg / requestedStepDeg));
+  double stepDeg = spanDeg / cells;
+  double direction = (toDeg > fromDeg) ? 1.0 : -1.0;
+
+  corrections.resize(cells + 1);
+  for (int k = 0; k <= cells; k++) {
+    double altitudeDeg = fromDeg + direction * k * stepDeg;
+
+    if (k == 0)
+      altitudeDeg += direction * kEdgeNudgeDeg;
+    if (k == cells)
+      altitudeDeg -= direction * kEdgeNudgeDeg;
+
+    corrections[k] = DirectCorrection(altitudeDeg, coordinateType,
+                                      pressureMbar, temperatureCelsius);
+  }
+
+  return stepDeg;
+}
+
+/**
+ * \brief Interpolate a correction from one segment of the grid.
+ *
+ * Four-point (cubic) Lagrange interpolation; the stencil is shifted inwards
+ * in the end cells so it never leaves the segment.
+ */
+inline double InterpolateSegment(const std::vector<double> &corrections,
+                                 double offsetDeg, double stepDeg) {
+  double x = offsetDeg / stepDeg;
+  std::size_t last = corrections.size() - 4;
+  std::size_t k = (x > 1) ? std::min((std::size_t)x - 1, last) : 0;
+  double t = x - k;
+
+  double c0 = corrections[k];
+  double c1 = corrections[k + 1];
+  double c2 = corrections[k + 2];
+  double c3 = corrections[k + 3];
+
+  return -c0 * (t - 1) * (t - 2) * (t - 3) / 6 +
+         c1 * t * (t - 2) * (t - 3) / 2 - c2 * t * (t - 1) * (t - 3) / 2 +
+         c3 * t * (t - 1) * (t - 2) / 6;
+}
+} // namespace
+
+/**
+ * \brief Build a refraction table for one pressure and temperature.
+ *
+ * @param atmosphericPressureMbar Atmospheric pressure, in millibars.
+ * @param atmosphericTemperatureCelsius Atmospheric temperature, in Celsius.
+ * @param coordinateType Actual to correct true altitudes to apparent ones,
+ * Apparent for the reverse (as in pa_macros::Refract).
+ * @param altitudeStepDeg Requested spacing of the altitude grid, in degrees.
+ * Steps finer than 0.0001 degrees are raised to it.
+ *
+ * @throws std::invalid_argument if altitudeStepDeg is not positive.
+ */
+PARefractionTable::PARefractionTable(double atmosphericPressureMbar,
+                                     double atmosphericTemperatureCelsius,
+                                     ECoordinateType coordinateType,
+                                     double altitudeStepDeg) {
+  if (!(altitudeStepDeg > 0))
+    throw std::invalid_argument(
+        "PARefractionTable: altitudeStepDeg must be positive");
+  altitudeStepDeg = std::max(altitudeStepDeg, kMinStepDeg);
+
+  this->pressureMbar = atmosphericPressureMbar;
+  this->temperatureCelsius = atmosphericTemperatureCelsius;
+  this->coordinateType = coordinateType;
+  this->minAltitudeDeg = WToDegrees(kRefractLimitRad);
+
+  // For true altitudes the seam moves to the true altitude whose refracted
+  // altitude first reaches the apparent-altitude seam.
+  double apparentSeamDeg = WToDegrees(kRefractSeamRad);
+  double seamDeg = apparentSeamDeg;
+  if (coordinateType == ECoordinateType::Actual) {
+    double belowDeg = apparentSeamDeg - 1.0;
+    double aboveDeg = apparentSeamDeg;
+
+    for (int i = 0; i < 40; i++) {
+      double midDeg = (belowDeg + aboveDeg) / 2;
+
+      if (Refract(midDeg, coordinateType, pressureMbar, temperatureCelsius) <
+          apparentSeamDeg)
+        belowDeg = midDeg;
+      else
+        aboveDeg = midDeg;
+    }
+    seamDeg = aboveDeg;
+  }
+  this->seamDeg = seamDeg;
+
+  double lowerStepDeg =
+      FillSegment(lowerCorrectionDeg, seamDeg, minAltitudeDeg, altitudeStepDeg,
+                  coordinateType, pressureMbar, temperatureCelsius);
+  double upperStepDeg =
+      FillSegment(upperCorrectionDeg, seamDeg, 90.0, altitudeStepDeg,
+                  coordinateType, pressureMbar, temperatureCelsius);
+  this->lowerStepDeg = lowerStepDeg;
+  this->upperStepDeg = upperStepDeg;
+
+  // Measure the interpolation error inside every cell.
+  double maxErrorDeg = 0.0;
+  for (int segment = 0; segment < 2; segment++) {
+    const std::vector<double> &corrections =
+        (segment == 0) ? lowerCorrectionDeg : upperCorrectionDeg;
+    double stepDeg = (segment == 0) ? -lowerStepDeg : upperStepDeg;
+
+    for (std::size_t k = 0; k + 1 < corrections.size(); k++) {
+      for (int q = 1; q < 4; q++) {
+        double altitudeDeg = seamDeg + (k + q / 4.0) * stepDeg;
+        double errorDeg =
+            std::abs(CorrectedAltitude(altitudeDeg) -
+                     Refract(altitudeDeg, coordinateType, pressureMbar,
+                             temperatureCelsius));
+
+        maxErrorDeg = std::max(maxErrorDeg, errorDeg);
+      }
+    }
+  }
+  this->maxErrorDeg = maxErrorDeg;
+}
+
+/**
+ * \brief Corrected altitude for a single object.
+ *
+ * Matches pa_macros::Refract: altitudes below -0.087 radians are returned as
+ * 0.
+ *
+ * @param altitudeDeg Altitude to correct, in degrees.
+ *
+ * @return Corrected altitude, in degrees.
+ */
+double PARefractionTable::CorrectedAltitude(double altitudeDeg) const {
+  if (altitudeDeg < minAltitudeDeg)
+    return 0;
+
+  double correctionDeg =
+      (altitudeDeg < seamDeg)
+          ? InterpolateSegment(lowerCorrectionDeg, seamDeg - altitudeDeg,
+                               lowerStepDeg)
+          : InterpolateSegment(upperCorrectionDeg, altitudeDeg - seamDeg,
+                               upperStepDeg);
+
+  return altitudeDeg + correctionDeg;
+}
+
+/**
+ * \brief Corrected altitudes for a batch of objects.
+ *
+ * @param altitudesDeg Altitudes to correct, in degrees.
+ * @param correctedAltitudesDeg Receives the corrected altitudes (may alias
+ * altitudesDeg).
+ * @param count Number of altitudes.
+ */
+void PARefractionTable::Apply(const double *altitudesDeg,
+                              double *correctedAltitudesDeg,
+                              std::size_t count) const {
+  for (std::size_t i = 0; i < count; i++)
+    correctedAltitudesDeg[i] = CorrectedAltitude(altitudesDeg[i]);
+}
+
+/**
+ * \brief Corrected altitudes for a batch of objects.
+ *
+ * @return Corrected altitudes, in degrees, in input order.
+ */
+std::vector<double>
+PARefractionTable::Apply(const std::vector<double> &altitudesDeg) const {
+  std::vector<double> correctedAltitudesDeg(altitudesDeg.size());
+
+  Apply(altitudesDeg.data(), correctedAltitudesDeg.data(),
+        altitudesDeg.size());
+
+  return correctedAltitudesDeg;
+}
+
+/**
+ * \brief Largest difference from pa_macros::Refract found in the table.
+ *
+ * Sampled at the quarter points of every cell when the table is built.
+ *
+ * @return Error bound, in degrees.
+ */
+double PARefractionTable::MaxErrorDeg() const { return maxErrorDeg; }
+
+double PARefractionTable::PressureMbar() const { return pressureMbar; }
+
+double PARefractionTable::TemperatureCelsius() const {
+  return temperatureCelsius;
+}
+
+ECoordinateType PARefractionTable::CoordinateType() const {
+  return coordinateType;
+}
@@ -0,0 +1,80 @@
+#ifndef _pa_refraction
+#define _pa_refraction
+
+#include "pa_types.h"
+#include <cstddef>
+#include <vector>
+
+using namespace pa_types;
+
+/**
+ * \brief Atmospheric refraction lookup table.
+ *
+ * Tabulates the correction produced by pa_macros::Refract for one set of
+ * atmospheric conditions, and interpolates it by altitude with a four-point
+ * (cubic) stencil.
+ *
+ * The grid is split at the seam between the two branches of the direct
+ * formula, so the interpolation never straddles the step in the formula. With
+ * the default 0.05 degree step, the difference from pa_macros::Refract is
+ * below 0.01 arcsec for apparent-to-true corrections, and below 0.2 arcsec for
+ * true-to-apparent corrections above -4 degrees. Within the last degree above
+ * the -0.087 radian cut-off, where the true-to-apparent iteration steepens, it
+ * can reach ~12 arcsec in cold, dense air. The bound measured for a particular
+ * table is available from MaxErrorDeg().
+ */
+class PARefractionTable {
+public:
+  PARefractionTable(double atmosphericPressureMbar,
+                    double atmosphericTemperatureCelsius,
+                    ECoordinateType coordinateType,
+                    double altitudeStepDeg = 0.05);
+
+  double CorrectedAltitude(double altitudeDeg) const;
+
+  void Apply(const double *altitudesDeg, double *correctedAltitudesDeg,
+             std::size_t count) const;
+
+  std::vector<double> Apply(const std::vector<double> &altitudesDeg) const;
+
+  double MaxErrorDeg() const;
+
+  double PressureMbar() const;
+
+  double TemperatureCelsius() const;
+
+  ECoordinateType CoordinateType() const;
+
+private:
+  /** Atmospheric pressure the table was built for, in millibars. */
+  double pressureMbar;
+
+  /** Atmospheric temperature the table was built for, in Celsius. */
+  double temperatureCelsius;
+
+  /** Direction of the correction (true to apparent, or the reverse). */
+  ECoordinateType coordinateType;
+
+  /** Spacing of the grid below the seam, in degrees. */
+  double lowerStepDeg;
+
+  /** Spacing of the grid above the seam, in degrees. */
+  double upperStepDeg;
+
+  /** Lowest altitude for which a correction is applied, in degrees. */
+  double minAltitudeDeg;
+
+  /** Altitude of the branch seam, in degrees. */
+  double seamDeg;
+
+  /** Corrections below the seam, at seamDeg - k * lowerStepDeg. */
+  std::vector<double> lowerCorrectionDeg;
+
+  /** Corrections above the seam, at seamDeg + k * upperStepDeg. */
+  std::vector<double> upperCorrectionDeg;
+
+  /** Largest difference from the direct formula found when building. */
+  double maxErrorDeg;
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include "pa_sun.h"
 #include "pa_macros.h"
 #include "pa_models.h"
+#include "pa_trace.h"
 #include "pa_types.h"
 #include "pa_util.h"
 #include <cmath>
@@ -18,6 +19,8 @@ using namespace pa_models;
 CApproximatePositionOfSun PASun::ApproximatePositionOfSun(
     double lctHours, double lctMinutes, double lctSeconds, double localDay,
     int localMonth, int localYear, bool isDaylightSaving, int zoneCorrection) {
+  PA_TRACE_SPAN("PASun::ApproximatePositionOfSun");
+
   int daylightSaving = (isDaylightSaving == true) ? 1 : 0;
 
   double greenwichDateDay = LocalCivilTimeGreenwichDay(
@@ -69,6 +72,8 @@ CApproximatePositionOfSun PASun::ApproximatePositionOfSun(
 CPrecisePositionOfSun PASun::PrecisePositionOfSun(
     double lctHours, double lctMinutes, double lctSeconds, double localDay,
     int localMonth, int localYear, bool isDaylightSaving, int zoneCorrection) {
+  PA_TRACE_SPAN("PASun::PrecisePositionOfSun");
+
   int daylightSaving = (isDaylightSaving == true) ? 1 : 0;
 
   double gDay = LocalCivilTimeGreenwichDay(lctHours, lctMinutes, lctSeconds,
@@ -108,6 +113,8 @@ CPrecisePositionOfSun PASun::PrecisePositionOfSun(
 CSunDistanceAngularSize PASun::SunDistanceAndAngularSize(
     double lctHours, double lctMinutes, double lctSeconds, double localDay,
     int localMonth, int localYear, bool isDaylightSaving, int zoneCorrection) {
+  PA_TRACE_SPAN("PASun::SunDistanceAndAngularSize");
+
   int daylightSaving = (isDaylightSaving) ? 1 : 0;
 
   double gDay = LocalCivilTimeGreenwichDay(lctHours, lctMinutes, lctSeconds,
@@ -148,6 +155,8 @@ CSunriseAndSunset PASun::SunriseAndSunset(double localDay, int localMonth,
                                           int zoneCorrection,
                                           double geographicalLongDeg,
                                           double geographicalLatDeg) {
+  PA_TRACE_SPAN("PASun::SunriseAndSunset");
+
   int daylightSaving = (isDaylightSaving) ? 1 : 0;
 
   double localSunriseHours = SunriseLocalCivilTime(
@@ -208,6 +217,8 @@ CMorningAndEveningTwilight PASun::MorningAndEveningTwilight(
     double localDay, int localMonth, int localYear, bool isDaylightSaving,
     int zoneCorrection, double geographicalLongDeg, double geographicalLatDeg,
     ETwilightType twilightType) {
+  PA_TRACE_SPAN("PASun::MorningAndEveningTwilight");
+
   int daylightSaving = (isDaylightSaving) ? 1 : 0;
 
   double startOfAMTwilightHours = TwilightAMLocalCivilTime(
@@ -256,6 +267,8 @@ CMorningAndEveningTwilight PASun::MorningAndEveningTwilight(
  */
 CEquationOfTime PASun::EquationOfTime(double gwdateDay, int gwdateMonth,
                                       int gwdateYear) {
+  PA_TRACE_SPAN("PASun::EquationOfTime");
+
   double sunLongitudeDeg =
       SunLong(12, 0, 0, 0, 0, gwdateDay, gwdateMonth, gwdateYear);
   double sunRAHours = DecimalDegreesToDegreeHours(EclipticRightAscension(
@@ -282,6 +295,8 @@ double PASun::SolarElongation(double raHour, double raMin, double raSec,
                               double decDeg, double decMin, double decSec,
                               double gwdateDay, int gwdateMonth,
                               int gwdateYear) {
+  PA_TRACE_SPAN("PASun::SolarElongation");
+
   double sunLongitudeDeg =
       SunLong(0, 0, 0, 0, 0, gwdateDay, gwdateMonth, gwdateYear);
   double sunRAHours = DecimalDegreesToDegreeHours(EclipticRightAscension(
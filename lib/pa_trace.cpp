@@ -0,0 +1,185 @@
+#include "pa_trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+namespace pa_trace {
+namespace {
+/**
+ * One finished span. Times are in nanoseconds from Start().
+ */
+struct Event {
+  const char *name;
+  std::int64_t startNs;
+  std::int64_t durationNs;
+  int threadId;
+};
+
+struct ThreadBuffer;
+
+/**
+ * Buffers of the live threads, and the events of threads that have exited.
+ * Never destroyed, so threads may exit during static destruction.
+ */
+struct Registry {
+  std::mutex mutex;
+  std::vector<ThreadBuffer *> buffers;
+  std::vector<Event> retired;
+  int nextThreadId = 1;
+  std::string path;
+};
+
+Registry &GlobalRegistry() {
+  static Registry *registry = new Registry();
+
+  return *registry;
+}
+
+std::atomic<bool> isActive(false);
+
+/** Start() time, in steady_clock nanoseconds. */
+std::atomic<std::int64_t> epochNs(0);
+
+std::int64_t SteadyNs(std::chrono::steady_clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+/**
+ * Events of one thread. Only Stop() and Start() take the lock from other
+ * threads, so it is almost never contended.
+ */
+struct ThreadBuffer {
+  std::mutex mutex;
+  std::vector<Event> events;
+  int threadId;
+
+  ThreadBuffer() {
+    Registry &registry = GlobalRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    threadId = registry.nextThreadId++;
+    registry.buffers.push_back(this);
+  }
+
+  ~ThreadBuffer() {
+    Registry &registry = GlobalRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.retired.insert(registry.retired.end(), events.begin(),
+                            events.end());
+    registry.buffers.erase(
+        std::find(registry.buffers.begin(), registry.buffers.end(), this));
+  }
+};
+
+ThreadBuffer &ThisThreadBuffer() {
+  thread_local ThreadBuffer buffer;
+
+  return buffer;
+}
+
+void WriteEvent(std::ofstream &file, const Event &event, bool &isFirst) {
+  file << (isFirst ? "\n" : ",\n") << "{\"name\": \"" << event.name
+       << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.threadId
+       << ", \"ts\": " << event.startNs / 1000.0
+       << ", \"dur\": " << event.durationNs / 1000.0 << "}";
+  isFirst = false;
+}
+} // namespace
+
+/**
+ * \brief Whether the library was built with PA_TRACE.
+ */
+bool IsEnabled() {
+#ifdef PA_TRACE
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * \brief Start recording spans, to be written to path by Stop(). Spans from
+ * an earlier session are discarded.
+ *
+ * @return false if path cannot be written.
+ */
+bool Start(const std::string &path) {
+  Registry &registry = GlobalRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  if (!std::ofstream(path, std::ios::trunc))
+    return false;
+
+  registry.path = path;
+  registry.retired.clear();
+  for (ThreadBuffer *buffer : registry.buffers) {
+    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+    buffer->events.clear();
+  }
+
+  epochNs.store(SteadyNs(std::chrono::steady_clock::now()));
+  isActive.store(true);
+
+  return true;
+}
+
+/**
+ * \brief Stop recording, and write every span recorded since Start() as a
+ * trace-event JSON object. Spans still open on other threads are not
+ * included.
+ *
+ * @return false if tracing was not active or the file cannot be written.
+ */
+bool Stop() {
+  if (!isActive.exchange(false))
+    return false;
+
+  Registry &registry = GlobalRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::ofstream file(registry.path, std::ios::trunc);
+  bool isFirst = true;
+
+  file << std::fixed << std::setprecision(3) << "{\"traceEvents\": [";
+  for (const Event &event : registry.retired)
+    WriteEvent(file, event, isFirst);
+  registry.retired.clear();
+
+  for (ThreadBuffer *buffer : registry.buffers) {
+    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+    for (const Event &event : buffer->events)
+      WriteEvent(file, event, isFirst);
+    buffer->events.clear();
+  }
+  file << "\n], \"displayTimeUnit\": \"ns\"}\n";
+
+  return static_cast<bool>(file);
+}
+
+/**
+ * \brief Whether spans are being recorded.
+ */
+bool IsActive() { return isActive.load(std::memory_order_relaxed); }
+
+ScopedSpan::ScopedSpan(const char *name)
+    : name(IsActive() ? name : nullptr),
+      start(this->name ? std::chrono::steady_clock::now()
+                       : std::chrono::steady_clock::time_point()) {}
+
+ScopedSpan::~ScopedSpan() {
+  if (name == nullptr)
+    return;
+
+  std::int64_t startNs = SteadyNs(start);
+  std::int64_t endNs = SteadyNs(std::chrono::steady_clock::now());
+  ThreadBuffer &buffer = ThisThreadBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+
+  buffer.events.push_back({name, startNs - epochNs.load(), endNs - startNs,
+                           buffer.threadId});
+}
+} // namespace pa_trace
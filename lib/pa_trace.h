@@ -0,0 +1,50 @@
+#ifndef _pa_trace
+#define _pa_trace
+
+#include <chrono>
+#include <string>
+
+/**
+ * \brief Timeline of nested calls, written as Chrome trace-event JSON.
+ *
+ * Spans are compiled in only when PA_TRACE is defined (for example
+ * `make test OPT_FLAGS=-DPA_TRACE`); otherwise PA_TRACE_SPAN expands to
+ * nothing. When compiled in, spans are recorded only between Start() and
+ * Stop(). Each thread appends to its own buffer, and Stop() writes them all
+ * to the file, which chrome://tracing and ui.perfetto.dev can open.
+ */
+namespace pa_trace {
+
+bool IsEnabled();
+
+bool Start(const std::string &path);
+
+bool Stop();
+
+bool IsActive();
+
+/**
+ * \brief Records the enclosing scope as one span, if tracing is active.
+ */
+class ScopedSpan {
+public:
+  explicit ScopedSpan(const char *name);
+
+  ~ScopedSpan();
+
+  ScopedSpan(const ScopedSpan &) = delete;
+  ScopedSpan &operator=(const ScopedSpan &) = delete;
+
+private:
+  const char *name; /**< Null when tracing was not active. */
+  std::chrono::steady_clock::time_point start;
+};
+} // namespace pa_trace
+
+#ifdef PA_TRACE
+#define PA_TRACE_SPAN(name) pa_trace::ScopedSpan paTraceSpan(name)
+#else
+#define PA_TRACE_SPAN(name) ((void)0)
+#endif
+
+#endif
@@ -75,9 +75,55 @@ enum class EAngleMeasure {
  */
 enum class EAccuracyLevel { Approximate, Precise };
 
+/**
+ * Planets with perturbations from the outer planet series, in the order of
+ * their elements (Jupiter is planet 4).
+ */
+enum class EOuterPlanet { Jupiter, Saturn, Uranus, Neptune };
+
 enum class ELunarEclipseStatus { Certain, Possible, None };
 
 enum class ESolarEclipseStatus { Certain, Possible, None };
 
+/**
+ * Body whose altitude is constrained in a visibility search.
+ */
+enum class EVisibilityBody {
+  FixedObject, /**< Object with a fixed right ascension and declination. */
+  Sun,         /**< The Sun */
+  Moon,        /**< The Moon (topocentric) */
+  Planet       /**< A planet, by name */
+};
+
+/**
+ * Type of a planetary event found by an event search.
+ */
+enum class EPlanetaryEventType {
+  Conjunction,            /**< Superior planet in conjunction with the Sun */
+  InferiorConjunction,    /**< Inferior planet between the Earth and Sun */
+  SuperiorConjunction,    /**< Inferior planet beyond the Sun */
+  Opposition,             /**< Superior planet opposite the Sun */
+  GreatestElongationEast, /**< Inferior planet furthest east of the Sun */
+  GreatestElongationWest, /**< Inferior planet furthest west of the Sun */
+  StationaryRetrograde,   /**< Planet stops, then moves westward */
+  StationaryDirect        /**< Planet stops, then moves eastward */
+};
+
+/**
+ * Side of an altitude limit required by a visibility constraint.
+ */
+enum class EAltitudeSense {
+  Above, /**< Altitude at or above the limit */
+  Below  /**< Altitude at or below the limit */
+};
+
+/**
+ * Output format of a batch run.
+ */
+enum class EBatchFormat {
+  Jsonl, /**< One JSON object per line */
+  Csv    /**< Comma-separated values, one line per request */
+};
+
 } // namespace pa_types
 #endif
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include "pa_visibility.h"
+#include "pa_events.h"
+#include "pa_macros.h"
+#include "pa_models.h"
+#include "pa_types.h"
+#include "pa_util.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace pa_types;
+using namespace pa_models;
+using namespace pa_util;
+using namespace pa_macros;
+
+namespace {
+/**
+ * \brief Local sidereal time, in radians, as in
+ * UniversalTimeToGreenwichSiderealTime.
+ */
+double LocalSiderealRadians(double julianDate, double geogLongDeg) {
+  double jd0 = floor(julianDate - 0.5) + 0.5;
+  double utHours = (julianDate - jd0) * 24;
+  double t = (jd0 - 2451545) / 36525;
+  double gst0 = 6.697374558 + (2400.051336 * t) + (0.000025862 * t * t);
+  double lstHours = gst0 + utHours * 1.002737909 + geogLongDeg / 15;
+
+  return DegreesToRadians(15 * (lstHours - 24 * floor(lstHours / 24)));
+}
+
+/**
+ * \brief Unit vector (equatorial, of date) and horizontal parallax of a body,
+ * from the full model.
+ */
+void BodyDirection(const CAltitudeConstraint &constraint, double julianDate,
+                   double direction[3], double &horizontalParallaxDeg) {
+  CGreenwichDateTime g = JulianDateToGreenwichDateTime(julianDate);
+  double longDeg = 0;
+  double latDeg = 0;
+
+  horizontalParallaxDeg = 0;
+  switch (constraint.body) {
+  case EVisibilityBody::Sun:
+    longDeg = SunLong(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year);
+    break;
+  case EVisibilityBody::Moon: {
+    CMoonLongLatHP moon =
+        MoonLongLatHP(g.utHours, 0, 0, 0, 0, g.day, g.month, g.year);
+    longDeg = moon.longitudeDegrees + NutatLong(g.day, g.month, g.year);
+    latDeg = moon.latitudeDegrees;
+    horizontalParallaxDeg = moon.horizontalParallax;
+  } break;
+  case EVisibilityBody::Planet: {
+    CPlanetCoordinates planet = PlanetCoordinates(
+        g.utHours, 0, 0, 0, 0, g.day, g.month, g.year, constraint.planetName);
+    longDeg = planet.planetLongitude;
+    latDeg = planet.planetLatitude;
+  } break;
+  case EVisibilityBody::FixedObject:
+    break;
+  }
+
+  double raRad, decRad;
+  if (constraint.body == EVisibilityBody::FixedObject) {
+    raRad = DegreesToRadians(DegreeHoursToDecimalDegrees(constraint.raHours));
+    decRad = DegreesToRadians(constraint.decDeg);
+  } else {
+    raRad = DegreesToRadians(EclipticRightAscension(longDeg, 0, 0, latDeg, 0, 0,
+                                                    g.day, g.month, g.year));
+    decRad = DegreesToRadians(EclipticDeclination(longDeg, 0, 0, latDeg, 0, 0,
+                                                  g.day, g.month, g.year));
+  }
+
+  direction[0] = cos(decRad) * cos(raRad);
+  direction[1] = cos(decRad) * sin(raRad);
+  direction[2] = sin(decRad);
+}
+
+/**
+ * \brief Sampled track of one body, interpolated quadratically between
+ * samples.
+ *
+ * Fixed objects are not sampled; their direction is used directly.
+ */
+class BodyTrack {
+public:
+  BodyTrack(const CAltitudeConstraint &constraint, double startJulianDate,
+            double endJulianDate) {
+    this->sampled = (constraint.body != EVisibilityBody::FixedObject);
+
+    if (!sampled) {
+      BodyDirection(constraint, startJulianDate, fixedDirection, fixedHpDeg);
+      return;
+    }
+
+    stepDays = (constraint.body == EVisibilityBody::Moon) ? 0.125 : 0.5;
+    firstJulianDate = startJulianDate - stepDays;
+    int count = (int)ceil((endJulianDate - startJulianDate) / stepDays) + 3;
+
+    samples.resize(4 * count);
+    for (int k = 0; k < count; k++)
+      BodyDirection(constraint, firstJulianDate + k * stepDays, &samples[4 * k],
+                    samples[4 * k + 3]);
+  }
+
+  void Direction(double julianDate, double direction[3], double &hpDeg) const {
+    if (!sampled) {
+      std::copy(fixedDirection, fixedDirection + 3, direction);
+      hpDeg = fixedHpDeg;
+      return;
+    }
+
+    int last = (int)(samples.size() / 4) - 2;
+    double x = (julianDate - firstJulianDate) / stepDays;
+    int k = std::max(1, std::min(last, (int)floor(x + 0.5)));
+    double t = x - k;
+    double wm = t * (t - 1) / 2;
+    double w0 = 1 - t * t;
+    double wp = t * (t + 1) / 2;
+    const double *sm = &samples[4 * (k - 1)];
+    const double *s0 = &samples[4 * k];
+    const double *sp = &samples[4 * (k + 1)];
+
+    double norm = 0;
+    for (int i = 0; i < 3; i++) {
+      direction[i] = wm * sm[i] + w0 * s0[i] + wp * sp[i];
+      norm += direction[i] * direction[i];
+    }
+    norm = sqrt(norm);
+    for (int i = 0; i < 3; i++)
+      direction[i] /= norm;
+    hpDeg = wm * sm[3] + w0 * s0[3] + wp * sp[3];
+  }
+
+private:
+  bool sampled;
+  double fixedDirection[3];
+  double fixedHpDeg;
+  double stepDays;
+  double firstJulianDate;
+  std::vector<double> samples; /* x, y, z, horizontal parallax per sample */
+};
+
+/**
+ * \brief Signed margin of an altitude constraint: positive where the
+ * constraint is satisfied.
+ */
+class ConstraintMargin {
+public:
+  ConstraintMargin(const CAltitudeConstraint &constraint,
+                   const BodyTrack &track, double geogLongDeg,
+                   double geogLatDeg)
+      : track(track) {
+    this->sign = (constraint.sense == EAltitudeSense::Above) ? 1.0 : -1.0;
+    this->altitudeDeg = constraint.altitudeDeg;
+    this->geogLongDeg = geogLongDeg;
+    this->sinLat = sin(DegreesToRadians(geogLatDeg));
+    this->cosLat = cos(DegreesToRadians(geogLatDeg));
+  }
+
+  double operator()(double julianDate) const {
+    double direction[3];
+    double hpDeg;
+    track.Direction(julianDate, direction, hpDeg);
+
+    double lst = LocalSiderealRadians(julianDate, geogLongDeg);
+    double sinAlt =
+        direction[2] * sinLat +
+        (direction[0] * cos(lst) + direction[1] * sin(lst)) * cosLat;
+    double altDeg = WToDegrees(asin(std::max(-1.0, std::min(1.0, sinAlt))));
+
+    // Geocentric to topocentric altitude (only the Moon has parallax here).
+    altDeg -= hpDeg * cos(DegreesToRadians(altDeg));
+
+    return sign * (altDeg - altitudeDeg);
+  }
+
+private:
+  const BodyTrack &track;
+  double sign;
+  double altitudeDeg;
+  double geogLongDeg;
+  double sinLat;
+  double cosLat;
+};
+} // namespace
+
+/**
+ * \brief Set up a visibility search for a site.
+ *
+ * @param geogLongDeg Geographical longitude of the site, in degrees (east
+ * positive).
+ * @param geogLatDeg Geographical latitude of the site, in degrees.
+ */
+PAVisibility::PAVisibility(double geogLongDeg, double geogLatDeg) {
+  this->geogLongDeg = geogLongDeg;
+  this->geogLatDeg = geogLatDeg;
+  this->searchStepDays = 1.0 / 24.0;
+  this->toleranceDays = 1.0 / 86400.0;
+}
+
+/**
+ * \brief Find the intervals in which one altitude constraint is satisfied.
+ *
+ * The margin from the altitude limit is sampled every searchStepDays. A sign
+ * change between samples is refined to toleranceDays. Where three samples of
+ * the same sign straddle a turning point, the turning point is located as
+ * well, so brief grazing windows shorter than the step are not lost.
+ *
+ * @return Sorted, non-overlapping intervals, as Julian dates (UT).
+ */
+std::vector<CVisibilityWindow>
+PAVisibility::AltitudeWindows(const CAltitudeConstraint &constraint,
+                              double startJulianDate, double endJulianDate) {
+  std::vector<CVisibilityWindow> windows;
+  if (endJulianDate <= startJulianDate)
+    return windows;
+
+  BodyTrack track(constraint, startJulianDate, endJulianDate);
+  ConstraintMargin margin(constraint, track, geogLongDeg, geogLatDeg);
+
+  int steps = std::max(
+      2, (int)ceil((endJulianDate - startJulianDate) / searchStepDays));
+  double stepDays = (endJulianDate - startJulianDate) / steps;
+
+  std::vector<double> t(steps + 1);
+  std::vector<double> f(steps + 1);
+  for (int i = 0; i <= steps; i++) {
+    t[i] = startJulianDate + i * stepDays;
+    f[i] = margin(t[i]);
+  }
+
+  std::vector<double> crossings;
+  for (int i = 0; i < steps; i++) {
+    if ((f[i] >= 0) != (f[i + 1] >= 0)) {
+      crossings.push_back(PAEvents::RefineCrossing(
+          margin, t[i], f[i], t[i + 1], f[i + 1], toleranceDays));
+      continue;
+    }
+
+    // Turning point between samples that all lie on one side of the limit.
+    if (i == 0 || (f[i - 1] >= 0) != (f[i] >= 0))
+      continue;
+    double sign = (f[i] < 0) ? 1.0 : -1.0;
+    if (sign * (f[i] - f[i - 1]) <= 0 || sign * (f[i] - f[i + 1]) <= 0)
+      continue;
+
+    double tExtremum = PAEvents::RefineExtremum(margin, t[i - 1], t[i + 1],
+                                                sign, toleranceDays);
+    double fExtremum = margin(tExtremum);
+    if ((fExtremum >= 0) == (f[i] >= 0))
+      continue;
+
+    if (tExtremum < t[i]) {
+      // Crossings in (t[i-1], t[i]) belong to the previous step; it saw no
+      // sign change, so add both here.
+      crossings.push_back(PAEvents::RefineCrossing(
+          margin, t[i - 1], f[i - 1], tExtremum, fExtremum, toleranceDays));
+      crossings.push_back(PAEvents::RefineCrossing(
+          margin, tExtremum, fExtremum, t[i], f[i], toleranceDays));
+    } else {
+      crossings.push_back(PAEvents::RefineCrossing(
+          margin, t[i], f[i], tExtremum, fExtremum, toleranceDays));
+      crossings.push_back(PAEvents::RefineCrossing(
+          margin, tExtremum, fExtremum, t[i + 1], f[i + 1], toleranceDays));
+    }
+  }
+  std::sort(crossings.begin(), crossings.end());
+
+  bool inside = (f[0] >= 0);
+  double openedAt = startJulianDate;
+  for (double crossing : crossings) {
+    if (inside)
+      windows.push_back(CVisibilityWindow(openedAt, crossing));
+    else
+      openedAt = crossing;
+    inside = !inside;
+  }
+  if (inside)
+    windows.push_back(CVisibilityWindow(openedAt, endJulianDate));
+
+  return Merge(windows);
+}
+
+/**
+ * \brief Find the intervals in which all of the constraints are satisfied.
+ *
+ * @return Sorted, non-overlapping intervals, as Julian dates (UT).
+ */
+std::vector<CVisibilityWindow>
+PAVisibility::Windows(const std::vector<CAltitudeConstraint> &constraints,
+                      double startJulianDate, double endJulianDate) {
+  std::vector<CVisibilityWindow> windows;
+  windows.push_back(CVisibilityWindow(startJulianDate, endJulianDate));
+
+  for (const CAltitudeConstraint &constraint : constraints) {
+    if (windows.empty())
+      break;
+
+    windows = Intersect(
+        windows, AltitudeWindows(constraint, windows.front().startJulianDate,
+                                 windows.back().endJulianDate));
+  }
+
+  return windows;
+}
+
+/**
+ * \brief Find the intervals in which both the Sun and the Moon are below the
+ * given altitudes (e.g. -18 and -0.833 degrees for astronomical dark time).
+ */
+std::vector<CVisibilityWindow>
+PAVisibility::DarkTime(double maxSunAltitudeDeg, double maxMoonAltitudeDeg,
+                       double startJulianDate, double endJulianDate) {
+  std::vector<CAltitudeConstraint> constraints = {
+      CAltitudeConstraint(EVisibilityBody::Sun, EAltitudeSense::Below,
+                          maxSunAltitudeDeg),
+      CAltitudeConstraint(EVisibilityBody::Moon, EAltitudeSense::Below,
+                          maxMoonAltitudeDeg)};
+
+  return Windows(constraints, startJulianDate, endJulianDate);
+}
+
+/**
+ * \brief Find the intervals in which a fixed object is above an altitude
+ * during dark time.
+ */
+std::vector<CVisibilityWindow> PAVisibility::ObservableWindows(
+    double raHours, double decDeg, double minAltitudeDeg,
+    double maxSunAltitudeDeg, double maxMoonAltitudeDeg,
+    double startJulianDate, double endJulianDate) {
+  std::vector<CAltitudeConstraint> constraints = {
+      CAltitudeConstraint(raHours, decDeg, EAltitudeSense::Above,
+                          minAltitudeDeg),
+      CAltitudeConstraint(EVisibilityBody::Sun, EAltitudeSense::Below,
+                          maxSunAltitudeDeg),
+      CAltitudeConstraint(EVisibilityBody::Moon, EAltitudeSense::Below,
+                          maxMoonAltitudeDeg)};
+
+  return Windows(constraints, startJulianDate, endJulianDate);
+}
+
+/**
+ * \brief Sort intervals and merge the ones that overlap or touch.
+ */
+std::vector<CVisibilityWindow>
+PAVisibility::Merge(std::vector<CVisibilityWindow> windows) {
+  std::sort(windows.begin(), windows.end(),
+            [](const CVisibilityWindow &a, const CVisibilityWindow &b) {
+              return a.startJulianDate < b.startJulianDate;
+            });
+
+  std::vector<CVisibilityWindow> merged;
+  for (const CVisibilityWindow &window : windows) {
+    if (window.endJulianDate <= window.startJulianDate)
+      continue;
+
+    if (!merged.empty() &&
+        window.startJulianDate <= merged.back().endJulianDate)
+      merged.back().endJulianDate =
+          std::max(merged.back().endJulianDate, window.endJulianDate);
+    else
+      merged.push_back(window);
+  }
+
+  return merged;
+}
+
+/**
+ * \brief Intersection of two sorted, non-overlapping interval lists.
+ */
+std::vector<CVisibilityWindow>
+PAVisibility::Intersect(const std::vector<CVisibilityWindow> &a,
+                        const std::vector<CVisibilityWindow> &b) {
+  std::vector<CVisibilityWindow> result;
+  std::size_t i = 0;
+  std::size_t j = 0;
+
+  while (i < a.size() && j < b.size()) {
+    double start = std::max(a[i].startJulianDate, b[j].startJulianDate);
+    double end = std::min(a[i].endJulianDate, b[j].endJulianDate);
+
+    if (start < end)
+      result.push_back(CVisibilityWindow(start, end));
+
+    if (a[i].endJulianDate < b[j].endJulianDate)
+      i++;
+    else
+      j++;
+  }
+
+  return result;
+}
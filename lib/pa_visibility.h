@@ -0,0 +1,59 @@
+#ifndef _pa_visibility
+#define _pa_visibility
+
+#include "pa_models.h"
+#include "pa_types.h"
+#include <vector>
+
+using namespace pa_models;
+using namespace pa_types;
+
+/**
+ * \brief Search for the times a site satisfies altitude constraints.
+ *
+ * Altitudes are sampled on a coarse grid, crossings of the limit are bracketed
+ * and then refined with a root solver, and the resulting intervals are
+ * returned as sorted, merged lists of Julian dates (UT). Positions of moving
+ * bodies are interpolated from a sparse set of samples of the full model.
+ */
+class PAVisibility {
+public:
+  PAVisibility(double geogLongDeg, double geogLatDeg);
+
+  std::vector<CVisibilityWindow>
+  AltitudeWindows(const CAltitudeConstraint &constraint, double startJulianDate,
+                  double endJulianDate);
+
+  std::vector<CVisibilityWindow>
+  Windows(const std::vector<CAltitudeConstraint> &constraints,
+          double startJulianDate, double endJulianDate);
+
+  std::vector<CVisibilityWindow> DarkTime(double maxSunAltitudeDeg,
+                                          double maxMoonAltitudeDeg,
+                                          double startJulianDate,
+                                          double endJulianDate);
+
+  std::vector<CVisibilityWindow>
+  ObservableWindows(double raHours, double decDeg, double minAltitudeDeg,
+                    double maxSunAltitudeDeg, double maxMoonAltitudeDeg,
+                    double startJulianDate, double endJulianDate);
+
+  static std::vector<CVisibilityWindow>
+  Merge(std::vector<CVisibilityWindow> windows);
+
+  static std::vector<CVisibilityWindow>
+  Intersect(const std::vector<CVisibilityWindow> &a,
+            const std::vector<CVisibilityWindow> &b);
+
+  /** Spacing of the altitude samples used to bracket crossings, in days. */
+  double searchStepDays;
+
+  /** Accuracy of the refined crossing times, in days. */
+  double toleranceDays;
+
+private:
+  double geogLongDeg;
+  double geogLatDeg;
+};
+
+#endif
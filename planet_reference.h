@@ -0,0 +1,17 @@
+#ifndef _planet_reference
+#define _planet_reference
+
+#include "lib/pa_data.h"
+#include "lib/pa_models.h"
+
+/**
+ * \brief PlanetLongL4945() as it was before the series became tables: string
+ * compares to pick the planet, then each term written out by hand.
+ *
+ * Kept as a reference for the tables, and as the baseline they are
+ * benchmarked against.
+ */
+pa_models::CPlanetLongLatL4945
+BranchyPlanetLongL4945(double t, pa_data::PlanetDataPrecise planet);
+
+#endif
@@ -0,0 +1,185 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_almanac.h"
+#include "lib/pa_macros.h"
+#include "lib/pa_models.h"
+#include "lib/pa_moon.h"
+#include "lib/pa_sun.h"
+#include "lib/pa_types.h"
+#include "lib/pa_util.h"
+#include <cmath>
+
+using namespace pa_models;
+using namespace pa_types;
+using namespace pa_util;
+
+namespace {
+/** Local time as the façades round it, in whole minutes. */
+double RoundedMinutes(double hours) {
+  double adjusted = hours + 0.008333;
+
+  return pa_macros::DecimalHoursHour(adjusted) * 60 +
+         pa_macros::DecimalHoursMinute(adjusted);
+}
+} // namespace
+
+SCENARIO("Almanac for a Site", "[almanac]") {
+  GIVEN("An almanac for 71.05d W, 42.37d N, Zone Correction -5") {
+    PAAlmanac paAlmanac(-71.05, 42.37, false, -5);
+    PASun paSun;
+    PAMoon paMoon;
+
+    WHEN("March 1986 is computed") {
+      CAlmanac result = paAlmanac.Days(1, 3, 1986, 31);
+
+      THEN("Every day matches the Sun and Moon façades") {
+        REQUIRE(result.size() == 31);
+
+        for (std::size_t i = 0; i < result.size(); i++) {
+          double day = i + 1;
+          REQUIRE(result.julianDate[i] ==
+                  pa_macros::CivilDateToJulianDate(day, 3, 1986));
+
+          CSunriseAndSunset sun =
+              paSun.SunriseAndSunset(day, 3, 1986, false, -5, -71.05, 42.37);
+          double sunriseHours = pa_macros::SunriseLocalCivilTime(
+              day, 3, 1986, 0, -5, -71.05, 42.37);
+
+          REQUIRE(result.sunStatus[i] == sun.status);
+          REQUIRE(RoundedMinutes(result.sunriseHours[i]) ==
+                  RoundedMinutes(sunriseHours));
+          REQUIRE(RoundedMinutes(result.sunsetHours[i]) ==
+                  sun.localSunsetHour * 60 + sun.localSunsetMinute);
+          REQUIRE(std::abs(result.sunsetAzimuthDeg[i] -
+                           sun.azimuthOfSunsetDeg) < 0.006);
+
+          const ETwilightType twilightTypes[3] = {ETwilightType::Civil,
+                                                  ETwilightType::Nautical,
+                                                  ETwilightType::Astronomical};
+          for (int t = 0; t < 3; t++) {
+            CMorningAndEveningTwilight twilight =
+                paSun.MorningAndEveningTwilight(day, 3, 1986, false, -5,
+                                                -71.05, 42.37,
+                                                twilightTypes[t]);
+
+            REQUIRE(result.twilightStatus[t][i] == twilight.status);
+            REQUIRE(RoundedMinutes(result.twilightBeginsHours[t][i]) ==
+                    twilight.amTwilightBeginsHour * 60 +
+                        twilight.amTwilightBeginsMin);
+            // The façade reports a failed evening event as 0:00.
+            double endsHours = result.twilightEndsHours[t][i];
+            REQUIRE(RoundedMinutes(endsHours == -99 ? 0.0 : endsHours) ==
+                    twilight.pmTwilightEndsHour * 60 +
+                        twilight.pmTwilightEndsMin);
+          }
+
+          CMoonRiseSet moon =
+              paMoon.MoonriseAndMoonset(day, 3, 1986, false, -5, -71.05, 42.37);
+
+          REQUIRE(std::abs(RoundedMinutes(result.moonriseHours[i]) -
+                           (moon.mrLocalTimeHour * 60 +
+                            moon.mrLocalTimeMin)) <= 1);
+          REQUIRE(result.moonriseDayOffset[i] ==
+                  pa_macros::CivilDateToJulianDate(moon.mrLocalDateDay,
+                                                   moon.mrLocalDateMonth,
+                                                   moon.mrLocalDateYear) -
+                      result.julianDate[i]);
+          REQUIRE(std::abs(RoundedMinutes(result.moonsetHours[i]) -
+                           (moon.msLocalTimeHour * 60 +
+                            moon.msLocalTimeMin)) <= 1);
+          REQUIRE(result.moonsetDayOffset[i] ==
+                  pa_macros::CivilDateToJulianDate(moon.msLocalDateDay,
+                                                   moon.msLocalDateMonth,
+                                                   moon.msLocalDateYear) -
+                      result.julianDate[i]);
+          REQUIRE(std::abs(result.moonriseAzimuthDeg[i] -
+                           moon.mrAzimuthDeg) < 0.1);
+
+          CMoonPhase phase = paMoon.MoonPhase(12, 0, 0, false, -5, day, 3, 1986,
+                                              EAccuracyLevel::Precise);
+
+          REQUIRE(Round(result.moonPhase[i], 2) == phase.phase);
+          REQUIRE(std::abs(result.moonBrightLimbDeg[i] - phase.brightLimbDeg) <
+                  0.006);
+
+          CEquationOfTime equationOfTime = paSun.EquationOfTime(day, 3, 1986);
+
+          REQUIRE(std::abs(result.equationOfTimeMinutes[i] -
+                           (equationOfTime.minutes +
+                            equationOfTime.seconds / 60)) < 0.0005);
+        }
+      }
+
+      THEN("Each Moon event converges in fewer steps than the façade's nine") {
+        for (std::size_t i = 0; i < result.size(); i++) {
+          REQUIRE(result.moonriseIterations[i] < 9);
+          REQUIRE(result.moonsetIterations[i] < 9);
+        }
+      }
+    }
+
+    WHEN("2024 is computed") {
+      CAlmanac result = paAlmanac.Year(2024);
+
+      THEN("Moonrise and moonset, seeded from the day before, need fewer "
+           "lunar positions than from noon") {
+        int seededRise = 0, seededSet = 0, noonRise = 0, noonSet = 0;
+        int daysFewer = 0;
+        for (std::size_t i = 0; i < result.size(); i++) {
+          double jd = result.julianDate[i];
+          double day = pa_macros::JulianDateDay(jd);
+          int month = pa_macros::JulianDateMonth(jd);
+          int year = pa_macros::JulianDateYear(jd);
+          CMoonRiseSetEvent rise = pa_macros::MoonRiseEvent(
+              12.0, day, month, year, 0, -5, -71.05, 42.37,
+              paAlmanac.moonToleranceHours, paAlmanac.moonMaxIterations);
+          CMoonRiseSetEvent set = pa_macros::MoonSetEvent(
+              12.0, day, month, year, 0, -5, -71.05, 42.37,
+              paAlmanac.moonToleranceHours, paAlmanac.moonMaxIterations);
+
+          seededRise += result.moonriseIterations[i];
+          seededSet += result.moonsetIterations[i];
+          noonRise += rise.iterations;
+          noonSet += set.iterations;
+          if (result.moonriseIterations[i] < rise.iterations)
+            daysFewer++;
+        }
+
+        REQUIRE(seededRise < noonRise * 0.9);
+        REQUIRE(seededSet < noonSet * 0.9);
+        REQUIRE(daysFewer > 180);
+      }
+    }
+
+    WHEN("Whole years are computed") {
+      THEN("There is one row per day") {
+        REQUIRE(paAlmanac.Year(1986).size() == 365);
+        REQUIRE(paAlmanac.Year(2000).size() == 366);
+      }
+    }
+  }
+
+  GIVEN("An almanac for 18.95d E, 69.65d N, Zone Correction 1") {
+    PAAlmanac paAlmanac(18.95, 69.65, false, 1);
+    PASun paSun;
+
+    WHEN("The days around the June solstice of 2020 are computed") {
+      CAlmanac result = paAlmanac.Days(18, 6, 2020, 5);
+
+      THEN("The Sun does not set, and statuses match the façades") {
+        for (std::size_t i = 0; i < result.size(); i++) {
+          double day = 18 + i;
+          CSunriseAndSunset sun =
+              paSun.SunriseAndSunset(day, 6, 2020, false, 1, 18.95, 69.65);
+          CMorningAndEveningTwilight twilight =
+              paSun.MorningAndEveningTwilight(day, 6, 2020, false, 1, 18.95,
+                                              69.65, ETwilightType::Civil);
+
+          REQUIRE(result.sunStatus[i] == ERiseSetStatus::Circumpolar);
+          REQUIRE(result.sunStatus[i] == sun.status);
+          REQUIRE(result.sunriseHours[i] == -99);
+          REQUIRE(result.twilightStatus[0][i] == twilight.status);
+        }
+      }
+    }
+  }
+}
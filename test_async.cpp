@@ -0,0 +1,111 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_async.h"
+#include "lib/pa_models.h"
+#include "lib/pa_moon.h"
+#include "lib/pa_planet.h"
+#include "lib/pa_sun.h"
+#include "lib/pa_types.h"
+#include <future>
+#include <string>
+#include <vector>
+
+SCENARIO("Asynchronous Façades", "[async]") {
+  GIVEN("A dispatcher with two workers") {
+    PAAsyncDispatcher dispatcher(2);
+    PAAsyncSun asyncSun(dispatcher);
+    PAAsyncMoon asyncMoon(dispatcher);
+    PAAsyncPlanet asyncPlanet(dispatcher);
+
+    WHEN("Requests are made through the futures") {
+      std::future<CSunriseAndSunset> sunrise =
+          asyncSun.SunriseAndSunset(10, 3, 1986, false, -5, -71.05, 42.37);
+      std::future<CMoonPhase> phase = asyncMoon.MoonPhase(
+          0, 0, 0, false, 0, 1, 9, 2003, EAccuracyLevel::Approximate);
+      std::future<CPrecisePositionOfPlanet> jupiter =
+          asyncPlanet.PrecisePositionOfPlanet(0, 0, 0, false, 0, 22, 11, 2003,
+                                              "Jupiter");
+      std::future<CApproximatePositionOfPlanet> pluto =
+          asyncPlanet.ApproximatePositionOfPlanet(0, 0, 0, false, 0, 22, 11,
+                                                  2003, "Pluto");
+
+      THEN("They give what the façades give") {
+        CSunriseAndSunset expectedSunrise =
+            PASun().SunriseAndSunset(10, 3, 1986, false, -5, -71.05, 42.37);
+        CMoonPhase expectedPhase = PAMoon().MoonPhase(
+            0, 0, 0, false, 0, 1, 9, 2003, EAccuracyLevel::Approximate);
+        CPrecisePositionOfPlanet expectedJupiter =
+            PAPlanet().PrecisePositionOfPlanet(0, 0, 0, false, 0, 22, 11, 2003,
+                                               "Jupiter");
+
+        CSunriseAndSunset gotSunrise = sunrise.get();
+        REQUIRE(gotSunrise.localSunsetHour == expectedSunrise.localSunsetHour);
+        REQUIRE(gotSunrise.localSunsetMinute ==
+                expectedSunrise.localSunsetMinute);
+        REQUIRE(phase.get().phase == expectedPhase.phase);
+
+        CPrecisePositionOfPlanet gotJupiter = jupiter.get();
+        REQUIRE(gotJupiter.PlanetRAHour == expectedJupiter.PlanetRAHour);
+        REQUIRE(gotJupiter.PlanetRAMin == expectedJupiter.PlanetRAMin);
+        REQUIRE(gotJupiter.PlanetDecDeg == expectedJupiter.PlanetDecDeg);
+        REQUIRE(pluto.get().planetRAHour ==
+                PAPlanet()
+                    .ApproximatePositionOfPlanet(0, 0, 0, false, 0, 22, 11,
+                                                 2003, "Pluto")
+                    .planetRAHour);
+      }
+    }
+
+    WHEN("Requests for one instant queue up while the workers are busy") {
+      std::promise<void> release;
+      std::shared_future<void> gate = release.get_future().share();
+      std::future<int> busy =
+          dispatcher.Submit<int>(1000, {}, "", [gate] {
+            gate.wait();
+            return 1;
+          });
+
+      std::vector<std::string> names = {"Mercury", "Venus",  "Mars",
+                                        "Jupiter", "Saturn", "Uranus",
+                                        "Neptune"};
+      std::vector<std::future<CPrecisePositionOfPlanet>> positions;
+      for (const std::string &name : names)
+        positions.push_back(asyncPlanet.PrecisePositionOfPlanet(
+            6, 0, 0, false, 0, 28, 8, 2003, name));
+      std::future<CPlanetVisualAspects> marsAspects =
+          asyncPlanet.VisualAspectsOfAPlanet(6, 0, 0, false, 0, 28, 8, 2003,
+                                             "Mars");
+      std::vector<std::future<CEquationOfTime>> equations;
+      for (int i = 0; i < 3; i++)
+        equations.push_back(asyncSun.EquationOfTime(27, 7, 2010));
+
+      release.set_value();
+
+      THEN("They share one computation per instant, and match the "
+           "façades") {
+        REQUIRE(busy.get() == 1);
+        for (std::size_t i = 0; i < names.size(); i++) {
+          CPrecisePositionOfPlanet expected =
+              PAPlanet().PrecisePositionOfPlanet(6, 0, 0, false, 0, 28, 8,
+                                                 2003, names[i]);
+          CPrecisePositionOfPlanet got = positions[i].get();
+
+          REQUIRE(got.PlanetRAHour == expected.PlanetRAHour);
+          REQUIRE(got.PlanetRAMin == expected.PlanetRAMin);
+          REQUIRE(got.PlanetRASec == expected.PlanetRASec);
+          REQUIRE(got.PlanetDecDeg == expected.PlanetDecDeg);
+        }
+        REQUIRE(marsAspects.get().phase ==
+                PAPlanet()
+                    .VisualAspectsOfAPlanet(6, 0, 0, false, 0, 28, 8, 2003,
+                                            "Mars")
+                    .phase);
+        for (std::future<CEquationOfTime> &equation : equations)
+          REQUIRE(equation.get().seconds ==
+                  PASun().EquationOfTime(27, 7, 2010).seconds);
+
+        REQUIRE(dispatcher.Requests() == 12);
+        REQUIRE(dispatcher.Computations() == 3);
+      }
+    }
+  }
+}
@@ -0,0 +1,215 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_batch.h"
+#include "lib/pa_datetime.h"
+#include "lib/pa_models.h"
+#include "lib/pa_parallel.h"
+#include "lib/pa_sun.h"
+#include "lib/pa_types.h"
+#include <sstream>
+#include <string>
+
+SCENARIO("Batch Requests", "[batch]") {
+  GIVEN("A batch reading JSON lines") {
+    PABatch batch(EBatchFormat::Jsonl);
+    std::string output;
+
+    WHEN("A request names a method and its arguments") {
+      batch.ProcessLine("{\"id\": \"a7\", \"function\": "
+                        "\"PASun.SunriseAndSunset\", \"args\": [10, 3, 1986, "
+                        "false, -5, -71.05, 42.37]}",
+                        3, output);
+
+      THEN("The result has the fields of the model") {
+        REQUIRE(output.rfind("{\"line\":3,\"id\":\"a7\",\"function\":"
+                             "\"PASun.SunriseAndSunset\",\"result\":{"
+                             "\"localSunriseHour\":",
+                             0) == 0);
+        REQUIRE(output.find("\"localSunsetMinute\":") != std::string::npos);
+        REQUIRE(output.find("\"status\":\"Ok\"") != std::string::npos);
+        REQUIRE(output.substr(output.size() - 2) == "}}");
+      }
+    }
+
+    WHEN("A request returns a double, or takes an enumeration") {
+      std::string twilight;
+      batch.ProcessLine("{\"function\": \"PADateTime.CivilTimeToDecimalHours\","
+                        " \"args\": [18, 31, 27]}",
+                        1, output);
+      batch.ProcessLine(
+          "{\"function\": \"PASun.MorningAndEveningTwilight\", \"args\": "
+          "[7, 9, 1979, false, 0, 0, 52, \"Astronomical\"]}",
+          2, twilight);
+
+      THEN("They are written as values and names") {
+        std::string prefix = "{\"line\":1,\"function\":"
+                             "\"PADateTime.CivilTimeToDecimalHours\","
+                             "\"result\":{\"value\":";
+        REQUIRE(output.rfind(prefix, 0) == 0);
+        REQUIRE(std::stod(output.substr(prefix.size())) ==
+                PADateTime().CivilTimeToDecimalHours(18, 31, 27));
+        REQUIRE(twilight.find("\"status\":\"Ok\"") != std::string::npos);
+      }
+    }
+
+    WHEN("Requests are wrong") {
+      std::string unknown, count, value, syntax, comment;
+      batch.ProcessLine("{\"function\": \"PASun.Nothing\", \"args\": []}", 1,
+                        unknown);
+      batch.ProcessLine(
+          "{\"function\": \"PASun.EquationOfTime\", \"args\": [27, 7]}", 2,
+          count);
+      batch.ProcessLine(
+          "{\"function\": \"PASun.EquationOfTime\", \"args\": [27, \"July\", "
+          "2010]}",
+          3, value);
+      batch.ProcessLine("PASun.EquationOfTime,27,7,2010", 4, syntax);
+      batch.ProcessLine("# a comment", 5, comment);
+
+      THEN("Each gives an error, and a comment gives nothing") {
+        REQUIRE(unknown == "{\"line\":1,\"function\":\"PASun.Nothing\","
+                           "\"error\":\"unknown function\"}");
+        REQUIRE(count.find("\"error\":\"expected 3 arguments, got 2\"") !=
+                std::string::npos);
+        REQUIRE(value.find("\"error\":\"argument 2 is not an integer\"") !=
+                std::string::npos);
+        REQUIRE(syntax.find("\"error\":\"expected a JSON object\"") !=
+                std::string::npos);
+        REQUIRE(comment.empty());
+      }
+    }
+
+    WHEN("Requests have ids of each kind") {
+      std::string number, literal, array, object, bare;
+      batch.ProcessLine("{\"id\": -1.5e3, \"function\": \"PASun.Nothing\"}",
+                        1, number);
+      batch.ProcessLine("{\"id\": null, \"function\": \"PASun.Nothing\"}", 2,
+                        literal);
+      batch.ProcessLine("{\"id\": [1], \"function\": \"PASun.Nothing\"}", 3,
+                        array);
+      batch.ProcessLine("{\"id\": {\"a\":1}, \"function\": \"PASun.Nothing\"}",
+                        4, object);
+      batch.ProcessLine("{\"id\": a7, \"function\": \"PASun.Nothing\"}", 5,
+                        bare);
+
+      THEN("Strings, numbers and literals are echoed, and others are errors") {
+        REQUIRE(number.rfind("{\"line\":1,\"id\":-1.5e3,", 0) == 0);
+        REQUIRE(literal.rfind("{\"line\":2,\"id\":null,", 0) == 0);
+
+        std::string error = ",\"function\":\"\",\"error\":\"id must be a "
+                            "string, number, true, false or null\"}";
+        REQUIRE(array == "{\"line\":3" + error);
+        REQUIRE(object == "{\"line\":4" + error);
+        REQUIRE(bare == "{\"line\":5" + error);
+      }
+    }
+  }
+
+  GIVEN("A batch reading CSV") {
+    PABatch batch(EBatchFormat::Csv);
+    std::string output;
+
+    WHEN("A request returns a model") {
+      batch.ProcessLine("PASun.EquationOfTime, 27, 7, 2010", 9, output);
+
+      THEN("Its fields are written in order, exactly") {
+        CEquationOfTime expected = PASun().EquationOfTime(27, 7, 2010);
+        std::string prefix = "9,PASun.EquationOfTime,";
+        REQUIRE(output.rfind(prefix, 0) == 0);
+
+        std::size_t comma = output.find(',', prefix.size());
+        REQUIRE(std::stod(output.substr(prefix.size())) == expected.minutes);
+        REQUIRE(std::stod(output.substr(comma + 1)) == expected.seconds);
+      }
+    }
+
+    WHEN("All planet positions are requested") {
+      batch.ProcessLine("PAPlanet.PrecisePositionOfAllPlanets,0,0,0,false,0,"
+                        "22,11,2003,true",
+                        1, output);
+
+      THEN("There is a group of fields for each planet") {
+        std::size_t commas = 0;
+        for (char c : output)
+          commas += c == ',' ? 1 : 0;
+        REQUIRE(commas == 1 + 7 * (6 + 8));
+        REQUIRE(output.find(",Mercury") == std::string::npos);
+      }
+    }
+
+    WHEN("A request is wrong") {
+      batch.ProcessLine("PASun.EquationOfTime,27,7,2010,1", 2, output);
+
+      THEN("The error follows the function, quoted") {
+        REQUIRE(output == "2,PASun.EquationOfTime,error,"
+                          "\"expected 3 arguments, got 4\"");
+      }
+    }
+
+    WHEN("Fields are quoted") {
+      std::string quoted, withComma, withQuotes, unclosed;
+      batch.ProcessLine("\"PASun.EquationOfTime\", \"27\",7 , \"2010\"", 1,
+                        quoted);
+      batch.ProcessLine("PASun.EquationOfTime,\"27,7\",2010", 2, withComma);
+      batch.ProcessLine("\"Say \"\"hi\"\", twice\",1", 3, withQuotes);
+      batch.ProcessLine("PASun.EquationOfTime,\"27,7,2010", 4, unclosed);
+
+      THEN("Commas and doubled quotes within them are read as text") {
+        batch.ProcessLine("PASun.EquationOfTime,27,7,2010", 1, output);
+        REQUIRE(quoted == output);
+        REQUIRE(withComma == "2,PASun.EquationOfTime,error,"
+                             "\"expected 3 arguments, got 2\"");
+        REQUIRE(withQuotes ==
+                "3,\"Say \"\"hi\"\", twice\",error,unknown function");
+        REQUIRE(unclosed ==
+                "4,PASun.EquationOfTime,error,quoted field is not closed");
+      }
+    }
+  }
+
+  GIVEN("A stream of requests run on four workers, in small blocks") {
+    std::ostringstream requests;
+    for (int i = 0; i < 25; i++) {
+      if (i % 10 == 4)
+        requests << "\n";
+      requests << "PADateTime.GetDateOfEaster," << 2000 + i << "\n";
+    }
+    std::istringstream input(requests.str());
+    std::ostringstream output;
+    PATaskPool pool(4);
+
+    WHEN("The batch is run") {
+      std::size_t count =
+          PABatch(EBatchFormat::Csv).Run(input, output, pool, 4);
+
+      THEN("The results come out in the order of the input") {
+        REQUIRE(count == 25);
+
+        std::istringstream lines(output.str());
+        std::string line;
+        int year = 2000;
+        int lineNumber = 0;
+        while (std::getline(lines, line)) {
+          lineNumber++;
+          if (lineNumber % 11 == 5)
+            lineNumber++;
+          CMonthDayYear easter = PADateTime().GetDateOfEaster(year++);
+          REQUIRE(line == std::to_string(lineNumber) +
+                              ",PADateTime.GetDateOfEaster," +
+                              std::to_string(easter.month) + "," +
+                              std::to_string(easter.day) + "," +
+                              std::to_string(easter.year));
+        }
+        REQUIRE(year == 2025);
+      }
+    }
+  }
+
+  GIVEN("The list of functions") {
+    THEN("Every function has a signature") {
+      for (const std::string &name : PABatch::FunctionNames())
+        REQUIRE(PABatch::Signature(name).size() > 0);
+      REQUIRE(PABatch::Signature("PASun.SunriseAndSunset") == "diibidd");
+      REQUIRE(PABatch::Signature("PASun.Nothing").empty());
+    }
+  }
+}
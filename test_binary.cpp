@@ -5,6 +5,7 @@
 #include "lib/pa_types.h"
 #include "lib/pa_util.h"
 #include <tuple>
+#include <vector>
 
 SCENARIO("Binary Star Orbital Data") {
   GIVEN("A PABinary object") {
@@ -22,4 +23,54 @@ SCENARIO("Binary Star Orbital Data") {
       }
     }
   }
-}
\ No newline at end of file
+}
+
+SCENARIO("Binary Star Orbit Track") {
+  GIVEN("A PABinary object") {
+    PABinary paBinary;
+
+    WHEN("Epochs are the first day of each year from 1970 to 2020 and Binary "
+         "Star is eta-Cor") {
+      std::vector<double> epochYears;
+      for (int year = 1970; year <= 2020; year++)
+        epochYears.push_back(PABinary::EpochYear(1, 1, year));
+
+      CBinaryStarOrbitTrack result =
+          paBinary.binaryStarOrbitTrack("eta-Cor", epochYears);
+
+      THEN("Each epoch matches binaryStarOrbit, after rounding") {
+        REQUIRE(result.size() == epochYears.size());
+
+        for (int i = 0; i < epochYears.size(); i++) {
+          CBinaryStarOrbitalData expected =
+              paBinary.binaryStarOrbit(1, 1, 1970 + i, "eta-Cor");
+
+          REQUIRE(pa_util::Round(result.positionAngleDeg[i], 1) ==
+                  expected.positionAngleDeg);
+          REQUIRE(pa_util::Round(result.separationArcsec[i], 2) ==
+                  expected.separationArcsec);
+        }
+      }
+    }
+
+    WHEN("Tracks are found for a catalogue of eta-Cor and gamma-Vir") {
+      std::vector<CBinaryStarOrbitTrack> result =
+          paBinary.binaryStarOrbitTracks(
+              {pa_data::getBinaryStarData("eta-Cor"),
+               pa_data::getBinaryStarData("gamma-Vir")},
+              {PABinary::EpochYear(1, 1, 1980)});
+
+      THEN("There is one track per star, matching binaryStarOrbit") {
+        CBinaryStarOrbitalData expected =
+            paBinary.binaryStarOrbit(1, 1, 1980, "gamma-Vir");
+
+        REQUIRE(result.size() == 2);
+        REQUIRE(pa_util::Round(result[0].positionAngleDeg[0], 1) == 318.5);
+        REQUIRE(pa_util::Round(result[1].positionAngleDeg[0], 1) ==
+                expected.positionAngleDeg);
+        REQUIRE(pa_util::Round(result[1].separationArcsec[0], 2) ==
+                expected.separationArcsec);
+      }
+    }
+  }
+}
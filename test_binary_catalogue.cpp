@@ -0,0 +1,149 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_binary.h"
+#include "lib/pa_binary_catalogue.h"
+#include "lib/pa_data.h"
+#include "lib/pa_models.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * \brief Place a field in a line of the Sixth Catalog, at a 1-based column.
+ */
+void PutField(std::string &line, std::size_t column, const std::string &text) {
+  if (line.size() < column - 1 + text.size())
+    line.resize(column - 1 + text.size(), ' ');
+  line.replace(column - 1, text.size(), text);
+}
+
+std::string SixthCatalogLine(const std::string &wds,
+                             const std::string &discoverer,
+                             const std::string &period,
+                             const std::string &axis, const std::string &incl,
+                             const std::string &node, const std::string &epoch,
+                             const std::string &ecc,
+                             const std::string &longPeri) {
+  std::string line;
+  PutField(line, 20, wds);
+  PutField(line, 31, discoverer);
+  PutField(line, 81, period);
+  PutField(line, 106, axis);
+  PutField(line, 126, incl);
+  PutField(line, 144, node);
+  PutField(line, 162, epoch);
+  PutField(line, 186, ecc);
+  PutField(line, 204, longPeri);
+  PutField(line, 212, "  5 n Sod1999 ");
+
+  return line;
+}
+} // namespace
+
+SCENARIO("Binary star catalogue", "[binary_catalogue]") {
+  GIVEN("A binary catalogue converted from lines of the Sixth Catalog") {
+    std::string textPath = "test_binary_catalogue.txt";
+    std::string binaryPath = "test_binary_catalogue.bin";
+    {
+      std::ofstream text(textPath);
+      text << SixthCatalogLine("15232+3017", "STF1937AB", "  41.623   y",
+                               "   0.907a", " 59.025", " 23.717",
+                               "1934.008   y", "0.276300", "219.907")
+           << "\n"
+           << "not an orbit\n"
+           << SixthCatalogLine("99999+9999", "TST   1", "3652.5     d",
+                               "  500    m", " 45.0", " 90.0", "51544.5    d",
+                               "0.500000", " 10.0")
+           << "\n"
+           << SixthCatalogLine("12417-0127", "STF1670AB", " 171.37    y",
+                               "   3.746a", "146.05", " 31.78",
+                               "1836.433   y", "0.880800", "252.88")
+           << "\n";
+    }
+
+    int converted =
+        PABinaryCatalogue::ConvertSixthCatalog(textPath, binaryPath);
+
+    PABinaryCatalogue paBinaryCatalogue;
+    bool opened = paBinaryCatalogue.Open(binaryPath);
+
+    WHEN("The catalogue is opened") {
+      THEN("The three orbits are read, sorted by WDS designation") {
+        REQUIRE(converted == 3);
+        REQUIRE(opened);
+        REQUIRE(paBinaryCatalogue.size() == 3);
+        REQUIRE(paBinaryCatalogue.Find("12417-0127") == 0);
+        REQUIRE(paBinaryCatalogue.Find("15232+3017") == 1);
+        REQUIRE(paBinaryCatalogue.Find("99999+9999") == 2);
+        REQUIRE(paBinaryCatalogue.Find("00000+0000") == -1);
+        REQUIRE(paBinaryCatalogue.DiscovererDesignation(1) == "STF1937AB");
+        REQUIRE(paBinaryCatalogue.Star(1).name == "15232+3017 STF1937AB");
+      }
+
+      THEN("Periods in days, axes in milliarcseconds and epochs as Julian "
+           "dates are converted") {
+        pa_data::BinaryStarData star = paBinaryCatalogue.Star(2);
+
+        REQUIRE(std::abs(star.period - 10.0) < 0.001);
+        REQUIRE(star.axis == 0.5);
+        REQUIRE(std::abs(star.epoch_peri - 2000.0) < 0.001);
+      }
+    }
+
+    WHEN("Orbit tracks are found for the first day of 1980") {
+      std::vector<CBinaryStarOrbitTrack> result =
+          paBinaryCatalogue.OrbitTracks({PABinary::EpochYear(1, 1, 1980)});
+
+      THEN("gamma-Vir and eta-Cor match binaryStarOrbitTrack") {
+        PABinary paBinary;
+        CBinaryStarOrbitTrack gammaVir = paBinary.binaryStarOrbitTrack(
+            "gamma-Vir", {PABinary::EpochYear(1, 1, 1980)});
+        CBinaryStarOrbitTrack etaCor = paBinary.binaryStarOrbitTrack(
+            "eta-Cor", {PABinary::EpochYear(1, 1, 1980)});
+
+        REQUIRE(result.size() == 3);
+        REQUIRE(result[0].positionAngleDeg[0] == gammaVir.positionAngleDeg[0]);
+        REQUIRE(result[0].separationArcsec[0] == gammaVir.separationArcsec[0]);
+        REQUIRE(result[1].positionAngleDeg[0] == etaCor.positionAngleDeg[0]);
+        REQUIRE(result[1].separationArcsec[0] == etaCor.separationArcsec[0]);
+      }
+    }
+
+    WHEN("The header claims so many records that their size wraps") {
+      paBinaryCatalogue.Close();
+      {
+        // count follows magic, byteOrder and recordSize; 80 * 2^60 is a
+        // multiple of 2^64.
+        std::fstream file(binaryPath,
+                          std::ios::in | std::ios::out | std::ios::binary);
+        uint64_t count = uint64_t(1) << 60;
+        file.seekp(16);
+        file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+      }
+
+      THEN("It is not opened") {
+        REQUIRE_FALSE(paBinaryCatalogue.Open(binaryPath));
+        REQUIRE(paBinaryCatalogue.size() == 0);
+      }
+    }
+
+    paBinaryCatalogue.Close();
+    std::remove(textPath.c_str());
+    std::remove(binaryPath.c_str());
+  }
+
+  GIVEN("A file that is not a binary catalogue") {
+    PABinaryCatalogue paBinaryCatalogue;
+
+    THEN("It is not opened") {
+      REQUIRE_FALSE(paBinaryCatalogue.Open("README.md"));
+      REQUIRE_FALSE(paBinaryCatalogue.Open("no_such_file.bin"));
+      REQUIRE(paBinaryCatalogue.size() == 0);
+      REQUIRE(PABinaryCatalogue::ConvertSixthCatalog("no_such_file.txt",
+                                                     "unused.bin") == -1);
+    }
+  }
+}
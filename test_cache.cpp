@@ -0,0 +1,134 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_cache.h"
+#include "lib/pa_models.h"
+#include "lib/pa_sun.h"
+#include "lib/pa_types.h"
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+SCENARIO("Cached Façade Results", "[cache]") {
+  GIVEN("A cache shared by the cached Sun, Moon and Planet façades") {
+    PAResultCache cache(64, 4);
+    PACachedSun cachedSun(cache);
+    PACachedMoon cachedMoon(cache);
+    PACachedPlanet cachedPlanet(cache);
+    PASun paSun;
+
+    WHEN("Sunrise and sunset for one place and date are asked for twice") {
+      CSunriseAndSunset first =
+          cachedSun.SunriseAndSunset(10, 3, 1986, false, -5, -71.05, 42.37);
+      CSunriseAndSunset second =
+          cachedSun.SunriseAndSunset(10, 3, 1986, false, -5, -71.05, 42.37);
+      CSunriseAndSunset expected =
+          paSun.SunriseAndSunset(10, 3, 1986, false, -5, -71.05, 42.37);
+
+      THEN("Both match PASun, and the second is a hit") {
+        REQUIRE(first.localSunsetHour == expected.localSunsetHour);
+        REQUIRE(first.localSunsetMinute == expected.localSunsetMinute);
+        REQUIRE(second.localSunsetHour == expected.localSunsetHour);
+        REQUIRE(second.localSunsetMinute == expected.localSunsetMinute);
+        REQUIRE(second.azimuthOfSunsetDeg == expected.azimuthOfSunsetDeg);
+        REQUIRE(cache.Stats().hits == 1);
+        REQUIRE(cache.Stats().misses == 1);
+        REQUIRE(cache.Stats().size == 1);
+      }
+    }
+
+    WHEN("Arguments differ by less than the resolution, or only in the "
+         "method or planet") {
+      cachedMoon.MoonPhase(12, 0, 0, false, -5, 1, 9, 2003,
+                           EAccuracyLevel::Precise);
+      cachedMoon.MoonPhase(12, 0, 0.0000001, false, -5, 1, 9, 2003,
+                           EAccuracyLevel::Precise);
+      cachedMoon.MoonPhase(12, 0, 0, false, -5, 1, 9, 2003,
+                           EAccuracyLevel::Approximate);
+      cachedPlanet.PrecisePositionOfPlanet(0, 0, 0, false, 0, 22, 11, 2003,
+                                           "Jupiter");
+      CPrecisePositionOfPlanet saturn = cachedPlanet.PrecisePositionOfPlanet(
+          0, 0, 0, false, 0, 22, 11, 2003, "Saturn");
+
+      THEN("Nearly equal arguments share a result, and the rest do not") {
+        REQUIRE(cache.Stats().hits == 1);
+        REQUIRE(cache.Stats().misses == 4);
+        REQUIRE(saturn.PlanetRAHour ==
+                PAPlanet()
+                    .PrecisePositionOfPlanet(0, 0, 0, false, 0, 22, 11, 2003,
+                                             "Saturn")
+                    .PlanetRAHour);
+      }
+    }
+
+    WHEN("A cache rounds the time of a call to the minute") {
+      PAResultCache coarse(64, 4, 1.0 / 60);
+      PACachedSun coarseSun(coarse);
+      coarseSun.ApproximatePositionOfSun(6, 0, 10, 27, 7, 2003, false, 0);
+      coarseSun.ApproximatePositionOfSun(6, 0, 20, 27, 7, 2003, false, 0);
+      coarseSun.ApproximatePositionOfSun(5, 59, 60, 27, 7, 2003, false, 0);
+      coarseSun.ApproximatePositionOfSun(6, 1, 0, 27, 7, 2003, false, 0);
+      coarseSun.SunriseAndSunset(10, 3, 1986, false, -5, -71.05, 42.37);
+      CSunriseAndSunset further =
+          coarseSun.SunriseAndSunset(10, 3, 1986, false, -5, -71.2, 42.37);
+
+      THEN("Calls in the same minute share a result, and sites do not") {
+        REQUIRE(coarse.Stats().hits == 2);
+        REQUIRE(coarse.Stats().misses == 4);
+        REQUIRE(further.localSunriseMinute ==
+                paSun.SunriseAndSunset(10, 3, 1986, false, -5, -71.2, 42.37)
+                    .localSunriseMinute);
+      }
+    }
+
+    WHEN("A cache is given no shards, or no resolution") {
+      THEN("It is refused") {
+        REQUIRE_THROWS_AS(PAResultCache(64, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(PAResultCache(64, 4, 0), std::invalid_argument);
+      }
+    }
+
+    WHEN("There are more shards than the capacity") {
+      PAResultCache small(2, 4);
+
+      THEN("Each shard still holds one result") {
+        REQUIRE(small.Stats().capacity == 4);
+      }
+    }
+
+    WHEN("More dates are asked for than the cache holds") {
+      for (int day = 1; day <= 28; day++)
+        for (int month = 1; month <= 12; month++)
+          cachedSun.EquationOfTime(day, month, 2010);
+
+      THEN("The oldest results are evicted and the size stays bounded") {
+        CCacheStats stats = cache.Stats();
+
+        REQUIRE(stats.capacity == 64);
+        REQUIRE(stats.size <= stats.capacity);
+        REQUIRE(stats.evictions == 28 * 12 - stats.size);
+
+        cache.Clear();
+        REQUIRE(cache.Stats().size == 0);
+        REQUIRE(cache.Stats().misses == 0);
+      }
+    }
+
+    WHEN("Several threads ask for the same few results") {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; t++)
+        threads.emplace_back([&cachedSun] {
+          for (int i = 0; i < 200; i++)
+            cachedSun.EquationOfTime(1 + i % 5, 6, 2020);
+        });
+      for (std::thread &thread : threads)
+        thread.join();
+
+      THEN("Every call is counted, and almost all are hits") {
+        CCacheStats stats = cache.Stats();
+
+        REQUIRE(stats.hits + stats.misses == 800);
+        REQUIRE(stats.size == 5);
+        REQUIRE(stats.hits >= 800 - 5 * 4);
+      }
+    }
+  }
+}
@@ -0,0 +1,60 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_catalogue.h"
+#include "lib/pa_coordinates.h"
+#include "lib/pa_macros.h"
+#include "lib/pa_models.h"
+#include "lib/pa_types.h"
+#include "lib/pa_util.h"
+#include <vector>
+
+using namespace pa_types;
+using namespace pa_models;
+using namespace pa_util;
+
+SCENARIO("Rising and setting for a catalogue of objects", "[catalogue]") {
+  GIVEN("A PACatalogue object") {
+    PACatalogue paCatalogue;
+
+    WHEN("Greenwich Date is 8/24/2010 and Geographical Long/Lat is 64/30, "
+         "for three objects") {
+      std::vector<double> raHours = {pa_macros::HmsToDh(23, 39, 20), 6.0,
+                                     12.0};
+      std::vector<double> decDeg = {
+          pa_macros::DegreesMinutesSecondsToDecimalDegrees(21, 42, 0), -75.0,
+          80.0};
+
+      CRiseSetCatalogue result = paCatalogue.RisingAndSetting(
+          raHours, decDeg, 24, 8, 2010, 64, 30, 0.5667);
+
+      THEN("The first object matches PACoordinates::RisingAndSetting, the "
+           "second never rises and the third is circumpolar") {
+        PACoordinates paCoordinates;
+        CRiseSet expected = paCoordinates.RisingAndSetting(
+            23, 39, 20, 21, 42, 0, 24, 8, 2010, 64, 30, 0.5667);
+        double utRise = result.utRiseHours[0] + 0.008333;
+        double utSet = result.utSetHours[0] + 0.008333;
+
+        REQUIRE(result.size() == 3);
+        REQUIRE(result.rsStatus[0] == expected.rsStatus);
+        REQUIRE(pa_macros::DecimalHoursHour(utRise) == expected.utRiseHour);
+        REQUIRE(pa_macros::DecimalHoursMinute(utRise) == expected.utRiseMin);
+        REQUIRE(pa_macros::DecimalHoursHour(utSet) == expected.utSetHour);
+        REQUIRE(pa_macros::DecimalHoursMinute(utSet) == expected.utSetMin);
+        REQUIRE(Round(result.azRiseDeg[0], 2) == expected.azRise);
+        REQUIRE(Round(result.azSetDeg[0], 2) == expected.azSet);
+
+        REQUIRE(result.rsStatus[1] == ERiseSetStatus::NeverRises);
+        REQUIRE(result.rsStatus[2] == ERiseSetStatus::Circumpolar);
+      }
+
+      THEN("Transit falls midway between rising and setting") {
+        double siderealDayHours = 24 * 0.9972695663;
+        double transit =
+            (result.utRiseHours[0] + result.utSetHours[0] + siderealDayHours) /
+            2;
+
+        REQUIRE(Round(result.utTransitHours[0], 4) == Round(transit, 4));
+      }
+    }
+  }
+}
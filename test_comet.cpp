@@ -1,10 +1,13 @@
 #include "catch2/catch.hpp"
 #include "lib/pa_comet.h"
 #include "lib/pa_data.h"
+#include "lib/pa_macros.h"
 #include "lib/pa_models.h"
 #include "lib/pa_types.h"
 #include "lib/pa_util.h"
+#include <cmath>
 #include <tuple>
+#include <vector>
 
 SCENARIO("Position of Elliptical Comet") {
   GIVEN("A PAComet object") {
@@ -54,4 +57,48 @@ SCENARIO("Position of Parabolic Comet") {
       }
     }
   }
-}
\ No newline at end of file
+}
+
+SCENARIO("Positions of Parabolic Comets") {
+  GIVEN("A PAComet object") {
+    PAComet paComet;
+
+    WHEN("Greenwich Date is 12/25/1977 and the comets are Kohler and three "
+         "copies of it passing perihelion 10, 100 and 1000 days later") {
+      pa_data::CometDataParabolic kohler =
+          pa_data::parabolicCometLookup("Kohler");
+      double perihelionJulianDate = pa_macros::CivilDateToJulianDate(
+          kohler.epoch_peri_day, kohler.epoch_peri_month,
+          kohler.epoch_peri_year);
+      std::vector<double> perihelionJulianDates = {
+          perihelionJulianDate, perihelionJulianDate + 10,
+          perihelionJulianDate + 100, perihelionJulianDate + 1000};
+      std::vector<double> q(4, kohler.peri_dist);
+      std::vector<double> incl(4, kohler.incl);
+      std::vector<double> argPeri(4, kohler.arg_peri);
+      std::vector<double> node(4, kohler.node);
+
+      CCometPositionCatalogue result = paComet.PositionsOfParabolicComets(
+          pa_macros::CivilDateToJulianDate(25, 12, 1977),
+          perihelionJulianDates, q, incl, argPeri, node);
+
+      THEN("Kohler matches PositionOfParabolicComet, and the others lie "
+           "further from the Sun the further they are from perihelion") {
+        CCometPosition expected = paComet.PositionOfParabolicComet(
+            0, 0, 0, false, 0, 25, 12, 1977, "Kohler");
+
+        REQUIRE(result.size() == 4);
+        REQUIRE(std::abs(result.raHours[0] -
+                         pa_macros::HmsToDh(expected.raHour, expected.raMin,
+                                            expected.raSec)) < 0.0001);
+        REQUIRE(std::abs(result.decDeg[0] -
+                         pa_macros::DegreesMinutesSecondsToDecimalDegrees(
+                             expected.decDeg, expected.decMin,
+                             expected.decSec)) < 0.001);
+        REQUIRE(result.sunDistanceAU[1] < result.sunDistanceAU[0]);
+        REQUIRE(result.sunDistanceAU[1] > kohler.peri_dist);
+        REQUIRE(result.sunDistanceAU[3] > result.sunDistanceAU[2]);
+      }
+    }
+  }
+}
@@ -0,0 +1,122 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_comet.h"
+#include "lib/pa_comet_catalogue.h"
+#include "lib/pa_macros.h"
+#include "lib/pa_models.h"
+#include <cmath>
+#include <sstream>
+#include <string>
+
+using namespace pa_models;
+
+SCENARIO("Comet catalogue", "[comet_catalogue]") {
+  GIVEN("A PACometCatalogue loaded from MPC one-line orbital elements") {
+    PACometCatalogue paCometCatalogue;
+    std::istringstream elements(
+        "0001P         1986 02  9.4589  0.574182  0.967856  112.2412   "
+        "59.4029  162.1900  19860205   4.0  6.0  1P/Halley                   "
+        "                              98, 83\n"
+        "\n"
+        "not an orbit\n"
+        "    CK77R010  1977 11 10.5659  0.990662  1.000000  163.4799  "
+        "181.8175   48.7196\n");
+
+    int added = paCometCatalogue.LoadOrbitalElements(elements);
+
+    WHEN("The catalogue is inspected") {
+      THEN("Both comets are read, by name or designation, and other lines "
+           "are skipped") {
+        REQUIRE(added == 2);
+        REQUIRE(paCometCatalogue.size() == 2);
+        REQUIRE(paCometCatalogue.Find("1P/Halley") == 0);
+        REQUIRE(paCometCatalogue.Find("CK77R010") == 1);
+        REQUIRE(paCometCatalogue.Find("Encke") == -1);
+        REQUIRE(paCometCatalogue.perihelionJulianDate[0] ==
+                pa_macros::CivilDateToJulianDate(9.4589, 2, 1986));
+        REQUIRE(paCometCatalogue.perihelionDistanceAU[0] == 0.574182);
+        REQUIRE(paCometCatalogue.eccentricity[1] == 1.0);
+        REQUIRE(paCometCatalogue.inclinationDeg[1] == 48.7196);
+      }
+    }
+
+    WHEN("Positions are found on Greenwich Date 12/25/1977") {
+      CCometPositionCatalogue result = paCometCatalogue.Positions(
+          pa_macros::CivilDateToJulianDate(25, 12, 1977));
+
+      THEN("The parabolic orbit matches PAComet::PositionOfParabolicComet "
+           "for Kohler") {
+        PAComet paComet;
+        CCometPosition expected = paComet.PositionOfParabolicComet(
+            0, 0, 0, false, 0, 25, 12, 1977, "Kohler");
+
+        REQUIRE(std::abs(result.raHours[1] -
+                         pa_macros::HmsToDh(expected.raHour, expected.raMin,
+                                            expected.raSec)) < 0.0001);
+        REQUIRE(std::abs(result.decDeg[1] -
+                         pa_macros::DegreesMinutesSecondsToDecimalDegrees(
+                             expected.decDeg, expected.decMin,
+                             expected.decSec)) < 0.001);
+      }
+    }
+  }
+
+  GIVEN("A PACometCatalogue with Halley's comet from the book's elements") {
+    PACometCatalogue paCometCatalogue;
+    double axisAU = 17.9435;
+    double eccentricity = 0.9673;
+
+    paCometCatalogue.Add("Halley",
+                         pa_macros::CivilDateToJulianDate(0, 1, 1986) +
+                             0.112 * 365.242191,
+                         axisAU * (1 - eccentricity), eccentricity,
+                         170.011 - 58.154, 58.154, 162.2384);
+
+    WHEN("Positions are found on Greenwich Date 1/1/1984") {
+      CCometPositionCatalogue result = paCometCatalogue.Positions(
+          pa_macros::CivilDateToJulianDate(1, 1, 1984));
+
+      THEN("Right Ascension is 6h 29m and Declination is 10d 13m, as given "
+           "by PAComet::PositionOfEllipticalComet, near opposition") {
+        REQUIRE(std::abs(result.raHours[0] - pa_macros::HmsToDh(6, 29, 0)) <
+                0.01);
+        REQUIRE(std::abs(result.decDeg[0] -
+                         pa_macros::DegreesMinutesSecondsToDecimalDegrees(
+                             10, 13, 0)) < 0.02);
+        REQUIRE(std::abs(result.earthDistanceAU[0] -
+                         (result.sunDistanceAU[0] - 0.983)) < 0.05);
+      }
+    }
+  }
+
+  GIVEN("A PACometCatalogue of 5000 elliptical, parabolic and hyperbolic "
+        "orbits") {
+    PACometCatalogue paCometCatalogue;
+
+    for (int i = 0; i < 5000; i++)
+      paCometCatalogue.Add(std::to_string(i), 2450000.0 + i * 0.37,
+                           0.3 + (i % 40) * 0.1, (i % 3) * 0.6 + 0.4,
+                           (i * 7) % 360, (i * 13) % 360, (i * 3) % 180);
+
+    WHEN("Positions are found with one thread, with four, and on a shared "
+         "pool") {
+      double julianDate = 2451545.0;
+      PATaskPool pool(3);
+      CCometPositionCatalogue single =
+          paCometCatalogue.Positions(julianDate, 1);
+      CCometPositionCatalogue threaded =
+          paCometCatalogue.Positions(julianDate, 4);
+      CCometPositionCatalogue pooled =
+          paCometCatalogue.Positions(julianDate, pool);
+
+      THEN("The results are identical") {
+        REQUIRE(single.size() == 5000);
+        REQUIRE(threaded.raHours == single.raHours);
+        REQUIRE(threaded.decDeg == single.decDeg);
+        REQUIRE(threaded.earthDistanceAU == single.earthDistanceAU);
+        REQUIRE(pooled.raHours == single.raHours);
+        REQUIRE(pooled.decDeg == single.decDeg);
+        REQUIRE(pooled.earthDistanceAU == single.earthDistanceAU);
+      }
+    }
+  }
+}
@@ -1,5 +1,6 @@
 #include "catch2/catch.hpp"
 #include "lib/pa_coordinates.h"
+#include "lib/pa_macros.h"
 #include "lib/pa_models.h"
 #include "lib/pa_types.h"
 #include "lib/pa_util.h"
@@ -317,6 +318,34 @@ SCENARIO("Nutation in Ecliptic Longitude and Obliquity", "[coordinates]") {
   }
 }
 
+SCENARIO("Precise Nutation for a Greenwich Date", "[coordinates]") {
+  GIVEN("Greenwich date is 9/1/1988") {
+    WHEN("Nutation in longitude and obliquity is found together") {
+      CNutation result = pa_macros::Nutation(1, 9, 1988);
+
+      THEN("Longitude is .0014243 and Obliquity is .0025596, as from "
+           "NutatLong and NutatObl") {
+        REQUIRE(Round(result.nutInLongDeg, 7) == 0.0014243);
+        REQUIRE(Round(result.nutInOblDeg, 7) == 0.0025596);
+        REQUIRE(pa_macros::NutatLong(1, 9, 1988) == result.nutInLongDeg);
+        REQUIRE(pa_macros::NutatObl(1, 9, 1988) == result.nutInOblDeg);
+      }
+    }
+
+    WHEN("It is found again after other dates have filled the cache") {
+      CNutation first = pa_macros::Nutation(1, 9, 1988);
+      for (int day = 2; day < 10; day++)
+        pa_macros::Nutation(day, 9, 1988);
+      CNutation again = pa_macros::Nutation(1, 9, 1988);
+
+      THEN("The result is unchanged") {
+        REQUIRE(again.nutInLongDeg == first.nutInLongDeg);
+        REQUIRE(again.nutInOblDeg == first.nutInOblDeg);
+      }
+    }
+  }
+}
+
 SCENARIO("Correct ecliptic coordinates for the effects of aberration.") {
   GIVEN("A PACoordinates object") {
     PACoordinates paCoordinates;
@@ -0,0 +1,160 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_ephemeris_table.h"
+#include "lib/pa_macros.h"
+#include "lib/pa_raw.h"
+#include "lib/pa_util.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+SCENARIO("Ephemeris Tables", "[ephemeris_table]") {
+  GIVEN("A table of the Sun every hour from 1/1/2024, for 40N 75W") {
+    std::string path = "test_ephemeris_table.bin";
+    double start = pa_macros::CivilDateToJulianDate(1, 1, 2024);
+    double step = 1.0 / 24;
+
+    PAEphemerisWriter writer;
+    bool created = writer.Create(path, "Sun", -75, 40, start, step);
+
+    std::vector<pa_raw::SunPosition> first, second;
+    for (int i = 0; i < 30; i++)
+      first.push_back(pa_raw::Sun(start + step * i));
+    for (int i = 30; i < 48; i++)
+      second.push_back(pa_raw::Sun(start + step * i));
+
+    WHEN("Positions are appended, some after the table is reopened") {
+      bool appended = writer.Append(first);
+      writer.Close();
+      bool reopened = writer.Open(path);
+      appended = appended && writer.Append(second);
+      writer.Close();
+
+      PAEphemerisTable table;
+      bool opened = table.Open(path);
+
+      THEN("The table has the header and positions written") {
+        REQUIRE(created);
+        REQUIRE(appended);
+        REQUIRE(reopened);
+        REQUIRE(opened);
+
+        REQUIRE(table.Body() == "Sun");
+        REQUIRE(table.GeogLongDeg() == -75);
+        REQUIRE(table.GeogLatDeg() == 40);
+        REQUIRE(table.StartJulianDate() == start);
+        REQUIRE(table.StepDays() == step);
+        REQUIRE(table.ColumnNames() == PAEphemerisWriter::PositionColumns());
+        REQUIRE(table.size() == 48);
+
+        PAColumnSpan ra = table.Column("raRad");
+        PAColumnSpan distance = table.Column("distance");
+        PAColumnSpan altitude = table.Column("altitudeRad");
+        PAColumnSpan azimuth = table.Column("azimuthRad");
+        REQUIRE(ra.size() == 48);
+        for (int i = 0; i < 48; i++) {
+          pa_raw::SunPosition sun = pa_raw::Sun(table.JulianDate(i));
+          REQUIRE(ra[i] == sun.raRad);
+          REQUIRE(table.Column(1)[i] == sun.decRad);
+          REQUIRE(distance[i] == sun.distanceKm);
+
+          double lstHours = pa_raw::LocalSiderealTime(
+              table.JulianDate(i), pa_util::DegreesToRadians(-75));
+          pa_raw::HorizonCoordinates horizon = pa_raw::EquatorialToHorizon(
+              pa_util::DegreesToRadians(lstHours * 15) - sun.raRad,
+              sun.decRad, pa_util::DegreesToRadians(40));
+          REQUIRE(altitude[i] == horizon.altitudeRad);
+          REQUIRE(azimuth[i] == horizon.azimuthRad);
+        }
+        REQUIRE(table.Column("magnitude").empty());
+      }
+    }
+
+    std::remove(path.c_str());
+  }
+
+  GIVEN("A table of two columns appended past its capacity") {
+    std::string path = "test_ephemeris_table_grow.bin";
+    PAEphemerisWriter writer;
+    bool created = writer.Create(path, "Test", 0, 0, 2451545.0, 1.0 / 1440,
+                                 {"row", "square"});
+
+    WHEN("The header claims a capacity so large that the columns wrap") {
+      writer.Close();
+      {
+        // rowCapacity follows magic, byteOrder, columnCount and rowCount;
+        // 8 * 2^61 is a multiple of 2^64.
+        std::fstream file(path,
+                          std::ios::in | std::ios::out | std::ios::binary);
+        uint64_t capacity = uint64_t(1) << 61;
+        file.seekp(24);
+        file.write(reinterpret_cast<const char *>(&capacity),
+                   sizeof(capacity));
+      }
+
+      THEN("It is not opened, for reading or appending") {
+        PAEphemerisTable table;
+        REQUIRE(created);
+        REQUIRE_FALSE(table.Open(path));
+        REQUIRE_FALSE(writer.Open(path));
+      }
+    }
+
+    WHEN("Ten thousand rows are appended in blocks of 3000") {
+      bool appended = true;
+      for (int block = 0; block < 10000; block += 3000) {
+        std::vector<double> row, square;
+        for (int i = block; i < std::min(block + 3000, 10000); i++) {
+          row.push_back(i);
+          square.push_back((double)i * i);
+        }
+        appended = appended && writer.AppendColumns({row, square});
+      }
+      bool wrongColumns = writer.AppendColumns({{1.0}});
+      bool noPositions = writer.Append(std::vector<pa_raw::SunPosition>(1));
+      writer.Close();
+
+      PAEphemerisTable table;
+      bool opened = table.Open(path);
+
+      THEN("Every row is read back, in order") {
+        REQUIRE(created);
+        REQUIRE(appended);
+        REQUIRE_FALSE(wrongColumns);
+        REQUIRE_FALSE(noPositions);
+        REQUIRE(opened);
+        REQUIRE(table.size() == 10000);
+
+        PAColumnSpan row = table.Column("row");
+        PAColumnSpan square = table.Column("square");
+        bool same = true;
+        for (int i = 0; i < 10000; i++)
+          same = same && row[i] == i && square[i] == (double)i * i;
+        REQUIRE(same);
+      }
+    }
+
+    std::remove(path.c_str());
+  }
+
+  GIVEN("A file that is not a table") {
+    std::string path = "test_ephemeris_table_bad.bin";
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    std::fputs("not an ephemeris table, but long enough to hold a header "
+               "of ninety-six bytes, more or less.",
+               file);
+    std::fclose(file);
+
+    THEN("It is not opened") {
+      PAEphemerisTable table;
+      PAEphemerisWriter writer;
+      REQUIRE_FALSE(table.Open(path));
+      REQUIRE_FALSE(writer.Open(path));
+      REQUIRE_FALSE(table.Open("no_such_table.bin"));
+      REQUIRE(table.Column(0).empty());
+    }
+
+    std::remove(path.c_str());
+  }
+}
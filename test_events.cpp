@@ -0,0 +1,134 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_events.h"
+#include "lib/pa_macros.h"
+#include "lib/pa_models.h"
+#include "lib/pa_parallel.h"
+#include "lib/pa_types.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace pa_types;
+using namespace pa_models;
+
+namespace {
+/**
+ * \brief Find the first event of a type for a planet after a given date
+ * (nullptr if none).
+ */
+const CPlanetaryEvent *FindEvent(const std::vector<CPlanetaryEvent> &events,
+                                 const std::string &planetName,
+                                 EPlanetaryEventType eventType,
+                                 double afterJulianDate = 0) {
+  for (const CPlanetaryEvent &event : events)
+    if (event.planetName == planetName && event.eventType == eventType &&
+        event.julianDate > afterJulianDate)
+      return &event;
+
+  return nullptr;
+}
+} // namespace
+
+SCENARIO("Scalar events", "[events]") {
+  GIVEN("A PAEvents object") {
+    PAEvents paEvents;
+
+    WHEN("Zero crossings and extrema of sin(2 pi t / 10) are searched over "
+         "0 to 20 days") {
+      auto f = [](double t) { return sin(2 * M_PI * t / 10); };
+      std::vector<CScalarEvent> crossings =
+          paEvents.ZeroCrossings(f, 0.5, 20, 1.0);
+      std::vector<CScalarEvent> extrema = paEvents.Extrema(f, 0, 20, 1.0);
+
+      THEN("Crossings are at 5, 10 and 15 and extrema at 2.5, 7.5, 12.5 and "
+           "17.5") {
+        REQUIRE(crossings.size() == 3);
+        REQUIRE(std::abs(crossings[0].julianDate - 5) < 0.001);
+        REQUIRE(crossings[0].direction == -1);
+        REQUIRE(std::abs(crossings[1].julianDate - 10) < 0.001);
+        REQUIRE(crossings[1].direction == 1);
+        REQUIRE(std::abs(crossings[2].julianDate - 15) < 0.001);
+
+        REQUIRE(extrema.size() == 4);
+        REQUIRE(std::abs(extrema[0].julianDate - 2.5) < 0.001);
+        REQUIRE(extrema[0].direction == 1);
+        REQUIRE(std::abs(extrema[1].julianDate - 7.5) < 0.001);
+        REQUIRE(extrema[1].direction == -1);
+      }
+    }
+  }
+}
+
+SCENARIO("Planetary events", "[events]") {
+  GIVEN("A PAEvents object") {
+    PAEvents paEvents;
+
+    WHEN("Events for Venus and Mars are searched from 1/1/2003 to 1/1/2005") {
+      std::vector<CPlanetaryEvent> result = paEvents.PlanetaryEvents(
+          {"Venus", "Mars"}, pa_macros::CivilDateToJulianDate(1, 1, 2003),
+          pa_macros::CivilDateToJulianDate(1, 1, 2005), 2);
+
+      THEN("The events are in time order and match the published dates") {
+        for (int i = 1; i < result.size(); i++)
+          REQUIRE(result[i - 1].julianDate <= result[i].julianDate);
+
+        const CPlanetaryEvent *opposition =
+            FindEvent(result, "Mars", EPlanetaryEventType::Opposition);
+        const CPlanetaryEvent *retrograde = FindEvent(
+            result, "Mars", EPlanetaryEventType::StationaryRetrograde);
+        const CPlanetaryEvent *direct =
+            FindEvent(result, "Mars", EPlanetaryEventType::StationaryDirect);
+        const CPlanetaryEvent *inferior = FindEvent(
+            result, "Venus", EPlanetaryEventType::InferiorConjunction);
+        const CPlanetaryEvent *east = FindEvent(
+            result, "Venus", EPlanetaryEventType::GreatestElongationEast);
+        const CPlanetaryEvent *west =
+            FindEvent(result, "Venus",
+                      EPlanetaryEventType::GreatestElongationWest,
+                      pa_macros::CivilDateToJulianDate(1, 1, 2004));
+
+        REQUIRE(opposition != nullptr);
+        REQUIRE(std::abs(opposition->julianDate -
+                         pa_macros::CivilDateToJulianDate(28.75, 8, 2003)) <
+                0.5);
+        REQUIRE(retrograde != nullptr);
+        REQUIRE(std::abs(retrograde->julianDate -
+                         pa_macros::CivilDateToJulianDate(30, 7, 2003)) < 2);
+        REQUIRE(direct != nullptr);
+        REQUIRE(std::abs(direct->julianDate -
+                         pa_macros::CivilDateToJulianDate(29, 9, 2003)) < 3);
+        REQUIRE(direct->julianDate > opposition->julianDate);
+        REQUIRE(inferior != nullptr);
+        REQUIRE(std::abs(inferior->julianDate -
+                         pa_macros::CivilDateToJulianDate(8.36, 6, 2004)) <
+                0.5);
+        REQUIRE(east != nullptr);
+        REQUIRE(std::abs(east->julianDate -
+                         pa_macros::CivilDateToJulianDate(29, 3, 2004)) < 1.5);
+        REQUIRE(std::abs(east->value - 46.0) < 0.5);
+        REQUIRE(west != nullptr);
+        REQUIRE(std::abs(west->julianDate -
+                         pa_macros::CivilDateToJulianDate(17, 8, 2004)) < 1.5);
+      }
+    }
+
+    WHEN("The same search is run on a shared pool of three workers") {
+      double start = pa_macros::CivilDateToJulianDate(1, 1, 2003);
+      double end = pa_macros::CivilDateToJulianDate(1, 1, 2005);
+      PATaskPool pool(3);
+      std::vector<CPlanetaryEvent> pooled =
+          paEvents.PlanetaryEvents({"Venus", "Mars"}, start, end, pool);
+      std::vector<CPlanetaryEvent> single =
+          paEvents.PlanetaryEvents({"Venus", "Mars"}, start, end, 1);
+
+      THEN("It finds the same events") {
+        REQUIRE(pooled.size() == single.size());
+        for (std::size_t i = 0; i < pooled.size(); i++) {
+          REQUIRE(pooled[i].planetName == single[i].planetName);
+          REQUIRE(pooled[i].eventType == single[i].eventType);
+          REQUIRE(pooled[i].julianDate == single[i].julianDate);
+        }
+      }
+    }
+  }
+}
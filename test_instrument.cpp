@@ -0,0 +1,45 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_instrument.h"
+#include "lib/pa_macros.h"
+#include <string>
+#include <vector>
+
+using namespace pa_instrument;
+
+SCENARIO("Hot Path Instrumentation", "[instrument]") {
+  GIVEN("Counters reset to zero") {
+    Reset();
+
+    WHEN("The Sun's longitude and a moonrise are found once each") {
+      pa_macros::SunLong(0, 0, 0, 0, 0, 27, 7, 1988);
+      pa_macros::MoonRiseLCT(6, 3, 1986, 0, -5, -71.05, 42.3667);
+      std::vector<FunctionStats> stats = Snapshot();
+
+      THEN("With instrumentation built in, each is counted once and the "
+           "moonrise loop eight times; without it, nothing is counted") {
+        const FunctionStats &sunLong =
+            stats[static_cast<int>(EFunction::SunLong)];
+        const FunctionStats &moonRise =
+            stats[static_cast<int>(EFunction::MoonRiseLCT)];
+
+        REQUIRE(stats.size() == static_cast<std::size_t>(EFunction::Count));
+        REQUIRE(sunLong.name == "SunLong");
+
+        if (IsEnabled()) {
+          REQUIRE(sunLong.calls == 1);
+          REQUIRE(sunLong.maxNs <= sunLong.totalNs);
+          REQUIRE(moonRise.calls == 1);
+          REQUIRE(moonRise.iterations == 8);
+          REQUIRE(stats[static_cast<int>(EFunction::NutatLong)].calls > 1);
+          REQUIRE(ToText(stats).find("MoonRiseLCT") != std::string::npos);
+        } else {
+          for (const FunctionStats &entry : stats)
+            REQUIRE(entry.calls == 0);
+        }
+
+        REQUIRE(ToJson(stats).find("{\"name\": \"SunLong\", \"calls\": ") !=
+                std::string::npos);
+      }
+    }
+  }
+}
@@ -0,0 +1,141 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_eclipses.h"
+#include "lib/pa_lunation_cache.h"
+#include "lib/pa_macros.h"
+#include "lib/pa_models.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace {
+void RequireSameLunar(const CLunarEclipseCircumstances &a,
+                      const CLunarEclipseCircumstances &b) {
+  REQUIRE(a.certainDateDay == b.certainDateDay);
+  REQUIRE(a.certainDateMonth == b.certainDateMonth);
+  REQUIRE(a.certainDateYear == b.certainDateYear);
+  REQUIRE(a.utStartPenPhaseHour == b.utStartPenPhaseHour);
+  REQUIRE(a.utStartPenPhaseMinutes == b.utStartPenPhaseMinutes);
+  REQUIRE(a.utStartUmbralPhaseHour == b.utStartUmbralPhaseHour);
+  REQUIRE(a.utStartUmbralPhaseMinutes == b.utStartUmbralPhaseMinutes);
+  REQUIRE(a.utStartTotalPhaseHour == b.utStartTotalPhaseHour);
+  REQUIRE(a.utStartTotalPhaseMinutes == b.utStartTotalPhaseMinutes);
+  REQUIRE(a.utMidEclipseHour == b.utMidEclipseHour);
+  REQUIRE(a.utMidEclipseMinutes == b.utMidEclipseMinutes);
+  REQUIRE(a.utEndTotalPhaseHour == b.utEndTotalPhaseHour);
+  REQUIRE(a.utEndTotalPhaseMinutes == b.utEndTotalPhaseMinutes);
+  REQUIRE(a.utEndUmbralPhaseHour == b.utEndUmbralPhaseHour);
+  REQUIRE(a.utEndUmbralPhaseMinutes == b.utEndUmbralPhaseMinutes);
+  REQUIRE(a.utEndPenPhaseHour == b.utEndPenPhaseHour);
+  REQUIRE(a.utEndPenPhaseMinutes == b.utEndPenPhaseMinutes);
+  REQUIRE(a.eclipseMagnitude == b.eclipseMagnitude);
+}
+
+void RequireSameSolar(const CSolarEclipseCircumstances &a,
+                      const CSolarEclipseCircumstances &b) {
+  REQUIRE(a.certainDateDay == b.certainDateDay);
+  REQUIRE(a.certainDateMonth == b.certainDateMonth);
+  REQUIRE(a.certainDateYear == b.certainDateYear);
+  REQUIRE(a.utFirstContactHour == b.utFirstContactHour);
+  REQUIRE(a.utFirstContactMinutes == b.utFirstContactMinutes);
+  REQUIRE(a.utMidEclipseHour == b.utMidEclipseHour);
+  REQUIRE(a.utMidEclipseMinutes == b.utMidEclipseMinutes);
+  REQUIRE(a.utLastContactHour == b.utLastContactHour);
+  REQUIRE(a.utLastContactMinutes == b.utLastContactMinutes);
+  REQUIRE(a.eclipseMagnitude == b.eclipseMagnitude);
+}
+} // namespace
+
+SCENARIO("Lunation Cache", "[lunation_cache]") {
+  GIVEN("A lunation table for 2015, with solar eclipses at 0, 68.65") {
+    std::string path = "test_lunation_cache.bin";
+    int written = PALunationCache::Generate(path, 2015, 2015, 0, 68.65);
+
+    PALunationCache paLunationCache;
+    bool opened = paLunationCache.Open(path);
+    PAEclipses paEclipses;
+
+    WHEN("The table is opened") {
+      THEN("It holds the lunations of the year") {
+        REQUIRE(written >= 12);
+        REQUIRE(written <= 14);
+        REQUIRE(opened);
+        REQUIRE(paLunationCache.size() == (std::size_t)written);
+        REQUIRE(paLunationCache.Find(pa_macros::LunationNumber(
+                    0, 0, 15, 6, 2015)) >= 0);
+        REQUIRE(paLunationCache.Find(pa_macros::LunationNumber(
+                    0, 0, 15, 6, 2016)) == -1);
+      }
+    }
+
+    WHEN("New and full Moons are asked for through the year") {
+      THEN("They match pa_macros") {
+        for (int month = 1; month <= 12; month++) {
+          REQUIRE(paLunationCache.NewMoon(0, -5, 10, month, 2015) ==
+                  pa_macros::NewMoon(0, -5, 10, month, 2015));
+          REQUIRE(paLunationCache.FullMoon(1, 10, 25, month, 2015) ==
+                  pa_macros::FullMoon(1, 10, 25, month, 2015));
+        }
+      }
+    }
+
+    WHEN("Eclipse circumstances are asked for") {
+      THEN("They match PAEclipses, from the table or computed") {
+        RequireSameLunar(
+            paLunationCache.LunarEclipseCircumstances(1, 4, 2015, false, 10),
+            paEclipses.LunarEclipseCircumstances(1, 4, 2015, false, 10));
+        RequireSameSolar(paLunationCache.SolarEclipseCircumstances(
+                             20, 3, 2015, false, 0, 0, 68.65),
+                         paEclipses.SolarEclipseCircumstances(
+                             20, 3, 2015, false, 0, 0, 68.65));
+
+        RequireSameSolar(paLunationCache.SolarEclipseCircumstances(
+                             20, 3, 2015, false, 0, 10, 50),
+                         paEclipses.SolarEclipseCircumstances(
+                             20, 3, 2015, false, 0, 10, 50));
+        RequireSameLunar(
+            paLunationCache.LunarEclipseCircumstances(28, 9, 2030, false, 0),
+            paEclipses.LunarEclipseCircumstances(28, 9, 2030, false, 0));
+      }
+    }
+
+    WHEN("The table was written by another algorithm version") {
+      {
+        // algorithmVersion follows magic, byteOrder and recordSize.
+        std::fstream file(path,
+                          std::ios::in | std::ios::out | std::ios::binary);
+        uint32_t version = PALunationCache::kAlgorithmVersion + 1;
+        file.seekp(16);
+        file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+      }
+
+      THEN("It is not opened, and queries are computed") {
+        REQUIRE_FALSE(paLunationCache.Open(path));
+        REQUIRE_FALSE(paLunationCache.IsOpen());
+        REQUIRE(paLunationCache.NewMoon(0, 0, 10, 5, 2015) ==
+                pa_macros::NewMoon(0, 0, 10, 5, 2015));
+        RequireSameLunar(
+            paLunationCache.LunarEclipseCircumstances(1, 4, 2015, false, 10),
+            paEclipses.LunarEclipseCircumstances(1, 4, 2015, false, 10));
+      }
+    }
+
+    WHEN("The header claims more records than the file holds") {
+      {
+        // count follows the span of years.
+        std::fstream file(path,
+                          std::ios::in | std::ios::out | std::ios::binary);
+        uint32_t count = UINT32_MAX;
+        file.seekp(28);
+        file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+      }
+
+      THEN("It is not opened") {
+        REQUIRE_FALSE(paLunationCache.Open(path));
+        REQUIRE_FALSE(paLunationCache.IsOpen());
+      }
+    }
+
+    std::remove(path.c_str());
+  }
+}
@@ -1,10 +1,14 @@
 #include "catch2/catch.hpp"
 #include "lib/pa_data.h"
+#include "lib/pa_macros.h"
 #include "lib/pa_models.h"
 #include "lib/pa_moon.h"
 #include "lib/pa_types.h"
 #include "lib/pa_util.h"
+#include <algorithm>
+#include <cmath>
 #include <tuple>
+#include <vector>
 
 SCENARIO("Approximate Position of Moon") {
   GIVEN("A PAMoon object") {
@@ -161,3 +165,104 @@ SCENARIO("") {
     }
   }
 }
+
+SCENARIO("Seeded Moonrise and Moonset") {
+  GIVEN("Geographical Longitude/Latitude -71.05d/42.3667d, Zone Correction "
+        "-5") {
+    WHEN("Moonrise and moonset on 3/6/1986 are seeded at local noon with "
+         "the default limits") {
+      CMoonRiseSetEvent rise = pa_macros::MoonRiseEvent(12, 6, 3, 1986, 0, -5,
+                                                        -71.05, 42.3667);
+      CMoonRiseSetEvent set = pa_macros::MoonSetEvent(12, 6, 3, 1986, 0, -5,
+                                                      -71.05, 42.3667);
+
+      THEN("They match the fixed eight-step iteration exactly") {
+        CFullDatePrecise riseDate =
+            pa_macros::MoonRiseLCDMY(6, 3, 1986, 0, -5, -71.05, 42.3667);
+
+        REQUIRE(rise.localTimeHours ==
+                pa_macros::MoonRiseLCT(6, 3, 1986, 0, -5, -71.05, 42.3667));
+        REQUIRE(rise.localDateDay == riseDate.day);
+        REQUIRE(rise.localDateMonth == riseDate.month);
+        REQUIRE(rise.localDateYear == riseDate.year);
+        REQUIRE(rise.azimuthDeg ==
+                pa_macros::MoonRiseAz(6, 3, 1986, 0, -5, -71.05, 42.3667));
+        REQUIRE(set.localTimeHours ==
+                pa_macros::MoonSetLCT(6, 3, 1986, 0, -5, -71.05, 42.3667));
+        REQUIRE(set.azimuthDeg ==
+                pa_macros::MoonSetAz(6, 3, 1986, 0, -5, -71.05, 42.3667));
+        REQUIRE(rise.iterations == 9);
+      }
+    }
+
+    WHEN("Moonrise on 3/7/1986 is seeded from the day before, with a "
+         "tolerance of 0.0001 hours") {
+      double seed =
+          pa_macros::MoonRiseLCT(6, 3, 1986, 0, -5, -71.05, 42.3667) + 0.84;
+      CMoonRiseSetEvent result = pa_macros::MoonRiseEvent(
+          seed, 7, 3, 1986, 0, -5, -71.05, 42.3667, 0.0001, 8);
+
+      THEN("It converges in fewer steps, within a second of the full "
+           "iteration") {
+        REQUIRE(result.isConverged);
+        REQUIRE(result.iterations < 9);
+        REQUIRE(std::abs(result.localTimeHours -
+                         pa_macros::MoonRiseLCT(7, 3, 1986, 0, -5, -71.05,
+                                                42.3667)) < 1.0 / 3600);
+      }
+    }
+  }
+}
+
+SCENARIO("Lunar Series at Many Instants") {
+  GIVEN("Julian dates every 0.37 days from 1/1/2000, for 100 instants") {
+    std::vector<double> julianDates;
+    for (int i = 0; i < 100; i++)
+      julianDates.push_back(2451544.5 + i * 0.37);
+
+    WHEN("The full series is evaluated for all instants at once") {
+      std::vector<CMoonLongLatHP> result =
+          pa_macros::MoonLongLatHPBatch(julianDates);
+
+      THEN("Each instant matches MoonLongLatHP for its Greenwich date and "
+           "time") {
+        REQUIRE(result.size() == julianDates.size());
+
+        for (std::size_t i = 0; i < julianDates.size(); i++) {
+          CGreenwichDateTime g =
+              pa_macros::JulianDateToGreenwichDateTime(julianDates[i]);
+          CMoonLongLatHP expected = pa_macros::MoonLongLatHP(
+              g.utHours, 0, 0, 0, 0, g.day, g.month, g.year);
+
+          REQUIRE(std::abs(result[i].longitudeDegrees -
+                           expected.longitudeDegrees) < 0.0000001);
+          REQUIRE(std::abs(result[i].latitudeDegrees -
+                           expected.latitudeDegrees) < 0.0000001);
+          REQUIRE(std::abs(result[i].horizontalParallax -
+                           expected.horizontalParallax) < 0.0000001);
+        }
+      }
+    }
+
+    WHEN("The series is truncated to terms of 0.001 degrees and more") {
+      std::vector<CMoonLongLatHP> full =
+          pa_macros::MoonLongLatHPBatch(julianDates);
+      std::vector<CMoonLongLatHP> truncated =
+          pa_macros::MoonLongLatHPBatch(julianDates, 0.001);
+
+      THEN("Longitude and latitude stay within 0.02 degrees of the full "
+           "series") {
+        for (std::size_t i = 0; i < julianDates.size(); i++) {
+          double longitudeError = std::abs(truncated[i].longitudeDegrees -
+                                           full[i].longitudeDegrees);
+
+          REQUIRE(std::min(longitudeError, 360 - longitudeError) < 0.02);
+          REQUIRE(std::abs(truncated[i].latitudeDegrees -
+                           full[i].latitudeDegrees) < 0.02);
+          REQUIRE(std::abs(truncated[i].horizontalParallax -
+                           full[i].horizontalParallax) < 0.002);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,118 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_models.h"
+#include "lib/pa_moon.h"
+#include "lib/pa_parallel.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+/**
+ * \brief Scratch that counts its calls and notes which thread made them.
+ */
+struct CountingScratch {
+  int calls = 0;
+  std::thread::id owner;
+  bool shared = false;
+
+  void Use() {
+    if (calls > 0 && owner != std::this_thread::get_id())
+      shared = true;
+    owner = std::this_thread::get_id();
+    calls++;
+  }
+};
+} // namespace
+
+SCENARIO("Parallel Bulk Jobs", "[parallel]") {
+  GIVEN("Sites from the equator to the Arctic, and a month of dates") {
+    std::vector<CObservingSite> sites = {
+        CObservingSite(-71.05, 42.37, false, -5),
+        CObservingSite(0, 0, false, 0), CObservingSite(18.95, 69.65, false, 1)};
+    std::vector<CMonthDayYear> dates;
+    for (int day = 1; day <= 30; day++)
+      dates.push_back(CMonthDayYear(6, day, 2021));
+
+    auto moonrise = [](PAWorkerFacades &facades, const CObservingSite &site,
+                       const CMonthDayYear &date) {
+      return facades.moon.MoonriseAndMoonset(
+          date.day, date.month, date.year, site.isDaylightSaving,
+          site.zoneCorrectionHours, site.geogLongDeg, site.geogLatDeg);
+    };
+
+    WHEN("Moonrise and moonset are found with one worker and with four") {
+      PATaskPool single(1);
+      PATaskPool four(4);
+      std::vector<CMoonRiseSet> serial =
+          ParallelForEach(single, sites, dates, moonrise);
+      std::vector<CMoonRiseSet> parallel =
+          ParallelForEach(four, sites, dates, moonrise);
+
+      THEN("Both match PAMoon, site by site and date by date") {
+        REQUIRE(four.WorkerCount() == 4);
+        REQUIRE(serial.size() == sites.size() * dates.size());
+        REQUIRE(parallel.size() == serial.size());
+
+        PAMoon paMoon;
+        for (std::size_t s = 0; s < sites.size(); s++)
+          for (std::size_t d = 0; d < dates.size(); d++) {
+            CMoonRiseSet expected = paMoon.MoonriseAndMoonset(
+                dates[d].day, dates[d].month, dates[d].year, false,
+                sites[s].zoneCorrectionHours, sites[s].geogLongDeg,
+                sites[s].geogLatDeg);
+            const CMoonRiseSet &fromSerial = serial[s * dates.size() + d];
+            const CMoonRiseSet &fromParallel = parallel[s * dates.size() + d];
+
+            REQUIRE(fromSerial.mrLocalTimeHour == expected.mrLocalTimeHour);
+            REQUIRE(fromSerial.mrLocalTimeMin == expected.mrLocalTimeMin);
+            REQUIRE(fromParallel.mrLocalTimeHour == expected.mrLocalTimeHour);
+            REQUIRE(fromParallel.mrLocalTimeMin == expected.mrLocalTimeMin);
+            REQUIRE(fromParallel.msLocalTimeHour == expected.msLocalTimeHour);
+            REQUIRE(fromParallel.msLocalTimeMin == expected.msLocalTimeMin);
+            REQUIRE(fromParallel.mrAzimuthDeg == expected.mrAzimuthDeg);
+          }
+      }
+    }
+
+    WHEN("Each worker is given its own scratch") {
+      PATaskPool pool(4);
+      std::vector<bool> shared = ParallelForEach<CountingScratch>(
+          pool, sites, dates,
+          [](CountingScratch &scratch, const CObservingSite &,
+             const CMonthDayYear &) {
+            scratch.Use();
+            return scratch.shared;
+          });
+
+      THEN("No scratch is used by two threads") {
+        REQUIRE(shared.size() == sites.size() * dates.size());
+        for (bool wasShared : shared)
+          REQUIRE_FALSE(wasShared);
+      }
+    }
+  }
+
+  GIVEN("A pool of four workers, and tasks of uneven cost") {
+    PATaskPool pool(4);
+    std::vector<std::atomic<int>> runs(200);
+    std::atomic<int> badWorker(0);
+
+    WHEN("The tasks are run, twice") {
+      for (int job = 0; job < 2; job++)
+        pool.Run(runs.size(), [&](std::size_t task, int worker) {
+          if (worker < 0 || worker >= pool.WorkerCount())
+            badWorker++;
+          if (task < 10)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+          runs[task]++;
+        });
+
+      THEN("Every task runs once per job, on a valid worker") {
+        for (std::atomic<int> &count : runs)
+          REQUIRE(count == 2);
+        REQUIRE(badWorker == 0);
+      }
+    }
+  }
+}
@@ -1,10 +1,14 @@
 #include "catch2/catch.hpp"
 #include "lib/pa_data.h"
+#include "lib/pa_macros.h"
 #include "lib/pa_models.h"
 #include "lib/pa_planet.h"
 #include "lib/pa_types.h"
 #include "lib/pa_util.h"
+#include "planet_reference.h"
+#include <cmath>
 #include <tuple>
+#include <vector>
 
 SCENARIO("Approximate Position of Planet") {
   GIVEN("A PAPlanet object") {
@@ -56,6 +60,39 @@ SCENARIO("Precise Position of Planet") {
   }
 }
 
+SCENARIO("Precise Position of Superior Planets Near Opposition") {
+  GIVEN("A PAPlanet object") {
+    PAPlanet paPlanet;
+
+    WHEN("Local Civil Time is 00:00:00, for Mars on 8/28/2003 and Jupiter "
+         "and Saturn on 1/1/2003") {
+      std::vector<CPrecisePositionOfPlanet> result = {
+          paPlanet.PrecisePositionOfPlanet(0, 0, 0, false, 0, 28, 8, 2003,
+                                           "Mars"),
+          paPlanet.PrecisePositionOfPlanet(0, 0, 0, false, 0, 1, 1, 2003,
+                                           "Jupiter"),
+          paPlanet.PrecisePositionOfPlanet(0, 0, 0, false, 0, 1, 1, 2003,
+                                           "Saturn")};
+
+      THEN("Each is opposite the Sun, not 180 degrees out") {
+        std::vector<CPrecisePositionOfPlanet> expected = {
+            CPrecisePositionOfPlanet(22, 38, 15.81, -15, 45, 37.39),
+            CPrecisePositionOfPlanet(9, 18, 20.39, 16, 30, 34.8),
+            CPrecisePositionOfPlanet(5, 35, 56.6, 22, 2, 15.66)};
+
+        for (std::size_t i = 0; i < expected.size(); i++) {
+          REQUIRE(result[i].PlanetRAHour == expected[i].PlanetRAHour);
+          REQUIRE(result[i].PlanetRAMin == expected[i].PlanetRAMin);
+          REQUIRE(result[i].PlanetRASec == expected[i].PlanetRASec);
+          REQUIRE(result[i].PlanetDecDeg == expected[i].PlanetDecDeg);
+          REQUIRE(result[i].PlanetDecMin == expected[i].PlanetDecMin);
+          REQUIRE(result[i].PlanetDecSec == expected[i].PlanetDecSec);
+        }
+      }
+    }
+  }
+}
+
 SCENARIO("Visual Aspects of a Planet") {
   GIVEN("A PAPlanet object") {
     PAPlanet paPlanet;
@@ -82,4 +119,74 @@ SCENARIO("Visual Aspects of a Planet") {
       }
     }
   }
-}
\ No newline at end of file
+}
+
+SCENARIO("Precise Position of All Planets") {
+  GIVEN("A PAPlanet object") {
+    PAPlanet paPlanet;
+
+    WHEN("Local Civil Time is 06:00:00 and Local Date is 8/28/2003, with "
+         "visual aspects") {
+      CAllPlanetPositions result = paPlanet.PrecisePositionOfAllPlanets(
+          6, 0, 0, false, 0, 28, 8, 2003, true);
+
+      THEN("Each planet matches PrecisePositionOfPlanet and "
+           "VisualAspectsOfAPlanet") {
+        REQUIRE(result.planetNames.size() == 7);
+        REQUIRE(result.positions.size() == 7);
+        REQUIRE(result.visualAspects.size() == 7);
+
+        for (int i = 0; i < result.planetNames.size(); i++) {
+          CPrecisePositionOfPlanet expected = paPlanet.PrecisePositionOfPlanet(
+              6, 0, 0, false, 0, 28, 8, 2003, result.planetNames[i]);
+          CPlanetVisualAspects expectedAspects =
+              paPlanet.VisualAspectsOfAPlanet(6, 0, 0, false, 0, 28, 8, 2003,
+                                              result.planetNames[i]);
+
+          REQUIRE(result.positions[i].PlanetRAHour == expected.PlanetRAHour);
+          REQUIRE(result.positions[i].PlanetRAMin == expected.PlanetRAMin);
+          REQUIRE(result.positions[i].PlanetRASec == expected.PlanetRASec);
+          REQUIRE(result.positions[i].PlanetDecDeg == expected.PlanetDecDeg);
+          REQUIRE(result.positions[i].PlanetDecMin == expected.PlanetDecMin);
+          REQUIRE(result.positions[i].PlanetDecSec == expected.PlanetDecSec);
+          REQUIRE(result.visualAspects[i].distanceAU ==
+                  expectedAspects.distanceAU);
+          REQUIRE(result.visualAspects[i].phase == expectedAspects.phase);
+          REQUIRE(result.visualAspects[i].posAngleBrightLimbDeg ==
+                  expectedAspects.posAngleBrightLimbDeg);
+          REQUIRE(result.visualAspects[i].approximateMagnitude ==
+                  expectedAspects.approximateMagnitude);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Outer Planet Perturbations") {
+  GIVEN("Elements of the planets every 10 years from 1800 to 2200") {
+    WHEN("Perturbations of Jupiter to Neptune come from the tables") {
+      THEN("They agree with the hand-written series") {
+        for (int decade = -10; decade <= 30; decade++) {
+          double t = decade / 10.0;
+          std::vector<pa_data::PlanetDataPrecise> pl =
+              pa_macros::PlanetElements(t);
+          COuterPlanetArguments outer = pa_macros::OuterPlanetArguments(t);
+
+          for (std::size_t ip = 4; ip < pl.size(); ip++) {
+            CPlanetLongLatL4945 expected = BranchyPlanetLongL4945(t, pl[ip]);
+            CPlanetLongLatL4945 result = pa_macros::PlanetLongL4945(
+                outer, static_cast<EOuterPlanet>(ip - 4), pl[ip].value4);
+
+            REQUIRE(std::abs(result.qa - expected.qa) < 1e-12);
+            REQUIRE(std::abs(result.qb - expected.qb) < 1e-12);
+            REQUIRE(std::abs(result.qc - expected.qc) < 1e-12);
+            REQUIRE(std::abs(result.qd - expected.qd) < 1e-12);
+            REQUIRE(std::abs(result.qe - expected.qe) < 1e-12);
+            REQUIRE(std::abs(result.qf - expected.qf) < 1e-12);
+            REQUIRE(std::abs(result.qg - expected.qg) < 1e-12);
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,183 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_macros.h"
+#include "lib/pa_models.h"
+#include "lib/pa_ranges.h"
+#include "lib/pa_raw.h"
+#include "lib/pa_util.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+namespace {
+/**
+ * \brief Values are their index; counts how many it is asked for.
+ */
+class CountingGenerator {
+public:
+  using value_type = double;
+
+  explicit CountingGenerator(std::size_t *computed) : computed(computed) {}
+
+  void Fill(std::size_t first, std::size_t count, double *values) {
+    for (std::size_t i = 0; i < count; i++)
+      values[i] = (double)(first + i);
+    *computed += count;
+  }
+
+private:
+  std::size_t *computed;
+};
+} // namespace
+
+SCENARIO("Lazy Ephemeris Ranges", "[ranges]") {
+  GIVEN("Ranges from 1/1/2024, every 0.3 days") {
+    double start = pa_macros::CivilDateToJulianDate(1, 1, 2024);
+
+    WHEN("The positions of the Sun, the Moon and Mars are taken") {
+      std::vector<pa_ranges::Position> sun, moon, mars;
+      for (const pa_ranges::Position &position :
+           pa_ranges::Ephemeris("Sun", start, 0.3, 20))
+        sun.push_back(position);
+      auto moonRange = pa_ranges::Ephemeris("Moon", start, 0.3, 20, 7);
+      std::copy(moonRange.begin(), moonRange.end(), std::back_inserter(moon));
+      for (const pa_ranges::Position &position :
+           pa_ranges::Ephemeris("Mars", start, 0.3).Take(20))
+        mars.push_back(position);
+
+      THEN("They are those of pa_raw, across changes of date") {
+        REQUIRE(sun.size() == 20);
+        REQUIRE(moon.size() == 20);
+        REQUIRE(mars.size() == 20);
+        for (int i = 0; i < 20; i++) {
+          double julianDate = start + 0.3 * i;
+          pa_raw::SunPosition expectedSun = pa_raw::Sun(julianDate);
+          pa_raw::MoonPosition expectedMoon = pa_raw::Moon(julianDate);
+          pa_raw::PlanetPosition expectedMars =
+              pa_raw::Planet(julianDate, "Mars");
+
+          REQUIRE(sun[i].julianDate == julianDate);
+          REQUIRE(sun[i].raRad == expectedSun.raRad);
+          REQUIRE(sun[i].decRad == expectedSun.decRad);
+          REQUIRE(sun[i].distance == expectedSun.distanceKm);
+          REQUIRE(moon[i].raRad == expectedMoon.raRad);
+          REQUIRE(moon[i].decRad == expectedMoon.decRad);
+          REQUIRE(moon[i].distance == expectedMoon.distanceKm);
+          REQUIRE(mars[i].raRad == expectedMars.raRad);
+          REQUIRE(mars[i].decRad == expectedMars.decRad);
+          REQUIRE(mars[i].distance == expectedMars.distanceAU);
+
+          pa_raw::DateTerms terms = pa_raw::DateTermsOf(julianDate);
+          REQUIRE(pa_raw::GreenwichSiderealTime(julianDate, terms) ==
+                  pa_raw::GreenwichSiderealTime(julianDate));
+        }
+      }
+    }
+  }
+
+  GIVEN("The Sun's altitude at 42.37 N 71.05 W, every minute of 10/3/1986") {
+    CObservingSite boston(-71.05, 42.37, false, -5);
+    double start = pa_macros::CivilDateToJulianDate(10, 3, 1986);
+    auto altitudes = pa_ranges::SunAltitudes(boston, start, 1.0 / 1440, 1440);
+
+    WHEN("The first minute of daylight is found") {
+      auto sunrise = std::find_if(
+          altitudes.begin(), altitudes.end(),
+          [](const pa_ranges::Altitude &sun) { return sun.altitudeRad > 0; });
+
+      THEN("It is just after sunrise, and as pa_raw would give it") {
+        REQUIRE(sunrise != altitudes.end());
+
+        double julianDate = sunrise->julianDate;
+        pa_raw::SunPosition sun = pa_raw::Sun(julianDate);
+        double lstHours = pa_raw::LocalSiderealTime(
+            julianDate, pa_util::DegreesToRadians(-71.05));
+        pa_raw::HorizonCoordinates horizon = pa_raw::EquatorialToHorizon(
+            pa_util::DegreesToRadians(lstHours * 15) - sun.raRad, sun.decRad,
+            pa_util::DegreesToRadians(42.37));
+        REQUIRE(sunrise->altitudeRad ==
+                Approx(horizon.altitudeRad).margin(1e-12));
+        REQUIRE(sunrise->azimuthRad ==
+                Approx(horizon.azimuthRad).margin(1e-12));
+
+        // Local civil time is UT - 5 hours. PASun gives sunrise at 06:05,
+        // for the upper limb with refraction; the centre of the Sun
+        // clears the geometric horizon five minutes later.
+        double utHours = (julianDate - start) * 24;
+        REQUIRE(utHours - 5 == Approx(6 + 10.0 / 60).margin(0.01));
+      }
+    }
+
+    WHEN("The highest and lowest altitudes are found, a chunk at a time") {
+      auto chunked =
+          pa_ranges::SunAltitudes(boston, start, 1.0 / 1440, 1440, 64);
+      auto byAltitude = [](const pa_ranges::Altitude &a,
+                           const pa_ranges::Altitude &b) {
+        return a.altitudeRad < b.altitudeRad;
+      };
+      auto highest =
+          std::max_element(chunked.begin(), chunked.end(), byAltitude);
+      auto extremes =
+          std::minmax_element(chunked.begin(), chunked.end(), byAltitude);
+
+      THEN("They are the Sun's at noon and midnight, not the last chunk's") {
+        double utHours = (highest->julianDate - start) * 24;
+        REQUIRE(highest->altitudeRad == Approx(0.7610).margin(0.0001));
+        REQUIRE(utHours == Approx(16 + 55.0 / 60).margin(0.001));
+
+        double highestRad = -1, lowestRad = 1;
+        for (const pa_ranges::Altitude &sun : altitudes) {
+          highestRad = std::max(highestRad, sun.altitudeRad);
+          lowestRad = std::min(lowestRad, sun.altitudeRad);
+        }
+        REQUIRE((*highest).altitudeRad == highestRad);
+        REQUIRE(extremes.second->altitudeRad == highestRad);
+        REQUIRE(extremes.first->altitudeRad == lowestRad);
+        REQUIRE((extremes.first->julianDate - start) * 24 ==
+                Approx(4 + 55.0 / 60).margin(0.1));
+      }
+    }
+
+    WHEN("Minutes of daylight are counted") {
+      std::ptrdiff_t daylight = std::count_if(
+          altitudes.begin(), altitudes.end(),
+          [](const pa_ranges::Altitude &sun) { return sun.altitudeRad > 0; });
+
+      THEN("There are about twelve hours of them") {
+        REQUIRE(daylight / 60.0 == Approx(11.7).margin(0.3));
+      }
+    }
+  }
+
+  GIVEN("A range with no end, computed eight values at a time") {
+    std::size_t computed = 0;
+    pa_ranges::LazyRange<CountingGenerator> range(
+        CountingGenerator(&computed), pa_ranges::kUnbounded, 8);
+
+    WHEN("Nothing is read") {
+      THEN("Nothing is computed") { REQUIRE(computed == 0); }
+    }
+
+    WHEN("An algorithm stops at the eleventh value") {
+      auto found = std::find_if(range.begin(), range.end(),
+                                [](double value) { return value == 10; });
+
+      THEN("Only the chunks up to it are computed") {
+        REQUIRE(*found == 10);
+        REQUIRE(computed == 16);
+      }
+    }
+
+    WHEN("The first twenty values are summed") {
+      pa_ranges::LazyRange<CountingGenerator> first = range.Take(20);
+      double sum = std::accumulate(first.begin(), first.end(), 0.0);
+
+      THEN("No chunk runs past them") {
+        REQUIRE(first.size() == 20);
+        REQUIRE(sum == 190);
+        REQUIRE(computed == 20);
+      }
+    }
+  }
+}
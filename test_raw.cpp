@@ -0,0 +1,197 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_macros.h"
+#include "lib/pa_moon.h"
+#include "lib/pa_raw.h"
+#include "lib/pa_types.h"
+#include "lib/pa_util.h"
+#include <cmath>
+#include <vector>
+
+using namespace pa_macros;
+using namespace pa_util;
+
+namespace {
+double HoursToRadians(double hours, double minutes, double seconds) {
+  return DegreesToRadians(HmsToDh(hours, minutes, seconds) * 15.0);
+}
+
+double DmsToRadians(double degrees, double minutes, double seconds) {
+  return DegreesToRadians(
+      DegreesMinutesSecondsToDecimalDegrees(degrees, minutes, seconds));
+}
+
+/** Half a second of time, in radians. */
+const double kHalfSecondRad = 0.000037;
+} // namespace
+
+SCENARIO("Raw Sun, Moon, Planet and Comet Positions", "[raw]") {
+  GIVEN("Instants as Julian dates") {
+    WHEN("The Sun is found at 0h UT on 7/27/1988") {
+      pa_raw::SunPosition result =
+          pa_raw::Sun(CivilDateToJulianDate(27, 7, 1988));
+
+      THEN("Right Ascension is 8h 26m 3.83s, Declination is 19d 12m 49.72s "
+           "and Distance is 151920130 km, as from PASun") {
+        REQUIRE(std::abs(result.raRad - HoursToRadians(8, 26, 3.83)) <
+                0.000001);
+        REQUIRE(std::abs(result.decRad - DmsToRadians(19, 12, 49.72)) <
+                0.000001);
+        REQUIRE(std::abs(result.distanceKm - 151920130) < 1);
+      }
+    }
+
+    WHEN("The Moon is found at 0h UT on 9/1/2003") {
+      double julianDate = CivilDateToJulianDate(1, 9, 2003);
+      pa_raw::MoonPosition result = pa_raw::Moon(julianDate);
+      pa_raw::MoonPhase phase = pa_raw::Phase(julianDate);
+
+      THEN("Right Ascension is 14h 12m 10.21s, Declination is -11d 34m "
+           "57.83s, Distance is 367964 km, and Phase matches PAMoon") {
+        PAMoon paMoon;
+        CMoonPhase expected = paMoon.MoonPhase(0, 0, 0, false, 0, 1, 9, 2003,
+                                               EAccuracyLevel::Precise);
+
+        REQUIRE(std::abs(result.raRad - HoursToRadians(14, 12, 10.21)) <
+                0.000001);
+        REQUIRE(std::abs(result.decRad - DmsToRadians(-11, 34, 57.83)) <
+                0.000001);
+        REQUIRE(std::abs(result.distanceKm - 367964) < 1);
+        REQUIRE(std::abs(result.horizontalParallaxRad -
+                         DegreesToRadians(0.993191)) < 0.00000001);
+        REQUIRE(Round(phase.illuminatedFraction, 2) == expected.phase);
+        REQUIRE(Round(RadiansToDegrees(phase.brightLimbPositionAngleRad), 2) ==
+                expected.brightLimbDeg);
+      }
+    }
+
+    WHEN("Jupiter is found at 0h UT on 11/22/2003, alone and with the other "
+         "planets") {
+      double julianDate = CivilDateToJulianDate(22, 11, 2003);
+      pa_raw::PlanetPosition result = pa_raw::Planet(julianDate, "Jupiter");
+      std::vector<pa_raw::PlanetPosition> all = pa_raw::AllPlanets(julianDate);
+
+      THEN("Right Ascension is 11h 10m 30.99s and Declination is 6d 25m "
+           "49.46s, and both results agree") {
+        REQUIRE(std::abs(result.raRad - HoursToRadians(11, 10, 30.99)) <
+                0.000001);
+        REQUIRE(std::abs(result.decRad - DmsToRadians(6, 25, 49.46)) <
+                0.000001);
+        REQUIRE(all.size() == 7);
+        REQUIRE(all[3].raRad == result.raRad);
+        REQUIRE(all[3].distanceAU == result.distanceAU);
+        REQUIRE(pa_raw::Planet(julianDate, "Pluto").distanceAU == 0);
+      }
+    }
+
+    WHEN("Comets Halley and Kohler are found at 0h UT on 1/1/1984 and "
+         "12/25/1977") {
+      pa_raw::CometPosition halley =
+          pa_raw::EllipticalComet(CivilDateToJulianDate(1, 1, 1984), "Halley");
+      pa_raw::CometPosition kohler =
+          pa_raw::ParabolicComet(CivilDateToJulianDate(25, 12, 1977), "Kohler");
+
+      THEN("Positions and distances match PAComet, before rounding") {
+        REQUIRE(std::abs(halley.raRad - HoursToRadians(6, 29, 0)) <
+                HoursToRadians(0, 1, 0));
+        REQUIRE(Round(halley.distanceAU, 2) == 8.13);
+        REQUIRE(std::abs(kohler.raRad - HoursToRadians(23, 17, 11.53)) <
+                kHalfSecondRad);
+        REQUIRE(std::abs(kohler.decRad - DmsToRadians(-33, 42, 26.42)) <
+                0.000001);
+        REQUIRE(Round(kohler.distanceAU, 2) == 1.11);
+      }
+    }
+  }
+}
+
+SCENARIO("Raw Coordinates", "[raw]") {
+  GIVEN("Coordinates in radians") {
+    WHEN("Hour Angle is 5h 51m 44s, Declination is 23d 13m 10s and Latitude "
+         "is 52d") {
+      pa_raw::HorizonCoordinates result = pa_raw::EquatorialToHorizon(
+          HoursToRadians(5, 51, 44), DmsToRadians(23, 13, 10),
+          DegreesToRadians(52));
+
+      THEN("Azimuth is 283d 16m 15.7s and Altitude is 19d 20m 3.64s") {
+        REQUIRE(std::abs(result.azimuthRad - DmsToRadians(283, 16, 15.7)) <
+                0.000001);
+        REQUIRE(std::abs(result.altitudeRad - DmsToRadians(19, 20, 3.64)) <
+                0.000001);
+      }
+    }
+
+    WHEN("Ecliptic Longitude is 139d 41m 10s and Latitude is 4d 52m 31s on "
+         "7/6/2009, and the result is converted back") {
+      double julianDate = CivilDateToJulianDate(6, 7, 2009);
+      pa_raw::EquatorialCoordinates result = pa_raw::EclipticToEquatorial(
+          DmsToRadians(139, 41, 10), DmsToRadians(4, 52, 31), julianDate);
+      pa_raw::EclipticCoordinates back =
+          pa_raw::EquatorialToEcliptic(result.raRad, result.decRad, julianDate);
+
+      THEN("Right Ascension is 9h 34m 53.4s and Declination is 19d 32m 8.52s, "
+           "and the ecliptic coordinates are recovered") {
+        REQUIRE(std::abs(result.raRad - HoursToRadians(9, 34, 53.4)) <
+                0.000001);
+        REQUIRE(std::abs(result.decRad - DmsToRadians(19, 32, 8.52)) <
+                0.000001);
+        REQUIRE(std::abs(back.longitudeRad - DmsToRadians(139, 41, 10)) <
+                0.000000001);
+        REQUIRE(std::abs(back.latitudeRad - DmsToRadians(4, 52, 31)) <
+                0.000000001);
+      }
+    }
+
+    WHEN("Universal Time is 14h 36m 51.67s on 4/22/1980") {
+      double julianDate =
+          CivilDateToJulianDate(22, 4, 1980) + HmsToDh(14, 36, 51.67) / 24;
+
+      THEN("Greenwich Sidereal Time is 4h 40m 5.23s") {
+        REQUIRE(std::abs(pa_raw::GreenwichSiderealTime(julianDate) -
+                         HmsToDh(4, 40, 5.23)) < 0.00001);
+        REQUIRE(std::abs(pa_raw::LocalSiderealTime(julianDate,
+                                                   DegreesToRadians(-64)) -
+                         HmsToDh(0, 24, 5.23)) < 0.00001);
+      }
+    }
+  }
+}
+
+SCENARIO("Raw Eclipses", "[raw]") {
+  GIVEN("Instants as Julian dates") {
+    WHEN("The lunar eclipse nearest 0h UT on 4/1/2015 is found") {
+      pa_raw::LunarEclipse result =
+          pa_raw::LunarEclipseCircumstances(CivilDateToJulianDate(1, 4, 2015));
+      double day = CivilDateToJulianDate(4, 4, 2015);
+
+      THEN("It is certain, mid eclipse is 12:01 UT on 4/4/2015, penumbral "
+           "phase runs from 9:00 to 15:01 and magnitude is 1.01") {
+        REQUIRE(result.status == ELunarEclipseStatus::Certain);
+        REQUIRE(std::abs(result.maximumJulianDate - (day + 12.0 / 24)) <
+                1.5 / 1440);
+        REQUIRE(std::abs(result.firstContactJulianDate - (day + 9.0 / 24)) <
+                1.5 / 1440);
+        REQUIRE(std::abs(result.lastContactJulianDate -
+                         (day + HmsToDh(15, 1, 0) / 24)) < 1.5 / 1440);
+        REQUIRE(Round(result.magnitude, 2) == 1.01);
+      }
+    }
+
+    WHEN("The solar eclipse of 3/20/2015 is found from 0d/68.65d") {
+      pa_raw::SolarEclipse result = pa_raw::SolarEclipseCircumstances(
+          CivilDateToJulianDate(20, 3, 2015), 0, DegreesToRadians(68.65));
+      double day = CivilDateToJulianDate(20, 3, 2015);
+
+      THEN("First contact is 8:55 UT, mid eclipse is 9:57 and last contact is "
+           "10:58 and magnitude is 1.016") {
+        REQUIRE(result.status == ESolarEclipseStatus::Certain);
+        REQUIRE(std::abs(result.firstContactJulianDate -
+                         (day + HmsToDh(8, 55, 0) / 24)) < 1.5 / 1440);
+        REQUIRE(std::abs(result.maximumJulianDate -
+                         (day + HmsToDh(9, 57, 0) / 24)) < 1.5 / 1440);
+        REQUIRE(std::abs(result.lastContactJulianDate -
+                         (day + HmsToDh(10, 58, 0) / 24)) < 1.5 / 1440);
+        REQUIRE(Round(result.magnitude, 3) == 1.016);
+      }
+    }
+  }
+}
@@ -0,0 +1,70 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_macros.h"
+#include "lib/pa_refraction.h"
+#include "lib/pa_types.h"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace pa_types;
+
+SCENARIO("Atmospheric refraction lookup table", "[refraction]") {
+  GIVEN("Refraction tables for 1012 mbar and 21.7 Celsius") {
+    PARefractionTable trueToApparent(1012, 21.7, ECoordinateType::Actual);
+    PARefractionTable apparentToTrue(1012, 21.7, ECoordinateType::Apparent);
+
+    WHEN("Altitudes are corrected between -4 and 90 degrees") {
+      double maxTrueErrorDeg = 0;
+      double maxApparentErrorDeg = 0;
+
+      for (double altitudeDeg = -4.0; altitudeDeg <= 90.0;
+           altitudeDeg += 0.0137) {
+        maxTrueErrorDeg = std::max(
+            maxTrueErrorDeg,
+            std::abs(trueToApparent.CorrectedAltitude(altitudeDeg) -
+                     pa_macros::Refract(altitudeDeg, ECoordinateType::Actual,
+                                        1012, 21.7)));
+        maxApparentErrorDeg = std::max(
+            maxApparentErrorDeg,
+            std::abs(apparentToTrue.CorrectedAltitude(altitudeDeg) -
+                     pa_macros::Refract(altitudeDeg, ECoordinateType::Apparent,
+                                        1012, 21.7)));
+      }
+
+      THEN("The tables agree with the direct formula to within 0.2 arcsec") {
+        REQUIRE(maxTrueErrorDeg < 0.2 / 3600);
+        REQUIRE(maxApparentErrorDeg < 0.2 / 3600);
+        REQUIRE(trueToApparent.MaxErrorDeg() < 1.0 / 3600);
+        REQUIRE(apparentToTrue.MaxErrorDeg() < 0.01 / 3600);
+      }
+    }
+
+    WHEN("A batch of altitudes is corrected") {
+      std::vector<double> altitudesDeg = {-10.0, -2.5, 0.0, 14.9, 15.0, 45.0};
+      std::vector<double> result = trueToApparent.Apply(altitudesDeg);
+
+      THEN("Each value matches the single-object correction") {
+        REQUIRE(result.size() == altitudesDeg.size());
+        REQUIRE(result[0] == 0);
+
+        for (int i = 0; i < altitudesDeg.size(); i++)
+          REQUIRE(result[i] ==
+                  trueToApparent.CorrectedAltitude(altitudesDeg[i]));
+      }
+    }
+
+    WHEN("A table is asked for a step that is not positive") {
+      THEN("It is rejected") {
+        REQUIRE_THROWS_AS(PARefractionTable(1012, 21.7, ECoordinateType::Actual,
+                                            0),
+                          std::invalid_argument);
+        REQUIRE_THROWS_AS(PARefractionTable(1012, 21.7,
+                                            ECoordinateType::Apparent, -0.05),
+                          std::invalid_argument);
+        REQUIRE_THROWS_AS(PARefractionTable(1012, 21.7,
+                                            ECoordinateType::Apparent, NAN),
+                          std::invalid_argument);
+      }
+    }
+  }
+}
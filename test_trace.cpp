@@ -0,0 +1,45 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_eclipses.h"
+#include "lib/pa_trace.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+SCENARIO("Trace of an eclipse calculation", "[trace]") {
+  GIVEN("A trace written to a file") {
+    std::string tracePath = "test_trace.json";
+    PAEclipses paEclipses;
+
+    REQUIRE(pa_trace::Start(tracePath));
+    REQUIRE(pa_trace::IsActive());
+    paEclipses.LunarEclipseCircumstances(1, 4, 2015, false, 10);
+    REQUIRE(pa_trace::Stop());
+
+    std::ifstream file(tracePath);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::string json = contents.str();
+
+    WHEN("The lunar eclipse of 4/4/2015 was computed while tracing") {
+      THEN("With tracing built in, the façade and its helpers are spans; "
+           "without it, the trace is empty") {
+        REQUIRE(json.rfind("{\"traceEvents\": [", 0) == 0);
+        REQUIRE_FALSE(pa_trace::IsActive());
+        REQUIRE_FALSE(pa_trace::Stop());
+
+        if (pa_trace::IsEnabled()) {
+          REQUIRE(json.find("\"name\": \"PAEclipses::LunarEclipseCircumstances"
+                            "\", \"ph\": \"X\"") != std::string::npos);
+          REQUIRE(json.find("\"name\": \"UTFirstContactLunarEclipse\"") !=
+                  std::string::npos);
+          REQUIRE(json.find("\"name\": \"FullMoon\"") != std::string::npos);
+        } else {
+          REQUIRE(json.find("\"ph\"") == std::string::npos);
+        }
+      }
+    }
+
+    std::remove(tracePath.c_str());
+  }
+}
@@ -0,0 +1,109 @@
+#include "catch2/catch.hpp"
+#include "lib/pa_catalogue.h"
+#include "lib/pa_coordinates.h"
+#include "lib/pa_macros.h"
+#include "lib/pa_models.h"
+#include "lib/pa_sun.h"
+#include "lib/pa_types.h"
+#include "lib/pa_visibility.h"
+#include <cmath>
+#include <vector>
+
+using namespace pa_types;
+using namespace pa_models;
+
+SCENARIO("Visibility windows", "[visibility]") {
+  GIVEN("A PAVisibility object for Geographical Long/Lat 64/30") {
+    PAVisibility paVisibility(64, 30);
+    double startJulianDate = pa_macros::CivilDateToJulianDate(24, 8, 2010);
+
+    WHEN("An object at RA 23h 39m 20s and Dec 21d 42m 0s must be above "
+         "-0.5667 degrees on Greenwich Date 8/24/2010") {
+      double raHours = pa_macros::HmsToDh(23, 39, 20);
+      double decDeg =
+          pa_macros::DegreesMinutesSecondsToDecimalDegrees(21, 42, 0);
+
+      std::vector<CVisibilityWindow> result = paVisibility.AltitudeWindows(
+          CAltitudeConstraint(raHours, decDeg, EAltitudeSense::Above, -0.5667),
+          startJulianDate, startJulianDate + 1);
+
+      THEN("It is up until it sets and after it rises, as given by "
+           "PACatalogue::RisingAndSetting") {
+        PACatalogue paCatalogue;
+        CRiseSetCatalogue riseSet = paCatalogue.RisingAndSetting(
+            {raHours}, {decDeg}, 24, 8, 2010, 64, 30, 0.5667);
+        double toleranceDays = 2.0 / 1440;
+
+        REQUIRE(result.size() == 2);
+        REQUIRE(result[0].startJulianDate == startJulianDate);
+        REQUIRE(std::abs(result[0].endJulianDate -
+                         (startJulianDate + riseSet.utSetHours[0] / 24)) <
+                toleranceDays);
+        REQUIRE(std::abs(result[1].startJulianDate -
+                         (startJulianDate + riseSet.utRiseHours[0] / 24)) <
+                toleranceDays);
+        REQUIRE(result[1].endJulianDate == startJulianDate + 1);
+      }
+    }
+
+    WHEN("Dark time is searched for the week starting 8/24/2010 (around "
+         "full Moon)") {
+      std::vector<CVisibilityWindow> result = paVisibility.DarkTime(
+          -18, -0.833, startJulianDate, startJulianDate + 7);
+
+      THEN("The windows are sorted and disjoint, and the Sun is below -18 "
+           "degrees in the middle of each") {
+        PASun paSun;
+        PACoordinates paCoordinates;
+
+        REQUIRE(result.size() == 3);
+        for (int i = 0; i < result.size(); i++) {
+          REQUIRE(result[i].startJulianDate < result[i].endJulianDate);
+          if (i > 0)
+            REQUIRE(result[i - 1].endJulianDate < result[i].startJulianDate);
+
+          double middle =
+              (result[i].startJulianDate + result[i].endJulianDate) / 2;
+          double jd0 = floor(middle - 0.5) + 0.5;
+          double day = pa_macros::JulianDateDay(jd0);
+          int month = pa_macros::JulianDateMonth(jd0);
+          int year = pa_macros::JulianDateYear(jd0);
+          double utHours = (middle - jd0) * 24;
+
+          CPrecisePositionOfSun sun = paSun.PrecisePositionOfSun(
+              utHours, 0, 0, day, month, year, false, 0);
+          CHourAngle hourAngle = paCoordinates.RightAscensionToHourAngle(
+              sun.rightAscensionHours, sun.rightAscensionMinutes,
+              sun.rightAscensionSeconds, utHours, 0, 0, false, 0, day,
+              month, year, 64);
+          CHorizonCoordinates horizon =
+              paCoordinates.EquatorialCoordinatesToHorizonCoordinates(
+                  hourAngle.hours, hourAngle.minutes, hourAngle.seconds,
+                  sun.declinationDegrees, sun.declinationMinutes,
+                  sun.declinationSeconds, 30);
+
+          REQUIRE(horizon.altitudeDegrees < -18);
+        }
+      }
+    }
+
+    WHEN("Intervals are merged and intersected") {
+      std::vector<CVisibilityWindow> merged = PAVisibility::Merge(
+          {CVisibilityWindow(3, 4), CVisibilityWindow(1, 2),
+           CVisibilityWindow(1.5, 2.5)});
+      std::vector<CVisibilityWindow> intersected = PAVisibility::Intersect(
+          merged, {CVisibilityWindow(2, 3.5)});
+
+      THEN("Overlaps are combined and the common parts kept") {
+        REQUIRE(merged.size() == 2);
+        REQUIRE(merged[0].startJulianDate == 1);
+        REQUIRE(merged[0].endJulianDate == 2.5);
+        REQUIRE(intersected.size() == 2);
+        REQUIRE(intersected[0].startJulianDate == 2);
+        REQUIRE(intersected[0].endJulianDate == 2.5);
+        REQUIRE(intersected[1].startJulianDate == 3);
+        REQUIRE(intersected[1].endJulianDate == 3.5);
+      }
+    }
+  }
+}